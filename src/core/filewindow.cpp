@@ -0,0 +1,46 @@
+#include "filewindow.h"
+#include <QFile>
+
+FileWindow::FileWindow(QFile *file, qint64 windowSize)
+    : m_file(file)
+    , m_windowSize(windowSize)
+    , m_data(nullptr)
+    , m_offset(0)
+    , m_length(0)
+{
+}
+
+FileWindow::~FileWindow()
+{
+    unmap();
+}
+
+const uchar *FileWindow::map(qint64 offset, qint64 length)
+{
+    if (m_data && offset >= m_offset && offset + length <= m_offset + m_length) {
+        return m_data + (offset - m_offset);
+    }
+
+    unmap();
+    const qint64 size = m_file->size();
+    if (offset < 0 || length <= 0 || offset + length > size) return nullptr;
+
+    m_length = qMin(qMax(m_windowSize, length), size - offset);
+    m_data = m_file->map(offset, m_length);
+    if (!m_data) {
+        m_length = 0;
+        return nullptr;
+    }
+    m_offset = offset;
+    return m_data;
+}
+
+void FileWindow::unmap()
+{
+    if (m_data) {
+        m_file->unmap(m_data);
+        m_data = nullptr;
+    }
+    m_offset = 0;
+    m_length = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef FILEWINDOW_H
+#define FILEWINDOW_H
+
+#include <QtGlobal>
+
+class QFile;
+
+// 按窗口映射大文件：同一时间只映射文件的一段（默认 16MB），顺序处理时常驻内存不随文件大小增长。
+// 映射的页面会计入进程常驻内存，整个映射一个 4GB 的文件在 2GB 内存的设备上不可行。
+class FileWindow
+{
+public:
+    static const qint64 DefaultSize = 16 * 1024 * 1024;
+
+    explicit FileWindow(QFile *file, qint64 windowSize = DefaultSize);
+    ~FileWindow();
+
+    // 保证 [offset, offset + length) 已映射，返回 offset 处的地址，失败时返回空。
+    // 不在当前窗口内时从 offset 开始重新映射，之前返回的地址随之失效
+    const uchar *map(qint64 offset, qint64 length);
+
+    qint64 windowSize() const { return m_windowSize; }
+    // 当前窗口的范围
+    qint64 offset() const { return m_offset; }
+    qint64 end() const { return m_offset + m_length; }
+
+private:
+    void unmap();
+
+private:
+    QFile *m_file;
+    qint64 m_windowSize;
+    uchar *m_data;
+    qint64 m_offset;
+    qint64 m_length;
+
+    Q_DISABLE_COPY(FileWindow)
+};
+
+#endif // FILEWINDOW_H
@@ -0,0 +1,353 @@
+#include "iconservice.h"
+#include "trace.h"
+#include "network/httpclient.h"
+#include <QApplication>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QSaveFile>
+#include <QPixmapCache>
+#include <QPointer>
+#include <QStandardPaths>
+#include <climits>
+
+namespace {
+
+const qint64 kDefaultPrefetchBudget = 4 * 1024 * 1024;   // 约 450 个 48px 图标
+
+} // namespace
+
+IconService *IconService::instance()
+{
+    static IconService *service = new IconService(qApp);
+    return service;
+}
+
+IconService::IconService(QObject *parent)
+    : QObject(parent)
+    , m_memoryCache(512)  // 默认最多保留512个图标
+    , m_prefetchBudget(0)
+    , m_downloadsConnected(false)
+{
+    setPrefetchBudget(kDefaultPrefetchBudget);
+    setDiskCacheDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                    + QStringLiteral("/icons"));
+}
+
+IconService::~IconService()
+{
+    // 排队中的解码直接丢弃，执行中的解码结果因对象已销毁而被忽略
+    for (PendingLoad &pending : m_pending) {
+        pending.token.cancel();
+    }
+}
+
+QPixmap IconService::placeholder()
+{
+    const QString key = QStringLiteral("appicon:placeholder");
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(iconSize(), iconSize());
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor("#e9ecef"));
+        painter.drawRoundedRect(QRectF(0, 0, iconSize(), iconSize()), 10, 10);
+        painter.end();
+
+        QPixmapCache::insert(key, pixmap);
+    }
+    return pixmap;
+}
+
+QPixmap IconService::cachedIcon(const QString &iconPath)
+{
+    QPixmap *pixmap = m_memoryCache.object(iconPath);
+    if (pixmap) return *pixmap;
+
+    // 预取的图标第一次使用时移入内存缓存，预取缓存的空间留给之后的预取
+    pixmap = m_prefetchCache.take(iconPath);
+    if (!pixmap) return QPixmap();
+    const QPixmap result = *pixmap;
+    m_memoryCache.insert(iconPath, pixmap);
+    return result;
+}
+
+QPixmap IconService::addThumbnail(const QString &iconPath, const QByteArray &png)
+{
+    const QImage image = QImage::fromData(png, "PNG");
+    if (image.isNull()) return QPixmap();
+
+    const QPixmap pixmap = QPixmap::fromImage(image);
+    m_memoryCache.insert(iconPath, new QPixmap(pixmap));
+    return pixmap;
+}
+
+void IconService::request(const QString &iconPath)
+{
+    if (iconPath.isEmpty()) return;
+
+    // 内存命中时仍然异步通知，保证调用方行为一致
+    const QPixmap cached = cachedIcon(iconPath);
+    if (!cached.isNull()) {
+        QMetaObject::invokeMethod(this, [this, iconPath, cached]() {
+            emit iconReady(iconPath, cached);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    auto it = m_pending.find(iconPath);
+    if (it != m_pending.end()) {
+        // 已有相同图标在解码，合并请求
+        it->refCount++;
+        if (it->prefetch) {
+            // 预取中的图标现在需要显示：下载中的提升优先级，其余按可见优先级重新排队
+            it->prefetch = false;
+            if (it->httpRequest != 0) {
+                HttpClient::instance()->setPriority(it->httpRequest, HttpClient::Visible);
+            } else {
+                it->token.cancel();
+                it->token = CancellationToken();
+                startLoad(iconPath, false);
+            }
+        }
+        return;
+    }
+
+    PendingLoad pending;
+    pending.refCount = 1;
+    m_pending.insert(iconPath, pending);
+    startLoad(iconPath, false);
+}
+
+void IconService::cancel(const QString &iconPath)
+{
+    auto it = m_pending.find(iconPath);
+    if (it == m_pending.end() || it->refCount <= 0) return;
+
+    if (--it->refCount == 0) {
+        if (it->httpRequest != 0) {
+            // 还在下载：取消下载请求（已发出的下载继续完成以填充 HTTP 缓存）
+            HttpClient::instance()->cancel(it->httpRequest);
+            m_downloads.remove(it->httpRequest);
+        }
+        // 解码任务排队中时由调度器丢弃；已在执行的任务结果因令牌不匹配而被忽略，
+        // 之后同一图标的新请求重新排队
+        it->token.cancel();
+        m_pending.erase(it);
+    }
+}
+
+void IconService::prefetch(const QString &iconPath)
+{
+    if (iconPath.isEmpty() || m_pending.contains(iconPath)
+        || m_memoryCache.contains(iconPath) || m_prefetchCache.contains(iconPath)) {
+        return;
+    }
+
+    PendingLoad pending;
+    pending.prefetch = true;
+    m_pending.insert(iconPath, pending);
+    startLoad(iconPath, true);
+}
+
+void IconService::cancelPrefetch(const QString &iconPath)
+{
+    auto it = m_pending.find(iconPath);
+    if (it == m_pending.end() || !it->prefetch) return;
+
+    if (it->httpRequest != 0) {
+        HttpClient::instance()->cancel(it->httpRequest);
+        m_downloads.remove(it->httpRequest);
+    }
+    it->token.cancel();
+    m_pending.erase(it);
+}
+
+void IconService::setMemoryCacheLimit(int count)
+{
+    m_memoryCache.setMaxCost(qMax(1, count));
+}
+
+void IconService::setDiskCacheDir(const QString &dir)
+{
+    m_diskCacheDir = dir;
+    if (!m_diskCacheDir.isEmpty()) {
+        QDir().mkpath(m_diskCacheDir);
+    }
+}
+
+void IconService::setPrefetchBudget(qint64 bytes)
+{
+    m_prefetchBudget = qMax<qint64>(0, bytes);
+    m_prefetchCache.setMaxCost(int(qMin<qint64>(m_prefetchBudget / 1024, INT_MAX)));
+}
+
+bool IconService::isRemote(const QString &iconPath)
+{
+    return iconPath.startsWith(QLatin1String("http://")) || iconPath.startsWith(QLatin1String("https://"));
+}
+
+void IconService::startLoad(const QString &iconPath, bool prefetch)
+{
+    if (isRemote(iconPath)) {
+        startDownload(iconPath, prefetch);
+        return;
+    }
+
+    const QString cacheDir = m_diskCacheDir;
+    const CancellationToken token = m_pending.value(iconPath).token;
+    startDecode(iconPath, token, prefetch, [iconPath, cacheDir, token]() {
+        return loadScaledImage(iconPath, cacheDir, token);
+    });
+}
+
+void IconService::startDecode(const QString &iconPath, const CancellationToken &token, bool prefetch,
+                              std::function<QImage()> decode)
+{
+    QPointer<IconService> guard(this);
+    const TaskScheduler::Priority priority = prefetch ? TaskScheduler::Prefetch : TaskScheduler::VisiblePage;
+    TaskScheduler::instance()->start(priority, [guard, iconPath, token, decode]() {
+        const QImage image = decode();
+
+        // QPixmap 只能在界面线程创建，结果通过队列连接送回；服务已销毁时直接丢弃
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, iconPath, image, token]() {
+            if (guard) {
+                guard->handleLoadFinished(iconPath, image, token);
+            }
+        }, Qt::QueuedConnection);
+    }, token);
+}
+
+void IconService::startDownload(const QString &iconPath, bool prefetch)
+{
+    HttpClient *client = HttpClient::instance();
+    if (!m_downloadsConnected) {
+        m_downloadsConnected = true;
+        connect(client, &HttpClient::finished, this, &IconService::handleDownloadFinished);
+        connect(client, &HttpClient::failed, this, &IconService::handleDownloadFailed);
+    }
+
+    const quint64 requestId = client->get(QUrl(iconPath), prefetch ? HttpClient::Prefetch : HttpClient::Visible);
+    m_pending[iconPath].httpRequest = requestId;
+    m_downloads.insert(requestId, iconPath);
+}
+
+void IconService::handleDownloadFinished(quint64 requestId, const QByteArray &data)
+{
+    const QString iconPath = m_downloads.take(requestId);
+    auto it = m_pending.find(iconPath);
+    if (iconPath.isEmpty() || it == m_pending.end()) return;
+    it->httpRequest = 0;
+
+    // 下载的内容在调度器中解码；HTTP 缓存保存原始内容，不再写缩略图
+    startDecode(iconPath, it->token, it->prefetch, [data]() {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        return readScaledImage(reader);
+    });
+}
+
+void IconService::handleDownloadFailed(quint64 requestId)
+{
+    const QString iconPath = m_downloads.take(requestId);
+    auto it = m_pending.find(iconPath);
+    if (iconPath.isEmpty() || it == m_pending.end()) return;
+    it->httpRequest = 0;
+    handleLoadFinished(iconPath, QImage(), it->token);
+}
+
+void IconService::handleLoadFinished(const QString &iconPath, const QImage &image, const CancellationToken &token)
+{
+    // 已取消的加载（之后可能又有新的请求重新排队）的结果不再使用
+    auto it = m_pending.find(iconPath);
+    if (it == m_pending.end() || it->token != token) return;
+
+    const bool prefetch = it->prefetch;
+    m_pending.erase(it);
+
+    QPixmap pixmap;
+    if (!image.isNull()) {
+        pixmap = QPixmap::fromImage(image);
+    }
+    if (prefetch) {
+        // 没有人在等待：放进预取缓存，不通知
+        if (!pixmap.isNull()) {
+            m_prefetchCache.insert(iconPath, new QPixmap(pixmap), int(iconBytes() / 1024));
+        }
+        return;
+    }
+    if (!pixmap.isNull()) {
+        m_memoryCache.insert(iconPath, new QPixmap(pixmap));
+    }
+    emit iconReady(iconPath, pixmap);
+}
+
+QString IconService::thumbnailPath(const QString &iconPath, const QString &cacheDir)
+{
+    if (cacheDir.isEmpty() || iconPath.isEmpty()) return QString();
+
+    // 磁盘缓存的键包含路径、修改时间和大小，源文件变化后自动失效
+    const QFileInfo info(iconPath);
+    const QByteArray key = iconPath.toUtf8() + '|'
+        + QByteArray::number(info.lastModified().toMSecsSinceEpoch()) + '|'
+        + QByteArray::number(info.size()) + '|'
+        + QByteArray::number(iconSize());
+    return cacheDir + QLatin1Char('/')
+        + QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex())
+        + QStringLiteral(".png");
+}
+
+QImage IconService::loadScaledImage(const QString &iconPath, const QString &cacheDir,
+                                    const CancellationToken &token)
+{
+    TRACE_SPAN("icon", "IconService::loadScaledImage");
+    const QString thumbPath = thumbnailPath(iconPath, cacheDir);
+    if (!thumbPath.isEmpty()) {
+        QImage cached(thumbPath);
+        if (!cached.isNull()) {
+            return cached;
+        }
+    }
+
+    if (token.isCancelled()) return QImage();
+
+    QImageReader reader(iconPath);
+    QImage image = readScaledImage(reader);
+    if (image.isNull() || token.isCancelled()) return QImage();
+
+    if (!thumbPath.isEmpty()) {
+        QSaveFile file(thumbPath);
+        if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG")) {
+            file.commit();
+        }
+    }
+
+    return image;
+}
+
+QImage IconService::readScaledImage(QImageReader &reader)
+{
+    reader.setAutoTransform(true);
+
+    // 大图先让解码器按两倍目标尺寸解码，减少解码和缩放开销
+    const QSize sourceSize = reader.size();
+    if (sourceSize.isValid() && reader.supportsOption(QImageIOHandler::ScaledSize)
+        && (sourceSize.width() > iconSize() * 4 || sourceSize.height() > iconSize() * 4)) {
+        reader.setScaledSize(sourceSize.scaled(iconSize() * 2, iconSize() * 2, Qt::KeepAspectRatio));
+    }
+
+    const QImage image = reader.read();
+    if (image.isNull()) return QImage();
+
+    return image.scaled(iconSize(), iconSize(), Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
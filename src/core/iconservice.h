@@ -0,0 +1,93 @@
+#ifndef ICONSERVICE_H
+#define ICONSERVICE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include "taskscheduler.h"
+
+class QImageReader;
+
+// 图标服务：在 TaskScheduler 中按当前页优先级解码并缩放图标，
+// 内存中保留最近使用的 48px 图标，磁盘上缓存缩放后的缩略图。
+// 同一图标的并发请求只解码一次，所有请求方取消后（例如翻页）取消令牌，未开始的解码由调度器直接丢弃。
+// http(s) 地址的图标通过 HttpClient 以可见优先级下载（合并请求、条件缓存），取消时排队中的下载一并取消。
+// 预取（见 PagePrefetcher）以预取优先级加载，结果放在单独的预取缓存中，总大小不超过预取预算，
+// 不会挤掉当前页的图标；预取的图标被使用时移入内存缓存，预取中的图标被请求时提升为可见优先级。
+class IconService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static IconService *instance();
+
+    explicit IconService(QObject *parent = nullptr);
+    ~IconService() override;
+
+    // 图标尺寸
+    static int iconSize() { return 48; }
+    // 加载完成前显示的占位图
+    static QPixmap placeholder();
+
+    // 从内存缓存中取图标，未命中时返回空图
+    QPixmap cachedIcon(const QString &iconPath);
+    // 用已有的缩略图（例如目录快照中保存的 PNG）填充内存缓存，返回解码后的图标，解码失败时返回空图
+    QPixmap addThumbnail(const QString &iconPath, const QByteArray &png);
+    // 请求加载图标，完成后通过 iconReady 信号通知；每次 request 需对应一次 cancel 或一次 iconReady
+    void request(const QString &iconPath);
+    // 取消一次请求
+    void cancel(const QString &iconPath);
+    // 预取图标：已缓存或正在加载时忽略，完成后不发出 iconReady
+    void prefetch(const QString &iconPath);
+    // 取消尚未完成的预取（已被 request 提升的不受影响）
+    void cancelPrefetch(const QString &iconPath);
+
+    // 缓存配置
+    void setMemoryCacheLimit(int count);
+    void setDiskCacheDir(const QString &dir);
+    // 预取缓存的大小上限（字节）
+    void setPrefetchBudget(qint64 bytes);
+    qint64 prefetchBudget() const { return m_prefetchBudget; }
+    // 一个图标在内存中占用的字节数
+    static qint64 iconBytes() { return qint64(iconSize()) * iconSize() * 4; }
+    QString diskCacheDir() const { return m_diskCacheDir; }
+    // 图标在磁盘缓存中的缩略图路径（可在任意线程调用）
+    static QString thumbnailPath(const QString &iconPath, const QString &cacheDir);
+
+signals:
+    // 图标加载完成（加载失败时 pixmap 为空）
+    void iconReady(const QString &iconPath, const QPixmap &pixmap);
+
+private:
+    struct PendingLoad {
+        int refCount = 0;                              // 仍在等待的请求数
+        CancellationToken token;                       // 所有请求都取消后取消
+        quint64 httpRequest = 0;                       // 正在下载的远程图标（见 HttpClient）
+        bool prefetch = false;                         // 只有预取在等待（refCount 为 0）
+    };
+
+    static bool isRemote(const QString &iconPath);
+    void startLoad(const QString &iconPath, bool prefetch);
+    void startDownload(const QString &iconPath, bool prefetch);
+    void handleDownloadFinished(quint64 requestId, const QByteArray &data);
+    void handleDownloadFailed(quint64 requestId);
+    void handleLoadFinished(const QString &iconPath, const QImage &image, const CancellationToken &token);
+    void startDecode(const QString &iconPath, const CancellationToken &token, bool prefetch,
+                     std::function<QImage()> decode);
+    static QImage loadScaledImage(const QString &iconPath, const QString &cacheDir,
+                                  const CancellationToken &token);
+    static QImage readScaledImage(QImageReader &reader);
+
+private:
+    QCache<QString, QPixmap> m_memoryCache;    // 内存 LRU 缓存
+    QCache<QString, QPixmap> m_prefetchCache;  // 预取的图标（按 KB 计算大小），使用时移入内存缓存
+    qint64 m_prefetchBudget;                   // 预取缓存的大小上限（字节）
+    QHash<QString, PendingLoad> m_pending;     // 正在解码的图标
+    QString m_diskCacheDir;                    // 磁盘缩略图目录
+    QHash<quint64, QString> m_downloads;       // 下载请求编号 -> 图标地址
+    bool m_downloadsConnected;                 // 是否已连接 HttpClient 的结果信号
+};
+
+#endif // ICONSERVICE_H
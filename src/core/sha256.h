@@ -0,0 +1,33 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+// 增量 SHA-256：数据可以分多次加入，适合边下载边计算。
+// CPU 支持 SHA 扩展指令（SHA-NI）时使用硬件加速，否则使用通用实现。
+class Sha256
+{
+public:
+    Sha256();
+
+    void reset();
+    void addData(const char *data, qint64 length);
+    void addData(const QByteArray &data) { addData(data.constData(), data.size()); }
+    // 返回 32 字节摘要，之后需要 reset() 才能计算下一个
+    QByteArray result();
+
+    static QByteArray hash(const QByteArray &data);
+
+    // 当前使用的实现
+    static bool hasHardwareAcceleration();
+    static const char *kernelName();
+
+private:
+    quint32 m_state[8];
+    uchar m_buffer[64];   // 不足一个块的数据
+    int m_bufferSize;
+    quint64 m_length;     // 已加入的总字节数
+};
+
+#endif // SHA256_H
@@ -0,0 +1,114 @@
+#include "stalldetector.h"
+#include "trace.h"
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QEvent>
+#include <QMetaEnum>
+
+namespace {
+
+const qint64 kDumpIntervalNs = 30LL * 1000 * 1000 * 1000;   // 两次导出的最小间隔
+
+} // namespace
+
+StallDetector::StallDetector(int thresholdMs, QObject *parent)
+    : QThread(parent)
+    , m_threshold(qMax(1, thresholdMs) * 1000000LL)
+    , m_stopping(false)
+    , m_busySince(0)
+    , m_eventType(QEvent::None)
+    , m_receiverClass(nullptr)
+    , m_lastDump(-kDumpIntervalNs)
+{
+    setObjectName(QStringLiteral("StallDetector"));
+
+    // 唤醒到进入等待之间为忙碌；直接连接，在界面线程中调用
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(QCoreApplication::instance()->thread());
+    connect(dispatcher, &QAbstractEventDispatcher::awake, this, [this]() {
+        m_busySince.store(Trace::now(), std::memory_order_relaxed);
+    }, Qt::DirectConnection);
+    connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, [this]() {
+        m_busySince.store(0, std::memory_order_relaxed);
+    }, Qt::DirectConnection);
+    QCoreApplication::instance()->installEventFilter(this);
+}
+
+StallDetector::~StallDetector()
+{
+    QCoreApplication::instance()->removeEventFilter(this);
+    stop();
+    wait();
+}
+
+void StallDetector::stop()
+{
+    m_stopping = true;
+}
+
+bool StallDetector::eventFilter(QObject *watched, QEvent *event)
+{
+    // 只记录最近开始派发的事件，卡顿时它通常就是阻塞事件循环的那一个
+    m_eventType.store(event->type(), std::memory_order_relaxed);
+    m_receiverClass.store(watched->metaObject()->className(), std::memory_order_relaxed);
+    return false;
+}
+
+void StallDetector::run()
+{
+    const unsigned long interval = qMax<qint64>(1, m_threshold / 4000000);   // 阈值的 1/4（毫秒）
+    qint64 stallStart = 0;   // 正在进行的卡顿
+    QString culprit;
+
+    while (!m_stopping) {
+        QThread::msleep(interval);
+
+        const qint64 busySince = m_busySince.load(std::memory_order_relaxed);
+        if (stallStart != 0 && busySince != stallStart) {
+            // 卡顿结束：事件循环进入等待或已经开始下一轮
+            reportStall(stallStart, Trace::now() - stallStart, culprit);
+            stallStart = 0;
+        }
+        if (stallStart == 0 && busySince != 0 && Trace::now() - busySince > m_threshold) {
+            stallStart = busySince;
+            culprit = describeCulprit();
+        }
+    }
+}
+
+QString StallDetector::describeCulprit() const
+{
+    const int type = m_eventType.load(std::memory_order_relaxed);
+    const char *receiver = m_receiverClass.load(std::memory_order_relaxed);
+    const char *span = Trace::currentGuiSpan();
+    const char *typeName = QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+
+    QString culprit = QStringLiteral("%1 to %2")
+                          .arg(typeName ? QString::fromLatin1(typeName) : QString::number(type),
+                               receiver ? QString::fromLatin1(receiver) : QStringLiteral("?"));
+    if (span) {
+        culprit += QStringLiteral(" in span ") + QString::fromUtf8(span);
+    }
+    return culprit;
+}
+
+void StallDetector::reportStall(qint64 start, qint64 duration, const QString &culprit)
+{
+    qWarning() << "GUI thread stalled for" << duration / 1000000 << "ms:" << culprit;
+    Trace::addComplete("stall", "GUI stall", start, duration, culprit);
+    emit stallDetected(duration / 1000000, culprit);
+
+    if (m_dumpDirectory.isEmpty() || !Trace::isEnabled() || Trace::now() - m_lastDump < kDumpIntervalNs) return;
+    m_lastDump = Trace::now();
+    QDir().mkpath(m_dumpDirectory);
+    const QString path = m_dumpDirectory + QStringLiteral("/stall-")
+        + QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss")) + QStringLiteral(".json");
+    QString error;
+    if (Trace::dump(path, &error)) {
+        qWarning() << "Trace written to" << path;
+    } else {
+        qWarning() << "Failed to write trace:" << error;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef STALLDETECTOR_H
+#define STALLDETECTOR_H
+
+#include <QThread>
+#include <QString>
+#include <atomic>
+
+// 界面线程卡顿检测：事件循环被唤醒后超过阈值仍没有回到等待状态即视为卡顿。
+// 界面线程只在唤醒、进入等待和派发每个事件时写几个原子变量；看门狗线程定期检查，
+// 卡顿时记录正在处理的事件类型、接收对象和最内层的追踪区间（见 Trace），
+// 卡顿结束后输出警告、写入追踪事件，并可以把追踪缓冲区导出为文件（同一段时间内只导出一次）。
+class StallDetector : public QThread
+{
+    Q_OBJECT
+
+public:
+    // 需要在界面线程创建，事件派发器已存在（QApplication 创建之后）；设置好之后调用 start() 开始检测
+    explicit StallDetector(int thresholdMs, QObject *parent = nullptr);
+    ~StallDetector() override;
+
+    // 卡顿后导出追踪到该目录，为空时不导出（在 start() 之前设置）
+    void setDumpDirectory(const QString &directory) { m_dumpDirectory = directory; }
+    void stop();
+
+signals:
+    // 在看门狗线程发出
+    void stallDetected(qint64 durationMs, const QString &culprit);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void run() override;
+
+private:
+    QString describeCulprit() const;
+    void reportStall(qint64 start, qint64 duration, const QString &culprit);
+
+private:
+    const qint64 m_threshold;                       // 纳秒
+    QString m_dumpDirectory;
+    std::atomic<bool> m_stopping;
+    std::atomic<qint64> m_busySince;                // 事件循环被唤醒的时间，等待时为 0
+    std::atomic<int> m_eventType;                   // 正在派发的事件
+    std::atomic<const char *> m_receiverClass;      // 接收对象的类名（元对象中的静态字符串）
+    qint64 m_lastDump;                              // 以下只在看门狗线程访问
+};
+
+#endif // STALLDETECTOR_H
@@ -0,0 +1,242 @@
+#include "taskscheduler.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <deque>
+
+namespace {
+
+// 当前线程所属的工作线程序号（不是工作线程时为 -1），用于把任务放进本线程的队列
+thread_local int t_workerIndex = -1;
+thread_local const TaskScheduler *t_workerScheduler = nullptr;
+
+const int kIdleWaitMs = 100;   // 空闲等待的上限，防止极端情况下漏掉唤醒
+
+} // namespace
+
+CancellationToken::CancellationToken()
+    : m_state(std::make_shared<std::atomic_bool>(false))
+{
+}
+
+void CancellationToken::cancel()
+{
+    m_state->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationToken::isCancelled() const
+{
+    return m_state->load(std::memory_order_relaxed);
+}
+
+struct TaskScheduler::Worker {
+    QMutex mutex;                                   // 保护本线程的队列（被其他线程窃取时也加锁）
+    std::deque<Task> queues[PriorityCount];
+    QThread *thread = nullptr;
+};
+
+TaskScheduler *TaskScheduler::instance()
+{
+    static TaskScheduler *scheduler = new TaskScheduler(0, QCoreApplication::instance());
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(int threads, QObject *parent)
+    : QObject(parent)
+    , m_epoch(0)
+    , m_stopping(false)
+    , m_nextWorker(0)
+{
+    m_clock.start();
+    if (threads <= 0) {
+        threads = qMax(2, QThread::idealThreadCount() - 1);
+    }
+
+    // 默认上限：界面等待和当前页的任务可以用满所有线程，预取最多一半，后台最多四分之一
+    const int caps[PriorityCount] = { threads, threads, qMax(1, threads / 2), qMax(1, threads / 4) };
+    for (int p = 0; p < PriorityCount; ++p) {
+        m_caps[p] = caps[p];
+        m_running[p] = 0;
+        m_queued[p] = 0;
+        m_started[p] = 0;
+        m_cancelled[p] = 0;
+        m_totalWaitNs[p] = 0;
+        m_maxWaitNs[p] = 0;
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        m_workers.append(new Worker);
+    }
+    for (int i = 0; i < threads; ++i) {
+        Worker *worker = m_workers.at(i);
+        worker->thread = QThread::create([this, i]() { workerLoop(i); });
+        worker->thread->setObjectName(QStringLiteral("TaskScheduler-%1").arg(i));
+        worker->thread->start();
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    // 未开始的任务直接丢弃，等待执行中的任务结束
+    {
+        QMutexLocker locker(&m_sleepMutex);
+        m_stopping = true;
+        m_wakeCondition.wakeAll();
+    }
+    for (Worker *worker : std::as_const(m_workers)) {
+        worker->thread->wait();
+        delete worker->thread;
+        delete worker;
+    }
+}
+
+void TaskScheduler::start(Priority priority, std::function<void()> task, const CancellationToken &token)
+{
+    Task entry;
+    entry.run = std::move(task);
+    entry.token = token;
+    entry.enqueuedNs = m_clock.nsecsElapsed();
+
+    // 工作线程中提交的任务放进本线程的队列，其他线程的任务轮流分配
+    const int index = t_workerScheduler == this
+        ? t_workerIndex
+        : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    Worker *worker = m_workers.at(index);
+    {
+        QMutexLocker locker(&worker->mutex);
+        worker->queues[priority].push_back(std::move(entry));
+    }
+    ++m_queued[priority];
+    wake(false);
+}
+
+void TaskScheduler::setConcurrencyCap(Priority priority, int cap)
+{
+    m_caps[priority] = qMax(1, cap);
+    wake(true);
+}
+
+TaskScheduler::Metrics TaskScheduler::metrics(Priority priority) const
+{
+    Metrics metrics;
+    metrics.queued = m_queued[priority];
+    metrics.running = m_running[priority];
+    metrics.cap = m_caps[priority];
+    metrics.started = m_started[priority];
+    metrics.cancelled = m_cancelled[priority];
+    metrics.totalWaitNs = m_totalWaitNs[priority];
+    metrics.maxWaitNs = m_maxWaitNs[priority];
+    return metrics;
+}
+
+const char *TaskScheduler::priorityName(Priority priority)
+{
+    switch (priority) {
+    case Interactive: return "interactive";
+    case VisiblePage: return "visible";
+    case Prefetch: return "prefetch";
+    case Background: return "background";
+    default: return "unknown";
+    }
+}
+
+void TaskScheduler::workerLoop(int index)
+{
+    t_workerIndex = index;
+    t_workerScheduler = this;
+
+    for (;;) {
+        quint64 epoch;
+        {
+            QMutexLocker locker(&m_sleepMutex);
+            if (m_stopping) return;
+            epoch = m_epoch;
+        }
+
+        Task task;
+        Priority priority = Background;
+        if (!takeTask(index, &task, &priority)) {
+            // 没有可执行的任务（或都受并发上限限制）：期间没有新任务、也没有任务结束时才等待
+            QMutexLocker locker(&m_sleepMutex);
+            if (m_stopping) return;
+            if (m_epoch == epoch) {
+                m_wakeCondition.wait(&m_sleepMutex, kIdleWaitMs);
+            }
+            continue;
+        }
+
+        if (task.token.isCancelled()) {
+            ++m_cancelled[priority];
+            releaseSlot(priority);
+            continue;
+        }
+
+        const qint64 waitNs = m_clock.nsecsElapsed() - task.enqueuedNs;
+        ++m_started[priority];
+        m_totalWaitNs[priority] += waitNs;
+        qint64 maxWait = m_maxWaitNs[priority];
+        while (waitNs > maxWait && !m_maxWaitNs[priority].compare_exchange_weak(maxWait, waitNs)) {
+        }
+
+        task.run();
+        releaseSlot(priority);
+    }
+}
+
+bool TaskScheduler::takeTask(int index, Task *task, Priority *priority)
+{
+    const int count = m_workers.size();
+    for (int p = 0; p < PriorityCount; ++p) {
+        if (m_queued[p] == 0 || !acquireSlot(Priority(p))) continue;
+
+        // 本线程从队尾取刚提交的任务（数据多半还在缓存中），窃取时从其他线程的队首取等待最久的任务，
+        // 队列两端分别由所有者和窃取者使用，较早排队的任务不会一直被后来的任务挤在后面
+        for (int offset = 0; offset < count; ++offset) {
+            Worker *worker = m_workers.at((index + offset) % count);
+            QMutexLocker locker(&worker->mutex);
+            std::deque<Task> &queue = worker->queues[p];
+            if (queue.empty()) continue;
+            if (offset == 0) {
+                *task = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                *task = std::move(queue.front());
+                queue.pop_front();
+            }
+            --m_queued[p];
+            *priority = Priority(p);
+            return true;
+        }
+        releaseSlot(Priority(p));
+    }
+    return false;
+}
+
+bool TaskScheduler::acquireSlot(Priority priority)
+{
+    int running = m_running[priority];
+    while (running < m_caps[priority]) {
+        if (m_running[priority].compare_exchange_weak(running, running + 1)) return true;
+    }
+    return false;
+}
+
+void TaskScheduler::releaseSlot(Priority priority)
+{
+    // 这一类原本已满上限时，其他线程可能因为取不到名额而在等待，唤醒一个线程接着执行排队的任务，
+    // 不必等到空闲等待超时
+    const int running = m_running[priority].fetch_sub(1);
+    if (running >= m_caps[priority] && m_queued[priority] > 0) {
+        wake(false);
+    }
+}
+
+void TaskScheduler::wake(bool all)
+{
+    QMutexLocker locker(&m_sleepMutex);
+    ++m_epoch;
+    if (all) {
+        m_wakeCondition.wakeAll();
+    } else {
+        m_wakeCondition.wakeOne();
+    }
+}
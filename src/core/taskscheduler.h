@@ -0,0 +1,108 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QThread;
+
+// 协作式取消令牌：复制后共享同一状态。任务开始前已取消的不再执行，
+// 执行中的任务可以自行检查 isCancelled() 提前结束
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    void cancel();
+    bool isCancelled() const;
+
+    bool operator==(const CancellationToken &other) const { return m_state == other.m_state; }
+    bool operator!=(const CancellationToken &other) const { return m_state != other.m_state; }
+
+private:
+    std::shared_ptr<std::atomic_bool> m_state;
+};
+
+// 后台任务调度器：替代直接使用 QThreadPool::globalInstance()，按优先级分类执行任务。
+// - 每类任务有并发上限，后台同步、预取占满上限后其余线程仍留给界面正在等待的任务；
+// - 每个工作线程有自己的队列，工作线程中提交的任务放进本线程的队列；线程从自己队列的队尾取最新的任务，
+//   空闲时从其他线程队列的队首窃取等待最久的任务（work stealing）；取任务时总是先取高优先级的类别；
+// - 令牌已取消的任务出队时直接丢弃，不占用并发名额；
+// - 每类任务的排队数、执行数和等待时间通过 metrics() 提供。
+// 任务中不能访问界面对象，结果用 QMetaObject::invokeMethod 送回界面线程（对象可能已销毁，需用 QPointer 检查）
+class TaskScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Interactive = 0,   // 用户操作后正在等待的结果（例如安装前的校验）
+        VisiblePage,       // 当前页需要的内容（例如图标解码）
+        Prefetch,          // 预取
+        Background,        // 后台同步、索引重建等
+        PriorityCount
+    };
+
+    struct Metrics {
+        int queued = 0;            // 排队中（包括已取消、尚未出队的）
+        int running = 0;           // 执行中
+        int cap = 0;               // 并发上限
+        quint64 started = 0;       // 已开始执行的任务数
+        quint64 cancelled = 0;     // 因令牌取消而丢弃的任务数
+        qint64 totalWaitNs = 0;    // 开始执行的任务排队时间之和
+        qint64 maxWaitNs = 0;      // 最长排队时间
+
+        qint64 averageWaitNs() const { return started > 0 ? totalWaitNs / qint64(started) : 0; }
+    };
+
+    static TaskScheduler *instance();
+
+    // threads 为 0 时使用 CPU 核数减一（至少两个），留一个核给界面线程
+    explicit TaskScheduler(int threads = 0, QObject *parent = nullptr);
+    ~TaskScheduler() override;
+
+    void start(Priority priority, std::function<void()> task, const CancellationToken &token = CancellationToken());
+
+    void setConcurrencyCap(Priority priority, int cap);
+    int threadCount() const { return m_workers.size(); }
+    Metrics metrics(Priority priority) const;
+    static const char *priorityName(Priority priority);
+
+private:
+    struct Task {
+        std::function<void()> run;
+        CancellationToken token;
+        qint64 enqueuedNs = 0;
+    };
+    struct Worker;
+
+    void workerLoop(int index);
+    bool takeTask(int index, Task *task, Priority *priority);
+    bool acquireSlot(Priority priority);
+    void releaseSlot(Priority priority);
+    void wake(bool all);
+
+private:
+    QList<Worker *> m_workers;
+    QElapsedTimer m_clock;                      // 排队时间的时钟
+    QMutex m_sleepMutex;                        // 与 m_wakeCondition 一起让空闲线程等待
+    QWaitCondition m_wakeCondition;
+    quint64 m_epoch;                            // 每次入队或修改上限时加一（在 m_sleepMutex 内修改）
+    bool m_stopping;
+    std::atomic_int m_nextWorker;               // 界面线程提交任务时轮流放入的工作线程
+    std::atomic_int m_caps[PriorityCount];
+    std::atomic_int m_running[PriorityCount];
+    std::atomic_int m_queued[PriorityCount];
+    std::atomic<quint64> m_started[PriorityCount];
+    std::atomic<quint64> m_cancelled[PriorityCount];
+    std::atomic<qint64> m_totalWaitNs[PriorityCount];
+    std::atomic<qint64> m_maxWaitNs[PriorityCount];
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,228 @@
+#include "trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThread>
+#include <QVector>
+
+namespace Trace {
+
+std::atomic_bool enabledFlag(false);
+
+namespace {
+
+struct Event
+{
+    const char *category = nullptr;
+    const char *name = nullptr;
+    qint64 start = 0;
+    qint64 duration = -1;   // -1 表示瞬时事件
+    int thread = 0;
+    QString detail;
+};
+
+// 环形缓冲区：写满后覆盖最旧的事件
+struct Recorder
+{
+    QMutex mutex;
+    QVector<Event> events;
+    int next = 0;
+    bool wrapped = false;
+    QHash<int, QString> threadNames;   // 线程编号 -> 名称
+    int nextThread = 1;
+};
+
+Recorder &recorder()
+{
+    static Recorder instance;
+    return instance;
+}
+
+const QElapsedTimer &clock()
+{
+    static const QElapsedTimer timer = []() {
+        QElapsedTimer started;
+        started.start();
+        return started;
+    }();
+    return timer;
+}
+
+thread_local Span *t_currentSpan = nullptr;
+thread_local int t_thread = 0;
+thread_local int t_isGui = -1;
+std::atomic<const char *> g_guiSpan(nullptr);
+
+bool isGuiThread()
+{
+    if (t_isGui < 0) {
+        QCoreApplication *app = QCoreApplication::instance();
+        if (!app) return false;
+        t_isGui = QThread::currentThread() == app->thread() ? 1 : 0;
+    }
+    return t_isGui == 1;
+}
+
+// 调用时已持有 recorder().mutex
+int threadIdLocked(Recorder &r)
+{
+    if (t_thread == 0) {
+        t_thread = r.nextThread++;
+        QString name = QThread::currentThread()->objectName();
+        if (isGuiThread()) {
+            name = QStringLiteral("GUI");
+        } else if (name.isEmpty()) {
+            name = QStringLiteral("Thread %1").arg(t_thread);
+        }
+        r.threadNames.insert(t_thread, name);
+    }
+    return t_thread;
+}
+
+void record(const char *category, const char *name, qint64 start, qint64 duration, const QString &detail)
+{
+    Recorder &r = recorder();
+    QMutexLocker locker(&r.mutex);
+    if (r.events.isEmpty()) return;
+
+    Event &event = r.events[r.next];
+    event.category = category;
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    event.thread = threadIdLocked(r);
+    event.detail = detail;
+    if (++r.next == r.events.size()) {
+        r.next = 0;
+        r.wrapped = true;
+    }
+}
+
+} // namespace
+
+void setEnabled(bool enabled, int capacity)
+{
+    clock();
+    Recorder &r = recorder();
+    {
+        QMutexLocker locker(&r.mutex);
+        r.events.clear();
+        if (enabled) {
+            r.events.resize(qMax(1, capacity));
+        }
+        r.next = 0;
+        r.wrapped = false;
+    }
+    enabledFlag.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 now()
+{
+    return clock().nsecsElapsed();
+}
+
+void addComplete(const char *category, const char *name, qint64 startNs, qint64 durationNs, const QString &detail)
+{
+    if (isEnabled()) {
+        record(category, name, startNs, qMax<qint64>(0, durationNs), detail);
+    }
+}
+
+void addInstant(const char *category, const char *name, const QString &detail)
+{
+    if (isEnabled()) {
+        record(category, name, now(), -1, detail);
+    }
+}
+
+const char *currentGuiSpan()
+{
+    return g_guiSpan.load(std::memory_order_relaxed);
+}
+
+qint64 Span::begin()
+{
+    m_parent = t_currentSpan;
+    t_currentSpan = this;
+    if (isGuiThread()) {
+        g_guiSpan.store(m_name, std::memory_order_relaxed);
+    }
+    return now();
+}
+
+void Span::end()
+{
+    record(m_category, m_name, m_start, now() - m_start, QString());
+    t_currentSpan = m_parent;
+    if (isGuiThread()) {
+        // 外层区间可能是在启用追踪之前开始的，那时没有登记
+        g_guiSpan.store(m_parent ? m_parent->m_name : nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool dump(const QString &path, QString *error)
+{
+    QVector<Event> events;
+    QHash<int, QString> threadNames;
+    {
+        Recorder &r = recorder();
+        QMutexLocker locker(&r.mutex);
+        // 按时间顺序：写满后从最旧的位置开始
+        if (r.wrapped) {
+            events = r.events.mid(r.next) + r.events.mid(0, r.next);
+        } else {
+            events = r.events.mid(0, r.next);
+        }
+        threadNames = r.threadNames;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    for (auto it = threadNames.cbegin(); it != threadNames.cend(); ++it) {
+        traceEvents.append(QJsonObject{
+            { QStringLiteral("name"), QStringLiteral("thread_name") },
+            { QStringLiteral("ph"), QStringLiteral("M") },
+            { QStringLiteral("pid"), pid },
+            { QStringLiteral("tid"), it.key() },
+            { QStringLiteral("args"), QJsonObject{ { QStringLiteral("name"), it.value() } } }
+        });
+    }
+    for (const Event &event : std::as_const(events)) {
+        QJsonObject object{
+            { QStringLiteral("name"), QString::fromUtf8(event.name) },
+            { QStringLiteral("cat"), QString::fromUtf8(event.category) },
+            { QStringLiteral("pid"), pid },
+            { QStringLiteral("tid"), event.thread },
+            { QStringLiteral("ts"), event.start / 1000.0 }   // 微秒
+        };
+        if (event.duration >= 0) {
+            object.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            object.insert(QStringLiteral("dur"), event.duration / 1000.0);
+        } else {
+            object.insert(QStringLiteral("ph"), QStringLiteral("i"));
+            object.insert(QStringLiteral("s"), QStringLiteral("t"));
+        }
+        if (!event.detail.isEmpty()) {
+            object.insert(QStringLiteral("args"), QJsonObject{ { QStringLiteral("detail"), event.detail } });
+        }
+        traceEvents.append(object);
+    }
+
+    QSaveFile file(path);
+    const QByteArray json = QJsonDocument(QJsonObject{
+        { QStringLiteral("traceEvents"), traceEvents },
+        { QStringLiteral("displayTimeUnit"), QStringLiteral("ms") }
+    }).toJson(QJsonDocument::Compact);
+    const bool ok = file.open(QIODevice::WriteOnly) && file.write(json) == json.size() && file.commit();
+    if (!ok && error) {
+        *error = file.errorString();
+    }
+    return ok;
+}
+
+} // namespace Trace
@@ -0,0 +1,69 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// 轻量级追踪：热点路径用 TRACE_SPAN 标记耗时区间，记录进固定大小的环形缓冲区（只保留最近的事件），
+// 需要时导出为 Chrome Trace Event 格式的 JSON（chrome://tracing 或 Perfetto 打开）。
+// 未启用时每个区间只有一次原子读取，不取时间、不加锁。
+// 区间的名称和分类必须是字符串字面量（只保存指针）。
+namespace Trace {
+
+extern std::atomic_bool enabledFlag;
+
+inline bool isEnabled() { return enabledFlag.load(std::memory_order_relaxed); }
+// 启用时清空缓冲区；capacity 为保留的事件数
+void setEnabled(bool enabled, int capacity = 65536);
+
+// 追踪时钟（纳秒，单调递增），未启用时也可使用
+qint64 now();
+
+// 直接记录事件（已启用时）：完整区间和瞬时事件，detail 显示在事件参数中
+void addComplete(const char *category, const char *name, qint64 startNs, qint64 durationNs,
+                 const QString &detail = QString());
+void addInstant(const char *category, const char *name, const QString &detail = QString());
+
+// 界面线程上最内层的区间名称，没有时为空（供卡顿检测在其他线程读取）
+const char *currentGuiSpan();
+
+// 把缓冲区中的事件写成 Chrome Trace JSON，可以在任意线程调用
+bool dump(const QString &path, QString *error = nullptr);
+
+class Span
+{
+public:
+    Span(const char *category, const char *name)
+        : m_category(category)
+        , m_name(name)
+        , m_parent(nullptr)
+        , m_start(isEnabled() ? begin() : -1)
+    {
+    }
+    ~Span()
+    {
+        if (m_start >= 0) end();
+    }
+
+private:
+    qint64 begin();
+    void end();
+
+private:
+    const char *m_category;
+    const char *m_name;
+    Span *m_parent;
+    qint64 m_start;
+
+    Q_DISABLE_COPY(Span)
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+// 标记从这里到作用域结束的区间
+#define TRACE_SPAN(category, name) Trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+
+#endif // TRACE_H
@@ -0,0 +1,49 @@
+#include "treehash.h"
+#include "sha256.h"
+#include <QFile>
+
+namespace TreeHash {
+
+int leafCount(qint64 fileSize)
+{
+    return fileSize <= 0 ? 0 : int((fileSize + LeafSize - 1) / LeafSize);
+}
+
+QByteArray root(const QList<QByteArray> &leaves)
+{
+    Sha256 sha;
+    for (const QByteArray &leaf : leaves) {
+        sha.addData(leaf);
+    }
+    return sha.result();
+}
+
+QByteArray hashFile(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return QByteArray();
+    }
+
+    // 逐块映射文件，避免把整个安装包读入内存
+    const qint64 size = file.size();
+    QList<QByteArray> leaves;
+    leaves.reserve(leafCount(size));
+    Sha256 sha;
+    for (qint64 offset = 0; offset < size; offset += LeafSize) {
+        const qint64 length = qMin(LeafSize, size - offset);
+        uchar *data = file.map(offset, length);
+        if (!data) {
+            if (error) *error = file.errorString();
+            return QByteArray();
+        }
+        sha.reset();
+        sha.addData(reinterpret_cast<const char *>(data), length);
+        file.unmap(data);
+        leaves.append(sha.result());
+    }
+    return root(leaves);
+}
+
+} // namespace TreeHash
@@ -0,0 +1,27 @@
+#ifndef TREEHASH_H
+#define TREEHASH_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// 分块树哈希：文件按 4MB 切成叶子块，每块独立计算 SHA-256，
+// 根哈希 = SHA-256(按顺序拼接的全部叶子哈希)。
+// 分段并行下载时每个分段只负责自己的叶子块，不需要按顺序读取整个文件。
+// 目录中的安装包哈希（package_hash）使用根哈希的十六进制形式。
+namespace TreeHash {
+
+const qint64 LeafSize = 4 * 1024 * 1024;
+
+// 文件包含的叶子块数量
+int leafCount(qint64 fileSize);
+
+// 由叶子哈希计算根哈希
+QByteArray root(const QList<QByteArray> &leaves);
+
+// 计算文件的根哈希（32 字节），失败时返回空并写入 error
+QByteArray hashFile(const QString &filePath, QString *error = nullptr);
+
+} // namespace TreeHash
+
+#endif // TREEHASH_H
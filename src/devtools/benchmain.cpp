@@ -0,0 +1,157 @@
+#include <QApplication>
+#include <QDebug>
+#include <QHostAddress>
+#include "devtools/catalogbench.h"
+#include "devtools/catalogsyncbench.h"
+#include "devtools/chunkbench.h"
+#include "devtools/deltabench.h"
+#include "devtools/httpclientbench.h"
+#include "devtools/paginationscrub.h"
+#include "devtools/prefetchbench.h"
+#include "devtools/schedulerbench.h"
+#include "devtools/searchbench.h"
+#include "devtools/standinserver.h"
+#include "devtools/syncjournalbench.h"
+#include "devtools/synctreebench.h"
+#include "devtools/treehashbench.h"
+#include "devtools/uibench.h"
+#include "devtools/uploadmemorybench.h"
+
+// 开发调试工具的入口（appGo_bench），与 appGo 共用 appGo_core 中的应用代码，appGo 本身不包含这些工具
+int main(int argc, char *argv[])
+{
+    // 开发调试：appGo_bench --stand-in-server <目录> [端口]，启动本地 HTTP 替身服务器；
+    // APPGO_STAND_IN_DELAY_MS 为每个下载请求的延迟（模拟较慢的网络）
+    if (argc >= 3 && qstrcmp(argv[1], "--stand-in-server") == 0) {
+        QCoreApplication app(argc, argv);
+        
+        StandInServer server(QString::fromLocal8Bit(argv[2]));
+        server.setResponseDelay(qEnvironmentVariableIntValue("APPGO_STAND_IN_DELAY_MS"));
+        const quint16 port = argc >= 4 ? QByteArray(argv[3]).toUShort() : 8080;
+        if (!server.listen(QHostAddress::LocalHost, port)) {
+            qWarning() << "Stand-in server failed to listen:" << server.errorString();
+            return 1;
+        }
+        qInfo() << "Stand-in server serving" << server.rootPath() << "on port" << server.serverPort();
+        
+        return app.exec();
+    }
+    
+    // 开发调试：appGo_bench --tree-hash <文件>，输出目录中 package_hash 使用的树哈希和哈希吞吐量
+    if (argc >= 3 && qstrcmp(argv[1], "--tree-hash") == 0) {
+        QCoreApplication app(argc, argv);
+        return TreeHashBench::run(QString::fromLocal8Bit(argv[2]));
+    }
+    
+    // 开发调试：appGo_bench --delta <旧文件> <新文件>，计算块级补丁，输出上传字节数、节省比例和每 GB 的计算耗时，
+    // 并用补丁重建新文件验证结果
+    if (argc >= 4 && qstrcmp(argv[1], "--delta") == 0) {
+        QCoreApplication app(argc, argv);
+        return DeltaBench::run(QString::fromLocal8Bit(argv[2]), QString::fromLocal8Bit(argv[3]));
+    }
+    
+    // 开发调试：appGo_bench --chunk-bench [目录]，测量内容分块吞吐量和去重率。
+    // 不指定目录时使用合成语料：若干随机模板，以及每个应用中的完整副本、局部修改的副本和截断导出的副本
+    if (argc >= 2 && qstrcmp(argv[1], "--chunk-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return ChunkBench::run(argc >= 3 ? QString::fromLocal8Bit(argv[2]) : QString());
+    }
+    
+    // 开发调试：appGo_bench --sync-tree <目录>，测量同步文件夹 Merkle 树的首次构建、保存/加载、
+    // 未变化时的重新扫描和根哈希耗时（启动前检查的本地部分目标为 100 ms 以内）
+    if (argc >= 3 && qstrcmp(argv[1], "--sync-tree") == 0) {
+        QCoreApplication app(argc, argv);
+        return SyncTreeBench::run(QString::fromLocal8Bit(argv[2]));
+    }
+    
+    // 开发调试：appGo_bench --sync-journal-bench [事件数]，测量同步日志的写入吞吐量和重放耗时，并做崩溃注入检查
+    if (argc >= 2 && qstrcmp(argv[1], "--sync-journal-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return SyncJournalBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 100000);
+    }
+    if (argc >= 3 && qstrcmp(argv[1], "--sync-journal-writer") == 0) {
+        QCoreApplication app(argc, argv);
+        return SyncJournalBench::runWriter(QString::fromLocal8Bit(argv[2]));
+    }
+    
+    // 开发调试：appGo_bench --upload-memory [MB]，上传大文件并检查峰值内存不随文件大小增长
+    if (argc >= 2 && qstrcmp(argv[1], "--upload-memory") == 0) {
+        QCoreApplication app(argc, argv);
+        return UploadMemoryBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 4096);
+    }
+    
+    // 开发调试：appGo_bench --catalog-bench [应用数]，比较目录快照与 JSON 的冷启动加载耗时
+    if (argc >= 2 && qstrcmp(argv[1], "--catalog-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return CatalogBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 10000);
+    }
+    
+    // 开发调试：appGo_bench --catalog-sync-bench [应用数]，测量目录增量同步的整条链路（模型通知、搜索索引、数据库提交和快照）
+    if (argc >= 2 && qstrcmp(argv[1], "--catalog-sync-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return CatalogSyncBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 10000);
+    }
+    
+    // 开发调试：appGo_bench --search-bench [应用数]，测量搜索索引的构建耗时和逐字输入时每次按键的查询耗时
+    if (argc >= 2 && qstrcmp(argv[1], "--search-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return SearchBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 50000);
+    }
+    
+    // 开发调试：appGo_bench --http-client-bench [地址数]，检查 HttpClient 的请求合并、重新验证、优先级和缓存淘汰
+    if (argc >= 2 && qstrcmp(argv[1], "--http-client-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return HttpClientBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 40);
+    }
+    
+    // 开发调试：appGo_bench --scheduler-bench [后台任务数]，检查 TaskScheduler 的优先级、并发上限、取消和任务窃取
+    if (argc >= 2 && qstrcmp(argv[1], "--scheduler-bench") == 0) {
+        QCoreApplication app(argc, argv);
+        return SchedulerBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 400);
+    }
+    
+    // 开发调试：appGo_bench --ui-bench [--cards N] [--format json|csv] [--output 文件]，界面热点路径的基准测试
+    if (argc >= 2 && qstrcmp(argv[1], "--ui-bench") == 0) {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QApplication app(argc, argv);
+        return UiBench::run(app.arguments().mid(2));
+    }
+    
+    // 开发调试：appGo_bench --pagination-scrub [翻页次数]，检查长时间快速翻页时分页控件没有泄漏
+    if (argc >= 2 && qstrcmp(argv[1], "--pagination-scrub") == 0) {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QApplication app(argc, argv);
+        return PaginationScrub::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 200000);
+    }
+    
+    // 开发调试：appGo_bench --prefetch-bench [翻页次数]，比较开启和关闭相邻页预取时翻页到图标全部显示的时间，检查连续滚动的游标分页
+    if (argc >= 2 && qstrcmp(argv[1], "--prefetch-bench") == 0) {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QApplication app(argc, argv);
+        return PrefetchBench::run(argc >= 3 ? QByteArray(argv[2]).toInt() : 8);
+    }
+    
+    qWarning().noquote() << "Usage: appGo_bench <mode> [arguments]\n"
+                            "  --stand-in-server <目录> [端口]\n"
+                            "  --tree-hash <文件>\n"
+                            "  --delta <旧文件> <新文件>\n"
+                            "  --chunk-bench [目录]\n"
+                            "  --sync-tree <目录>\n"
+                            "  --sync-journal-bench [事件数]\n"
+                            "  --upload-memory [MB]\n"
+                            "  --catalog-bench [应用数]\n"
+                            "  --catalog-sync-bench [应用数]\n"
+                            "  --search-bench [应用数]\n"
+                            "  --http-client-bench [地址数]\n"
+                            "  --scheduler-bench [后台任务数]\n"
+                            "  --ui-bench [--cards N] [--format json|csv] [--output 文件]\n"
+                            "  --pagination-scrub [翻页次数]\n"
+                            "  --prefetch-bench [翻页次数]";
+    return 2;
+}
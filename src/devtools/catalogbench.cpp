@@ -0,0 +1,155 @@
+#include "catalogbench.h"
+#include "storage/catalogsnapshot.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+namespace {
+
+const int kRounds = 5;
+const int kFirstPage = 64;   // 首屏读取的行数
+
+QList<AppInfo> generateCatalog(int count)
+{
+    QList<AppInfo> apps;
+    apps.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        AppInfo app;
+        app.id = QStringLiteral("com.example.app%1").arg(i);
+        app.name = QStringLiteral("应用 %1").arg(i);
+        app.description = QStringLiteral("应用描述 %1").arg(i % 50);
+        app.iconPath = QStringLiteral("/usr/share/appgo/icons/app%1.png").arg(i);
+        app.packageUrl = QStringLiteral("https://packages.example.com/app%1.exe").arg(i);
+        app.packageHash = QString::fromLatin1(QByteArray(64, 'a' + i % 6));
+        app.installed = i % 10 == 0;
+        apps.append(app);
+    }
+    return apps;
+}
+
+QByteArray toJson(const QList<AppInfo> &apps)
+{
+    QJsonArray array;
+    for (const AppInfo &app : apps) {
+        QJsonObject object;
+        object.insert(QStringLiteral("id"), app.id);
+        object.insert(QStringLiteral("name"), app.name);
+        object.insert(QStringLiteral("description"), app.description);
+        object.insert(QStringLiteral("icon"), app.iconPath);
+        object.insert(QStringLiteral("packageUrl"), app.packageUrl);
+        object.insert(QStringLiteral("packageHash"), app.packageHash);
+        object.insert(QStringLiteral("installed"), app.installed);
+        array.append(object);
+    }
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+// 丢弃文件的页缓存，模拟开机后的第一次读取
+void dropCache(const QString &path)
+{
+#ifdef Q_OS_LINUX
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        posix_fadvise(file.handle(), 0, 0, POSIX_FADV_DONTNEED);
+    }
+#else
+    Q_UNUSED(path);
+#endif
+}
+
+qint64 loadJson(const QString &path, int *count)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    const QJsonArray array = QJsonDocument::fromJson(file.readAll()).array();
+    QList<AppInfo> apps;
+    apps.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const QJsonObject object = value.toObject();
+        AppInfo app;
+        app.id = object.value(QStringLiteral("id")).toString();
+        app.name = object.value(QStringLiteral("name")).toString();
+        app.description = object.value(QStringLiteral("description")).toString();
+        app.iconPath = object.value(QStringLiteral("icon")).toString();
+        app.packageUrl = object.value(QStringLiteral("packageUrl")).toString();
+        app.packageHash = object.value(QStringLiteral("packageHash")).toString();
+        app.installed = object.value(QStringLiteral("installed")).toBool();
+        apps.append(app);
+    }
+    *count = apps.size();
+    return timer.nsecsElapsed();
+}
+
+qint64 loadSnapshot(const QString &path, int *count)
+{
+    QElapsedTimer timer;
+    timer.start();
+    CatalogSnapshot snapshot;
+    if (!snapshot.open(path)) return -1;
+    // 与模型相同：打开后只读取首屏需要的行
+    QList<AppInfo> page;
+    for (int row = 0; row < qMin(kFirstPage, snapshot.count()); ++row) {
+        page.append(snapshot.app(row));
+    }
+    *count = snapshot.count();
+    return timer.nsecsElapsed();
+}
+
+} // namespace
+
+int CatalogBench::run(int apps)
+{
+    if (apps <= 0) return 1;
+
+    QTemporaryDir dir;
+    const QString jsonPath = dir.filePath(QStringLiteral("catalog.json"));
+    const QString snapshotPath = dir.filePath(QStringLiteral("catalog.snapshot"));
+    const QList<AppInfo> catalog = generateCatalog(apps);
+
+    QFile json(jsonPath);
+    if (!json.open(QIODevice::WriteOnly) || json.write(toJson(catalog)) < 0) {
+        qWarning() << "Failed to write" << jsonPath;
+        return 1;
+    }
+    json.close();
+    QString error;
+    if (!CatalogSnapshot::write(snapshotPath, catalog, QString(), &error)) {
+        qWarning() << "Failed to write snapshot:" << error;
+        return 1;
+    }
+
+    qint64 jsonBest = -1;
+    qint64 snapshotBest = -1;
+    int jsonCount = 0;
+    int snapshotCount = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        dropCache(jsonPath);
+        const qint64 jsonNs = loadJson(jsonPath, &jsonCount);
+        dropCache(snapshotPath);
+        const qint64 snapshotNs = loadSnapshot(snapshotPath, &snapshotCount);
+        if (jsonNs < 0 || snapshotNs < 0) {
+            qWarning() << "Catalog load failed";
+            return 1;
+        }
+        jsonBest = jsonBest < 0 ? jsonNs : qMin(jsonBest, jsonNs);
+        snapshotBest = snapshotBest < 0 ? snapshotNs : qMin(snapshotBest, snapshotNs);
+    }
+
+    qInfo().noquote() << QStringLiteral("JSON:     %1 apps, %2 bytes, %3 ms")
+                         .arg(jsonCount).arg(QFileInfo(jsonPath).size()).arg(jsonBest / 1e6, 0, 'f', 2);
+    qInfo().noquote() << QStringLiteral("Snapshot: %1 apps, %2 bytes, %3 ms (first %4 rows read)")
+                         .arg(snapshotCount).arg(QFileInfo(snapshotPath).size()).arg(snapshotBest / 1e6, 0, 'f', 2)
+                         .arg(qMin(kFirstPage, snapshotCount));
+    qInfo().noquote() << QStringLiteral("Speedup:  %1x").arg(double(jsonBest) / qMax<qint64>(1, snapshotBest), 0, 'f', 1);
+    return jsonCount == apps && snapshotCount == apps ? 0 : 1;
+}
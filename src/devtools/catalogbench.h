@@ -0,0 +1,15 @@
+#ifndef CATALOGBENCH_H
+#define CATALOGBENCH_H
+
+// 目录加载的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --catalog-bench [应用数]
+//     生成指定数量的应用目录，分别保存为 JSON 和目录快照（见 CatalogSnapshot），
+//     比较两者的冷启动加载耗时：JSON 读取并解析成 AppInfo 列表，快照映射后读出第一页。
+//     每轮加载前通知内核丢弃文件缓存（Linux），结果取多轮的最小值。
+namespace CatalogBench {
+
+int run(int apps);
+
+} // namespace CatalogBench
+
+#endif // CATALOGBENCH_H
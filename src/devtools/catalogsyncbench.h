@@ -0,0 +1,18 @@
+#ifndef CATALOGSYNCBENCH_H
+#define CATALOGSYNCBENCH_H
+
+// 目录增量同步的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --catalog-sync-bench [应用数]
+//     在本进程内启动替身服务器（见 StandInServer 的 /.catalog），以临时目录中的数据库和目录快照搭起与 MainWindow
+//     相同的链路（目录、搜索索引、过滤和分页模型），通过 CatalogSync 完整同步一次，
+//     再在服务器上修改 10 个应用（4 个修改、3 个新增、3 个删除，删除的应用分布在当前页之前、之中和之后）后增量同步。
+//     测量整条链路：界面线程上的 applyDelta（含搜索索引的增量更新）和快照写入通知的处理，数据库线程上的提交和快照重写。
+//     检查增量应用后目录和快照与服务器一致、分页模型没有重置且偏移量不变、通知数与变化数相当、
+//     快照不被整体重新加载、搜索索引不整体重建且结果正确，并与整体重新加载快照和重新完整同步的耗时比较。
+namespace CatalogSyncBench {
+
+int run(int apps);
+
+} // namespace CatalogSyncBench
+
+#endif // CATALOGSYNCBENCH_H
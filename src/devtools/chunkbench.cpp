@@ -0,0 +1,102 @@
+#include "chunkbench.h"
+#include "core/sha256.h"
+#include "sync/contentchunker.h"
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QRandomGenerator>
+
+namespace {
+
+const int kTemplates = 8;
+const int kTemplateBytes = 4 * 1024 * 1024;
+const int kApps = 3;
+const int kEditsPerCopy = 3;
+
+QList<QByteArray> readDirectory(const QString &directory)
+{
+    QList<QByteArray> corpus;
+    QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QFile file(it.next());
+        if (file.open(QIODevice::ReadOnly)) {
+            corpus.append(file.readAll());
+        }
+    }
+    return corpus;
+}
+
+// 合成语料：随机模板，每个应用中各有一份完整副本、插入几处修改的副本和截断到 60% 的副本
+QList<QByteArray> syntheticCorpus()
+{
+    QRandomGenerator random(42);
+    QList<QByteArray> corpus;
+    QList<QByteArray> templates;
+    for (int i = 0; i < kTemplates; ++i) {
+        QByteArray data(kTemplateBytes, Qt::Uninitialized);
+        random.fillRange(reinterpret_cast<quint32 *>(data.data()), data.size() / 4);
+        templates.append(data);
+        corpus.append(data);
+    }
+    for (int appIndex = 0; appIndex < kApps; ++appIndex) {
+        for (const QByteArray &data : std::as_const(templates)) {
+            corpus.append(data);
+            QByteArray variant = data;
+            for (int edit = 0; edit < kEditsPerCopy; ++edit) {
+                QByteArray insert(1024, char('a' + edit));
+                variant.insert(random.bounded(variant.size()), insert);
+            }
+            corpus.append(variant);
+            corpus.append(data.left(data.size() * 6 / 10));
+        }
+    }
+    return corpus;
+}
+
+} // namespace
+
+int ChunkBench::run(const QString &directory)
+{
+    const QList<QByteArray> corpus = directory.isEmpty() ? syntheticCorpus() : readDirectory(directory);
+
+    qint64 totalBytes = 0;
+    for (const QByteArray &data : corpus) {
+        totalBytes += data.size();
+    }
+
+    // 只分块，不计算哈希
+    QElapsedTimer timer;
+    timer.start();
+    qint64 chunkCount = 0;
+    for (const QByteArray &data : corpus) {
+        chunkCount += ContentChunker::chunk(reinterpret_cast<const uchar *>(data.constData()), data.size(), false).size();
+    }
+    const qint64 cutNsecs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    // 分块并计算哈希，按哈希统计去重后的块
+    QHash<QByteArray, int> unique;
+    timer.restart();
+    for (const QByteArray &data : corpus) {
+        const QVector<ContentChunker::Chunk> chunks =
+            ContentChunker::chunk(reinterpret_cast<const uchar *>(data.constData()), data.size());
+        for (const ContentChunker::Chunk &chunk : chunks) {
+            unique.insert(chunk.hash, chunk.length);
+        }
+    }
+    const qint64 hashNsecs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    qint64 uniqueBytes = 0;
+    for (int length : std::as_const(unique)) {
+        uniqueBytes += length;
+    }
+
+    qInfo() << "Corpus" << corpus.size() << "files," << totalBytes / (1024 * 1024) << "MB,"
+            << chunkCount << "chunks (average" << (chunkCount > 0 ? totalBytes / chunkCount : 0) << "bytes )";
+    qInfo() << "Chunking" << double(totalBytes) / cutNsecs << "GB/s; chunk + hash"
+            << double(totalBytes) / hashNsecs << "GB/s (" << Sha256::kernelName() << ")";
+    qInfo() << "Unique" << unique.size() << "chunks," << uniqueBytes / (1024 * 1024) << "MB; dedup ratio"
+            << (uniqueBytes > 0 ? double(totalBytes) / uniqueBytes : 0.0);
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef CHUNKBENCH_H
+#define CHUNKBENCH_H
+
+#include <QString>
+
+// 内容分块的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --chunk-bench [目录]
+//     对目录中的全部文件做内容分块（见 ContentChunker），输出分块吞吐量、加上哈希后的吞吐量和去重率。
+//     不指定目录时使用合成语料：若干随机模板，
+//     以及每个应用中的完整副本、局部修改的副本和截断导出的副本。
+namespace ChunkBench {
+
+int run(const QString &directory = QString());
+
+} // namespace ChunkBench
+
+#endif // CHUNKBENCH_H
@@ -0,0 +1,52 @@
+#include "deltabench.h"
+#include "core/sha256.h"
+#include "sync/blocksignature.h"
+#include "sync/delta.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryFile>
+#include <ctime>
+
+int DeltaBench::run(const QString &basePath, const QString &filePath)
+{
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    const BlockSignature base = BlockSignature::computeFile(basePath, &error);
+    const qint64 signatureNsecs = timer.nsecsElapsed();
+    if (!base.isValid()) {
+        qWarning() << "Signature failed:" << error;
+        return 1;
+    }
+
+    QTemporaryFile patch;
+    BlockSignature target;
+    Delta::Stats stats;
+    const std::clock_t cpuStart = std::clock();
+    if (!patch.open() || !Delta::encode(base, filePath, &patch, &target, &stats, &error)) {
+        qWarning() << "Delta failed:" << error;
+        return 1;
+    }
+    const double cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    // 用补丁重建新文件，与编码时计算的新文件哈希比较
+    QTemporaryFile rebuilt;
+    rebuilt.open();
+    QFile::copy(basePath, rebuilt.fileName() + ".base");
+    patch.seek(0);
+    const bool ok = Delta::apply(rebuilt.fileName() + ".base", &patch, rebuilt.fileName(), &error)
+                    && BlockSignature::computeFile(rebuilt.fileName()).fileHash == target.fileHash;
+    QFile::remove(rebuilt.fileName() + ".base");
+
+    const double gigabytes = qMax<qint64>(1, stats.sourceBytes) / 1e9;
+    qInfo() << "Block size" << base.blockSize << "bytes," << base.blockCount() << "base blocks, signature took"
+            << signatureNsecs / 1000000 << "ms";
+    qInfo() << "Wire" << stats.patchBytes << "of" << stats.sourceBytes << "bytes ("
+            << (stats.sourceBytes > 0 ? 100.0 - 100.0 * stats.patchBytes / stats.sourceBytes : 0.0) << "% saved ),"
+            << stats.copiedBytes << "bytes copied," << stats.literalBytes << "literal";
+    qInfo() << "Diff took" << stats.nsecs / 1000000 << "ms," << stats.nsecs / 1e9 / gigabytes << "s/GB wall,"
+            << cpuSeconds / gigabytes << "s/GB CPU (" << Sha256::kernelName() << ")";
+    qInfo() << "Rebuilt file" << (ok ? "matches" : "does NOT match") << error;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#ifndef DELTABENCH_H
+#define DELTABENCH_H
+
+#include <QString>
+
+// 块级补丁的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --delta <旧文件> <新文件>
+//     计算旧文件的块签名和新文件相对旧文件的补丁（见 Delta），输出上传字节数、节省比例和每 GB 的计算耗时，
+//     然后用补丁重建新文件并比较哈希，重建结果不一致时返回非零。
+namespace DeltaBench {
+
+int run(const QString &basePath, const QString &filePath);
+
+} // namespace DeltaBench
+
+#endif // DELTABENCH_H
@@ -0,0 +1,80 @@
+#include "core/sha256.h"
+#include "search/pinyin.h"
+#include "sync/contentchunker.h"
+#include <QRandomGenerator>
+#include <QTest>
+
+// 热点函数的 QtTest 基准（appGo_qbench）：每项先检查结果正确，再用 QBENCHMARK 测量；
+// 可用 QtTest 的命令行参数选择计时方式，例如 -tickcounter、-minimumvalue
+class HotPathBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void sha256Chunk();
+    void contentChunking();
+    void pinyinTranscribe();
+
+private:
+    QByteArray m_data;  // 4MB 随机数据
+};
+
+void HotPathBench::initTestCase()
+{
+    QRandomGenerator random(42);
+    m_data = QByteArray(4 * 1024 * 1024, Qt::Uninitialized);
+    random.fillRange(reinterpret_cast<quint32 *>(m_data.data()), m_data.size() / 4);
+}
+
+// 一个平均大小的块（64KB）的 SHA-256，块上传和去重的每个块都要计算
+void HotPathBench::sha256Chunk()
+{
+    const QByteArray chunk = QByteArray::fromRawData(m_data.constData(), 64 * 1024);
+    QCOMPARE(Sha256::hash(QByteArrayLiteral("abc")).toHex(),
+             QByteArrayLiteral("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    QByteArray hash;
+    QBENCHMARK {
+        hash = Sha256::hash(chunk);
+    }
+    QCOMPARE(hash.size(), 32);
+}
+
+// 4MB 数据的内容分块（只切分不计算哈希）
+void HotPathBench::contentChunking()
+{
+    const uchar *data = reinterpret_cast<const uchar *>(m_data.constData());
+
+    QVector<ContentChunker::Chunk> chunks;
+    QBENCHMARK {
+        chunks = ContentChunker::chunk(data, m_data.size(), false);
+    }
+
+    qint64 offset = 0;
+    for (int i = 0; i < chunks.size(); ++i) {
+        const ContentChunker::Chunk &chunk = chunks.at(i);
+        QCOMPARE(chunk.offset, offset);
+        QVERIFY(chunk.length <= ContentChunker::MaxSize);
+        QVERIFY(chunk.length >= ContentChunker::MinSize || i == chunks.size() - 1);
+        offset += chunk.length;
+    }
+    QCOMPARE(offset, qint64(m_data.size()));
+}
+
+// 建立搜索索引时每个应用名都要转写一次
+void HotPathBench::pinyinTranscribe()
+{
+    const QString name = QStringLiteral("腾讯会议");
+
+    Pinyin::Transcription transcription;
+    QBENCHMARK {
+        transcription = Pinyin::transcribe(name);
+    }
+    QCOMPARE(transcription.full, QByteArrayLiteral("tengxunhuiyi"));
+    QCOMPARE(transcription.initials, QByteArrayLiteral("txhy"));
+}
+
+QTEST_GUILESS_MAIN(HotPathBench)
+
+#include "hotpathbench.moc"
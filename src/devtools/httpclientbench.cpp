@@ -0,0 +1,154 @@
+#include "httpclientbench.h"
+#include "devtools/standinserver.h"
+#include "network/httpclient.h"
+#include <QDebug>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QHostAddress>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTimer>
+
+namespace {
+
+const int kRequestsPerUrl = 5;
+const int kFileSize = 4096;
+const int kPrefetchCount = 20;
+const int kVisibleCount = 3;
+const int kTimeoutMs = 30000;
+
+// 等待一组请求全部结束，按完成顺序返回请求编号
+QList<quint64> waitFor(HttpClient *client, const QSet<quint64> &ids, int *failures)
+{
+    QList<quint64> order;
+    QSet<quint64> pending = ids;
+    QEventLoop loop;
+    const auto done = [&](quint64 id) {
+        if (pending.remove(id)) {
+            order.append(id);
+            if (pending.isEmpty()) {
+                loop.quit();
+            }
+        }
+    };
+    QObject::connect(client, &HttpClient::finished, &loop, [&](quint64 id) { done(id); });
+    QObject::connect(client, &HttpClient::failed, &loop, [&](quint64 id, const QString &error) {
+        qWarning() << "Request failed:" << error;
+        ++*failures;
+        done(id);
+    });
+    QTimer::singleShot(kTimeoutMs, &loop, &QEventLoop::quit);
+    if (!pending.isEmpty()) {
+        loop.exec();
+    }
+    return order;
+}
+
+void printStats(const char *phase, const HttpClient::Stats &stats)
+{
+    qInfo().noquote() << QStringLiteral("%1 requests %2, hits %3, revalidated %4, misses %5, coalesced %6, "
+                                        "failures %7, evictions %8, cache %9 bytes")
+                         .arg(QString::fromLatin1(phase), -14).arg(stats.requests).arg(stats.hits)
+                         .arg(stats.revalidated).arg(stats.misses).arg(stats.coalesced).arg(stats.failures)
+                         .arg(stats.evictions).arg(stats.cacheBytes);
+}
+
+} // namespace
+
+int HttpClientBench::run(int urls)
+{
+    if (urls <= 0) return 1;
+
+    QTemporaryDir root;
+    QTemporaryDir cacheDir;
+    QDir().mkpath(root.filePath(QStringLiteral("icons")));
+    for (int i = 0; i < urls; ++i) {
+        QFile file(root.filePath(QStringLiteral("icons/%1.png").arg(i)));
+        QByteArray data(kFileSize, Qt::Uninitialized);
+        QRandomGenerator::global()->fillRange(reinterpret_cast<quint32 *>(data.data()), kFileSize / 4);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+            qWarning() << "Failed to write" << file.fileName();
+            return 1;
+        }
+    }
+
+    StandInServer server(root.path());
+    if (!server.listen(QHostAddress::LocalHost, 0)) {
+        qWarning() << "Failed to listen:" << server.errorString();
+        return 1;
+    }
+    const auto iconUrl = [&](int i, const QString &query = QString()) {
+        QUrl url(QStringLiteral("http://127.0.0.1:%1/icons/%2.png").arg(server.serverPort()).arg(i));
+        url.setQuery(query);
+        return url;
+    };
+
+    HttpClient client;
+    client.setCacheDirectory(cacheDir.path());
+    int failures = 0;
+
+    // 1. 并发请求合并
+    QSet<quint64> ids;
+    for (int round = 0; round < kRequestsPerUrl; ++round) {
+        for (int i = 0; i < urls; ++i) {
+            ids.insert(client.get(iconUrl(i), round == 0 ? HttpClient::Prefetch : HttpClient::Visible));
+        }
+    }
+    waitFor(&client, ids, &failures);
+    const HttpClient::Stats first = client.stats();
+    printStats("Concurrent:", first);
+    const bool coalesced = first.misses == quint64(urls) && first.coalesced == quint64(urls * (kRequestsPerUrl - 1));
+
+    // 2. 条件请求重新验证
+    ids.clear();
+    for (int i = 0; i < urls; ++i) {
+        ids.insert(client.get(iconUrl(i)));
+    }
+    waitFor(&client, ids, &failures);
+    const HttpClient::Stats second = client.stats();
+    printStats("Revalidate:", second);
+    const bool revalidated = second.revalidated - first.revalidated == quint64(urls) && second.misses == first.misses;
+
+    // 3. 优先级：预取先排队，可见请求后到但先完成
+    client.setMaxConcurrent(1);
+    QSet<quint64> prefetch;
+    QSet<quint64> visible;
+    for (int i = 0; i < kPrefetchCount; ++i) {
+        prefetch.insert(client.get(iconUrl(i % urls, QStringLiteral("prefetch=%1").arg(i)), HttpClient::Prefetch));
+    }
+    for (int i = 0; i < kVisibleCount; ++i) {
+        visible.insert(client.get(iconUrl(i % urls, QStringLiteral("visible=%1").arg(i)), HttpClient::Visible));
+    }
+    const QList<quint64> order = waitFor(&client, prefetch + visible, &failures);
+    int lastVisible = -1;
+    for (int i = 0; i < order.size(); ++i) {
+        if (visible.contains(order.at(i))) {
+            lastVisible = i;
+        }
+    }
+    qInfo().noquote() << QStringLiteral("Priority:      last visible request finished at position %1 of %2")
+                         .arg(lastVisible + 1).arg(order.size());
+    // 可见请求排入队列之前，最多已有一两个预取请求开始
+    const bool prioritized = lastVisible >= 0 && lastVisible <= kVisibleCount + 1;
+    client.setMaxConcurrent(6);
+
+    // 4. 缩小缓存上限后淘汰
+    const qint64 limit = qint64(kFileSize) * 8;
+    client.setCacheSize(limit);
+    ids.clear();
+    for (int i = 0; i < urls; ++i) {
+        ids.insert(client.get(iconUrl(i, QStringLiteral("evict=1"))));
+    }
+    waitFor(&client, ids, &failures);
+    const HttpClient::Stats fourth = client.stats();
+    printStats("Evict:", fourth);
+    const bool bounded = fourth.cacheBytes <= limit && (urls <= 8 || fourth.evictions > 0);
+
+    qInfo().noquote() << QStringLiteral("Coalescing:   %1").arg(coalesced ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Revalidation: %1").arg(revalidated ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Priority:     %1").arg(prioritized ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("LRU bound:    %1").arg(bounded ? "PASS" : "FAIL");
+    return failures == 0 && coalesced && revalidated && prioritized && bounded ? 0 : 1;
+}
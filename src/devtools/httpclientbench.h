@@ -0,0 +1,18 @@
+#ifndef HTTPCLIENTBENCH_H
+#define HTTPCLIENTBENCH_H
+
+// HttpClient 的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --http-client-bench [地址数]
+//     在本进程内启动替身服务器，依次检查：
+//     1. 每个地址同时请求 5 次，只访问一次网络，其余合并；
+//     2. 再次请求全部地址，服务器返回 304，使用缓存内容；
+//     3. 同时只允许一个请求时，先排队的预取请求让位于之后到来的可见请求；
+//     4. 缩小缓存上限后按最近使用时间淘汰，缓存大小不超过上限。
+//     输出各阶段的命中、重新验证、未命中和合并计数。
+namespace HttpClientBench {
+
+int run(int urls);
+
+} // namespace HttpClientBench
+
+#endif // HTTPCLIENTBENCH_H
@@ -0,0 +1,96 @@
+#include "paginationscrub.h"
+#include "widgets/paginationwidget.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+
+namespace {
+
+const int kWarmupChanges = 1000;               // 先翻页一段时间，让样式缓存和分配器稳定下来
+const int kEventInterval = 100;                // 每翻这么多页处理一次事件（包括 deleteLater）
+const int kTotalChangeInterval = 10000;        // 每隔这么多次翻页改变一次总页数
+const qint64 kMaxRssGrowth = 2 * 1024 * 1024;
+
+// 从 /proc/self/status 读取常驻内存（字节），其他平台返回 -1
+qint64 residentBytes()
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+// 按住下一页、随机跳页和跳到首尾交替进行，覆盖有无省略号的各种组合
+void scrub(PaginationWidget *pagination, int changes, int *step)
+{
+    static const int kTotals[] = {500, 7, 1, 60};
+    for (int i = 0; i < changes; ++i, ++*step) {
+        if (*step % kTotalChangeInterval == 0) {
+            pagination->setTotalPages(kTotals[(*step / kTotalChangeInterval) % 4]);
+        }
+        const int total = pagination->totalPages();
+        switch (*step % 50) {
+        case 0:
+            pagination->setCurrentPage(1);
+            break;
+        case 25:
+            pagination->setCurrentPage(total);
+            break;
+        case 10: case 20: case 30: case 40:
+            pagination->setCurrentPage(1 + QRandomGenerator::global()->bounded(total));
+            break;
+        default:
+            pagination->setCurrentPage(pagination->currentPage() % total + 1);
+            break;
+        }
+        if (*step % kEventInterval == 0) {
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+            QCoreApplication::processEvents();
+        }
+    }
+}
+
+} // namespace
+
+int PaginationScrub::run(int changes)
+{
+    changes = qMax(1, changes);
+
+    PaginationWidget pagination;
+    pagination.resize(1200, 60);
+    pagination.show();
+
+    int step = 0;
+    scrub(&pagination, kWarmupChanges, &step);
+
+    const int childrenBefore = pagination.findChildren<QObject*>().size();
+    const qint64 rssBefore = residentBytes();
+
+    QElapsedTimer timer;
+    timer.start();
+    scrub(&pagination, changes, &step);
+    const qint64 nsecs = timer.nsecsElapsed();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QCoreApplication::processEvents();
+
+    const int childrenAfter = pagination.findChildren<QObject*>().size();
+    const qint64 rssAfter = residentBytes();
+    const qint64 rssGrowth = rssBefore >= 0 && rssAfter >= 0 ? rssAfter - rssBefore : 0;
+
+    qInfo() << changes << "page changes in" << nsecs / 1000000 << "ms," << nsecs / changes << "ns per change";
+    qInfo() << "Child objects:" << childrenBefore << "->" << childrenAfter;
+    if (rssBefore >= 0) {
+        qInfo() << "Resident memory:" << rssBefore / 1024 << "KB ->" << rssAfter / 1024 << "KB";
+    }
+
+    const bool passed = childrenAfter == childrenBefore && rssGrowth <= kMaxRssGrowth;
+    qInfo().noquote() << (passed ? QStringLiteral("PASS") : QStringLiteral("FAIL"));
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+#ifndef PAGINATIONSCRUB_H
+#define PAGINATIONSCRUB_H
+
+// 分页控件的泄漏检查（开发调试工具，需要 QApplication；未设置 QT_QPA_PLATFORM 时使用 offscreen 平台）：
+//   appGo_bench --pagination-scrub [翻页次数]
+//     模拟长时间快速翻页：按住下一页、随机跳页、总页数变化交替进行，定期处理事件。
+//     检查翻页前后 PaginationWidget 的子对象数不变、常驻内存增长不超过 2MB，并输出每次翻页的平均耗时。
+namespace PaginationScrub {
+
+int run(int changes);
+
+} // namespace PaginationScrub
+
+#endif // PAGINATIONSCRUB_H
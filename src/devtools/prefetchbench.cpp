@@ -0,0 +1,272 @@
+#include "prefetchbench.h"
+#include "core/iconservice.h"
+#include "core/taskscheduler.h"
+#include "devtools/standinserver.h"
+#include "models/applistmodel.h"
+#include "network/catalogpager.h"
+#include "network/httpclient.h"
+#include "widgets/appgridview.h"
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QHostAddress>
+#include <QImage>
+#include <QListView>
+#include <QPainter>
+#include <QScrollBar>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const int kItemsPerPage = 12;       // 1200x800 的窗口中一页全部可见
+const int kLatencyMs = 60;          // 替身服务器每个请求的延迟
+const int kDwellMs = 800;           // 每页停留的时间（用户浏览）
+const int kIconSourceSize = 256;    // 源图标尺寸，解码后缩放到 48px
+const int kScrollPages = 6;         // 连续滚动时服务器上的页数
+const int kTimeoutMs = 30000;
+const QSize kWindowSize(1200, 800);
+
+// 按页从替身服务器读取目录的列表模型（CatalogStore::fetchMore 的简化版）
+class PagedListModel : public AppListModel
+{
+public:
+    explicit PagedListModel(CatalogPager *pager)
+        : m_pager(pager)
+    {
+        QObject::connect(pager, &CatalogPager::pageReady, this, [this](const QList<AppInfo> &apps) {
+            appendApps(apps);
+        });
+    }
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        return !parent.isValid() && m_pager->hasMore();
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        if (canFetchMore(parent)) {
+            m_pager->fetchNext();
+        }
+    }
+
+private:
+    CatalogPager *m_pager;
+};
+
+// 处理事件直到条件满足，超时返回 false
+bool waitUntil(const std::function<bool()> &done, int timeoutMs = kTimeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done()) {
+        if (timer.elapsed() > timeoutMs) return false;
+        QEventLoop loop;
+        QTimer::singleShot(1, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+    return true;
+}
+
+void idle(int msecs)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+bool writeIcon(const QString &path, int index)
+{
+    QImage image(kIconSourceSize, kIconSourceSize, QImage::Format_ARGB32);
+    image.fill(QColor::fromHsv(index * 37 % 360, 160, 220));
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setBrush(Qt::white);
+    painter.drawEllipse(image.rect().adjusted(40, 40, -40, -40));
+    painter.end();
+    return image.save(path, "PNG");
+}
+
+QList<AppInfo> makeApps(int first, int count, quint16 port, int icons, const QString &tag)
+{
+    QList<AppInfo> apps;
+    for (int i = first; i < first + count; ++i) {
+        AppInfo app;
+        app.id = QStringLiteral("com.example.app%1").arg(i);
+        app.name = QStringLiteral("应用 %1").arg(i);
+        app.description = QStringLiteral("应用描述 %1").arg(i);
+        app.iconPath = QStringLiteral("http://127.0.0.1:%1/icons/%2.png?run=%3").arg(port).arg(i % icons).arg(tag);
+        apps.append(app);
+    }
+    return apps;
+}
+
+// 当前页的图标都已在内存中（委托绘制时直接使用，不再显示占位图）
+bool pageRendered(QAbstractItemModel *pageModel)
+{
+    IconService *service = IconService::instance();
+    for (int row = 0; row < pageModel->rowCount(); ++row) {
+        const QString iconPath = pageModel->index(row, 0).data(AppListModel::IconPathRole).toString();
+        if (service->cachedIcon(iconPath).isNull()) return false;
+    }
+    return true;
+}
+
+qint64 median(QList<qint64> samples)
+{
+    if (samples.isEmpty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    return samples.at(samples.size() / 2);
+}
+
+// 依次翻页，返回每次翻页到当前页完整绘制的时间（纳秒）；超时返回空
+QList<qint64> measurePaging(AppGridView *grid, AppListModel *model, const QList<AppInfo> &apps, int pages)
+{
+    model->setApps(apps);
+    grid->setCurrentPage(1);
+    QAbstractItemModel *pageModel = grid->findChild<QListView *>()->model();
+    if (!waitUntil([&]() { return pageRendered(pageModel); })) return {};
+
+    QList<qint64> samples;
+    QElapsedTimer timer;
+    for (int page = 2; page <= pages + 1; ++page) {
+        idle(kDwellMs);
+        timer.start();
+        grid->setCurrentPage(page);
+        if (!waitUntil([&]() { return pageRendered(pageModel); })) return {};
+        samples.append(timer.nsecsElapsed());
+    }
+    return samples;
+}
+
+} // namespace
+
+int PrefetchBench::run(int pages)
+{
+    if (pages <= 0) return 1;
+
+    QTemporaryDir root;
+    QTemporaryDir cacheDir;
+    const int icons = (pages + 2) * kItemsPerPage;
+    QDir().mkpath(root.filePath(QStringLiteral("icons")));
+    for (int i = 0; i < icons; ++i) {
+        if (!writeIcon(root.filePath(QStringLiteral("icons/%1.png").arg(i)), i)) {
+            qWarning() << "Failed to write icon" << i;
+            return 1;
+        }
+    }
+
+    StandInServer server(root.path());
+    server.setResponseDelay(kLatencyMs);
+    if (!server.listen(QHostAddress::LocalHost, 0)) {
+        qWarning() << "Failed to listen:" << server.errorString();
+        return 1;
+    }
+    // 图标和目录经共用的 HttpClient 请求，响应缓存放在临时目录中；每轮使用不同的地址，互不命中
+    HttpClient::instance()->setCacheDirectory(cacheDir.path());
+
+    // 1. 分页模式：关闭和开启预取各翻页一轮
+    AppListModel model;
+    AppGridView grid;
+    grid.resize(kWindowSize);
+    grid.setItemsPerPage(kItemsPerPage);
+    grid.setModel(&model);
+    grid.show();
+
+    grid.setPrefetchEnabled(false);
+    const QList<qint64> cold = measurePaging(&grid, &model, makeApps(0, icons, server.serverPort(), icons,
+                                                                     QStringLiteral("cold")), pages);
+    grid.setPrefetchEnabled(true);
+    const QList<qint64> warm = measurePaging(&grid, &model, makeApps(0, icons, server.serverPort(), icons,
+                                                                     QStringLiteral("prefetch")), pages);
+    const TaskScheduler::Metrics prefetchMetrics = TaskScheduler::instance()->metrics(TaskScheduler::Prefetch);
+
+    const auto report = [](const char *name, const QList<qint64> &samples) {
+        qInfo().noquote() << QStringLiteral("%1 median %2 ms, max %3 ms over %4 page changes")
+                             .arg(QString::fromLatin1(name), -18)
+                             .arg(median(samples) / 1e6, 0, 'f', 1)
+                             .arg((samples.isEmpty() ? 0 : *std::max_element(samples.cbegin(), samples.cend())) / 1e6,
+                                  0, 'f', 1)
+                             .arg(samples.size());
+    };
+    report("Without prefetch:", cold);
+    report("With prefetch:", warm);
+    qInfo().noquote() << QStringLiteral("Prefetch tasks:     %1 decoded, %2 cancelled, budget %3 KB")
+                         .arg(prefetchMetrics.started).arg(prefetchMetrics.cancelled)
+                         .arg(IconService::instance()->prefetchBudget() / 1024);
+    // 不预取时每页至少等待一次网络往返；预取后图标在翻页前已就绪
+    const bool faster = cold.size() == pages && warm.size() == pages
+        && median(warm) * 2 < median(cold);
+
+    // 2. 连续滚动：目录按页读取，第一页之后修改服务器上的目录
+    const int serverApps = kScrollPages * kItemsPerPage;
+    server.updateCatalog(makeApps(0, serverApps, server.serverPort(), icons, QStringLiteral("scroll")), QStringList());
+    CatalogPager pager(QUrl(QStringLiteral("http://127.0.0.1:%1/.catalog").arg(server.serverPort())), kItemsPerPage);
+    PagedListModel pagedModel(&pager);
+    AppGridView scrollGrid;
+    scrollGrid.resize(kWindowSize);
+    scrollGrid.setItemsPerPage(kItemsPerPage);
+    scrollGrid.setModel(&pagedModel);
+    scrollGrid.setContinuousScroll(true);
+    scrollGrid.show();
+
+    pager.fetchNext();
+    bool scrolled = waitUntil([&]() { return pagedModel.rowCount() > 0; });
+    // 已读过的第一个应用和还没读到的一个应用被删除，末尾新增两个应用
+    const QString removedEarly = QStringLiteral("com.example.app0");
+    const QString removedLate = QStringLiteral("com.example.app%1").arg(serverApps / 2);
+    server.updateCatalog(makeApps(serverApps, 2, server.serverPort(), icons, QStringLiteral("scroll")),
+                         { removedEarly, removedLate });
+
+    QListView *list = scrollGrid.findChild<QListView *>();
+    QScrollBar *bar = list->verticalScrollBar();
+    int resets = 0;
+    scrolled = scrolled && waitUntil([&]() {
+        if (!pager.hasMore() && list->model()->rowCount() == pagedModel.rowCount()
+            && bar->value() >= bar->maximum()) {
+            return true;
+        }
+        const int target = bar->maximum();
+        bar->setValue(target);
+        idle(20);
+        // 追加的行在末尾，之前的滚动位置保持不变
+        if (target > 0 && bar->value() < target) {
+            ++resets;
+        }
+        return false;
+    });
+
+    QSet<QString> ids;
+    int duplicates = 0;
+    for (int row = 0; row < pagedModel.rowCount(); ++row) {
+        const QString appId = pagedModel.appAt(row).id;
+        if (ids.contains(appId)) {
+            ++duplicates;
+        }
+        ids.insert(appId);
+    }
+    int missing = 0;
+    for (int i = 0; i < serverApps + 2; ++i) {
+        const QString appId = QStringLiteral("com.example.app%1").arg(i);
+        if (appId != removedEarly && appId != removedLate && !ids.contains(appId)) {
+            ++missing;
+        }
+    }
+    qInfo().noquote() << QStringLiteral("Continuous:         %1 rows in %2 pages, %3 shown, %4 duplicates, %5 missing, "
+                                        "%6 scroll resets")
+                         .arg(pagedModel.rowCount()).arg(kScrollPages).arg(list->model()->rowCount())
+                         .arg(duplicates).arg(missing).arg(resets);
+    const bool paged = scrolled && duplicates == 0 && missing == 0 && !ids.contains(removedLate);
+    const bool kept = scrolled && resets == 0;
+
+    qInfo().noquote() << QStringLiteral("Prefetch:      %1").arg(faster ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Cursor pages:  %1").arg(paged ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Scroll kept:   %1").arg(kept ? "PASS" : "FAIL");
+    return faster && paged && kept ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+#ifndef PREFETCHBENCH_H
+#define PREFETCHBENCH_H
+
+// 相邻页预取和连续滚动的开发调试工具（需要 QApplication，默认使用 offscreen 平台）：
+//   appGo_bench --prefetch-bench [翻页次数]
+//     在本进程内启动替身服务器，每个请求延迟 60ms 模拟较慢的网络，图标经 HttpClient 下载。
+//     1. 分页模式下每页停留一段时间后翻到下一页，测量翻页到当前页图标全部可以绘制的时间，
+//        分别在关闭和开启预取（见 PagePrefetcher）时测量，开启后中位数应明显缩短；
+//     2. 连续滚动模式下目录经 CatalogPager 按页读取，第一页之后服务器删除、新增应用，
+//        反复滚动到末尾直到读完，检查没有重复和遗漏、追加行时滚动位置不变。
+namespace PrefetchBench {
+
+int run(int pages);
+
+} // namespace PrefetchBench
+
+#endif // PREFETCHBENCH_H
@@ -0,0 +1,177 @@
+#include "schedulerbench.h"
+#include "core/taskscheduler.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+
+const int kThreads = 4;
+const int kVisibleTasks = 20;
+const int kCancelledTasks = 100;
+const int kStolenTasks = 64;
+const int kBackgroundTaskMs = 5;
+const int kVisibleTaskMs = 1;
+
+// 模拟耗时的任务：忙等而不是睡眠，占住 CPU 与真实的解码、哈希任务相同
+void spin(int msecs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < msecs) {
+    }
+}
+
+// 等待调度器中某一类任务全部出队并执行完
+void waitIdle(const TaskScheduler &scheduler, TaskScheduler::Priority priority)
+{
+    for (;;) {
+        const TaskScheduler::Metrics metrics = scheduler.metrics(priority);
+        if (metrics.queued == 0 && metrics.running == 0) return;
+        QThread::msleep(5);
+    }
+}
+
+// 同样的提交顺序在先进先出的 QThreadPool 中，当前页任务的平均等待时间（纳秒）
+qint64 fifoVisibleWait(int backgroundTasks)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(kThreads);
+    QElapsedTimer clock;
+    clock.start();
+
+    std::atomic<qint64> totalWait(0);
+    for (int i = 0; i < backgroundTasks; ++i) {
+        pool.start([]() { spin(kBackgroundTaskMs); });
+    }
+    for (int i = 0; i < kVisibleTasks; ++i) {
+        const qint64 enqueued = clock.nsecsElapsed();
+        pool.start([&clock, &totalWait, enqueued]() {
+            totalWait += clock.nsecsElapsed() - enqueued;
+            spin(kVisibleTaskMs);
+        });
+    }
+    pool.waitForDone();
+    return totalWait / kVisibleTasks;
+}
+
+void printMetrics(const TaskScheduler &scheduler)
+{
+    qInfo().noquote() << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8")
+                         .arg(QStringLiteral("class"), -12).arg(QStringLiteral("queued"), 7)
+                         .arg(QStringLiteral("running"), 8).arg(QStringLiteral("cap"), 4)
+                         .arg(QStringLiteral("started"), 8).arg(QStringLiteral("cancelled"), 10)
+                         .arg(QStringLiteral("avg wait"), 11).arg(QStringLiteral("max wait"), 11);
+    for (int p = 0; p < TaskScheduler::PriorityCount; ++p) {
+        const TaskScheduler::Priority priority = TaskScheduler::Priority(p);
+        const TaskScheduler::Metrics metrics = scheduler.metrics(priority);
+        qInfo().noquote() << QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8")
+                             .arg(QString::fromLatin1(TaskScheduler::priorityName(priority)), -12)
+                             .arg(metrics.queued, 7).arg(metrics.running, 8).arg(metrics.cap, 4)
+                             .arg(metrics.started, 8).arg(metrics.cancelled, 10)
+                             .arg(QStringLiteral("%1 ms").arg(metrics.averageWaitNs() / 1e6, 0, 'f', 2), 11)
+                             .arg(QStringLiteral("%1 ms").arg(metrics.maxWaitNs / 1e6, 0, 'f', 2), 11);
+    }
+}
+
+} // namespace
+
+int SchedulerBench::run(int backgroundTasks)
+{
+    if (backgroundTasks <= 0) return 1;
+
+    TaskScheduler scheduler(kThreads);
+
+    // 1、2. 后台任务占满队列后提交当前页任务
+    std::atomic_int backgroundRunning(0);
+    std::atomic_int backgroundPeak(0);
+    for (int i = 0; i < backgroundTasks; ++i) {
+        scheduler.start(TaskScheduler::Background, [&backgroundRunning, &backgroundPeak]() {
+            const int running = ++backgroundRunning;
+            int peak = backgroundPeak;
+            while (running > peak && !backgroundPeak.compare_exchange_weak(peak, running)) {
+            }
+            spin(kBackgroundTaskMs);
+            --backgroundRunning;
+        });
+    }
+    QSemaphore visibleDone;
+    for (int i = 0; i < kVisibleTasks; ++i) {
+        scheduler.start(TaskScheduler::VisiblePage, [&visibleDone]() {
+            spin(kVisibleTaskMs);
+            visibleDone.release();
+        });
+    }
+    visibleDone.acquire(kVisibleTasks);
+    const TaskScheduler::Metrics visible = scheduler.metrics(TaskScheduler::VisiblePage);
+    waitIdle(scheduler, TaskScheduler::Background);
+
+    const qint64 baselineWait = fifoVisibleWait(backgroundTasks);
+    qInfo().noquote() << QStringLiteral("Visible wait:  scheduler avg %1 ms / max %2 ms, FIFO pool avg %3 ms")
+                         .arg(visible.averageWaitNs() / 1e6, 0, 'f', 2).arg(visible.maxWaitNs / 1e6, 0, 'f', 2)
+                         .arg(baselineWait / 1e6, 0, 'f', 2);
+    qInfo().noquote() << QStringLiteral("Background:    peak %1 running, cap %2")
+                         .arg(backgroundPeak.load()).arg(scheduler.metrics(TaskScheduler::Background).cap);
+    // 后台上限之外的线程空闲，当前页任务几乎不用排队；至少比先进先出快一个数量级
+    const bool prioritized = visible.maxWaitNs < qint64(kBackgroundTaskMs) * 4 * 1000000
+        && visible.averageWaitNs() * 10 < baselineWait;
+    const bool capped = backgroundPeak <= scheduler.metrics(TaskScheduler::Background).cap;
+
+    // 3. 所有线程都在执行交互任务时提交预取任务，随后取消（相当于翻页离开）
+    QSemaphore blockers;
+    QSemaphore release;
+    for (int i = 0; i < kThreads; ++i) {
+        scheduler.start(TaskScheduler::Interactive, [&blockers, &release]() {
+            blockers.release();
+            release.acquire();
+        });
+    }
+    blockers.acquire(kThreads);
+    CancellationToken token;
+    std::atomic_int cancelledRan(0);
+    for (int i = 0; i < kCancelledTasks; ++i) {
+        scheduler.start(TaskScheduler::Prefetch, [&cancelledRan]() { ++cancelledRan; }, token);
+    }
+    token.cancel();
+    release.release(kThreads);
+    waitIdle(scheduler, TaskScheduler::Prefetch);
+    waitIdle(scheduler, TaskScheduler::Interactive);
+    qInfo().noquote() << QStringLiteral("Cancellation:  %1 of %2 cancelled tasks ran, %3 dropped")
+                         .arg(cancelledRan.load()).arg(kCancelledTasks)
+                         .arg(scheduler.metrics(TaskScheduler::Prefetch).cancelled);
+    const bool cancelled = cancelledRan == 0
+        && scheduler.metrics(TaskScheduler::Prefetch).cancelled == quint64(kCancelledTasks);
+
+    // 4. 一个工作线程提交的任务进入它自己的队列，其他线程窃取执行
+    QMutex threadsMutex;
+    QSet<QThread *> threads;
+    QSemaphore stolenDone;
+    scheduler.start(TaskScheduler::VisiblePage, [&]() {
+        for (int i = 0; i < kStolenTasks; ++i) {
+            scheduler.start(TaskScheduler::VisiblePage, [&]() {
+                {
+                    QMutexLocker locker(&threadsMutex);
+                    threads.insert(QThread::currentThread());
+                }
+                spin(kVisibleTaskMs);
+                stolenDone.release();
+            });
+        }
+    });
+    stolenDone.acquire(kStolenTasks);
+    qInfo().noquote() << QStringLiteral("Stealing:      %1 tasks submitted from one worker ran on %2 threads")
+                         .arg(kStolenTasks).arg(threads.size());
+    const bool stolen = threads.size() > 1;
+
+    printMetrics(scheduler);
+
+    qInfo().noquote() << QStringLiteral("Priority:     %1").arg(prioritized ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Class cap:    %1").arg(capped ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Cancellation: %1").arg(cancelled ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Stealing:     %1").arg(stolen ? "PASS" : "FAIL");
+    return prioritized && capped && cancelled && stolen ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+#ifndef SCHEDULERBENCH_H
+#define SCHEDULERBENCH_H
+
+// TaskScheduler 的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --scheduler-bench [后台任务数]
+//     用 4 个工作线程依次检查：
+//     1. 先提交大量后台任务，再提交当前页任务，当前页任务的等待时间远小于同样顺序提交到 QThreadPool 时的等待时间；
+//     2. 同时执行的后台任务数不超过并发上限；
+//     3. 所有线程都忙时提交并取消的任务一个也不执行，计入取消数；
+//     4. 工作线程中提交的任务会被其他空闲线程窃取执行。
+//     输出每类任务的排队数、执行数、上限、平均和最长等待时间。
+namespace SchedulerBench {
+
+int run(int backgroundTasks);
+
+} // namespace SchedulerBench
+
+#endif // SCHEDULERBENCH_H
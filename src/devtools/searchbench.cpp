@@ -0,0 +1,166 @@
+#include "searchbench.h"
+#include "search/searchindex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+const int kRounds = 15;
+const int kTimeoutMs = 120000;
+const qint64 kTargetNs = 1000000;  // 每次按键 1 ms
+
+// 常见应用名称中的词，随机组合成名称
+const char *const kWords[] = {
+    "微信", "钉钉", "腾讯", "会议", "支付宝", "淘宝", "京东", "美团", "百度", "地图",
+    "网易", "云音乐", "抖音", "快手", "小红书", "高德", "滴滴", "出行", "携程", "旅行",
+    "拼多多", "爱奇艺", "优酷", "酷狗", "输入法", "浏览器", "文件", "管理", "相机", "日历",
+    "天气", "计算器", "笔记", "邮件", "视频", "播放器", "阅读", "助手", "安全", "卫士",
+    "办公", "文档", "表格", "翻译", "词典", "学习", "健康", "运动", "Music", "Player",
+    "Office", "Studio", "Pro", "Lite", "Cloud", "Photo", "Editor", "Chat"
+};
+const int kWordCount = int(sizeof(kWords) / sizeof(kWords[0]));
+
+// 逐字输入的关键词，以及结果中期望出现的应用名称
+struct Typing {
+    const char *text;
+    const char *expectedName;
+};
+const Typing kTypings[] = {
+    { "微信", "微信" },
+    { "weixin", "微信" },
+    { "wx", "微信" },
+    { "txhy", "腾讯会议" },
+    { "tengxun huiyi", "腾讯会议" },
+    { "会议", "腾讯会议" },
+    { "zhifubao", "支付宝" },
+    { "music player", "Music Player" },
+    { "浏览器", nullptr },
+    { "a", nullptr },
+    { "视频播放", nullptr },
+};
+
+QList<SearchEntry> generateEntries(int count)
+{
+    QRandomGenerator random(20261018);
+    QList<SearchEntry> entries;
+    entries.reserve(count);
+
+    // 固定的几个应用，检查结果是否包含它们
+    const char *const fixed[] = { "微信", "腾讯会议", "支付宝", "Music Player" };
+    for (const char *name : fixed) {
+        SearchEntry entry;
+        entry.row = entries.size();
+        entry.name = QString::fromUtf8(name);
+        entry.description = QStringLiteral("常用应用");
+        entries.append(entry);
+    }
+
+    while (entries.size() < count) {
+        QString name;
+        const int words = 1 + random.bounded(3);
+        for (int i = 0; i < words; ++i) {
+            const QString word = QString::fromUtf8(kWords[random.bounded(kWordCount)]);
+            if (!name.isEmpty() && word.at(0).unicode() < 0x80) name += QLatin1Char(' ');
+            name += word;
+        }
+        name += QString::number(entries.size());
+
+        QString description;
+        for (int i = 0; i < 6; ++i) {
+            description += QString::fromUtf8(kWords[random.bounded(kWordCount)]);
+        }
+
+        SearchEntry entry;
+        entry.row = entries.size();
+        entry.name = name;
+        entry.description = description;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+} // namespace
+
+int SearchBench::run(int apps)
+{
+    if (apps <= 0) return 1;
+
+    const QList<SearchEntry> entries = generateEntries(apps);
+
+    // 后台构建，等待 ready
+    SearchIndex index;
+    qint64 buildMsecs = -1;
+    QEventLoop loop;
+    QObject::connect(&index, &SearchIndex::ready, &loop, [&](int, qint64 msecs) {
+        buildMsecs = msecs;
+        loop.quit();
+    });
+    QTimer::singleShot(kTimeoutMs, &loop, &QEventLoop::quit);
+    index.build(entries);
+    loop.exec();
+    if (!index.isReady()) {
+        qWarning() << "Search index build timed out";
+        return 1;
+    }
+    qInfo().noquote() << QStringLiteral("Build:    %1 apps in %2 ms").arg(index.entryCount()).arg(buildMsecs);
+
+    // 每次按键查询当前已输入的前缀，重复多次取中位数
+    QList<qint64> keystrokes;
+    bool found = true;
+    for (const Typing &typing : kTypings) {
+        const QString text = QString::fromUtf8(typing.text);
+        qint64 slowest = 0;
+        int matches = 0;
+        for (int length = 1; length <= text.size(); ++length) {
+            const QString prefix = text.left(length);
+            QList<qint64> samples;
+            QList<int> rows;
+            for (int round = 0; round < kRounds; ++round) {
+                QElapsedTimer timer;
+                timer.start();
+                rows = index.query(prefix);
+                samples.append(timer.nsecsElapsed());
+            }
+            std::sort(samples.begin(), samples.end());
+            const qint64 median = samples.at(kRounds / 2);
+            keystrokes.append(median);
+            slowest = qMax(slowest, median);
+            matches = rows.size();
+
+            if (length == text.size() && typing.expectedName) {
+                const QString expected = QString::fromUtf8(typing.expectedName);
+                bool hit = false;
+                for (int row : rows) {
+                    if (entries.at(row).name == expected) {
+                        hit = true;
+                        break;
+                    }
+                }
+                if (!hit) {
+                    qWarning().noquote() << QStringLiteral("\"%1\" did not find \"%2\"").arg(text, expected);
+                    found = false;
+                }
+            }
+        }
+        qInfo().noquote() << QStringLiteral("%1 %2 keystrokes, %3 matches, slowest %4 us")
+                             .arg(QStringLiteral("\"%1\":").arg(text), -16).arg(text.size())
+                             .arg(matches).arg(slowest / 1000.0, 0, 'f', 1);
+    }
+
+    std::sort(keystrokes.begin(), keystrokes.end());
+    const qint64 p50 = keystrokes.at(keystrokes.size() / 2);
+    const qint64 p99 = keystrokes.at(qMin(keystrokes.size() - 1, keystrokes.size() * 99 / 100));
+    const qint64 worst = keystrokes.last();
+    qInfo().noquote() << QStringLiteral("Query:    %1 keystrokes, p50 %2 us, p99 %3 us, max %4 us")
+                         .arg(keystrokes.size()).arg(p50 / 1000.0, 0, 'f', 1)
+                         .arg(p99 / 1000.0, 0, 'f', 1).arg(worst / 1000.0, 0, 'f', 1);
+
+    const bool fast = worst < kTargetNs;
+    qInfo().noquote() << QStringLiteral("Under 1 ms: %1").arg(fast ? "PASS" : "FAIL");
+    qInfo().noquote() << QStringLiteral("Results:    %1").arg(found ? "PASS" : "FAIL");
+    return fast && found ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#ifndef SEARCHBENCH_H
+#define SEARCHBENCH_H
+
+// 搜索索引的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --search-bench [应用数]
+//     生成指定数量的中英文混合应用名称和描述，测量后台构建索引的耗时，
+//     再模拟逐字输入若干关键词（中文、全拼、首字母、英文、单个字母、描述中的词），
+//     每次按键重复查询多次取中位数，输出每个关键词最慢一次按键的耗时和全部按键的 p50/p99。
+//     检查每次按键的查询耗时都在 1 ms 以内，且结果中包含期望的应用。
+namespace SearchBench {
+
+int run(int apps);
+
+} // namespace SearchBench
+
+#endif // SEARCHBENCH_H
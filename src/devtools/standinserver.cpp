@@ -0,0 +1,753 @@
+#include "standinserver.h"
+#include "core/sha256.h"
+#include "network/catalogsync.h"
+#include "sync/contentchunker.h"
+#include "sync/delta.h"
+#include "sync/syncbatch.h"
+#include "sync/synctree.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QScopedPointer>
+#include <QTcpSocket>
+#include <QTemporaryFile>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QVector>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+const qint64 kChunkSize = 64 * 1024;          // 每次写入套接字的字节数
+const qint64 kMaxPendingWrite = 256 * 1024;   // 套接字待发送数据的上限，超过后等待 bytesWritten
+const int kMaxHeaderSize = 16 * 1024;
+
+QByteArray httpDate(const QDateTime &time)
+{
+    return QLocale::c().toString(time.toUTC(), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'")).toLatin1();
+}
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 411: return "Length Required";
+    case 415: return "Unsupported Media Type";
+    case 416: return "Range Not Satisfiable";
+    default: return "Error";
+    }
+}
+
+enum UploadMethod {
+    Put,
+    Patch,
+    Post
+};
+
+const char *const kUploadMethodNames[] = { "PUT", "PATCH", "POST" };
+
+// 一个客户端连接：每个连接只处理一个请求，响应完成后关闭。
+// 除下载外还接受上传：PUT 写入完整文件，PATCH 把块级增量补丁（见 Delta）应用到已有文件，
+// /.chunks 下保存按内容分块上传的块：POST /.chunks/missing 查询缺少的块，PUT /.chunks/<哈希> 上传块，
+// 对文件地址 POST 块清单（见 ContentChunker）拼出文件，POST /.batch 一次写入或删除多个小文件（见 SyncBatch），
+// POST /.catalog 修改应用目录。
+// 上传块时可以带 Content-Encoding: deflate（zlib 格式），解压后再按哈希校验。
+class StandInConnection : public QObject
+{
+public:
+    StandInConnection(QTcpSocket *socket, StandInServer *server)
+        : QObject(server)
+        , m_socket(socket)
+        , m_server(server)
+        , m_rootPath(server->rootPath())
+        , m_remaining(0)
+        , m_handled(false)
+        , m_bodyRemaining(0)
+        , m_method(Put)
+        , m_deflated(false)
+    {
+        m_socket->setParent(this);
+        connect(m_socket, &QTcpSocket::readyRead, this, [this]() { readRequest(); });
+        connect(m_socket, &QTcpSocket::bytesWritten, this, [this]() { pump(); });
+        connect(m_socket, &QTcpSocket::disconnected, this, &QObject::deleteLater);
+    }
+
+private:
+    void readRequest()
+    {
+        if (m_handled) {
+            if (m_bodyRemaining > 0) {
+                receiveBody(m_socket->readAll());
+            } else {
+                m_socket->readAll();
+            }
+            return;
+        }
+
+        m_header.append(m_socket->readAll());
+        const int end = m_header.indexOf("\r\n\r\n");
+        if (end < 0) {
+            if (m_header.size() > kMaxHeaderSize) {
+                sendError(400);
+            }
+            return;
+        }
+        m_handled = true;
+
+        const QList<QByteArray> lines = m_header.left(end).split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() < 3) {
+            sendError(400);
+            return;
+        }
+
+        QHash<QByteArray, QByteArray> headers;
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines.at(i).indexOf(':');
+            if (colon > 0) {
+                headers.insert(lines.at(i).left(colon).trimmed().toLower(), lines.at(i).mid(colon + 1).trimmed());
+            }
+        }
+
+        const QByteArray method = requestLine.at(0);
+        const QString path = QUrl::fromPercentEncoding(requestLine.at(1).split('?').first());
+        if (method == "PUT" || method == "PATCH" || method == "POST") {
+            const UploadMethod upload = method == "PUT" ? Put : (method == "PATCH" ? Patch : Post);
+            beginUpload(path, headers, upload, m_header.mid(end + 4));
+            return;
+        }
+        if (method != "GET" && method != "HEAD") {
+            sendError(405);
+            return;
+        }
+
+        // 模拟较慢的网络：读请求延迟一段时间再响应（连接在此期间断开时随连接对象一起取消）
+        const QByteArray target = requestLine.at(1);
+        const int delay = m_server->responseDelay();
+        if (delay > 0) {
+            QTimer::singleShot(delay, this, [this, method, path, target, headers]() {
+                serveRead(method, path, target, headers);
+            });
+            return;
+        }
+        serveRead(method, path, target, headers);
+    }
+
+    void serveRead(const QByteArray &method, const QString &path, const QByteArray &target,
+                   const QHash<QByteArray, QByteArray> &headers)
+    {
+        if (path.startsWith(QLatin1String("/.tree/"))) {
+            serveTree(path.mid(7), method == "HEAD");
+            return;
+        }
+        if (path == QLatin1String("/.catalog")) {
+            const QUrlQuery query(QString::fromLatin1(target).section(QLatin1Char('?'), 1));
+            if (query.hasQueryItem(QStringLiteral("limit"))) {
+                const QByteArray body = m_server->catalogPage(
+                    query.queryItemValue(QStringLiteral("cursor"), QUrl::FullyDecoded),
+                    query.queryItemValue(QStringLiteral("limit")).toInt());
+                serveCatalog(body, headers, method == "HEAD");
+            } else {
+                const QString since = query.queryItemValue(QStringLiteral("since"), QUrl::FullyDecoded);
+                serveCatalog(m_server->catalogChanges(since), headers, method == "HEAD");
+            }
+            return;
+        }
+        serveFile(path, headers, method == "HEAD");
+    }
+
+    // 应用目录：/.catalog?since=<版本>（见 CatalogSync）或 /.catalog?cursor=<游标>&limit=<条数>（见 CatalogPager）；
+    // 同一地址的响应只随目录版本变化，版本作为 ETag
+    void serveCatalog(const QByteArray &body, const QHash<QByteArray, QByteArray> &headers, bool headOnly)
+    {
+        const QByteArray etag = '"' + m_server->catalogVersion().toUtf8() + '"';
+        if (headers.value("if-none-match") == etag) {
+            sendNotModified(etag, QByteArray());
+            return;
+        }
+
+        QByteArray response = "HTTP/1.1 200 " + reasonPhrase(200) + "\r\n";
+        response += "Content-Type: application/json\r\n";
+        response += "ETag: " + etag + "\r\n";
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        m_socket->write(headOnly ? response : response + body);
+        m_socket->disconnectFromHost();
+        qInfo() << "StandInServer: catalog" << body.size() << "bytes";
+    }
+
+    // 同步文件夹的 Merkle 树：/.tree/<文件夹>/<目录> 返回目录哈希和子项列表（见 SyncChecker）
+    void serveTree(const QString &path, bool headOnly)
+    {
+        const QString folder = path.section(QLatin1Char('/'), 0, 0);
+        const QString directory = path.section(QLatin1Char('/'), 1);
+        SyncTree *tree = m_server->treeFor(folder);
+        QList<SyncTree::Entry> entries;
+        if (!tree || !tree->children(directory, &entries)) {
+            sendError(404);
+            return;
+        }
+
+        QByteArray body;
+        for (const SyncTree::Entry &entry : std::as_const(entries)) {
+            body += (entry.directory ? "d " : "f ") + entry.hash.toHex() + ' '
+                    + QUrl::toPercentEncoding(entry.name) + '\n';
+        }
+
+        QByteArray response = "HTTP/1.1 200 " + reasonPhrase(200) + "\r\n";
+        response += "Content-Type: text/plain\r\n";
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        response += "X-Tree-Hash: " + tree->hash(directory).toHex() + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        m_socket->write(headOnly ? response : response + body);
+        m_socket->disconnectFromHost();
+        qInfo() << "StandInServer: tree" << path << entries.size() << "entries";
+    }
+
+    void beginUpload(const QString &path, const QHash<QByteArray, QByteArray> &headers, UploadMethod method,
+                     const QByteArray &initialBody)
+    {
+        bool ok = false;
+        const qint64 length = headers.value("content-length").toLongLong(&ok);
+        if (!ok || length < 0) {
+            sendError(411);
+            return;
+        }
+
+        // 只允许写入根目录内的文件
+        const QString root = QDir(m_rootPath).canonicalPath();
+        m_targetPath = QDir::cleanPath(root + QLatin1Char('/') + path);
+        if (!m_targetPath.startsWith(root + QLatin1Char('/'))) {
+            sendError(403);
+            return;
+        }
+        if (method == Patch && !QFileInfo::exists(m_targetPath)) {
+            sendError(404);
+            return;
+        }
+        // 只有块上传支持压缩，压缩的块先收下再解压
+        const QByteArray encoding = headers.value("content-encoding").trimmed().toLower();
+        const bool chunkUpload = method == Put
+            && QFileInfo(m_targetPath).absolutePath() == root + QStringLiteral("/.chunks");
+        m_deflated = encoding == "deflate";
+        if ((!encoding.isEmpty() && encoding != "identity" && !m_deflated) || (m_deflated && !chunkUpload)) {
+            sendError(415);
+            return;
+        }
+        QDir().mkpath(QFileInfo(m_targetPath).absolutePath());
+
+        // PUT 直接写入目标文件（完成后原子替换）；PATCH、POST 和压缩的块先收下整个请求体再处理
+        if (method == Put && !m_deflated) {
+            m_body.reset(new QSaveFile(m_targetPath));
+        } else {
+            m_body.reset(new QTemporaryFile);
+        }
+        if (!m_body->open(QIODevice::WriteOnly)) {
+            sendError(403);
+            return;
+        }
+        m_method = method;
+        m_bodyHash.reset();
+        m_bodyRemaining = length;
+        receiveBody(initialBody);
+    }
+
+    void receiveBody(const QByteArray &data)
+    {
+        const QByteArray chunk = data.left(m_bodyRemaining);
+        if (!chunk.isEmpty() && m_body->write(chunk) != chunk.size()) {
+            m_bodyRemaining = 0;
+            sendError(403);
+            return;
+        }
+        m_bodyHash.addData(chunk);
+        m_bodyRemaining -= chunk.size();
+        if (m_bodyRemaining == 0) {
+            finishUpload();
+        }
+    }
+
+    void finishUpload()
+    {
+        const QString chunkDir = QDir(m_rootPath).canonicalPath() + QStringLiteral("/.chunks");
+        int status = 201;
+        QByteArray body;
+
+        if (m_deflated) {
+            QTemporaryFile *upload = static_cast<QTemporaryFile *>(m_body.data());
+            status = storeDeflatedChunk(upload);
+        } else if (m_method == Put) {
+            // 块以 SHA-256 命名，内容必须与名称一致
+            QSaveFile *file = static_cast<QSaveFile *>(m_body.data());
+            if (QFileInfo(m_targetPath).absolutePath() == chunkDir
+                && m_bodyHash.result().toHex() != QFileInfo(m_targetPath).fileName().toLatin1()) {
+                file->cancelWriting();
+                status = 400;
+            } else if (!file->commit()) {
+                status = 403;
+            }
+        } else {
+            QTemporaryFile *upload = static_cast<QTemporaryFile *>(m_body.data());
+            upload->close();
+            if (!upload->open()) {
+                status = 403;
+            } else if (m_method == Patch) {
+                QString error;
+                if (!Delta::apply(m_targetPath, upload, m_targetPath, &error)) {
+                    qInfo() << "StandInServer: patch rejected:" << error;
+                    status = 409;
+                }
+            } else if (m_targetPath == chunkDir + QStringLiteral("/missing")) {
+                body = missingChunks(chunkDir, upload->readAll());
+                status = 200;
+            } else if (m_targetPath == QDir(m_rootPath).canonicalPath() + QStringLiteral("/.batch")) {
+                status = applyBatch(upload->readAll());
+            } else if (m_targetPath == QDir(m_rootPath).canonicalPath() + QStringLiteral("/.catalog")) {
+                status = updateCatalog(upload->readAll(), &body);
+            } else {
+                status = assembleFromChunks(chunkDir, upload->readAll());
+            }
+        }
+        m_body.reset();
+
+        if (status >= 300) {
+            sendError(status);
+            return;
+        }
+        QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n"
+                              "Content-Type: application/octet-stream\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                              "Connection: close\r\n\r\n";
+        m_socket->write(response + body);
+        m_socket->disconnectFromHost();
+        qInfo() << "StandInServer:" << kUploadMethodNames[m_method] << m_targetPath << status;
+    }
+
+    // 解压 zlib 格式的块，校验哈希后写入块目录
+    int storeDeflatedChunk(QTemporaryFile *upload)
+    {
+        upload->close();
+        if (!upload->open()) return 403;
+
+        // qUncompress 需要 4 字节大端序的原始长度前缀，块不超过 MaxSize，用它作为上限
+        QByteArray compressed(4, '\0');
+        qToBigEndian<quint32>(ContentChunker::MaxSize, compressed.data());
+        compressed += upload->readAll();
+        const QByteArray data = qUncompress(compressed);
+        if (data.isEmpty() || data.size() > ContentChunker::MaxSize
+            || Sha256::hash(data).toHex() != QFileInfo(m_targetPath).fileName().toLatin1()) {
+            return 400;
+        }
+
+        QSaveFile file(m_targetPath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) return 403;
+        return 201;
+    }
+
+    // 请求体为若干 32 字节块哈希，返回其中服务器没有的
+    QByteArray missingChunks(const QString &chunkDir, const QByteArray &hashes)
+    {
+        QByteArray missing;
+        for (int i = 0; i + 32 <= hashes.size(); i += 32) {
+            const QByteArray hash = hashes.mid(i, 32);
+            if (!QFileInfo::exists(chunkDir + QLatin1Char('/') + QString::fromLatin1(hash.toHex()))) {
+                missing += hash;
+            }
+        }
+        return missing;
+    }
+
+    // 批量同步请求（见 SyncBatch）：先检查全部路径，再依次写入或删除
+    int applyBatch(const QByteArray &data)
+    {
+        QList<SyncBatch::Entry> entries;
+        if (!SyncBatch::parse(data, &entries)) return 400;
+
+        const QString root = QDir(m_rootPath).canonicalPath();
+        QStringList paths;
+        for (const SyncBatch::Entry &entry : std::as_const(entries)) {
+            const QString path = QDir::cleanPath(root + QLatin1Char('/') + entry.path);
+            if (!path.startsWith(root + QLatin1Char('/'))) return 403;
+            paths.append(path);
+        }
+
+        for (int i = 0; i < entries.size(); ++i) {
+            const SyncBatch::Entry &entry = entries.at(i);
+            if (entry.removed) {
+                QFile::remove(paths.at(i));
+                continue;
+            }
+            QDir().mkpath(QFileInfo(paths.at(i)).absolutePath());
+            QSaveFile file(paths.at(i));
+            if (!file.open(QIODevice::WriteOnly) || file.write(entry.data) != entry.data.size() || !file.commit()) {
+                return 403;
+            }
+        }
+        qInfo() << "StandInServer: batch" << entries.size() << "entries";
+        return 200;
+    }
+
+    // 修改应用目录，响应体为新版本
+    int updateCatalog(const QByteArray &data, QByteArray *body)
+    {
+        const QJsonDocument document = QJsonDocument::fromJson(data);
+        if (!document.isObject()) return 400;
+
+        QList<AppInfo> upserts;
+        const QJsonArray apps = document.object().value(QStringLiteral("upserts")).toArray();
+        for (const QJsonValue &value : apps) {
+            const AppInfo app = CatalogSync::fromJson(value.toObject());
+            if (app.id.isEmpty()) return 400;
+            upserts.append(app);
+        }
+        QStringList removedIds;
+        const QJsonArray removed = document.object().value(QStringLiteral("removed")).toArray();
+        for (const QJsonValue &value : removed) {
+            removedIds.append(value.toString());
+        }
+
+        *body = m_server->updateCatalog(upserts, removedIds).toUtf8();
+        return 200;
+    }
+
+    // 按块清单（见 ContentChunker::manifest）拼出文件；缺少块时返回 409
+    int assembleFromChunks(const QString &chunkDir, const QByteArray &manifest)
+    {
+        qint64 fileSize = 0;
+        QVector<ContentChunker::Chunk> chunks;
+        if (!ContentChunker::parseManifest(manifest, &fileSize, &chunks)) return 400;
+
+        QSaveFile file(m_targetPath);
+        if (!file.open(QIODevice::WriteOnly)) return 403;
+        for (const ContentChunker::Chunk &chunk : std::as_const(chunks)) {
+            QFile source(chunkDir + QLatin1Char('/') + QString::fromLatin1(chunk.hash.toHex()));
+            if (!source.open(QIODevice::ReadOnly) || source.size() != chunk.length) {
+                file.cancelWriting();
+                return 409;
+            }
+            file.write(source.readAll());
+        }
+        return file.commit() ? 201 : 403;
+    }
+
+    void serveFile(const QString &path, const QHash<QByteArray, QByteArray> &headers, bool headOnly)
+    {
+        // 只允许访问根目录内的文件
+        const QString root = QDir(m_rootPath).canonicalPath();
+        const QFileInfo info(QDir(root).filePath(QDir::cleanPath(path).mid(1)));
+        if (!info.exists() || !info.isFile()) {
+            sendError(404);
+            return;
+        }
+        if (!info.canonicalFilePath().startsWith(root + QLatin1Char('/'))) {
+            sendError(403);
+            return;
+        }
+
+        const qint64 size = info.size();
+        const QByteArray etag = '"' + QByteArray::number(size, 16) + '-'
+                                + QByteArray::number(info.lastModified().toMSecsSinceEpoch(), 16) + '"';
+        const QByteArray lastModified = httpDate(info.lastModified());
+        const QByteArray ifNoneMatch = headers.value("if-none-match");
+        if ((!ifNoneMatch.isEmpty() && ifNoneMatch == etag)
+            || (ifNoneMatch.isEmpty() && headers.value("if-modified-since") == lastModified)) {
+            sendNotModified(etag, lastModified);
+            return;
+        }
+
+        // 解析单段 Range；If-Range 不匹配时返回完整内容
+        qint64 first = 0;
+        qint64 last = size - 1;
+        bool partial = false;
+        const QByteArray range = headers.value("range");
+        const QByteArray ifRange = headers.value("if-range");
+        if (range.startsWith("bytes=") && !range.contains(',')
+            && (ifRange.isEmpty() || ifRange == etag || ifRange == lastModified)) {
+            const QByteArray spec = range.mid(6);
+            const int dash = spec.indexOf('-');
+            bool ok = dash >= 0;
+            if (ok && dash == 0) {
+                // bytes=-n：最后 n 个字节
+                const qint64 suffix = spec.mid(1).toLongLong(&ok);
+                first = qMax<qint64>(0, size - suffix);
+            } else if (ok) {
+                first = spec.left(dash).toLongLong(&ok);
+                if (ok && dash + 1 < spec.size()) {
+                    last = qMin(last, spec.mid(dash + 1).toLongLong(&ok));
+                }
+            }
+            if (!ok || first >= size || first > last) {
+                QByteArray response = "HTTP/1.1 416 " + reasonPhrase(416) + "\r\n"
+                                      "Content-Range: bytes */" + QByteArray::number(size) + "\r\n"
+                                      "Content-Length: 0\r\n"
+                                      "Connection: close\r\n\r\n";
+                m_socket->write(response);
+                m_socket->disconnectFromHost();
+                qInfo() << "StandInServer:" << path << 416;
+                return;
+            }
+            partial = true;
+        }
+
+        m_file.setFileName(info.filePath());
+        if (!m_file.open(QIODevice::ReadOnly) || !m_file.seek(first)) {
+            sendError(403);
+            return;
+        }
+
+        const int status = partial ? 206 : 200;
+        QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+        response += "Content-Type: application/octet-stream\r\n";
+        response += "Content-Length: " + QByteArray::number(last - first + 1) + "\r\n";
+        if (partial) {
+            response += "Content-Range: bytes " + QByteArray::number(first) + '-' + QByteArray::number(last)
+                        + '/' + QByteArray::number(size) + "\r\n";
+        }
+        response += "Accept-Ranges: bytes\r\n";
+        response += "ETag: " + etag + "\r\n";
+        response += "Last-Modified: " + lastModified + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        m_socket->write(response);
+
+        qInfo() << "StandInServer:" << path << status << first << "-" << last;
+
+        m_remaining = headOnly ? 0 : last - first + 1;
+        pump();
+    }
+
+    // 按套接字的发送进度分块读取文件，不把整个文件读入内存
+    void pump()
+    {
+        while (m_remaining > 0 && m_socket->bytesToWrite() < kMaxPendingWrite) {
+            const QByteArray chunk = m_file.read(qMin(m_remaining, kChunkSize));
+            if (chunk.isEmpty()) {
+                m_remaining = 0;
+                break;
+            }
+            m_socket->write(chunk);
+            m_remaining -= chunk.size();
+        }
+
+        if (m_handled && m_remaining == 0 && m_socket->bytesToWrite() == 0) {
+            m_file.close();
+            m_socket->disconnectFromHost();
+        }
+    }
+
+    // 条件请求命中：内容未变，不发送响应体
+    void sendNotModified(const QByteArray &etag, const QByteArray &lastModified)
+    {
+        QByteArray response = "HTTP/1.1 304 " + reasonPhrase(304) + "\r\n";
+        response += "ETag: " + etag + "\r\n";
+        if (!lastModified.isEmpty()) {
+            response += "Last-Modified: " + lastModified + "\r\n";
+        }
+        response += "Content-Length: 0\r\n";
+        response += "Connection: close\r\n\r\n";
+        m_socket->write(response);
+        m_socket->disconnectFromHost();
+        qInfo() << "StandInServer: not modified" << etag;
+    }
+
+    void sendError(int status)
+    {
+        const QByteArray body = QByteArray::number(status) + ' ' + reasonPhrase(status) + '\n';
+        QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+        response += "Content-Type: text/plain\r\n";
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        m_socket->write(response + body);
+        m_handled = true;
+        m_socket->disconnectFromHost();
+        qInfo() << "StandInServer: error" << status;
+    }
+
+private:
+    QTcpSocket *m_socket;
+    StandInServer *m_server;
+    QString m_rootPath;
+    QByteArray m_header;    // 尚未解析完的请求头
+    QFile m_file;           // 正在发送的文件
+    qint64 m_remaining;     // 剩余要发送的字节数
+    bool m_handled;         // 请求是否已处理
+    QScopedPointer<QFileDevice> m_body;   // 正在接收的上传内容
+    QString m_targetPath;   // 上传的目标文件
+    qint64 m_bodyRemaining; // 剩余要接收的字节数
+    UploadMethod m_method;  // 正在接收的上传方式
+    Sha256 m_bodyHash;      // 上传内容的哈希，用于校验块
+    bool m_deflated;        // 上传内容为压缩的块
+};
+
+} // namespace
+
+StandInServer::StandInServer(const QString &rootPath, QObject *parent)
+    : QTcpServer(parent)
+    , m_rootPath(rootPath)
+    , m_catalogSerial(0)
+    , m_catalogPosition(0)
+    , m_catalogEpoch(QString::number(QRandomGenerator::global()->generate(), 16))
+    , m_responseDelay(0)
+{
+    loadCatalog();
+}
+
+StandInServer::~StandInServer()
+{
+    qDeleteAll(m_trees);
+}
+
+SyncTree *StandInServer::treeFor(const QString &folder)
+{
+    const QString root = QDir(m_rootPath).canonicalPath();
+    const QString folderPath = QDir::cleanPath(root + QLatin1Char('/') + folder);
+    if (folder.isEmpty() || folder.startsWith(QLatin1Char('.')) || !QFileInfo(folderPath).isDir()
+        || !folderPath.startsWith(root + QLatin1Char('/'))) {
+        return nullptr;
+    }
+
+    // 每次请求都与磁盘对比，只有大小或修改时间变化的文件才重新计算哈希
+    SyncTree *&tree = m_trees[folder];
+    if (!tree) {
+        tree = new SyncTree;
+    }
+    tree->rescan(folderPath);
+    return tree;
+}
+
+void StandInServer::incomingConnection(qintptr socketDescriptor)
+{
+    QTcpSocket *socket = new QTcpSocket;
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+    new StandInConnection(socket, this);
+}
+
+QString StandInServer::catalogVersion() const
+{
+    return m_catalogEpoch + QLatin1Char(':') + QString::number(m_catalogSerial);
+}
+
+QString StandInServer::updateCatalog(const QList<AppInfo> &upserts, const QStringList &removedIds)
+{
+    ++m_catalogSerial;
+    for (const QString &appId : removedIds) {
+        if (m_catalog.remove(appId)) {
+            m_catalogOrder.removeOne(appId);
+            m_catalogRemoved.insert(appId, m_catalogSerial);
+        }
+    }
+    for (const AppInfo &app : upserts) {
+        auto it = m_catalog.find(app.id);
+        if (it == m_catalog.end()) {
+            m_catalog.insert(app.id, { app, m_catalogSerial, m_catalogSerial, ++m_catalogPosition });
+            m_catalogOrder.append(app.id);
+            m_catalogRemoved.remove(app.id);
+        } else {
+            it->app = app;
+            it->changed = m_catalogSerial;
+        }
+    }
+    qInfo() << "StandInServer: catalog" << catalogVersion() << m_catalog.size() << "apps";
+    return catalogVersion();
+}
+
+QByteArray StandInServer::catalogChanges(const QString &since) const
+{
+    // 其他实例的标记或比当前还新的序号都无法比较，返回完整目录
+    bool ok = false;
+    const quint64 serial = since.section(QLatin1Char(':'), 1).toULongLong(&ok);
+    const bool full = !ok || since.section(QLatin1Char(':'), 0, 0) != m_catalogEpoch || serial > m_catalogSerial;
+
+    // 新增的应用按加入顺序返回，客户端追加后与服务器顺序一致
+    QJsonArray added;
+    QJsonArray updated;
+    for (const QString &appId : m_catalogOrder) {
+        const CatalogEntry &entry = m_catalog[appId];
+        if (full || entry.created > serial) {
+            added.append(CatalogSync::toJson(entry.app));
+        } else if (entry.changed > serial) {
+            updated.append(CatalogSync::toJson(entry.app));
+        }
+    }
+    QJsonArray removed;
+    if (!full) {
+        for (auto it = m_catalogRemoved.cbegin(); it != m_catalogRemoved.cend(); ++it) {
+            if (it.value() > serial) {
+                removed.append(it.key());
+            }
+        }
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), catalogVersion());
+    root.insert(QStringLiteral("full"), full);
+    root.insert(QStringLiteral("added"), added);
+    root.insert(QStringLiteral("updated"), updated);
+    root.insert(QStringLiteral("removed"), removed);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QByteArray StandInServer::catalogPage(const QString &cursor, int limit) const
+{
+    // 加入顺序即位置顺序，二分查找游标之后的第一个应用；游标之前的应用被删除不影响后面的页
+    bool ok = false;
+    quint64 after = cursor.section(QLatin1Char(':'), 1).toULongLong(&ok);
+    if (!ok || cursor.section(QLatin1Char(':'), 0, 0) != m_catalogEpoch) {
+        after = 0;
+    }
+    auto it = std::partition_point(m_catalogOrder.cbegin(), m_catalogOrder.cend(), [this, after](const QString &appId) {
+        return m_catalog[appId].position <= after;
+    });
+
+    QJsonArray apps;
+    quint64 last = after;
+    for (; it != m_catalogOrder.cend() && apps.size() < qMax(1, limit); ++it) {
+        const CatalogEntry &entry = m_catalog[*it];
+        apps.append(CatalogSync::toJson(entry.app));
+        last = entry.position;
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), catalogVersion());
+    root.insert(QStringLiteral("apps"), apps);
+    root.insert(QStringLiteral("next"), it == m_catalogOrder.cend()
+                ? QString() : m_catalogEpoch + QLatin1Char(':') + QString::number(last));
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+void StandInServer::loadCatalog()
+{
+    QFile file(QDir(m_rootPath).filePath(QStringLiteral(".catalog.json")));
+    if (!file.open(QIODevice::ReadOnly)) return;
+
+    QList<AppInfo> apps;
+    const QJsonArray array = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &value : array) {
+        const AppInfo app = CatalogSync::fromJson(value.toObject());
+        if (!app.id.isEmpty()) {
+            apps.append(app);
+        }
+    }
+    updateCatalog(apps, QStringList());
+}
@@ -0,0 +1,72 @@
+#ifndef STANDINSERVER_H
+#define STANDINSERVER_H
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QTcpServer>
+#include <QString>
+#include "models/appinfo.h"
+
+class SyncTree;
+
+// 本地 HTTP 替身服务器（开发调试用）：把 rootPath 目录下的文件按 HTTP/1.1 提供下载，
+// 支持 HEAD、单段 Range、ETag/Last-Modified、If-Range 和条件请求（If-None-Match、If-Modified-Since 返回 304）；
+// 同时接受 PUT（完整上传）、PATCH（块级增量补丁，基准不一致时返回 409）、按内容分块的去重上传和批量上传，
+// /.tree/<文件夹> 提供同步文件夹的 Merkle 树，供启动前的同步检查使用。
+// /.catalog 提供应用目录的增量同步接口（见 CatalogSync）和游标分页接口（见 CatalogPager），POST /.catalog 修改目录：
+// {"upserts": [应用], "removed": ["<应用ID>", ...]}；启动时从 <目录>/.catalog.json（应用数组）读取初始目录。
+// 用于在没有应用管理平台的环境下验证下载、续传、限速和文件同步。
+// 启动方式：appGo_bench --stand-in-server <目录> [端口]
+class StandInServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit StandInServer(const QString &rootPath, QObject *parent = nullptr);
+    ~StandInServer() override;
+
+    QString rootPath() const { return m_rootPath; }
+    // 根目录下某个文件夹的同步树（已与磁盘同步），文件夹不存在时返回空
+    SyncTree *treeFor(const QString &folder);
+
+    // 应用目录：版本标记为 "<实例标识>:<序号>"，每次修改序号加一；服务器重启后旧标记失效，返回完整目录
+    QString catalogVersion() const;
+    // 修改目录，返回新版本
+    QString updateCatalog(const QList<AppInfo> &upserts, const QStringList &removedIds);
+    // since 之后的变化（CatalogSync 的响应格式）
+    QByteArray catalogChanges(const QString &since) const;
+    // 游标之后的 limit 个应用（CatalogPager 的响应格式）；游标为 "<实例标识>:<上一页最后一个应用的位置>"，
+    // 其他实例的游标从头开始
+    QByteArray catalogPage(const QString &cursor, int limit) const;
+
+    // GET、HEAD 请求延迟多久再响应（毫秒），模拟较慢的网络
+    void setResponseDelay(int msecs) { m_responseDelay = qMax(0, msecs); }
+    int responseDelay() const { return m_responseDelay; }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    struct CatalogEntry {
+        AppInfo app;
+        quint64 created;   // 加入目录时的序号
+        quint64 changed;   // 最后修改时的序号
+        quint64 position;  // 在加入顺序中的位置（每个应用唯一，用作分页游标）
+    };
+
+    void loadCatalog();
+
+private:
+    QString m_rootPath;   // 提供文件的根目录
+    QHash<QString, SyncTree *> m_trees;   // 文件夹 -> 同步树
+    QHash<QString, CatalogEntry> m_catalog;   // 应用ID -> 目录条目
+    QStringList m_catalogOrder;               // 应用的加入顺序
+    QHash<QString, quint64> m_catalogRemoved; // 已删除的应用ID -> 删除时的序号
+    quint64 m_catalogSerial;                  // 目录的当前序号
+    quint64 m_catalogPosition;                // 最后加入的应用的位置
+    QString m_catalogEpoch;                   // 本实例的标识
+    int m_responseDelay;                      // 读请求的延迟（毫秒）
+};
+
+#endif // STANDINSERVER_H
@@ -0,0 +1,20 @@
+#ifndef SYNCJOURNALBENCH_H
+#define SYNCJOURNALBENCH_H
+
+#include <QString>
+
+// 同步日志的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --sync-journal-bench [事件数]
+//     测量同步记录的写入吞吐量（每秒事件数、每次落盘合并的事件数）和启动重放的耗时，
+//     然后做崩溃注入检查：子进程持续写入并报告已提交的日志编号，在随机时刻被强制结束，
+//     重新打开数据库确认报告过的记录全部能够重放。
+//   appGo_bench --sync-journal-writer <数据库>
+//     崩溃注入检查使用的子进程，不单独使用。
+namespace SyncJournalBench {
+
+int run(int events);
+int runWriter(const QString &databasePath);
+
+} // namespace SyncJournalBench
+
+#endif // SYNCJOURNALBENCH_H
@@ -0,0 +1,16 @@
+#ifndef SYNCTREEBENCH_H
+#define SYNCTREEBENCH_H
+
+#include <QString>
+
+// 同步文件夹 Merkle 树的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --sync-tree <目录>
+//     测量首次构建、保存/加载、未变化时的重新扫描和根哈希的耗时（见 SyncTree），
+//     启动前检查的本地部分目标为 100 ms 以内；保存后加载或重新扫描得到的根哈希不一致时返回非零。
+namespace SyncTreeBench {
+
+int run(const QString &rootPath);
+
+} // namespace SyncTreeBench
+
+#endif // SYNCTREEBENCH_H
@@ -0,0 +1,23 @@
+#include "treehashbench.h"
+#include "core/sha256.h"
+#include "core/treehash.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+int TreeHashBench::run(const QString &filePath)
+{
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray hash = TreeHash::hashFile(filePath, &error);
+    const qint64 nsecs = qMax<qint64>(1, timer.nsecsElapsed());
+    if (hash.isEmpty()) {
+        qWarning() << "Tree hash failed:" << error;
+        return 1;
+    }
+    qInfo().noquote() << hash.toHex() << filePath;
+    qInfo() << "Hashed" << QFileInfo(filePath).size() / (1024 * 1024) << "MB in" << nsecs / 1000000 << "ms,"
+            << double(QFileInfo(filePath).size()) / nsecs << "GB/s (" << Sha256::kernelName() << ")";
+    return 0;
+}
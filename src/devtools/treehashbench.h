@@ -0,0 +1,15 @@
+#ifndef TREEHASHBENCH_H
+#define TREEHASHBENCH_H
+
+#include <QString>
+
+// 树哈希的开发调试工具（需要 QCoreApplication）：
+//   appGo_bench --tree-hash <文件>
+//     输出目录中 package_hash 使用的树哈希（见 TreeHash），以及哈希耗时和吞吐量。
+namespace TreeHashBench {
+
+int run(const QString &filePath);
+
+} // namespace TreeHashBench
+
+#endif // TREEHASHBENCH_H
@@ -0,0 +1,433 @@
+#include "uibench.h"
+#include "mainwindow.h"
+#include "models/applistmodel.h"
+#include "widgets/appcard.h"
+#include "widgets/appgridview.h"
+#include "widgets/paginationwidget.h"
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEnterEvent>
+#include <QFile>
+#include <QHBoxLayout>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLabel>
+#include <QLoggingCategory>
+#include <QMouseEvent>
+#include <QPushButton>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const qint64 kMinTotalNs = 200 * 1000 * 1000;   // 每项累计运行时间
+const int kMinIterations = 5;
+const int kMaxIterations = 10000;
+const QSize kWindowSize(1200, 800);
+
+struct Result
+{
+    QString name;
+    int iterations = 0;
+    qint64 minNs = 0;
+    qint64 medianNs = 0;
+    qint64 meanNs = 0;
+};
+
+// 重复执行 body，setup 和 teardown 不计时
+Result measure(const QString &name, const std::function<void()> &body,
+               const std::function<void()> &setup = nullptr, const std::function<void()> &teardown = nullptr)
+{
+    QList<qint64> samples;
+    qint64 total = 0;
+    QElapsedTimer timer;
+    while ((total < kMinTotalNs || samples.size() < kMinIterations) && samples.size() < kMaxIterations) {
+        if (setup) setup();
+        timer.start();
+        body();
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (teardown) teardown();
+        samples.append(elapsed);
+        total += elapsed;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    Result result;
+    result.name = name;
+    result.iterations = samples.size();
+    result.minNs = samples.first();
+    result.medianNs = samples.at(samples.size() / 2);
+    result.meanNs = total / samples.size();
+    qInfo().noquote() << QStringLiteral("%1: %2 iterations, median %3 us")
+                         .arg(name).arg(result.iterations).arg(result.medianNs / 1000.0, 0, 'f', 1);
+    return result;
+}
+
+AppCard *createCard(QWidget *parent, int index)
+{
+    AppCard *card = new AppCard(parent);
+    const QString name = QStringLiteral("应用 %1").arg(index);
+    card->setAppId(name);
+    card->setAppName(name);
+    card->setAppDescription(QStringLiteral("应用描述"));
+    card->setInstalled(index % 3 == 0);
+    return card;
+}
+
+// 改为直接绘制之前的 AppCard：图标、名称、描述是标签，操作是按钮，悬停和按下状态变化时重新设置整张卡片的样式表。
+// 只用于悬停扫过的前后对比
+class StyleSheetCard : public QWidget
+{
+public:
+    explicit StyleSheetCard(QWidget *parent)
+        : QWidget(parent)
+        , m_isHovered(false)
+        , m_isPressed(false)
+    {
+        setFixedSize(280, 100);
+        QHBoxLayout *mainLayout = new QHBoxLayout(this);
+        mainLayout->setContentsMargins(12, 12, 12, 12);
+        mainLayout->setSpacing(12);
+        QLabel *iconLabel = new QLabel(this);
+        iconLabel->setFixedSize(48, 48);
+        mainLayout->addWidget(iconLabel);
+
+        QVBoxLayout *textLayout = new QVBoxLayout();
+        textLayout->setSpacing(4);
+        QLabel *nameLabel = new QLabel(QStringLiteral("应用 0"), this);
+        QFont nameFont = nameLabel->font();
+        nameFont.setPointSize(12);
+        nameFont.setBold(true);
+        nameLabel->setFont(nameFont);
+        textLayout->addWidget(nameLabel);
+        QLabel *descLabel = new QLabel(QStringLiteral("应用描述"), this);
+        descLabel->setWordWrap(true);
+        QFont descFont = descLabel->font();
+        descFont.setPointSize(10);
+        descLabel->setFont(descFont);
+        textLayout->addWidget(descLabel);
+        mainLayout->addLayout(textLayout, 1);
+
+        QPushButton *actionBtn = new QPushButton(QStringLiteral("安装"), this);
+        actionBtn->setFixedSize(80, 32);
+        actionBtn->setFocusPolicy(Qt::NoFocus);
+        mainLayout->addWidget(actionBtn);
+
+        updateStyle();
+        setMouseTracking(true);
+    }
+
+protected:
+    void enterEvent(QEnterEvent *event) override
+    {
+        m_isHovered = true;
+        updateStyle();
+        QWidget::enterEvent(event);
+    }
+
+    void leaveEvent(QEvent *event) override
+    {
+        m_isHovered = false;
+        m_isPressed = false;
+        updateStyle();
+        QWidget::leaveEvent(event);
+    }
+
+private:
+    void updateStyle()
+    {
+        setStyleSheet(QString(
+            "QWidget { background-color: %1; border: 1px solid %2; border-radius: 8px; }"
+            "QLabel { background: transparent; border: none; }"
+            "QPushButton { background-color: #007AFF; color: white; border: none; border-radius: 4px; padding: 4px 12px; }"
+            "QPushButton:hover { background-color: #0056b3; }")
+            .arg(m_isPressed ? "#e8e8e8" : (m_isHovered ? "#f5f5f5" : "#ffffff"))
+            .arg(m_isHovered ? "#e0e0e0" : "#f0f0f0"));
+        setCursor(m_isHovered ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    }
+
+    bool m_isHovered;
+    bool m_isPressed;
+};
+
+// 鼠标扫过卡片：进入、横向移动 20 次、离开，每个事件后立即重绘，共 kHoverFrames 帧
+const int kHoverFrames = 22;
+
+void hoverFrames(QWidget *card)
+{
+    const QRect rect = card->rect();
+    QEnterEvent enter(QPointF(0, rect.center().y()), QPointF(0, rect.center().y()),
+                      card->mapToGlobal(QPointF(0, rect.center().y())));
+    QCoreApplication::sendEvent(card, &enter);
+    card->repaint();
+    for (int i = 0; i < 20; ++i) {
+        const QPointF pos(rect.width() * i / 20.0, rect.height() * (i % 5) / 5.0);
+        QMouseEvent move(QEvent::MouseMove, pos, card->mapToGlobal(pos), Qt::NoButton, Qt::NoButton,
+                         Qt::NoModifier);
+        QCoreApplication::sendEvent(card, &move);
+        card->repaint();
+    }
+    QEvent leave(QEvent::Leave);
+    QCoreApplication::sendEvent(card, &leave);
+    card->repaint();
+}
+
+// 处理排队的布局和绘制
+void flush()
+{
+    QCoreApplication::sendPostedEvents();
+    QCoreApplication::processEvents();
+}
+
+QList<Result> runAll(int cards)
+{
+    QList<Result> results;
+
+    // 1. 添加卡片（控件模式）：每次新建网格并添加 N 张卡片，直到布局完成
+    {
+        AppGridView *grid = nullptr;
+        results.append(measure(QStringLiteral("grid_populate_%1").arg(cards), [&]() {
+            for (int i = 0; i < cards; ++i) {
+                grid->addAppCard(createCard(grid, i));
+            }
+            flush();
+        }, [&]() {
+            grid = new AppGridView;
+            grid->resize(kWindowSize);
+            grid->show();
+            flush();
+        }, [&]() {
+            delete grid;
+            grid = nullptr;
+        }));
+    }
+
+    // 2. 分页控件连续翻页
+    {
+        PaginationWidget pagination;
+        pagination.setTotalPages(100);
+        pagination.resize(kWindowSize.width(), 60);
+        pagination.show();
+        flush();
+        int page = 0;
+        results.append(measure(QStringLiteral("pagination_set_page_x100"), [&]() {
+            for (int i = 0; i < 100; ++i) {
+                page = (page + 37) % 100;
+                pagination.setCurrentPage(page + 1);
+            }
+            flush();
+        }));
+    }
+
+    // 3. 缩放后重新排列：在两种列数之间切换，计时包含 reflow 和随后的布局、绘制；
+    //    连续 30 次缩放（拖动窗口边缘）应只合并为一次重新排列
+    {
+        AppGridView grid;
+        grid.resize(kWindowSize);
+        grid.show();
+        for (int i = 0; i < cards; ++i) {
+            grid.addAppCard(createCard(&grid, i));
+        }
+        flush();
+        bool wide = false;
+        results.append(measure(QStringLiteral("grid_reflow_%1").arg(cards), [&]() {
+            wide = !wide;
+            grid.resize(wide ? QSize(1600, 900) : QSize(900, 700));
+            grid.reflow();
+            flush();
+        }));
+        results.append(measure(QStringLiteral("grid_resize_burst_x30_%1").arg(cards), [&]() {
+            for (int i = 0; i < 30; ++i) {
+                grid.resize(900 + i * 25, 700 + i * 5);
+            }
+            grid.reflow();
+            flush();
+        }));
+    }
+
+    // 4. 鼠标扫过卡片：进入、横向移动 20 次、离开，然后重绘
+    {
+        QWidget host;
+        host.resize(400, 300);
+        AppCard *card = createCard(&host, 0);
+        host.show();
+        flush();
+        const QRect rect = card->rect();
+        results.append(measure(QStringLiteral("card_hover_sweep"), [&]() {
+            QEnterEvent enter(QPointF(0, rect.center().y()), QPointF(0, rect.center().y()),
+                              card->mapToGlobal(QPointF(0, rect.center().y())));
+            QCoreApplication::sendEvent(card, &enter);
+            for (int i = 0; i < 20; ++i) {
+                const QPointF pos(rect.width() * i / 20.0, rect.height() * (i % 5) / 5.0);
+                QMouseEvent move(QEvent::MouseMove, pos, card->mapToGlobal(pos), Qt::NoButton, Qt::NoButton,
+                                 Qt::NoModifier);
+                QCoreApplication::sendEvent(card, &move);
+            }
+            QEvent leave(QEvent::Leave);
+            QCoreApplication::sendEvent(card, &leave);
+            card->repaint();
+        }));
+    }
+
+    // 5. 悬停扫过的逐帧耗时：改为直接绘制之前的样式表卡片与当前的 AppCard 做同样的扫过，
+    //    输出每帧中位数和两者之比
+    {
+        QWidget host;
+        host.resize(400, 300);
+        StyleSheetCard *before = new StyleSheetCard(&host);
+        AppCard *after = createCard(&host, 0);
+        after->move(0, 150);
+        host.show();
+        flush();
+        const Result styled = measure(QStringLiteral("card_hover_frames_x%1_stylesheet").arg(kHoverFrames),
+                                      [&]() { hoverFrames(before); });
+        const Result painted = measure(QStringLiteral("card_hover_frames_x%1_painted").arg(kHoverFrames),
+                                       [&]() { hoverFrames(after); });
+        results.append(styled);
+        results.append(painted);
+        qInfo().noquote() << QStringLiteral("hover frame: stylesheet %1 us, painted %2 us (%3x)")
+                             .arg(styled.medianNs / 1000.0 / kHoverFrames, 0, 'f', 1)
+                             .arg(painted.medianNs / 1000.0 / kHoverFrames, 0, 'f', 1)
+                             .arg(double(styled.medianNs) / qMax<qint64>(1, painted.medianNs), 0, 'f', 1);
+    }
+
+    // 6. 翻页：控件模式（添加卡片后按页显示）与模型模式（委托只绘制当前页）在 100、1 万、10 万个应用下
+    //    依次翻到下一页，计时包含随后的布局和绘制。模型模式的耗时应与应用总数无关；
+    //    控件模式只测到 1 万个，10 万个卡片控件的构建过慢
+    for (int apps : { 100, 10000, 100000 }) {
+        if (apps <= 10000) {
+            AppGridView grid;
+            grid.resize(kWindowSize);
+            grid.show();
+            for (int i = 0; i < apps; ++i) {
+                grid.addAppCard(createCard(&grid, i));
+            }
+            flush();
+            results.append(measure(QStringLiteral("grid_widget_page_switch_%1").arg(apps), [&]() {
+                grid.setCurrentPage(grid.currentPage() % grid.totalPages() + 1);
+                flush();
+            }));
+        }
+
+        QList<AppInfo> infos;
+        infos.reserve(apps);
+        for (int i = 0; i < apps; ++i) {
+            AppInfo info;
+            info.id = QStringLiteral("应用 %1").arg(i);
+            info.name = info.id;
+            info.description = QStringLiteral("应用描述");
+            info.installed = i % 3 == 0;
+            infos.append(info);
+        }
+        AppListModel model;
+        model.setApps(infos);
+        AppGridView grid;
+        grid.resize(kWindowSize);
+        grid.setModel(&model);
+        grid.show();
+        flush();
+        results.append(measure(QStringLiteral("grid_model_page_switch_%1").arg(apps), [&]() {
+            grid.setCurrentPage(grid.currentPage() % grid.totalPages() + 1);
+            flush();
+        }));
+    }
+
+    // 7. 主窗口：构建、显示并处理到首帧
+    {
+        MainWindow *window = nullptr;
+        results.append(measure(QStringLiteral("mainwindow_construct_show"), [&]() {
+            window = new MainWindow;
+            window->resize(kWindowSize);
+            window->show();
+            flush();
+        }, nullptr, [&]() {
+            delete window;
+            window = nullptr;
+            flush();
+        }));
+    }
+
+    return results;
+}
+
+QByteArray toJson(const QList<Result> &results, int cards)
+{
+    QJsonArray array;
+    for (const Result &result : results) {
+        QJsonObject object;
+        object.insert(QStringLiteral("name"), result.name);
+        object.insert(QStringLiteral("iterations"), result.iterations);
+        object.insert(QStringLiteral("min_ns"), result.minNs);
+        object.insert(QStringLiteral("median_ns"), result.medianNs);
+        object.insert(QStringLiteral("mean_ns"), result.meanNs);
+        array.append(object);
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("suite"), QStringLiteral("appGo-ui"));
+    root.insert(QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    root.insert(QStringLiteral("platform"), QGuiApplication::platformName());
+    root.insert(QStringLiteral("cpu"), QSysInfo::currentCpuArchitecture());
+    root.insert(QStringLiteral("cards"), cards);
+    root.insert(QStringLiteral("results"), array);
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray toCsv(const QList<Result> &results)
+{
+    QByteArray csv = "name,iterations,min_ns,median_ns,mean_ns\n";
+    for (const Result &result : results) {
+        csv += result.name.toUtf8() + ',' + QByteArray::number(result.iterations) + ','
+               + QByteArray::number(result.minNs) + ',' + QByteArray::number(result.medianNs) + ','
+               + QByteArray::number(result.meanNs) + '\n';
+    }
+    return csv;
+}
+
+} // namespace
+
+int UiBench::run(const QStringList &arguments)
+{
+    int cards = 100;
+    QString format = QStringLiteral("json");
+    QString outputPath;
+    for (int i = 0; i + 1 < arguments.size(); ++i) {
+        if (arguments.at(i) == QLatin1String("--cards")) {
+            cards = qMax(1, arguments.at(++i).toInt());
+        } else if (arguments.at(i) == QLatin1String("--format")) {
+            format = arguments.at(++i);
+        } else if (arguments.at(i) == QLatin1String("--output")) {
+            outputPath = arguments.at(++i);
+        }
+    }
+    if (format != QLatin1String("json") && format != QLatin1String("csv")) {
+        qWarning() << "Unknown format" << format << "(expected json or csv)";
+        return 1;
+    }
+
+    // 调试输出（翻页耗时等）会影响测量；主窗口的数据库和同步目录放在测试目录，不碰真实数据
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    QStandardPaths::setTestModeEnabled(true);
+
+    const QList<Result> results = runAll(cards);
+    const QByteArray report = format == QLatin1String("csv") ? toCsv(results) : toJson(results, cards);
+
+    if (outputPath.isEmpty()) {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        out.write(report);
+        return 0;
+    }
+    QFile out(outputPath);
+    if (!out.open(QIODevice::WriteOnly) || out.write(report) != report.size()) {
+        qWarning() << "Failed to write" << outputPath;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef UIBENCH_H
+#define UIBENCH_H
+
+#include <QStringList>
+
+// 界面热点路径的基准测试（开发调试工具，需要 QApplication；未设置 QT_QPA_PLATFORM 时使用 offscreen 平台，
+// 没有显示器的 Linux 机器上也能运行）：
+//   appGo_bench --ui-bench [--cards N] [--format json|csv] [--output 文件]
+//     依次测量：向 AppGridView 添加 N 张卡片、PaginationWidget 连续翻页、AppGridView 缩放后的重新排列及连续缩放、
+//     AppCard 悬停扫过、悬停逐帧耗时（与改为直接绘制之前的样式表卡片对比）、
+//     控件模式和模型模式在 100、1 万、10 万个应用下的翻页、完整构建并显示 MainWindow。
+//     每项重复到累计 200ms（至少 5 次），输出每次的最小值、中位数和平均值（纳秒），
+//     结果为 JSON 或 CSV，便于在版本之间比较。
+namespace UiBench {
+
+int run(const QStringList &arguments);
+
+} // namespace UiBench
+
+#endif // UIBENCH_H
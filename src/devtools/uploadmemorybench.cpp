@@ -0,0 +1,182 @@
+#include "uploadmemorybench.h"
+#include "sync/deltauploader.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+const qint64 kMegabyte = 1024 * 1024;
+const qint64 kMaxPeakGrowth = 48 * kMegabyte;   // 每个阶段允许的峰值内存增长
+const int kServerStartTimeoutMs = 10000;
+
+// 从 /proc/self/status 读取内存项（字节）
+qint64 procStatus(const QByteArray &key)
+{
+    QFile file(QStringLiteral("/proc/self/status"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.startsWith(key + ':')) {
+            return line.mid(key.size() + 1).trimmed().split(' ').value(0).toLongLong() * 1024;
+        }
+    }
+    return -1;
+}
+
+// 把峰值内存复位为当前值
+bool resetPeak()
+{
+    QFile file(QStringLiteral("/proc/self/clear_refs"));
+    return file.open(QIODevice::WriteOnly) && file.write("5") == 1;
+}
+
+bool writeRandomFile(const QString &path, int megabytes)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QByteArray block(kMegabyte, Qt::Uninitialized);
+    for (int i = 0; i < megabytes; ++i) {
+        QRandomGenerator::global()->fillRange(reinterpret_cast<quint32 *>(block.data()), block.size() / 4);
+        if (file.write(block) != block.size()) return false;
+    }
+    return true;
+}
+
+// 原地修改文件开头和中间的少量字节，用于补丁上传
+bool modifyFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+    const QByteArray patch(4096, 'x');
+    for (const qint64 offset : {qint64(0), file.size() / 2}) {
+        if (!file.seek(offset) || file.write(patch) != patch.size()) return false;
+    }
+    return true;
+}
+
+bool upload(DeltaUploader *uploader, const QString &filePath, const QUrl &url, qint64 *wireBytes)
+{
+    QEventLoop loop;
+    bool ok = false;
+    const quint64 id = uploader->upload(filePath, url);
+    QObject::connect(uploader, &DeltaUploader::uploaded, &loop, [&](quint64 uploadId, const QString &, qint64 sent, qint64) {
+        if (uploadId != id) return;
+        ok = true;
+        *wireBytes = sent;
+        loop.quit();
+    });
+    QObject::connect(uploader, &DeltaUploader::failed, &loop, [&](quint64 uploadId, const QString &error) {
+        if (uploadId != id) return;
+        qWarning() << "Upload failed:" << error;
+        loop.quit();
+    });
+    loop.exec();
+    return ok;
+}
+
+} // namespace
+
+int UploadMemoryBench::run(int megabytes)
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    if (megabytes <= 0 || procStatus("VmHWM") < 0) {
+        qWarning() << "Upload memory check needs a positive size and /proc/self/status";
+        return 1;
+    }
+
+    QTemporaryDir dir;
+    const QString filePath = dir.filePath(QStringLiteral("upload.dat"));
+    const QString serverRoot = dir.filePath(QStringLiteral("server"));
+    QDir().mkpath(serverRoot);
+    if (!writeRandomFile(filePath, megabytes)) {
+        qWarning() << "Failed to write" << filePath;
+        return 1;
+    }
+
+    // 替身服务器放在子进程中，接收上传的内存不计入本进程
+    QProcess server;
+    server.setProcessChannelMode(QProcess::SeparateChannels);
+    server.start(QCoreApplication::applicationFilePath(),
+                 {QStringLiteral("--stand-in-server"), serverRoot, QStringLiteral("0")});
+    quint16 port = 0;
+    QByteArray serverOutput;
+    QElapsedTimer startTimer;
+    startTimer.start();
+    const QRegularExpression portPattern(QStringLiteral("on port (\\d+)"));
+    while (port == 0 && startTimer.elapsed() < kServerStartTimeoutMs && server.waitForReadyRead(kServerStartTimeoutMs)) {
+        serverOutput += server.readAllStandardError();
+        const QRegularExpressionMatch match = portPattern.match(QString::fromLocal8Bit(serverOutput));
+        if (match.hasMatch()) {
+            port = match.captured(1).toUShort();
+        }
+    }
+    if (port == 0) {
+        qWarning() << "Stand-in server did not start:" << serverOutput;
+        server.kill();
+        return 1;
+    }
+    // 之后服务器的日志直接丢弃，避免管道写满
+    QObject::connect(&server, &QProcess::readyReadStandardError, &server, [&server]() {
+        server.readAllStandardError();
+    });
+
+    const QString baseUrl = QStringLiteral("http://127.0.0.1:%1").arg(port);
+    DeltaUploader fullUploader(dir.filePath(QStringLiteral("signatures-full")));
+    DeltaUploader chunkUploader(dir.filePath(QStringLiteral("signatures-chunk")));
+    chunkUploader.enableChunkUpload(QUrl(baseUrl + QStringLiteral("/.chunks")));
+    chunkUploader.setChunkCompression(true);
+
+    struct Phase {
+        const char *name;
+        DeltaUploader *uploader;
+        QString path;
+    };
+    const Phase phases[] = {
+        {"full", &fullUploader, QStringLiteral("/full.dat")},
+        {"chunks", &chunkUploader, QStringLiteral("/chunked.dat")},
+        {"patch", &chunkUploader, QStringLiteral("/chunked.dat")},   // 块上传后保存了签名，修改后按补丁上传
+    };
+
+    bool passed = true;
+    for (const Phase &phase : phases) {
+        if (qstrcmp(phase.name, "patch") == 0 && !modifyFile(filePath)) {
+            qWarning() << "Failed to modify" << filePath;
+            passed = false;
+            break;
+        }
+        if (!resetPeak()) {
+            qWarning() << "Cannot reset peak RSS (/proc/self/clear_refs)";
+            passed = false;
+            break;
+        }
+        const qint64 baseline = procStatus("VmRSS");
+        QElapsedTimer timer;
+        timer.start();
+        qint64 wireBytes = 0;
+        const bool ok = upload(phase.uploader, filePath, QUrl(baseUrl + phase.path), &wireBytes);
+        const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+        const qint64 growth = procStatus("VmHWM") - baseline;
+        const bool phasePassed = ok && growth <= kMaxPeakGrowth;
+        qInfo().noquote() << QStringLiteral("%1: %2 MB in %3 ms (%4 MB/s), %5 bytes sent, peak RSS +%6 MB (limit %7 MB) - %8")
+                             .arg(QLatin1String(phase.name)).arg(megabytes).arg(elapsed)
+                             .arg(megabytes * 1000 / elapsed).arg(wireBytes)
+                             .arg(double(growth) / kMegabyte, 0, 'f', 1).arg(kMaxPeakGrowth / kMegabyte)
+                             .arg(phasePassed ? QStringLiteral("PASS") : QStringLiteral("FAIL"));
+        passed = passed && phasePassed;
+    }
+
+    server.kill();
+    server.waitForFinished();
+    return passed ? 0 : 1;
+}
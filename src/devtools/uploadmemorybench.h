@@ -0,0 +1,14 @@
+#ifndef UPLOADMEMORYBENCH_H
+#define UPLOADMEMORYBENCH_H
+
+// 大文件上传的内存检查（开发调试工具，需要 QCoreApplication，仅 Linux）：
+//   appGo_bench --upload-memory [MB]
+//     生成指定大小的随机文件，启动本地替身服务器子进程，依次做完整上传、压缩的块上传和修改后的补丁上传，
+//     每个阶段从 /proc/self/status 读取峰值内存（VmHWM），增长超过上限时返回非零。
+namespace UploadMemoryBench {
+
+int run(int megabytes);
+
+} // namespace UploadMemoryBench
+
+#endif // UPLOADMEMORYBENCH_H
@@ -0,0 +1,353 @@
+#include "installscheduler.h"
+#include "processinstaller.h"
+#include "core/taskscheduler.h"
+#include "core/treehash.h"
+#include "network/downloadmanager.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QUrl>
+
+namespace {
+
+const int kDownloadLimit = 4;
+const int kVerifyLimit = 2;
+const int kInstallLimit = 1;   // 大多数安装程序不能同时运行
+
+// 各阶段结束时的整体进度
+const int kStageEndPercent[InstallScheduler::StageCount] = { 90, 95, 100 };
+
+} // namespace
+
+InstallScheduler::InstallScheduler(DownloadManager *downloads, const QString &packageDir, QObject *parent)
+    : QObject(parent)
+    , m_downloads(downloads)
+    , m_installer(nullptr)
+    , m_defaultInstaller(new ProcessInstaller(this))
+    , m_packageDir(packageDir)
+    , m_nextId(1)
+    , m_nextSequence(0)
+{
+    m_limits[Download] = kDownloadLimit;
+    m_limits[Verify] = kVerifyLimit;
+    m_limits[Install] = kInstallLimit;
+    for (int stage = 0; stage < StageCount; ++stage) {
+        m_running[stage] = 0;
+    }
+
+    connect(m_downloads, &DownloadManager::progressChanged, this, &InstallScheduler::handleDownloadProgress);
+    connect(m_downloads, &DownloadManager::finished, this, &InstallScheduler::handleDownloadFinished);
+    connect(m_downloads, &DownloadManager::failed, this, &InstallScheduler::handleDownloadFailed);
+
+    setInstaller(m_defaultInstaller);
+}
+
+InstallScheduler::~InstallScheduler() = default;
+
+void InstallScheduler::setInstaller(PackageInstaller *installer)
+{
+    if (!installer) {
+        installer = m_defaultInstaller;
+    }
+    if (m_installer) {
+        disconnect(m_installer, nullptr, this, nullptr);
+    }
+    m_installer = installer;
+    connect(m_installer, &PackageInstaller::finished, this, &InstallScheduler::handleInstallFinished);
+}
+
+void InstallScheduler::setStageLimit(Stage stage, int limit)
+{
+    m_limits[stage] = qMax(1, limit);
+    schedule();
+}
+
+quint64 InstallScheduler::enqueue(const AppInfo &app, int priority)
+{
+    if (m_jobByApp.contains(app.id)) {
+        return m_jobByApp.value(app.id);
+    }
+
+    Job job;
+    job.id = m_nextId++;
+    job.app = app;
+    job.priority = priority;
+    job.sequence = m_nextSequence++;
+
+    m_jobs.insert(job.id, job);
+    m_jobByApp.insert(app.id, job.id);
+    setPercent(m_jobs[job.id], 0);
+
+    schedule();
+    return job.id;
+}
+
+void InstallScheduler::cancel(quint64 jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) return;
+
+    // 校验在线程池中无法中断，任务移除后其结果会被忽略
+    if (it->running) {
+        if (it->stage == Download) {
+            m_downloads->cancel(it->downloadId);
+        } else if (it->stage == Install) {
+            m_installer->cancel(jobId);
+        }
+    }
+    finishJob(jobId, false, QStringLiteral("已取消"));
+}
+
+void InstallScheduler::setPriority(quint64 jobId, int priority)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->priority == priority) return;
+
+    it->priority = priority;
+    schedule();
+}
+
+void InstallScheduler::schedule()
+{
+    // 先推进后面的阶段，让已下载的任务尽快进入安装
+    for (int stage = StageCount - 1; stage >= 0; --stage) {
+        while (m_running[stage] < m_limits[stage]) {
+            const quint64 jobId = pickNext(Stage(stage));
+            if (jobId == 0) break;
+            startStage(jobId);
+        }
+    }
+}
+
+quint64 InstallScheduler::pickNext(Stage stage) const
+{
+    const Job *best = nullptr;
+    for (const Job &job : m_jobs) {
+        if (job.stage != stage || job.running) continue;
+        if (!best || job.priority > best->priority
+            || (job.priority == best->priority && job.sequence < best->sequence)) {
+            best = &job;
+        }
+    }
+    return best ? best->id : 0;
+}
+
+void InstallScheduler::startStage(quint64 jobId)
+{
+    Job &job = m_jobs[jobId];
+    const Stage stage = job.stage;
+    const QString appId = job.app.id;
+    job.running = true;
+    ++m_running[stage];
+    job.stageTimer.start();
+    emit stageStarted(jobId, appId, stage);
+
+    // 槽函数中可能加入或取消任务（m_jobs 可能重新分配），按编号重新查找；任务已被取消时不再启动
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->stage != stage || !it->running) return;
+
+    switch (stage) {
+    case Download:
+        startDownload(*it);
+        break;
+    case Verify:
+        startVerify(*it);
+        break;
+    case Install:
+        m_installer->install(jobId, appId, it->packagePath);
+        break;
+    default:
+        break;
+    }
+}
+
+void InstallScheduler::startDownload(Job &job)
+{
+    const quint64 jobId = job.id;
+    job.packagePath = packagePathFor(job.app);
+    job.actualHash.clear();
+
+    // 之前已下载完成的安装包直接进入校验（由校验阶段重新计算哈希）
+    if (QFileInfo::exists(job.packagePath)) {
+        QMetaObject::invokeMethod(this, [this, jobId]() { finishStage(jobId); }, Qt::QueuedConnection);
+        return;
+    }
+    if (job.app.packageUrl.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this, jobId]() {
+            finishJob(jobId, false, QStringLiteral("没有安装包下载地址"));
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    job.downloadId = m_downloads->download(QUrl(job.app.packageUrl), job.packagePath, job.app.packageHash);
+    m_jobByDownload.insert(job.downloadId, jobId);
+}
+
+void InstallScheduler::startVerify(Job &job)
+{
+    const quint64 jobId = job.id;
+
+    // 下载时已经计算了哈希，只需要比较
+    if (job.app.packageHash.isEmpty() || !job.actualHash.isEmpty()) {
+        if (job.app.packageHash.isEmpty()) {
+            qWarning() << "No package hash for" << job.app.id << ", skipping verification";
+        }
+        const QByteArray hash = QByteArray::fromHex(job.actualHash.toLatin1());
+        QMetaObject::invokeMethod(this, [this, jobId, hash]() {
+            handleVerifyFinished(jobId, hash, QString());
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    // 缓存中的安装包需要重新读取计算，用户正在等待安装，按交互优先级执行
+    QPointer<InstallScheduler> guard(this);
+    const QString packagePath = job.packagePath;
+    TaskScheduler::instance()->start(TaskScheduler::Interactive, [guard, jobId, packagePath]() {
+        QString error;
+        const QByteArray hash = TreeHash::hashFile(packagePath, &error);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, jobId, hash, error]() {
+            if (guard) {
+                guard->handleVerifyFinished(jobId, hash, error);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void InstallScheduler::handleVerifyFinished(quint64 jobId, const QByteArray &hash, const QString &error)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->stage != Verify || !it->running) return;
+
+    if (!error.isEmpty()) {
+        finishJob(jobId, false, QStringLiteral("读取安装包失败：%1").arg(error));
+        return;
+    }
+
+    const QString expected = it->app.packageHash;
+    if (expected.isEmpty() || QString::fromLatin1(hash.toHex()).compare(expected, Qt::CaseInsensitive) == 0) {
+        finishStage(jobId);
+        return;
+    }
+
+    // 缓存的安装包与目录不一致（通常是版本已更新），删除后重新下载一次
+    QFile::remove(it->packagePath);
+    if (it->actualHash.isEmpty() && !it->redownloaded) {
+        --m_running[Verify];
+        it->running = false;
+        it->redownloaded = true;
+        it->stage = Download;
+        schedule();
+        return;
+    }
+    finishJob(jobId, false, QStringLiteral("安装包校验失败"));
+}
+
+void InstallScheduler::handleDownloadProgress(quint64 downloadId, qint64 bytesReceived, qint64 bytesTotal,
+                                              qint64 bytesPerSecond)
+{
+    Q_UNUSED(bytesPerSecond);
+    const quint64 jobId = m_jobByDownload.value(downloadId);
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || bytesTotal <= 0) return;
+
+    setPercent(*it, int(bytesReceived * kStageEndPercent[Download] / bytesTotal));
+}
+
+void InstallScheduler::handleDownloadFinished(quint64 downloadId, const QString &filePath, const QString &hash)
+{
+    Q_UNUSED(filePath);
+    const quint64 jobId = m_jobByDownload.take(downloadId);
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) return;
+
+    it->actualHash = hash;
+    finishStage(jobId);
+}
+
+void InstallScheduler::handleDownloadFailed(quint64 downloadId, const QString &error)
+{
+    const quint64 jobId = m_jobByDownload.take(downloadId);
+    if (m_jobs.contains(jobId)) {
+        finishJob(jobId, false, error);
+    }
+}
+
+void InstallScheduler::handleInstallFinished(quint64 jobId, bool ok, const QString &error)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || it->stage != Install || !it->running) return;
+
+    if (ok) {
+        finishStage(jobId);
+    } else {
+        finishJob(jobId, false, error);
+    }
+}
+
+void InstallScheduler::finishStage(quint64 jobId)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end() || !it->running) return;
+
+    const Stage stage = it->stage;
+    const QString appId = it->app.id;
+    const qint64 msecs = it->stageTimer.elapsed();
+    --m_running[stage];
+    it->running = false;
+    emit stageFinished(jobId, appId, stage, msecs);
+
+    if (stage == Install) {
+        finishJob(jobId, true, QString());
+        return;
+    }
+
+    // 同 startStage：发出信号后重新查找，任务可能已被取消
+    it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) return;
+    it->stage = Stage(stage + 1);
+    setPercent(*it, kStageEndPercent[stage]);
+    schedule();
+}
+
+void InstallScheduler::finishJob(quint64 jobId, bool ok, const QString &error)
+{
+    auto it = m_jobs.find(jobId);
+    if (it == m_jobs.end()) return;
+
+    if (it->running) {
+        --m_running[it->stage];
+    }
+    m_jobByDownload.remove(it->downloadId);
+
+    // 安装成功后删除安装包，释放磁盘空间
+    if (ok) {
+        QFile::remove(it->packagePath);
+    }
+
+    const QString appId = it->app.id;
+    m_jobByApp.remove(appId);
+    m_jobs.erase(it);
+    emit jobFinished(jobId, appId, ok, error);
+
+    schedule();
+}
+
+void InstallScheduler::setPercent(Job &job, int percent)
+{
+    if (percent == job.percent) return;
+
+    job.percent = percent;
+    emit progressChanged(job.id, job.app.id, percent);
+}
+
+QString InstallScheduler::packagePathFor(const AppInfo &app) const
+{
+    QString fileName = QUrl(app.packageUrl).fileName();
+    if (fileName.isEmpty()) {
+        fileName = QStringLiteral("package");
+    }
+    return QDir(m_packageDir).filePath(app.id + QLatin1Char('/') + fileName);
+}
@@ -0,0 +1,102 @@
+#ifndef INSTALLSCHEDULER_H
+#define INSTALLSCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include "models/appinfo.h"
+
+class DownloadManager;
+class PackageInstaller;
+
+// 安装队列：每个任务依次经过 下载 -> 校验 -> 安装 三个阶段，
+// 各阶段有独立的并发上限，不同任务的阶段流水线并行（第 N+1 个下载时第 N 个在安装）。
+// 等待中的任务按优先级（大的优先）和加入顺序调度。
+class InstallScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage {
+        Download,
+        Verify,
+        Install,
+        StageCount
+    };
+    Q_ENUM(Stage)
+
+    InstallScheduler(DownloadManager *downloads, const QString &packageDir, QObject *parent = nullptr);
+    ~InstallScheduler() override;
+
+    // 替换安装步骤的实现（不持有）；默认使用 ProcessInstaller
+    void setInstaller(PackageInstaller *installer);
+    PackageInstaller *installer() const { return m_installer; }
+
+    // 各阶段的并发上限，默认 下载 4、校验 2、安装 1
+    void setStageLimit(Stage stage, int limit);
+    int stageLimit(Stage stage) const { return m_limits[stage]; }
+
+    // 加入队列，返回任务编号；同一应用已在队列中时返回已有的编号
+    quint64 enqueue(const AppInfo &app, int priority = 0);
+    void cancel(quint64 jobId);
+    void setPriority(quint64 jobId, int priority);
+
+    bool isQueued(const QString &appId) const { return m_jobByApp.contains(appId); }
+
+signals:
+    void stageStarted(quint64 jobId, const QString &appId, InstallScheduler::Stage stage);
+    void stageFinished(quint64 jobId, const QString &appId, InstallScheduler::Stage stage, qint64 msecs);
+    // 整体进度（0-100）：下载占 0-90，校验 90-95，安装 95-100
+    void progressChanged(quint64 jobId, const QString &appId, int percent);
+    void jobFinished(quint64 jobId, const QString &appId, bool ok, const QString &error);
+
+private slots:
+    void handleDownloadProgress(quint64 downloadId, qint64 bytesReceived, qint64 bytesTotal, qint64 bytesPerSecond);
+    void handleDownloadFinished(quint64 downloadId, const QString &filePath, const QString &hash);
+    void handleDownloadFailed(quint64 downloadId, const QString &error);
+    void handleInstallFinished(quint64 jobId, bool ok, const QString &error);
+    void handleVerifyFinished(quint64 jobId, const QByteArray &hash, const QString &error);
+
+private:
+    struct Job {
+        quint64 id = 0;
+        AppInfo app;
+        int priority = 0;
+        quint64 sequence = 0;     // 加入顺序，优先级相同时先进先出
+        Stage stage = Download;
+        bool running = false;     // 当前阶段是否正在执行
+        QString packagePath;
+        QString actualHash;       // 下载时计算出的树哈希
+        quint64 downloadId = 0;
+        int percent = -1;
+        bool redownloaded = false; // 缓存的安装包校验失败后已重新下载过
+        QElapsedTimer stageTimer;  // 当前阶段的耗时（stageFinished）
+    };
+
+    void schedule();
+    quint64 pickNext(Stage stage) const;
+    // 按编号启动任务的当前阶段，stageStarted 的槽函数可能修改 m_jobs，不持有任务的引用
+    void startStage(quint64 jobId);
+    void startDownload(Job &job);
+    void startVerify(Job &job);
+    void finishStage(quint64 jobId);
+    void finishJob(quint64 jobId, bool ok, const QString &error);
+    void setPercent(Job &job, int percent);
+    QString packagePathFor(const AppInfo &app) const;
+
+private:
+    DownloadManager *m_downloads;
+    PackageInstaller *m_installer;
+    PackageInstaller *m_defaultInstaller;
+    QString m_packageDir;                   // 安装包缓存目录
+    int m_limits[StageCount];
+    int m_running[StageCount];
+    QHash<quint64, Job> m_jobs;
+    QHash<QString, quint64> m_jobByApp;     // 应用ID -> 任务编号
+    QHash<quint64, quint64> m_jobByDownload; // 下载编号 -> 任务编号
+    quint64 m_nextId;
+    quint64 m_nextSequence;
+};
+
+#endif // INSTALLSCHEDULER_H
@@ -0,0 +1,26 @@
+#ifndef PACKAGEINSTALLER_H
+#define PACKAGEINSTALLER_H
+
+#include <QObject>
+#include <QString>
+
+// 安装步骤的扩展点：InstallScheduler 只通过这个接口执行安装，
+// 可以替换为调用系统安装程序、脚本或测试用的假安装器
+class PackageInstaller : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PackageInstaller(QObject *parent = nullptr) : QObject(parent) {}
+    ~PackageInstaller() override = default;
+
+    // 开始安装，完成后发出 finished（可以异步）
+    virtual void install(quint64 jobId, const QString &appId, const QString &packagePath) = 0;
+    // 取消进行中的安装，之后不再发出该任务的 finished
+    virtual void cancel(quint64 jobId) = 0;
+
+signals:
+    void finished(quint64 jobId, bool ok, const QString &error);
+};
+
+#endif // PACKAGEINSTALLER_H
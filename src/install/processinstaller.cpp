@@ -0,0 +1,119 @@
+#include "processinstaller.h"
+#include <QFileInfo>
+#include <QProcess>
+#include <QTimer>
+
+namespace {
+
+const int kDefaultTimeout = 30 * 60 * 1000;   // 大型安装包可能需要较长时间
+
+QStringList substitute(const QStringList &arguments, const QString &appId, const QString &packagePath)
+{
+    QStringList result;
+    result.reserve(arguments.size());
+    for (QString argument : arguments) {
+        argument.replace(QLatin1String("{package}"), packagePath);
+        argument.replace(QLatin1String("{appId}"), appId);
+        result.append(argument);
+    }
+    return result;
+}
+
+} // namespace
+
+ProcessInstaller::ProcessInstaller(QObject *parent)
+    : PackageInstaller(parent)
+    , m_timeout(kDefaultTimeout)
+{
+}
+
+ProcessInstaller::~ProcessInstaller()
+{
+    for (QProcess *process : std::as_const(m_processes)) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+    }
+    qDeleteAll(m_processes);
+}
+
+void ProcessInstaller::setCommand(const QString &program, const QStringList &arguments)
+{
+    m_program = program;
+    m_arguments = arguments;
+}
+
+void ProcessInstaller::install(quint64 jobId, const QString &appId, const QString &packagePath)
+{
+    QString program;
+    QStringList arguments;
+    if (!m_program.isEmpty()) {
+        program = substitute({ m_program }, appId, packagePath).first();
+        arguments = substitute(m_arguments, appId, packagePath);
+    } else {
+#ifdef Q_OS_WIN
+        if (QFileInfo(packagePath).suffix().compare(QLatin1String("msi"), Qt::CaseInsensitive) == 0) {
+            program = QStringLiteral("msiexec");
+            arguments = { QStringLiteral("/i"), packagePath, QStringLiteral("/qn"), QStringLiteral("/norestart") };
+        } else {
+            program = packagePath;
+            arguments = { QStringLiteral("/S") };
+        }
+#else
+        // 使用 QTimer 延后发出，保证调用方总是异步收到结果
+        QTimer::singleShot(0, this, [this, jobId]() {
+            emit finished(jobId, false, QStringLiteral("未配置安装命令"));
+        });
+        return;
+#endif
+    }
+
+    QProcess *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    m_processes.insert(jobId, process);
+
+    connect(process, &QProcess::finished, this, [this, jobId]() { handleFinished(jobId); });
+    connect(process, &QProcess::errorOccurred, this, [this, jobId](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            handleFinished(jobId);
+        }
+    });
+
+    // 超时后结束进程，按失败处理
+    QTimer::singleShot(m_timeout, process, [process]() { process->kill(); });
+
+    process->start(program, arguments);
+}
+
+void ProcessInstaller::cancel(quint64 jobId)
+{
+    QProcess *process = m_processes.take(jobId);
+    if (!process) return;
+
+    process->disconnect(this);
+    process->kill();
+    connect(process, &QProcess::finished, process, &QObject::deleteLater);
+}
+
+void ProcessInstaller::handleFinished(quint64 jobId)
+{
+    QProcess *process = m_processes.take(jobId);
+    if (!process) return;
+
+    bool ok = false;
+    QString error;
+    if (process->error() == QProcess::FailedToStart) {
+        error = QStringLiteral("无法启动安装程序：%1").arg(process->errorString());
+    } else if (process->exitStatus() != QProcess::NormalExit) {
+        error = QStringLiteral("安装程序异常退出");
+    } else if (process->exitCode() != 0) {
+        error = QStringLiteral("安装程序返回错误码 %1：%2")
+                    .arg(process->exitCode())
+                    .arg(QString::fromLocal8Bit(process->readAll()).trimmed().right(200));
+    } else {
+        ok = true;
+    }
+
+    process->deleteLater();
+    emit finished(jobId, ok, error);
+}
@@ -0,0 +1,38 @@
+#ifndef PROCESSINSTALLER_H
+#define PROCESSINSTALLER_H
+
+#include <QHash>
+#include <QStringList>
+#include "packageinstaller.h"
+
+class QProcess;
+
+// 通过外部进程静默安装。命令中的 {package} 和 {appId} 会被替换为安装包路径和应用ID。
+// 未设置命令时：Windows 上 .msi 使用 msiexec /qn，其他安装包以 /S 参数直接运行；
+// 其他平台必须设置命令（例如测试用的假安装脚本：sh fake-install.sh {package} {appId}）。
+class ProcessInstaller : public PackageInstaller
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessInstaller(QObject *parent = nullptr);
+    ~ProcessInstaller() override;
+
+    void setCommand(const QString &program, const QStringList &arguments);
+    // 单个安装进程的超时时间
+    void setTimeout(int msecs) { m_timeout = msecs; }
+
+    void install(quint64 jobId, const QString &appId, const QString &packagePath) override;
+    void cancel(quint64 jobId) override;
+
+private:
+    void handleFinished(quint64 jobId);
+
+private:
+    QString m_program;
+    QStringList m_arguments;
+    int m_timeout;
+    QHash<quint64, QProcess*> m_processes;  // 进行中的安装进程
+};
+
+#endif // PROCESSINSTALLER_H
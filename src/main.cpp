@@ -1,12 +1,49 @@
 #include <QApplication>
+#include <QDebug>
 #include "mainwindow.h"
+#include "core/stalldetector.h"
+#include "core/trace.h"
+#include <QDateTime>
+#include <QDir>
+#include <QScopedPointer>
+#include <QShortcut>
+#include <QStandardPaths>
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
     
+    // APPGO_TRACE=1 时记录热点路径的追踪区间，Ctrl+Alt+T 导出到 <AppData>/traces
+    const QString traceDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/traces";
+    if (qEnvironmentVariableIntValue("APPGO_TRACE") != 0) {
+        Trace::setEnabled(true);
+    }
+    
+    // 界面线程卡顿检测只在设置 APPGO_STALL_MS（阈值，毫秒）时开启，否则不安装事件过滤器和调度器钩子；
+    // 启用追踪时卡顿后自动导出
+    const int stallThreshold = qEnvironmentVariableIntValue("APPGO_STALL_MS");
+    QScopedPointer<StallDetector> stallDetector;
+    if (stallThreshold > 0) {
+        stallDetector.reset(new StallDetector(stallThreshold));
+        stallDetector->setDumpDirectory(traceDir);
+        stallDetector->start(QThread::LowPriority);
+    }
+    
     MainWindow window;
     window.showFullScreen();
     
+    QShortcut *traceShortcut = new QShortcut(QKeySequence(QStringLiteral("Ctrl+Alt+T")), &window);
+    QObject::connect(traceShortcut, &QShortcut::activated, &window, [traceDir]() {
+        if (!Trace::isEnabled()) return;
+        QDir().mkpath(traceDir);
+        const QString path = traceDir + "/trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".json";
+        QString error;
+        if (Trace::dump(path, &error)) {
+            qInfo() << "Trace written to" << path;
+        } else {
+            qWarning() << "Failed to write trace:" << error;
+        }
+    });
+    
     return app.exec();
 } 
\ No newline at end of file
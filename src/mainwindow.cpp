@@ -1,13 +1,92 @@
 #include "mainwindow.h"
-#include "widgets/appcard.h"
 #include "widgets/appgridview.h"
+#include "models/applistmodel.h"
+#include "models/catalogfiltermodel.h"
+#include "models/catalogstore.h"
+#include "models/searchfiltermodel.h"
+#include "core/iconservice.h"
+#include "core/taskscheduler.h"
+#include "core/trace.h"
+#include "storage/localstore.h"
+#include "network/catalogpager.h"
+#include "network/catalogsync.h"
+#include "network/downloadmanager.h"
+#include "install/installscheduler.h"
+#include "install/processinstaller.h"
+#include "sync/deltauploader.h"
+#include "sync/folderwatcher.h"
+#include "sync/syncdispatcher.h"
+#include "sync/syncstate.h"
+#include <QEvent>
+#include <QProcess>
 #include <QVBoxLayout>
 #include <QTabWidget>
+#include <QLineEdit>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QUrl>
+#include <QDebug>
+
+namespace {
+
+// 测试数据
+const QStringList kStoreApps = {
+    "微信", "QQ", "钉钉", "企业微信", "腾讯会议",
+    "网易云音乐", "QQ音乐", "酷狗音乐", "酷我音乐", "虾米音乐",
+    "Chrome", "Firefox", "Edge", "Opera", "Safari",
+    "VSCode", "Sublime Text", "Atom", "WebStorm", "PyCharm",
+    "PhotoShop", "Illustrator", "Premiere", "After Effects", "Lightroom"
+};
+
+const QStringList kInstalledApps = {
+    "微信", "QQ", "Chrome", "VSCode", "PhotoShop",
+    "网易云音乐", "钉钉", "企业微信", "Firefox", "Sublime Text",
+    "QQ音乐", "腾讯会议", "Edge", "Atom", "Illustrator"
+};
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , m_store(new LocalStore(this))
+    , m_tabs(nullptr)
+    , m_storeGrid(nullptr)
+    , m_installedTab(nullptr)
+    , m_installedGrid(nullptr)
+    , m_catalog(nullptr)
+    , m_searchModel(nullptr)
+    , m_installedModel(nullptr)
+    , m_catalogSync(nullptr)
+    , m_catalogVersionRequest(0)
+    , m_catalogPager(nullptr)
+    , m_downloads(nullptr)
+    , m_installs(nullptr)
+    , m_syncWatcher(nullptr)
+    , m_syncState(nullptr)
+    , m_syncChecker(nullptr)
+    , m_uploader(nullptr)
+    , m_syncDispatcher(nullptr)
+    , m_firstFrameShown(false)
+    , m_interactive(false)
 {
+    m_startupTimer.start();
+    
+    // 首帧之前只创建可见的应用商城页签；数据库在自己的线程打开，第一页数据读出后显示。
+    // 其余初始化在首帧之后按顺序逐个执行，每次事件循环一项，不阻塞输入
+    setupStorage();
     setupUI();
+    // 设置 APPGO_CATALOG_URL（例如 <本地替身服务器地址>/.catalog）后目录从服务器增量同步，不写入测试数据
+    const QString catalogUrl = qEnvironmentVariable("APPGO_CATALOG_URL");
+    if (catalogUrl.isEmpty()) {
+        defer("test data", [this]() { seedTestData(); });
+    } else {
+        defer("catalog sync", [this, catalogUrl]() { setupCatalogSync(catalogUrl); });
+    }
+    defer("installer", [this]() { setupInstaller(); });
+    defer("sync", [this]() { setupSync(); });
 }
 
 MainWindow::~MainWindow() = default;
@@ -29,11 +108,11 @@ void MainWindow::setupUI()
     mainLayout->setSpacing(0);
     
     // 创建标签页
-    QTabWidget *tabWidget = new QTabWidget(this);
-    mainLayout->addWidget(tabWidget);
+    m_tabs = new QTabWidget(this);
+    mainLayout->addWidget(m_tabs);
     
     // 设置标签页样式
-    tabWidget->setStyleSheet(
+    m_tabs->setStyleSheet(
         "QTabWidget::pane {"
         "  border: none;"
         "  background: white;"
@@ -57,82 +136,561 @@ void MainWindow::setupUI()
     QVBoxLayout *storeLayout = new QVBoxLayout(storeTab);
     AppGridView *storeGrid = new AppGridView(storeTab);
     storeLayout->addWidget(storeGrid);
+    m_storeGrid = storeGrid;
     
-    // 添加测试卡片到应用商城
-    QStringList storeApps = {
-        "微信", "QQ", "钉钉", "企业微信", "腾讯会议",
-        "网易云音乐", "QQ音乐", "酷狗音乐", "酷我音乐", "虾米音乐",
-        "Chrome", "Firefox", "Edge", "Opera", "Safari",
-        "VSCode", "Sublime Text", "Atom", "WebStorm", "PyCharm",
-        "PhotoShop", "Illustrator", "Premiere", "After Effects", "Lightroom"
-    };
-    
-    for (const QString &appName : storeApps) {
-        AppCard *card = new AppCard(storeGrid);
-        card->setAppName(appName);
-        card->setInstalled(false);
-        storeGrid->addAppCard(card);
-    }
-    
-    // 创建已安装标签页
-    QWidget *installedTab = new QWidget();
-    QVBoxLayout *installedLayout = new QVBoxLayout(installedTab);
-    AppGridView *installedGrid = new AppGridView(installedTab);
-    installedLayout->addWidget(installedGrid);
-    
-    // 添加测试卡片到已安装
-    QStringList installedApps = {
-        "微信", "QQ", "Chrome", "VSCode", "PhotoShop",
-        "网易云音乐", "钉钉", "企业微信", "Firefox", "Sublime Text",
-        "QQ音乐", "腾讯会议", "Edge", "Atom", "Illustrator"
-    };
-    
-    for (const QString &appName : installedApps) {
-        AppCard *card = new AppCard(installedGrid);
-        card->setAppName(appName);
-        card->setInstalled(true);
-        installedGrid->addAppCard(card);
-    }
+    // 应用商城条目较多，使用模型模式，两个页签共用内存中的同一份目录，
+    // 搜索结果通过过滤模型驱动网格和分页
+    m_catalog = new CatalogStore(m_store, this);
+    m_searchModel = new SearchFilterModel(this);
+    m_searchModel->setSourceModel(m_catalog);
+    // 目录整体加载后在后台重建搜索索引，按行变化时只更新变化的条目
+    connect(m_catalog, &CatalogStore::reloaded, this, &MainWindow::reloadSearchIndex);
+    connect(m_catalog, &CatalogStore::entriesChanged, this, &MainWindow::updateSearchIndex);
+    // 上次的目录快照直接读取显示，不等待数据库；目录更新后按新快照更新变化的行
+    m_catalog->loadSnapshot(m_catalogSnapshotPath);
+    storeGrid->setModel(m_searchModel);
+    // APPGO_CONTINUOUS_SCROLL=1 时不分页、滚动到末尾时继续加载；APPGO_PREFETCH=0 时不预取相邻页
+    storeGrid->setContinuousScroll(qEnvironmentVariableIntValue("APPGO_CONTINUOUS_SCROLL") != 0);
+    storeGrid->setPrefetchEnabled(qEnvironmentVariable("APPGO_PREFETCH") != QLatin1String("0"));
+    
+    // 搜索栏：支持名称、拼音和首字母
+    QLineEdit *searchEdit = new QLineEdit(storeTab);
+    searchEdit->setPlaceholderText("搜索应用（支持拼音和首字母）");
+    searchEdit->setClearButtonEnabled(true);
+    searchEdit->setFixedHeight(36);
+    searchEdit->setStyleSheet(
+        "QLineEdit {"
+        "  border: 1px solid #dee2e6;"
+        "  border-radius: 18px;"
+        "  padding: 0 16px;"
+        "  background: #f8f9fa;"
+        "}"
+        "QLineEdit:focus {"
+        "  border-color: #007bff;"
+        "  background: white;"
+        "}"
+    );
+    storeLayout->insertWidget(0, searchEdit);
+    
+    connect(searchEdit, &QLineEdit::textChanged, this, [this, storeGrid](const QString &text) {
+        m_searchModel->setQuery(text);
+        storeGrid->setCurrentPage(1);
+    });
+    
+    // 已安装页签先放一个空页面，第一次切换过去时才创建网格
+    m_installedTab = new QWidget();
+    new QVBoxLayout(m_installedTab);
     
     // 添加标签页到QTabWidget
-    tabWidget->addTab(storeTab, "应用商城");
-    tabWidget->addTab(installedTab, "已安装");
+    m_tabs->addTab(storeTab, "应用商城");
+    m_tabs->addTab(m_installedTab, "已安装");
+    connect(m_tabs, &QTabWidget::currentChanged, this, [this](int index) {
+        if (m_tabs->widget(index) == m_installedTab && !m_installedGrid) {
+            buildInstalledTab();
+        }
+    });
+    
+    connectGrid(storeGrid);
+    
+    // 页签第一次绘制后记录首帧时间，并开始执行推迟的初始化
+    m_tabs->installEventFilter(this);
+}
+
+void MainWindow::buildInstalledTab()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    m_installedGrid = new AppGridView(m_installedTab);
+    m_installedTab->layout()->addWidget(m_installedGrid);
+    
+    // 已安装的应用是目录的过滤视图，按名称排序；安装完成后自动出现在这里
+    m_installedModel = new CatalogFilterModel(m_catalog, this);
+    m_installedModel->setInstalledOnly(true);
+    m_installedModel->setSortByName(true);
+    m_installedGrid->setModel(m_installedModel);
+    
+    connectGrid(m_installedGrid);
+    qDebug() << "Installed tab built in" << timer.elapsed() << "ms";
+}
+
+void MainWindow::connectGrid(AppGridView *grid)
+{
+    // 安装进度显示在卡片上；安装器还没有创建时由 setupInstaller 连接
+    if (m_installs) {
+        connectInstallProgress(grid);
+    }
+    
+    connect(grid, &AppGridView::cardClicked, this, &MainWindow::handleCardClicked);
+    connect(grid, &AppGridView::cardDoubleClicked, this, &MainWindow::handleCardDoubleClicked);
+    connect(grid, &AppGridView::cardInstallClicked, this, &MainWindow::handleCardInstall);
+    connect(grid, &AppGridView::cardUninstallClicked, this, &MainWindow::handleCardUninstall);
+    connect(grid, &AppGridView::cardStartClicked, this, &MainWindow::handleCardStart);
+}
+
+void MainWindow::seedTestData()
+{
+    // 测试数据写入本地数据库（一个事务），写入后目录变化信号刷新网格和搜索索引。
+    // 设置 APPGO_PACKAGE_BASE_URL（例如本地替身服务器地址）后，安装包地址为 <地址>/<应用名>.exe
+    const QString packageBaseUrl = qEnvironmentVariable("APPGO_PACKAGE_BASE_URL");
+    QList<AppInfo> storeInfos;
+    storeInfos.reserve(kStoreApps.size());
+    for (const QString &appName : kStoreApps) {
+        AppInfo info;
+        info.id = appName;
+        info.name = appName;
+        info.description = "应用描述";
+        if (!packageBaseUrl.isEmpty()) {
+            info.packageUrl = packageBaseUrl + "/" + appName + ".exe";
+        }
+        storeInfos.append(info);
+    }
+    m_store->replaceCatalog(storeInfos);
+    
+    for (const QString &appName : kInstalledApps) {
+        m_store->setInstalled(appName, QString(), QString());
+    }
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_tabs && event->type() == QEvent::Paint && !m_firstFrameShown) {
+        m_firstFrameShown = true;
+        m_tabs->removeEventFilter(this);
+        // 绘制结果在本轮事件处理结束时提交到屏幕，之后再记录和开始后续初始化
+        QTimer::singleShot(0, this, [this]() {
+            qDebug() << "Startup: first frame after" << m_startupTimer.elapsed() << "ms";
+            runDeferredTask();
+        });
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::defer(const char *name, const std::function<void()> &task)
+{
+    m_deferredTasks.append({name, task});
+}
+
+void MainWindow::runDeferredTask()
+{
+    if (m_deferredTasks.isEmpty()) {
+        if (!m_interactive) {
+            m_interactive = true;
+            qDebug() << "Startup: interactive after" << m_startupTimer.elapsed() << "ms";
+        }
+        return;
+    }
+    
+    const DeferredTask task = m_deferredTasks.takeFirst();
+    QElapsedTimer timer;
+    timer.start();
+    {
+        TRACE_SPAN("startup", task.name);
+        task.run();
+    }
+    qDebug() << "Startup task" << task.name << "took" << timer.elapsed() << "ms";
+    
+    // 下一项留到下一轮事件循环，中间可以处理输入和绘制
+    QTimer::singleShot(0, this, &MainWindow::runDeferredTask);
+}
+
+void MainWindow::finishDeferredStartup()
+{
+    // 首帧之后不久用户就操作了需要这些初始化的功能，立即完成剩下的部分
+    while (!m_deferredTasks.isEmpty()) {
+        runDeferredTask();
+    }
+    runDeferredTask();
+}
+
+void MainWindow::setupStorage()
+{
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    
+    connect(m_store, &LocalStore::opened, this, [](bool ok, const QString &error) {
+        if (!ok) {
+            qWarning() << "Failed to open local store:" << error;
+        }
+    });
+    connect(m_store, &LocalStore::errorOccurred, this, [](const QString &message) {
+        qWarning() << "Local store error:" << message;
+    });
+    
+    // 每次提交目录后在数据库线程重写快照，图标缩略图取自图标磁盘缓存
+    m_catalogSnapshotPath = dataDir + "/catalog.snapshot";
+    m_store->setCatalogSnapshot(m_catalogSnapshotPath, IconService::instance()->diskCacheDir());
+    m_store->open(dataDir + "/appgo.db");
+}
+
+void MainWindow::setupSync()
+{
+    // 同步根目录下每个应用一个子目录；监视事件先更新各应用的 Merkle 树，内容确实变化时才记录和上传
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    m_syncRoot = dataDir + "/sync";
+    QDir().mkpath(m_syncRoot);
+    
+    m_syncState = new SyncState(m_syncRoot, dataDir + "/synctrees", this);
+    connect(m_syncState, &SyncState::fileChanged, this,
+            [this](const QString &appId, const QString &relativePath, const QString &filePath) {
+        recordSyncChange(appId, relativePath, filePath, false);
+    });
+    connect(m_syncState, &SyncState::fileRemoved, this, [this](const QString &appId, const QString &relativePath) {
+        recordSyncChange(appId, relativePath, QString(), true);
+    });
+    m_syncState->load();
+    
+    m_syncWatcher = new FolderWatcher(this);
+    connect(m_syncWatcher, &FolderWatcher::fileSettled, m_syncState, &SyncState::handleFileSettled);
+    connect(m_syncWatcher, &FolderWatcher::fileRemoved, m_syncState, &SyncState::handleFileRemoved);
+    connect(m_syncWatcher, &FolderWatcher::directoryRemoved, m_syncState, &SyncState::handleDirectoryRemoved);
+    connect(m_syncWatcher, &FolderWatcher::rescanNeeded, m_syncState, &SyncState::rescan);
+    connect(m_syncWatcher, &FolderWatcher::errorOccurred, this, [](const QString &message) {
+        qWarning() << "Sync watcher error:" << message;
+    });
+    m_syncWatcher->addFolder(m_syncRoot);
+    
+    // 设置 APPGO_SYNC_BASE_URL（例如本地替身服务器地址）后，变化的文件上传到 <地址>/<应用ID>/<相对路径>，
+    // 再次修改时只上传变化的部分；启动应用前与服务器比较 Merkle 树，拉取较新的文件
+    m_syncBaseUrl = qEnvironmentVariable("APPGO_SYNC_BASE_URL");
+    if (!m_syncBaseUrl.isEmpty()) {
+        m_uploader = new DeltaUploader(dataDir + "/signatures", this);
+        // 新文件按内容分块上传，服务器已有的块（其他文件或其他应用中的相同内容）不再重复发送
+        m_uploader->enableChunkUpload(QUrl(m_syncBaseUrl + "/.chunks"));
+        // 块不再复制到本地块存储，删除之前留下的 chunks 目录
+        TaskScheduler::instance()->start(TaskScheduler::Background, [chunkDir = dataDir + "/chunks"]() {
+            QDir(chunkDir).removeRecursively();
+        });
+        // APPGO_SYNC_COMPRESS=1 时块压缩后发送，适合上行带宽较小的网络
+        m_uploader->setChunkCompression(qEnvironmentVariableIntValue("APPGO_SYNC_COMPRESS") != 0);
+        connect(m_uploader, &DeltaUploader::failed, this, [](quint64, const QString &error) {
+            qWarning() << "Sync upload failed:" << error;
+        });
+        // 同步日志中的记录合并后上传：小文件和删除批量发送，大文件并发上传；启动时先重放上次未完成的记录
+        m_syncDispatcher = new SyncDispatcher(m_store, m_uploader, m_syncRoot, m_syncBaseUrl, this);
+        m_syncDispatcher->start();
+        
+        m_syncChecker = new SyncChecker(m_syncState, this);
+        connect(m_syncChecker, &SyncChecker::finished, this,
+                [this](quint64, const QString &appId, const QList<SyncChecker::RemoteFile> &newer) {
+            handleSyncChecked(appId, newer);
+        });
+        connect(m_syncChecker, &SyncChecker::failed, this,
+                [this](quint64, const QString &appId, const QString &error) {
+            // 无法连接服务器时使用本地文件启动
+            qWarning() << "Sync check failed:" << error;
+            launchApp(appId);
+        });
+        connect(m_downloads, &DownloadManager::finished, this, [this](quint64 id) {
+            handleSyncPullDone(id, true);
+        });
+        connect(m_downloads, &DownloadManager::failed, this, [this](quint64 id, const QString &error) {
+            if (m_syncPulls.contains(id)) {
+                qWarning() << "Sync pull failed:" << error;
+            }
+            handleSyncPullDone(id, false);
+        });
+    }
+    
+    // 启动前必须拉取完成的文件（文件名模式，以分号分隔），默认全部；其余文件在启动后继续拉取
+    const QString requiredPatterns = qEnvironmentVariable("APPGO_SYNC_REQUIRED", "*");
+    m_launchRequiredPatterns = requiredPatterns.split(';', Qt::SkipEmptyParts);
+}
+
+void MainWindow::recordSyncChange(const QString &appId, const QString &relativePath, const QString &filePath,
+                                  bool removed)
+{
+    SyncRecord record;
+    record.appId = appId;
+    record.relativePath = relativePath;
+    if (removed) {
+        record.operation = SyncRecord::Removed;
+    } else {
+        const QFileInfo info(filePath);
+        record.operation = SyncRecord::Modified;
+        record.size = info.size();
+        record.mtime = info.lastModified().toMSecsSinceEpoch();
+    }
+    // 记录落盘后由 SyncDispatcher 上传
+    m_store->appendSyncRecords({record});
+}
+
+void MainWindow::handleSyncChecked(const QString &appId, const QList<SyncChecker::RemoteFile> &newer)
+{
+    int blockers = 0;
+    for (const SyncChecker::RemoteFile &file : newer) {
+        const QString localPath = m_syncState->folderFor(appId) + "/" + file.relativePath;
+        QDir().mkpath(QFileInfo(localPath).absolutePath());
+        
+        SyncPull pull;
+        pull.appId = appId;
+        pull.relativePath = file.relativePath;
+        pull.hash = file.hash;
+        pull.required = QDir::match(m_launchRequiredPatterns, QFileInfo(localPath).fileName());
+        const quint64 id = m_downloads->download(QUrl(m_syncBaseUrl + "/" + appId + "/" + file.relativePath),
+                                                 localPath, QString::fromLatin1(file.hash.toHex()));
+        m_syncPulls.insert(id, pull);
+        if (pull.required) {
+            ++blockers;
+        }
+    }
     
-    // 连接信号
-    connect(storeGrid, &AppGridView::cardClicked, this, &MainWindow::handleCardClicked);
-    connect(storeGrid, &AppGridView::cardDoubleClicked, this, &MainWindow::handleCardDoubleClicked);
-    connect(storeGrid, &AppGridView::cardInstallClicked, this, &MainWindow::handleCardInstall);
-    connect(storeGrid, &AppGridView::cardUninstallClicked, this, &MainWindow::handleCardUninstall);
-    connect(storeGrid, &AppGridView::cardStartClicked, this, &MainWindow::handleCardStart);
+    if (blockers == 0) {
+        launchApp(appId);
+    } else {
+        qDebug() << "Waiting for" << blockers << "synced files before starting" << appId;
+        m_launchBlockers.insert(appId, blockers);
+    }
+}
+
+void MainWindow::handleSyncPullDone(quint64 downloadId, bool ok)
+{
+    const auto it = m_syncPulls.constFind(downloadId);
+    if (it == m_syncPulls.constEnd()) return;
+    const SyncPull pull = it.value();
+    m_syncPulls.erase(it);
     
-    connect(installedGrid, &AppGridView::cardClicked, this, &MainWindow::handleCardClicked);
-    connect(installedGrid, &AppGridView::cardDoubleClicked, this, &MainWindow::handleCardDoubleClicked);
-    connect(installedGrid, &AppGridView::cardInstallClicked, this, &MainWindow::handleCardInstall);
-    connect(installedGrid, &AppGridView::cardUninstallClicked, this, &MainWindow::handleCardUninstall);
-    connect(installedGrid, &AppGridView::cardStartClicked, this, &MainWindow::handleCardStart);
+    if (ok) {
+        m_syncState->markPulled(pull.appId, pull.relativePath, pull.hash);
+    }
+    // 拉取失败时仍然启动，应用使用本地已有的版本
+    if (pull.required && m_launchBlockers.contains(pull.appId) && --m_launchBlockers[pull.appId] == 0) {
+        m_launchBlockers.remove(pull.appId);
+        launchApp(pull.appId);
+    }
+}
+
+void MainWindow::launchApp(const QString &appId)
+{
+    m_launching.remove(appId);
+    qDebug() << "Starting:" << appId;
+}
+
+void MainWindow::setupInstaller()
+{
+    m_downloads = new DownloadManager(this);
+    
+    const QString packageDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/packages";
+    m_installs = new InstallScheduler(m_downloads, packageDir, this);
+    
+    // 安装命令可以通过环境变量替换，例如 Linux 上用假安装脚本测试：
+    // APPGO_INSTALLER_COMMAND="sh fake-install.sh {package} {appId}"
+    const QStringList command = QProcess::splitCommand(qEnvironmentVariable("APPGO_INSTALLER_COMMAND"));
+    if (!command.isEmpty()) {
+        ProcessInstaller *installer = new ProcessInstaller(this);
+        installer->setCommand(command.first(), command.mid(1));
+        m_installs->setInstaller(installer);
+    }
+    
+    connect(m_installs, &InstallScheduler::jobFinished, this,
+            [this](quint64 jobId, const QString &appId, bool ok, const QString &error) {
+        Q_UNUSED(jobId);
+        if (ok) {
+            // 内存中的目录只更新这一行，两个页签随之刷新；数据库另行落盘
+            m_catalog->setInstalled(appId, true);
+            m_store->setInstalled(appId, QString(), QString());
+        } else {
+            qWarning() << "Install failed:" << appId << error;
+        }
+    });
+    
+    // 安装进度显示在已经创建的页签的卡片上
+    connectInstallProgress(m_storeGrid);
+    if (m_installedGrid) {
+        connectInstallProgress(m_installedGrid);
+    }
+}
+
+void MainWindow::connectInstallProgress(AppGridView *grid)
+{
+    connect(m_installs, &InstallScheduler::progressChanged, grid,
+            [grid](quint64 jobId, const QString &appId, int percent) {
+        Q_UNUSED(jobId);
+        grid->setAppProgress(appId, percent);
+    });
+    connect(m_installs, &InstallScheduler::jobFinished, grid,
+            [grid](quint64 jobId, const QString &appId) {
+        Q_UNUSED(jobId);
+        grid->setAppProgress(appId, -1);
+    });
 }
 
-void MainWindow::handleCardClicked(AppCard *card)
+void MainWindow::setupCatalogSync(const QString &catalogUrl)
 {
-    qDebug() << "Card clicked:" << card->appName();
+    m_catalogSync = new CatalogSync(QUrl(catalogUrl), this);
+    connect(m_catalogSync, &CatalogSync::deltaReady, this, &MainWindow::handleCatalogDelta);
+    connect(m_catalogSync, &CatalogSync::failed, this, [](const QString &error) {
+        qWarning() << "Catalog sync failed:" << error;
+    });
+
+    // 先读出上次同步的版本，之后只请求这之后的变化；APPGO_CATALOG_SYNC_INTERVAL 为定期同步的间隔（秒）。
+    // 从未同步过且设置了 APPGO_CATALOG_PAGE_SIZE 时不下载完整目录，先读第一页，
+    // 其余的页在滚动或预取需要时读取（见 CatalogStore::fetchMore），读完后再开始增量同步
+    const int pageSize = qEnvironmentVariableIntValue("APPGO_CATALOG_PAGE_SIZE");
+    connect(m_store, &LocalStore::catalogVersionReady, this,
+            [this, catalogUrl, pageSize](quint64 requestId, const QString &version) {
+        if (requestId != m_catalogVersionRequest) return;
+        m_catalogVersionRequest = 0;
+        m_catalogVersion = version;
+        if (version.isEmpty() && pageSize > 0) {
+            m_catalogPager = new CatalogPager(QUrl(catalogUrl), pageSize, this);
+            connect(m_catalogPager, &CatalogPager::pageReady, this, &MainWindow::handleCatalogPage);
+            connect(m_catalogPager, &CatalogPager::failed, this, [](const QString &error) {
+                qWarning() << "Catalog page failed:" << error;
+            });
+            m_catalog->setPager(m_catalogPager);
+            m_catalogPager->fetchNext();
+            return;
+        }
+        m_catalogSync->fetch(m_catalogVersion);
+    });
+    m_catalogVersionRequest = m_store->requestCatalogVersion();
+
+    const int interval = qEnvironmentVariableIntValue("APPGO_CATALOG_SYNC_INTERVAL");
+    QTimer *timer = new QTimer(this);
+    timer->setInterval((interval > 0 ? interval : 300) * 1000);
+    connect(timer, &QTimer::timeout, this, [this]() {
+        if (m_catalogVersionRequest == 0 && !m_catalogPager) {
+            m_catalogSync->fetch(m_catalogVersion);
+        }
+    });
+    timer->start();
+}
+
+void MainWindow::handleCatalogPage(const QList<AppInfo> &apps, bool last)
+{
+    TRACE_SPAN("catalog", "MainWindow::handleCatalogPage");
+    // 每一页追加到内存中的目录（已有的应用按行更新），由目录随后写入数据库
+    for (const AppInfo &app : apps) {
+        m_pagedAppIds.insert(app.id);
+    }
+    m_catalog->applyDelta(apps, QStringList());
+    if (!last) return;
+
+    // 读完后删除本地有而各页中都没有的应用，保存第一页的版本并从这个版本增量同步，补齐分页期间的变化
+    QStringList removed;
+    const QStringList localIds = m_catalog->appIds();
+    for (const QString &appId : localIds) {
+        if (!m_pagedAppIds.contains(appId)) {
+            removed.append(appId);
+        }
+    }
+    if (!removed.isEmpty()) {
+        m_catalog->applyDelta(QList<AppInfo>(), removed);
+    }
+    m_pagedAppIds.clear();
+
+    m_catalogVersion = m_catalogPager->version();
+    m_store->setCatalogVersion(m_catalogVersion);
+    m_catalog->setPager(nullptr);
+    m_catalogPager->deleteLater();
+    m_catalogPager = nullptr;
+    m_catalogSync->fetch(m_catalogVersion);
 }
 
-void MainWindow::handleCardDoubleClicked(AppCard *card)
+void MainWindow::handleCatalogDelta(const QString &version, bool full, const QList<AppInfo> &upserts,
+                                    const QStringList &removedIds)
 {
-    qDebug() << "Card double clicked:" << card->appName();
+    TRACE_SPAN("catalog", "MainWindow::handleCatalogDelta");
+    // 完整目录：本地有而服务器没有的应用视为删除
+    QStringList removed = removedIds;
+    if (full) {
+        QSet<QString> remoteIds;
+        remoteIds.reserve(upserts.size());
+        for (const AppInfo &app : upserts) {
+            remoteIds.insert(app.id);
+        }
+        const QStringList localIds = m_catalog->appIds();
+        for (const QString &appId : localIds) {
+            if (!remoteIds.contains(appId)) {
+                removed.append(appId);
+            }
+        }
+    }
+
+    // 内存中的目录立即按行更新，页面不重置；目录随后写入数据库，提交后的快照只包含这些修改，不再重新加载
+    m_catalog->applyDelta(upserts, removed);
+    m_store->setCatalogVersion(version);
+    m_catalogVersion = version;
 }
 
-void MainWindow::handleCardInstall(AppCard *card)
+void MainWindow::reloadSearchIndex()
 {
-    qDebug() << "Installing:" << card->appName();
+    // 名称和描述取自内存中的目录，索引在后台线程构建
+    QList<SearchEntry> entries;
+    entries.reserve(m_catalog->rowCount());
+    for (int row = 0; row < m_catalog->rowCount(); ++row) {
+        SearchEntry entry;
+        entry.row = row;
+        entry.name = m_catalog->name(row);
+        entry.description = m_catalog->description(row);
+        entries.append(entry);
+    }
+    m_searchModel->setEntries(entries);
 }
 
-void MainWindow::handleCardUninstall(AppCard *card)
+void MainWindow::updateSearchIndex(const QList<int> &removedRows, const QList<int> &changedRows)
 {
-    qDebug() << "Uninstalling:" << card->appName();
+    // 只取变化的行，索引在界面线程直接更新；增量积累过多时整体重建
+    QList<SearchEntry> entries;
+    entries.reserve(changedRows.size());
+    for (int row : changedRows) {
+        SearchEntry entry;
+        entry.row = row;
+        entry.name = m_catalog->name(row);
+        entry.description = m_catalog->description(row);
+        entries.append(entry);
+    }
+    if (!m_searchModel->updateEntries(removedRows, entries)) {
+        reloadSearchIndex();
+    }
 }
 
-void MainWindow::handleCardStart(AppCard *card)
+void MainWindow::handleCardClicked(const QString &appId)
 {
-    qDebug() << "Starting:" << card->appName();
+    qDebug() << "Card clicked:" << appId;
+}
+
+void MainWindow::handleCardDoubleClicked(const QString &appId)
+{
+    qDebug() << "Card double clicked:" << appId;
+}
+
+void MainWindow::handleCardInstall(const QString &appId)
+{
+    // 卡片信号只携带应用ID，名称和安装包从目录读取（两个页签的网格都是目录的视图）
+    const int row = m_catalog->rowOfApp(appId);
+    if (row < 0) {
+        qWarning() << "Install requested for unknown app:" << appId;
+        return;
+    }
+    qDebug() << "Installing:" << m_catalog->name(row);
+    finishDeferredStartup();
+    
+    const QModelIndex index = m_catalog->index(row);
+    AppInfo app;
+    app.id = appId;
+    app.name = m_catalog->name(row);
+    app.packageUrl = index.data(AppListModel::PackageUrlRole).toString();
+    app.packageHash = index.data(AppListModel::PackageHashRole).toString();
+    m_installs->enqueue(app);
+}
+
+void MainWindow::handleCardUninstall(const QString &appId)
+{
+    qDebug() << "Uninstalling:" << appId;
+}
+
+void MainWindow::handleCardStart(const QString &appId)
+{
+    if (m_launching.contains(appId)) return;
+    finishDeferredStartup();
+    
+    // 启动前确认同步文件夹是最新的；没有配置同步服务器时直接启动
+    if (!m_syncChecker) {
+        launchApp(appId);
+        return;
+    }
+    m_launching.insert(appId);
+    m_syncChecker->check(appId, QUrl(m_syncBaseUrl + "/.tree/" + appId));
 }
\ No newline at end of file
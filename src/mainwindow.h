@@ -2,8 +2,28 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include "models/appinfo.h"
+#include "sync/syncchecker.h"
+#include <functional>
 
-class AppCard;
+class AppGridView;
+class CatalogFilterModel;
+class CatalogPager;
+class CatalogStore;
+class CatalogSync;
+class DeltaUploader;
+class DownloadManager;
+class FolderWatcher;
+class InstallScheduler;
+class LocalStore;
+class SearchFilterModel;
+class SyncDispatcher;
+class SyncState;
 class QTabWidget;
 
 class MainWindow : public QMainWindow
@@ -14,15 +34,85 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
-    void handleCardClicked(AppCard *card);
-    void handleCardDoubleClicked(AppCard *card);
-    void handleCardInstall(AppCard *card);
-    void handleCardUninstall(AppCard *card);
-    void handleCardStart(AppCard *card);
+    void handleCardClicked(const QString &appId);
+    void handleCardDoubleClicked(const QString &appId);
+    void handleCardInstall(const QString &appId);
+    void handleCardUninstall(const QString &appId);
+    void handleCardStart(const QString &appId);
 
 private:
     void setupUI();
+    void buildInstalledTab();
+    void connectGrid(AppGridView *grid);
+    void seedTestData();
+    void defer(const char *name, const std::function<void()> &task);
+    void runDeferredTask();
+    void finishDeferredStartup();
+    void setupStorage();
+    void setupInstaller();
+    void setupSync();
+    void setupCatalogSync(const QString &catalogUrl);
+    void handleCatalogPage(const QList<AppInfo> &apps, bool last);
+    void handleCatalogDelta(const QString &version, bool full, const QList<AppInfo> &upserts,
+                            const QStringList &removedIds);
+    void recordSyncChange(const QString &appId, const QString &relativePath, const QString &filePath, bool removed);
+    void handleSyncChecked(const QString &appId, const QList<SyncChecker::RemoteFile> &newer);
+    void handleSyncPullDone(quint64 downloadId, bool ok);
+    void launchApp(const QString &appId);
+    void connectInstallProgress(AppGridView *grid);
+    void reloadSearchIndex();
+    void updateSearchIndex(const QList<int> &removedRows, const QList<int> &changedRows);
+
+private:
+    LocalStore *m_store;                  // 本地数据库
+    QTabWidget *m_tabs;                   // 应用商城 / 已安装
+    AppGridView *m_storeGrid;             // 应用商城网格
+    QWidget *m_installedTab;              // 已安装页签，首次切换时才创建内容
+    AppGridView *m_installedGrid;         // 已安装网格（创建前为空）
+    CatalogStore *m_catalog;              // 应用目录，两个页签共用
+    SearchFilterModel *m_searchModel;     // 应用商城搜索过滤
+    CatalogFilterModel *m_installedModel; // 已安装的应用（页签创建前为空）
+    QString m_catalogSnapshotPath;        // 目录快照，启动时直接读取显示
+    CatalogSync *m_catalogSync;           // 目录增量同步（未配置服务器时为空）
+    QString m_catalogVersion;             // 最近一次同步得到的目录版本
+    quint64 m_catalogVersionRequest;      // 读取已保存目录版本的请求
+    CatalogPager *m_catalogPager;         // 本地还没有目录时按页读取（读完后为空）
+    QSet<QString> m_pagedAppIds;          // 按页读取时已收到的应用
+    DownloadManager *m_downloads;         // 安装包下载
+    InstallScheduler *m_installs;         // 安装队列
+    FolderWatcher *m_syncWatcher;         // 同步文件夹监视
+    SyncState *m_syncState;               // 各应用同步文件夹的 Merkle 树
+    SyncChecker *m_syncChecker;           // 启动前同步检查（未配置服务器时为空）
+    QString m_syncRoot;                   // 同步根目录，每个应用一个子目录
+    DeltaUploader *m_uploader;            // 同步文件上传（未配置服务器时为空）
+    SyncDispatcher *m_syncDispatcher;     // 同步日志上传调度（未配置服务器时为空）
+    QString m_syncBaseUrl;                // 同步上传地址
+    
+    // 启动前从服务器拉取的文件
+    struct SyncPull {
+        QString appId;
+        QString relativePath;
+        QByteArray hash;
+        bool required = false;            // 应用启动前必须拉取完成
+    };
+    QHash<quint64, SyncPull> m_syncPulls;  // 下载编号 -> 拉取的文件
+    QHash<QString, int> m_launchBlockers;  // 应用ID -> 尚未完成的必需文件数
+    QSet<QString> m_launching;            // 正在检查或等待拉取的应用
+    QStringList m_launchRequiredPatterns; // 启动前必须拉取的文件名模式
+    
+    // 启动计时与首帧之后执行的初始化
+    struct DeferredTask {
+        const char *name;
+        std::function<void()> run;
+    };
+    QElapsedTimer m_startupTimer;         // 从创建主窗口开始计时
+    QList<DeferredTask> m_deferredTasks;  // 尚未执行的初始化，首帧之后逐个执行
+    bool m_firstFrameShown;
+    bool m_interactive;                   // 初始化全部完成
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef APPINFO_H
+#define APPINFO_H
+
+#include <QString>
+
+// 单个应用的目录信息
+struct AppInfo
+{
+    QString id;           // 应用唯一标识
+    QString name;         // 应用名称
+    QString description;  // 应用描述
+    QString iconPath;     // 图标路径
+    QString packageUrl;   // 安装包下载地址
+    QString packageHash;  // 安装包树哈希（十六进制，见 TreeHash）
+    bool installed = false; // 是否已安装
+};
+
+#endif // APPINFO_H
@@ -0,0 +1,101 @@
+#include "applistmodel.h"
+
+AppListModel::AppListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+AppListModel::~AppListModel() = default;
+
+int AppListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_apps.size();
+}
+
+QVariant AppListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_apps.size()) {
+        return QVariant();
+    }
+
+    const AppInfo &app = m_apps.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return app.name;
+    case Qt::ToolTipRole:
+    case DescriptionRole:
+        return app.description;
+    case AppIdRole:
+        return app.id;
+    case IconPathRole:
+        return app.iconPath;
+    case InstalledRole:
+        return app.installed;
+    case PackageUrlRole:
+        return app.packageUrl;
+    case PackageHashRole:
+        return app.packageHash;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> AppListModel::roleNames() const
+{
+    return {
+        { AppIdRole, "appId" },
+        { NameRole, "name" },
+        { DescriptionRole, "description" },
+        { IconPathRole, "iconPath" },
+        { InstalledRole, "installed" },
+        { PackageUrlRole, "packageUrl" },
+        { PackageHashRole, "packageHash" }
+    };
+}
+
+void AppListModel::setApps(const QList<AppInfo> &apps)
+{
+    beginResetModel();
+    m_apps = apps;
+    m_rowById.clear();
+    rebuildIdIndex(0);
+    endResetModel();
+}
+
+void AppListModel::appendApps(const QList<AppInfo> &apps)
+{
+    if (apps.isEmpty()) return;
+
+    const int first = m_apps.size();
+    beginInsertRows(QModelIndex(), first, first + apps.size() - 1);
+    m_apps.append(apps);
+    rebuildIdIndex(first);
+    endInsertRows();
+}
+
+void AppListModel::clear()
+{
+    beginResetModel();
+    m_apps.clear();
+    m_rowById.clear();
+    endResetModel();
+}
+
+void AppListModel::setInstalled(int row, bool installed)
+{
+    if (row < 0 || row >= m_apps.size() || m_apps[row].installed == installed) return;
+
+    m_apps[row].installed = installed;
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { InstalledRole });
+}
+
+void AppListModel::rebuildIdIndex(int fromRow)
+{
+    for (int i = fromRow; i < m_apps.size(); ++i) {
+        if (!m_apps[i].id.isEmpty()) {
+            m_rowById.insert(m_apps[i].id, i);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef APPLISTMODEL_H
+#define APPLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include "appinfo.h"
+
+// 应用列表模型：只保存数据，不创建任何界面对象
+class AppListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        AppIdRole = Qt::UserRole + 1,
+        NameRole,
+        DescriptionRole,
+        IconPathRole,
+        InstalledRole,
+        PackageUrlRole,
+        PackageHashRole,
+        ThumbnailRole       // 图标缩略图（PNG），只有目录快照提供
+    };
+
+    explicit AppListModel(QObject *parent = nullptr);
+    ~AppListModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // 数据操作
+    void setApps(const QList<AppInfo> &apps);
+    void appendApps(const QList<AppInfo> &apps);
+    void clear();
+    void setInstalled(int row, bool installed);
+
+    // 数据访问
+    const AppInfo &appAt(int row) const { return m_apps.at(row); }
+    int rowOfApp(const QString &appId) const { return m_rowById.value(appId, -1); }
+
+private:
+    void rebuildIdIndex(int fromRow);
+
+private:
+    QList<AppInfo> m_apps;          // 应用数据
+    QHash<QString, int> m_rowById;  // 应用ID到行号的索引
+};
+
+#endif // APPLISTMODEL_H
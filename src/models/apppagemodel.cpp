@@ -0,0 +1,190 @@
+#include "apppagemodel.h"
+
+AppPageModel::AppPageModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+    , m_offset(0)
+    , m_pageSize(10)
+    , m_rows(0)
+{
+}
+
+AppPageModel::~AppPageModel() = default;
+
+void AppPageModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged,
+                this, &AppPageModel::handleSourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::modelReset,
+                this, &AppPageModel::handleSourceStructureChanged);
+        connect(sourceModel, &QAbstractItemModel::layoutChanged,
+                this, &AppPageModel::handleSourceStructureChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted,
+                this, &AppPageModel::handleSourceRowsChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved,
+                this, &AppPageModel::handleSourceRowsChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsMoved,
+                this, &AppPageModel::handleSourceStructureChanged);
+    }
+
+    m_rows = pageRows();
+    endResetModel();
+    emit sourceRowCountChanged(sourceModel ? sourceModel->rowCount() : 0);
+}
+
+void AppPageModel::setPage(int offset, int pageSize)
+{
+    offset = qMax(0, offset);
+    pageSize = qMax(1, pageSize);
+    if (offset == m_offset && pageSize == m_pageSize) return;
+
+    const int oldRows = rowCount();
+    const int oldPageSize = m_pageSize;
+    const int oldOffset = m_offset;
+    m_offset = offset;
+    m_pageSize = pageSize;
+    const int newRows = pageRows();
+
+    // 行数不变时只通知数据变化，视图无需重新布局
+    if (oldRows == newRows && oldPageSize == pageSize) {
+        if (newRows > 0) {
+            emit dataChanged(index(0, 0), index(newRows - 1, 0));
+        }
+        return;
+    }
+
+    // 偏移量不变（连续滚动加载更多、调整每页条数）：只在页尾插入或删除行
+    if (offset == oldOffset) {
+        if (newRows > oldRows) {
+            beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+            m_rows = newRows;
+            endInsertRows();
+        } else if (newRows < oldRows) {
+            beginRemoveRows(QModelIndex(), newRows, oldRows - 1);
+            m_rows = newRows;
+            endRemoveRows();
+        }
+        return;
+    }
+
+    // 页大小或末页行数变化时，页内重置的代价也只与每页行数相关
+    beginResetModel();
+    m_rows = newRows;
+    endResetModel();
+}
+
+QModelIndex AppPageModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || column < 0
+        || row >= rowCount() || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex AppPageModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int AppPageModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int AppPageModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return sourceModel()->columnCount();
+}
+
+QModelIndex AppPageModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel()) return QModelIndex();
+    return sourceModel()->index(m_offset + proxyIndex.row(), proxyIndex.column());
+}
+
+QModelIndex AppPageModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) return QModelIndex();
+
+    const int row = sourceIndex.row() - m_offset;
+    if (row < 0 || row >= rowCount()) return QModelIndex();
+    return createIndex(row, sourceIndex.column());
+}
+
+bool AppPageModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) return false;
+    // 页内还没有填满已有的行时不需要更多数据，避免视图在普通翻页时触发读取
+    return m_offset + m_pageSize >= sourceModel()->rowCount() && sourceModel()->canFetchMore(QModelIndex());
+}
+
+void AppPageModel::fetchMore(const QModelIndex &parent)
+{
+    if (canFetchMore(parent)) {
+        sourceModel()->fetchMore(QModelIndex());
+    }
+}
+
+void AppPageModel::handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                           const QList<int> &roles)
+{
+    // 只转发与当前页相交的部分
+    const int first = qMax(topLeft.row(), m_offset);
+    const int last = qMin(bottomRight.row(), m_offset + rowCount() - 1);
+    if (first > last) return;
+
+    emit dataChanged(index(first - m_offset, topLeft.column()),
+                     index(last - m_offset, bottomRight.column()),
+                     roles);
+}
+
+void AppPageModel::handleSourceStructureChanged()
+{
+    beginResetModel();
+    m_rows = pageRows();
+    endResetModel();
+    emit sourceRowCountChanged(sourceModel() ? sourceModel()->rowCount() : 0);
+}
+
+void AppPageModel::handleSourceRowsChanged(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(last);
+    if (parent.isValid()) return;
+
+    // 偏移量不变：页尾按行数差插入或删除，从变化位置到页尾的其余行内容后移，通知数据变化
+    const int oldRows = m_rows;
+    const int newRows = pageRows();
+    if (newRows > oldRows) {
+        beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        m_rows = newRows;
+        endInsertRows();
+    } else if (newRows < oldRows) {
+        beginRemoveRows(QModelIndex(), newRows, oldRows - 1);
+        m_rows = newRows;
+        endRemoveRows();
+    }
+
+    const int changedFirst = qMax(0, first - m_offset);
+    const int changedLast = qMin(oldRows, newRows) - 1;
+    if (changedFirst <= changedLast) {
+        emit dataChanged(index(changedFirst, 0), index(changedLast, columnCount() - 1));
+    }
+    emit sourceRowCountChanged(sourceModel() ? sourceModel()->rowCount() : 0);
+}
+
+int AppPageModel::pageRows() const
+{
+    if (!sourceModel()) return 0;
+    return qBound(0, sourceModel()->rowCount() - m_offset, m_pageSize);
+}
@@ -0,0 +1,54 @@
+#ifndef APPPAGEMODEL_H
+#define APPPAGEMODEL_H
+
+#include <QAbstractProxyModel>
+
+// 分页代理模型：只向视图暴露源模型中当前页的若干行，
+// 翻页只改变偏移量，开销与总应用数无关。源模型插入、删除行时保持当前页的偏移量，
+// 只通知页内受影响的行（页尾行数的增减和内容变化），变化发生在本页之后时不通知视图。
+// 连续滚动时偏移量固定为 0、页大小逐步增大，新增的行按插入通知，视图保持滚动位置
+class AppPageModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit AppPageModel(QObject *parent = nullptr);
+    ~AppPageModel() override;
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    // 设置当前页的起始行和每页行数
+    void setPage(int offset, int pageSize);
+    int offset() const { return m_offset; }
+    int pageSize() const { return m_pageSize; }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+    // 页已到达源模型末尾时才向源模型请求更多数据（例如按页从服务器读取目录，见 CatalogPager）
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    // 源模型总行数变化（用于更新总页数）
+    void sourceRowCountChanged(int count);
+
+private slots:
+    void handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                 const QList<int> &roles);
+    void handleSourceStructureChanged();
+    void handleSourceRowsChanged(const QModelIndex &parent, int first, int last);
+
+private:
+    int pageRows() const;
+
+private:
+    int m_offset;     // 当前页在源模型中的起始行
+    int m_pageSize;   // 每页行数
+    int m_rows;       // 当前页的行数（源模型行数变化时据此计算通知范围）
+};
+
+#endif // APPPAGEMODEL_H
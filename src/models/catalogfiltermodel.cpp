@@ -0,0 +1,41 @@
+#include "catalogfiltermodel.h"
+#include "applistmodel.h"
+#include "catalogstore.h"
+
+CatalogFilterModel::CatalogFilterModel(CatalogStore *catalog, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_catalog(catalog)
+    , m_installedOnly(false)
+{
+    // 只有这两个角色变化时才需要重新过滤、排序，其他角色的 dataChanged 直接转发
+    setFilterRole(AppListModel::InstalledRole);
+    setSortRole(AppListModel::NameRole);
+    setDynamicSortFilter(true);
+    setSourceModel(catalog);
+}
+
+CatalogFilterModel::~CatalogFilterModel() = default;
+
+void CatalogFilterModel::setInstalledOnly(bool installedOnly)
+{
+    if (m_installedOnly == installedOnly) return;
+
+    m_installedOnly = installedOnly;
+    invalidateRowsFilter();
+}
+
+void CatalogFilterModel::setSortByName(bool sortByName)
+{
+    sort(sortByName ? 0 : -1);
+}
+
+bool CatalogFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    return !m_installedOnly || m_catalog->isInstalled(sourceRow);
+}
+
+bool CatalogFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    return m_catalog->nameRank(left.row()) < m_catalog->nameRank(right.row());
+}
@@ -0,0 +1,35 @@
+#ifndef CATALOGFILTERMODEL_H
+#define CATALOGFILTERMODEL_H
+
+#include <QSortFilterProxyModel>
+
+class CatalogStore;
+
+// CatalogStore 的过滤排序代理：可以只显示已安装的应用、按名称排序。
+// 过滤和比较直接读取目录的安装状态列和名称排序位置，不经过 data()；
+// 安装状态变化时源模型只通知一行，代理只插入或移除这一行
+class CatalogFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit CatalogFilterModel(CatalogStore *catalog, QObject *parent = nullptr);
+    ~CatalogFilterModel() override;
+
+    // 只显示已安装的应用
+    void setInstalledOnly(bool installedOnly);
+    bool installedOnly() const { return m_installedOnly; }
+
+    // 按名称排序；关闭时保持目录顺序
+    void setSortByName(bool sortByName);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    CatalogStore *m_catalog;
+    bool m_installedOnly;
+};
+
+#endif // CATALOGFILTERMODEL_H
@@ -0,0 +1,524 @@
+#include "catalogstore.h"
+#include "applistmodel.h"
+#include "core/trace.h"
+#include "network/catalogpager.h"
+#include "storage/catalogsnapshot.h"
+#include "storage/localstore.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+CatalogStore::CatalogStore(LocalStore *store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+    , m_pageRequest(0)
+    , m_pageRevision(0)
+    , m_settledRevision(0)
+    , m_reloadPending(false)
+{
+    connect(m_store, &LocalStore::catalogPageReady, this, &CatalogStore::handlePageReady);
+    connect(m_store, &LocalStore::catalogChanged, this, &CatalogStore::handleCatalogChanged);
+    connect(m_store, &LocalStore::installedChanged, this, &CatalogStore::handleInstalledChanged);
+    connect(m_store, &LocalStore::catalogSnapshotWritten, this, &CatalogStore::handleSnapshotWritten);
+}
+
+CatalogStore::~CatalogStore() = default;
+
+int CatalogStore::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_data.records.size();
+}
+
+QVariant CatalogStore::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_data.records.size()) {
+        return QVariant();
+    }
+
+    const Record &record = m_data.records.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case AppListModel::NameRole:
+        return m_data.strings.at(record.name);
+    case Qt::ToolTipRole:
+    case AppListModel::DescriptionRole:
+        return m_data.strings.at(record.description);
+    case AppListModel::AppIdRole:
+        return m_data.strings.at(record.id);
+    case AppListModel::IconPathRole:
+        return m_data.strings.at(record.iconPath);
+    case AppListModel::InstalledRole:
+        return m_data.installed.at(index.row());
+    case AppListModel::PackageUrlRole:
+        return m_data.strings.at(record.packageUrl);
+    case AppListModel::PackageHashRole:
+        return m_data.strings.at(record.packageHash);
+    case AppListModel::ThumbnailRole:
+        return m_snapshot ? m_snapshot->thumbnail(index.row()) : QByteArray();
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> CatalogStore::roleNames() const
+{
+    return {
+        { AppListModel::AppIdRole, "appId" },
+        { AppListModel::NameRole, "name" },
+        { AppListModel::DescriptionRole, "description" },
+        { AppListModel::IconPathRole, "iconPath" },
+        { AppListModel::InstalledRole, "installed" },
+        { AppListModel::PackageUrlRole, "packageUrl" },
+        { AppListModel::PackageHashRole, "packageHash" },
+        { AppListModel::ThumbnailRole, "thumbnail" }
+    };
+}
+
+void CatalogStore::refresh()
+{
+    m_pageRevision = m_store->catalogRevision();
+    m_pageRequest = m_store->requestCatalogPage(0, -1);
+}
+
+bool CatalogStore::loadSnapshot(const QString &path)
+{
+    m_snapshotPath = path;
+    if (swapSnapshot(path)) return true;
+
+    // 还没有快照（首次启动）时先从数据库读取，快照写入后再换用快照
+    refresh();
+    return false;
+}
+
+void CatalogStore::setInstalled(const QString &appId, bool installed)
+{
+    const int row = rowOfApp(appId);
+    if (row < 0 || m_data.installed.at(row) == installed) return;
+
+    m_data.installed[row] = installed;
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx, { AppListModel::InstalledRole });
+}
+
+void CatalogStore::applyDelta(const QList<AppInfo> &upserts, const QStringList &removedIds)
+{
+    TRACE_SPAN("model", "CatalogStore::applyDelta");
+
+    // 删除：相邻的行合并成一段，从后往前逐段通知，前面的行号不受影响；
+    // 全部删除后一次性整理名称排序和后面行的索引
+    QList<int> removedRows;
+    for (const QString &appId : removedIds) {
+        const int row = rowOfApp(appId);
+        if (row >= 0) {
+            removedRows.append(row);
+        }
+    }
+    std::sort(removedRows.begin(), removedRows.end());
+    removedRows.erase(std::unique(removedRows.begin(), removedRows.end()), removedRows.end());
+    for (int last = removedRows.size() - 1; last >= 0;) {
+        int first = last;
+        while (first > 0 && removedRows.at(first - 1) == removedRows.at(first) - 1) {
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), removedRows.at(first), removedRows.at(last));
+        m_data.removeRows(removedRows.at(first), last - first + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+    if (!removedRows.isEmpty()) {
+        m_data.removeNames(removedRows);
+        m_data.reindexIds(removedRows.first());
+        // 快照的行号不再与记录对应，等下一次快照写入后再提供缩略图
+        m_snapshot.reset();
+    }
+
+    // 修改：逐行比较，内容变化的行才通知；改名的行一起重新排序后再通知（排序代理用到排序位置）。
+    // 新应用留到最后一起追加
+    QList<AppInfo> added;
+    QSet<QString> addedIds;
+    QList<int> changedRows;
+    QList<int> renamedRows;
+    QList<int> textRows;       // 名称或描述变化的行，需要重新索引
+    for (const AppInfo &app : upserts) {
+        const int row = rowOfApp(app.id);
+        if (row < 0) {
+            if (!app.id.isEmpty() && !addedIds.contains(app.id)) {
+                addedIds.insert(app.id);
+                added.append(app);
+            }
+            continue;
+        }
+        const quint32 description = m_data.records.at(row).description;
+        bool renamed = false;
+        if (m_data.update(row, app, &renamed)) {
+            changedRows.append(row);
+            if (renamed) {
+                renamedRows.append(row);
+            }
+            if (renamed || m_data.records.at(row).description != description) {
+                textRows.append(row);
+            }
+        }
+    }
+    if (!renamedRows.isEmpty()) {
+        m_data.replaceNames(renamedRows);
+    }
+    for (int row : std::as_const(changedRows)) {
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx);
+    }
+
+    if (!added.isEmpty()) {
+        const int first = m_data.records.size();
+        beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+        for (const AppInfo &app : std::as_const(added)) {
+            m_data.append(app);
+            m_data.placeName(m_data.records.size() - 1);
+            textRows.append(m_data.records.size() - 1);
+        }
+        m_data.renumberRanks();
+        endInsertRows();
+    }
+
+    // 写入数据库；记下修订号，提交后的快照或通知只包含这些修改时不必重新加载
+    if (!removedIds.isEmpty()) {
+        m_ownRevisions.append(m_store->removeCatalog(removedIds));
+    }
+    if (!upserts.isEmpty()) {
+        m_ownRevisions.append(m_store->upsertCatalog(upserts));
+    }
+
+    if (!removedRows.isEmpty() || !textRows.isEmpty()) {
+        emit entriesChanged(removedRows, textRows);
+    }
+}
+
+QStringList CatalogStore::appIds() const
+{
+    QStringList ids;
+    ids.reserve(m_data.records.size());
+    for (const Record &record : m_data.records) {
+        ids.append(m_data.strings.at(record.id));
+    }
+    return ids;
+}
+
+void CatalogStore::setPager(CatalogPager *pager)
+{
+    m_pager = pager;
+}
+
+bool CatalogStore::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_pager && m_pager->hasMore();
+}
+
+void CatalogStore::fetchMore(const QModelIndex &parent)
+{
+    // 上一页还在读取时忽略，避免视图和预取重复请求
+    if (canFetchMore(parent)) {
+        m_pager->fetchNext();
+    }
+}
+
+void CatalogStore::handlePageReady(quint64 requestId, int offset, const QList<AppInfo> &apps)
+{
+    if (requestId != m_pageRequest) return;
+    Q_UNUSED(offset);
+    m_pageRequest = 0;
+
+    // 读取请求之后本对象又写入了修改，读到的目录不包含它们，替换会暂时撤销这些修改
+    if (!m_ownRevisions.isEmpty() && m_ownRevisions.last() > m_pageRevision) {
+        m_reloadPending = true;
+        return;
+    }
+
+    Data data;
+    for (const AppInfo &app : apps) {
+        data.append(app);
+    }
+    data.rankNames();
+    replaceData(data, nullptr);
+}
+
+void CatalogStore::handleCatalogChanged(quint64 revision)
+{
+    // 使用快照时由快照写入的通知处理；这里只处理数据库模式，以及快照无法使用后等待中的重新加载
+    if (settleRevision(revision)) {
+        reload(!m_snapshotPath.isEmpty());
+    }
+}
+
+void CatalogStore::handleInstalledChanged(const QHash<QString, bool> &installed)
+{
+    // 通常已经由 setInstalled 先行更新，这里只有其他写入者的修改才会产生通知
+    for (auto it = installed.constBegin(); it != installed.constEnd(); ++it) {
+        setInstalled(it.key(), it.value());
+    }
+}
+
+void CatalogStore::handleSnapshotWritten(const QString &path, bool ok, quint64 revision)
+{
+    if (m_snapshotPath.isEmpty() || path != m_snapshotPath) return;
+
+    const bool needsReload = settleRevision(revision);
+    if (!ok) {
+        // 快照与数据库不一致，不再从中读取缩略图，改为从数据库读取（本对象的修改都提交后）
+        m_snapshot.reset();
+        m_reloadPending = true;
+        if (m_ownRevisions.isEmpty()) {
+            reload(false);
+        }
+        return;
+    }
+    if (needsReload) {
+        reload(true);
+        return;
+    }
+
+    // 快照只包含本对象已经应用到内存的修改：不重新读取、排序和比较，只换用新快照提供缩略图。
+    // 还有修改未提交时快照落后于内存，行号可能对不上，等它们提交后的快照
+    if (m_ownRevisions.isEmpty() && m_pageRequest == 0) {
+        adoptSnapshot(path);
+    }
+}
+
+bool CatalogStore::settleRevision(quint64 revision)
+{
+    // 本对象的修订号依次提交；这段修订号中有其他写入者的修改时（例如首次运行时写入的测试目录）需要重新加载
+    int own = 0;
+    while (!m_ownRevisions.isEmpty() && m_ownRevisions.first() <= revision) {
+        m_ownRevisions.removeFirst();
+        ++own;
+    }
+    if (revision > m_settledRevision) {
+        if (revision - m_settledRevision > quint64(own)) {
+            m_reloadPending = true;
+        }
+        m_settledRevision = revision;
+    }
+
+    // 内存中还有未提交的修改时，现在重新加载会暂时撤销它们，等它们提交后再加载
+    return m_reloadPending && m_ownRevisions.isEmpty();
+}
+
+void CatalogStore::reload(bool fromSnapshot)
+{
+    m_reloadPending = false;
+    if (!fromSnapshot || !swapSnapshot(m_snapshotPath)) {
+        refresh();
+    }
+}
+
+void CatalogStore::adoptSnapshot(const QString &path)
+{
+    TRACE_SPAN("model", "CatalogStore::adoptSnapshot");
+    CatalogSnapshot *snapshot = new CatalogSnapshot;
+    if (!snapshot->open(path) || snapshot->count() != m_data.records.size()) {
+        // 与内存中的目录对不上（例如之前的提交失败），整体重新加载
+        delete snapshot;
+        reload(true);
+        return;
+    }
+    // 缩略图可能变化，视图重新读取即可，不单独通知
+    m_snapshot.reset(snapshot);
+}
+
+bool CatalogStore::swapSnapshot(const QString &path)
+{
+    TRACE_SPAN("model", "CatalogStore::swapSnapshot");
+    QElapsedTimer timer;
+    timer.start();
+    CatalogSnapshot *snapshot = new CatalogSnapshot;
+    if (!snapshot->open(path)) {
+        delete snapshot;
+        return false;
+    }
+
+    Data data;
+    data.records.reserve(snapshot->count());
+    for (int row = 0; row < snapshot->count(); ++row) {
+        data.append(snapshot->app(row));
+    }
+    data.rankNames();
+    m_pageRequest = 0;       // 进行中的数据库读取结果不再使用
+    replaceData(data, snapshot);
+
+    qDebug() << "CatalogStore loaded snapshot with" << m_data.records.size() << "apps in" << timer.elapsed() << "ms";
+    return true;
+}
+
+void CatalogStore::replaceData(Data &data, CatalogSnapshot *snapshot)
+{
+    // 应用列表（ID 和顺序）不变时逐行比较，只通知变化的行；否则整体重置
+    bool sameApps = data.records.size() == m_data.records.size();
+    for (int row = 0; sameApps && row < data.records.size(); ++row) {
+        sameApps = data.strings.at(data.records.at(row).id) == m_data.strings.at(m_data.records.at(row).id);
+    }
+
+    if (!sameApps) {
+        beginResetModel();
+        m_data = std::move(data);
+        m_snapshot.reset(snapshot);
+        endResetModel();
+        emit reloaded();
+        return;
+    }
+
+    QList<int> changedRows;
+    QList<int> textRows;
+    for (int row = 0; row < data.records.size(); ++row) {
+        const Record &before = m_data.records.at(row);
+        const Record &after = data.records.at(row);
+        const auto same = [&](quint32 Record::*field) {
+            return m_data.strings.at(before.*field) == data.strings.at(after.*field);
+        };
+        const bool sameText = same(&Record::name) && same(&Record::description);
+        if (!sameText) {
+            textRows.append(row);
+        }
+        if (!sameText || m_data.installed.at(row) != data.installed.at(row) || !same(&Record::iconPath)
+            || !same(&Record::packageUrl) || !same(&Record::packageHash)) {
+            changedRows.append(row);
+        }
+    }
+
+    // 缩略图可能变化，快照替换后视图重新读取即可，不单独通知
+    m_data = std::move(data);
+    m_snapshot.reset(snapshot);
+    for (int row : std::as_const(changedRows)) {
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx);
+    }
+    if (!textRows.isEmpty()) {
+        emit entriesChanged(QList<int>(), textRows);
+    }
+}
+
+quint32 CatalogStore::Data::intern(const QString &text)
+{
+    const auto it = stringIds.constFind(text);
+    if (it != stringIds.constEnd()) return it.value();
+
+    const quint32 id = strings.size();
+    strings.append(text);
+    stringIds.insert(text, id);
+    return id;
+}
+
+void CatalogStore::Data::append(const AppInfo &app)
+{
+    Record record;
+    record.id = intern(app.id);
+    record.name = intern(app.name);
+    record.description = intern(app.description);
+    record.iconPath = intern(app.iconPath);
+    record.packageUrl = intern(app.packageUrl);
+    record.packageHash = intern(app.packageHash);
+
+    if (!app.id.isEmpty()) {
+        rowById.insert(app.id, records.size());
+    }
+    records.append(record);
+    installed.append(app.installed);
+}
+
+bool CatalogStore::Data::update(int row, const AppInfo &app, bool *renamed)
+{
+    Record record;
+    record.id = records.at(row).id;
+    record.name = intern(app.name);
+    record.description = intern(app.description);
+    record.iconPath = intern(app.iconPath);
+    record.packageUrl = intern(app.packageUrl);
+    record.packageHash = intern(app.packageHash);
+
+    Record &current = records[row];
+    if (std::memcmp(&record, &current, sizeof(Record)) == 0) return false;
+
+    // 名称的排序位置由调用者对所有改名的行一起整理（见 replaceNames）
+    *renamed = record.name != current.name;
+    current = record;
+    return true;
+}
+
+void CatalogStore::Data::removeRows(int first, int count)
+{
+    for (int row = first; row < first + count; ++row) {
+        rowById.remove(strings.at(records.at(row).id));
+    }
+    records.remove(first, count);
+    installed.remove(first, count);
+    // 排序位置只删除不重新编号：剩下的行相对顺序不变，排序代理照常比较；nameOrder 由 removeNames 一次整理
+    nameRanks.remove(first, count);
+}
+
+void CatalogStore::Data::removeNames(const QList<int> &removedRows)
+{
+    // 一次遍历去掉已删除的行，其余行号减去前面删除的行数，再重新编号（整数数组上的线性操作，不比较字符串）
+    int kept = 0;
+    for (int rank = 0; rank < nameOrder.size(); ++rank) {
+        const int row = nameOrder.at(rank);
+        const auto it = std::lower_bound(removedRows.begin(), removedRows.end(), row);
+        if (it != removedRows.end() && *it == row) continue;
+        nameOrder[kept++] = row - int(it - removedRows.begin());
+    }
+    nameOrder.resize(kept);
+    renumberRanks();
+}
+
+void CatalogStore::Data::replaceNames(const QList<int> &renamedRows)
+{
+    // 一次遍历从排序中去掉改名的行，逐个二分查找新位置插入，最后重新编号一次
+    std::vector<bool> renamed(records.size(), false);
+    for (int row : renamedRows) {
+        renamed[row] = true;
+    }
+    nameOrder.erase(std::remove_if(nameOrder.begin(), nameOrder.end(), [&renamed](int row) { return renamed[row]; }),
+                    nameOrder.end());
+    for (int row : renamedRows) {
+        placeName(row);
+    }
+    renumberRanks();
+}
+
+void CatalogStore::Data::reindexIds(int fromRow)
+{
+    for (int row = fromRow; row < records.size(); ++row) {
+        rowById[strings.at(records.at(row).id)] = row;
+    }
+}
+
+void CatalogStore::Data::rankNames()
+{
+    // 名称按本地化规则排序一次，之后排序只比较整数
+    nameOrder.resize(records.size());
+    std::iota(nameOrder.begin(), nameOrder.end(), 0);
+    std::stable_sort(nameOrder.begin(), nameOrder.end(), [this](int left, int right) {
+        return QString::localeAwareCompare(strings.at(records.at(left).name), strings.at(records.at(right).name)) < 0;
+    });
+    renumberRanks();
+}
+
+void CatalogStore::Data::placeName(int row)
+{
+    // 二分查找插入位置，只比较 O(log n) 次名称
+    const QString &name = strings.at(records.at(row).name);
+    const auto it = std::upper_bound(nameOrder.begin(), nameOrder.end(), row, [&](int, int other) {
+        return QString::localeAwareCompare(name, strings.at(records.at(other).name)) < 0;
+    });
+    nameOrder.insert(it, row);
+}
+
+void CatalogStore::Data::renumberRanks()
+{
+    nameRanks.resize(records.size());
+    for (int rank = 0; rank < nameOrder.size(); ++rank) {
+        nameRanks[nameOrder.at(rank)] = rank;
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef CATALOGSTORE_H
+#define CATALOGSTORE_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QScopedPointer>
+#include <QStringList>
+#include "appinfo.h"
+
+class CatalogPager;
+class CatalogSnapshot;
+class LocalStore;
+
+// 应用目录在内存中的唯一副本，应用商城和已安装页签都通过代理模型显示它（见 CatalogFilterModel）。
+// 每个应用一条紧凑记录，字符串字段保存为字符串池中的编号，相同的描述、地址只存一份；
+// 排序和过滤用到的安装状态、名称排序位置按列单独存放，代理模型比较时不经过 data() 和 QVariant。
+// 安装状态变化只修改一条记录，并只对这一行发出 dataChanged。
+// 启动时从目录快照读取，快照不可用时从数据库读取整个目录。增量修改由本对象写入数据库并记下修订号，
+// 提交后的快照只包含这些修改时不重新加载（内存已是最新）；有其他写入者的修改时按新快照重新加载，
+// 应用列表不变时只对内容变化的行发出 dataChanged，不重置模型
+class CatalogStore : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit CatalogStore(LocalStore *store, QObject *parent = nullptr);
+    ~CatalogStore() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // 从数据库读取整个目录（构造后调用它或 loadSnapshot 开始加载）
+    void refresh();
+    // 使用目录快照（见 LocalStore::setCatalogSnapshot），文件无效时返回 false 并改为从数据库读取，
+    // 之后的新快照仍会被使用
+    bool loadSnapshot(const QString &path);
+
+    int rowOfApp(const QString &appId) const { return m_data.rowById.value(appId, -1); }
+    QString name(int row) const { return m_data.strings.at(m_data.records.at(row).name); }
+    QString description(int row) const { return m_data.strings.at(m_data.records.at(row).description); }
+    bool isInstalled(int row) const { return m_data.installed.at(row); }
+    int nameRank(int row) const { return m_data.nameRanks.at(row); }
+
+    // 更新一个应用的安装状态（数据库由调用者另行更新，提交后只修改快照中的标志位，不重新加载目录）
+    void setInstalled(const QString &appId, bool installed);
+
+    // 应用增量变化（见 CatalogSync）并写入数据库：删除的行按相邻的段 rowsRemoved，新应用追加到末尾（与数据库顺序一致）
+    // 一次 rowsInserted，内容变化的行各自 dataChanged，没有变化的条目不通知；安装状态是本地状态，不受影响。
+    // 字符串处理和通知的开销与变化条数成正比，行号和排序位置的整理每次增量只做常数次整数数组上的线性操作
+    void applyDelta(const QList<AppInfo> &upserts, const QStringList &removedIds);
+    QStringList appIds() const;
+
+    // 目录按页从服务器读取时（见 CatalogPager）：视图或预取需要更多行时通过 fetchMore 请求下一页，
+    // 收到的页由调用者经 applyDelta 追加（不持有 pager）
+    void setPager(CatalogPager *pager);
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    // 目录整体重新加载（模型已重置），用于重建搜索索引
+    void reloaded();
+    // 目录按行变化（增量或重新加载时应用列表不变），用于增量更新搜索索引：
+    // removedRows 为删除前的行号（升序），changedRows 为删除之后名称或描述变化的行和新增的行
+    void entriesChanged(const QList<int> &removedRows, const QList<int> &changedRows);
+
+private slots:
+    void handlePageReady(quint64 requestId, int offset, const QList<AppInfo> &apps);
+    void handleCatalogChanged(quint64 revision);
+    void handleInstalledChanged(const QHash<QString, bool> &installed);
+    void handleSnapshotWritten(const QString &path, bool ok, quint64 revision);
+
+private:
+    // 一个应用的记录：各字段为字符串池中的编号
+    struct Record {
+        quint32 id;
+        quint32 name;
+        quint32 description;
+        quint32 iconPath;
+        quint32 packageUrl;
+        quint32 packageHash;
+    };
+
+    struct Data {
+        QList<Record> records;
+        QList<bool> installed;            // 按列存放，过滤用
+        QList<int> nameRanks;             // 名称的排序位置，排序用
+        QList<int> nameOrder;             // 按名称排序的行号（nameRanks 的逆映射）
+        QStringList strings;              // 字符串池（增量修改留下的旧字符串在下次整体加载时回收）
+        QHash<QString, quint32> stringIds;
+        QHash<QString, int> rowById;      // 应用ID -> 行号
+
+        quint32 intern(const QString &text);
+        void append(const AppInfo &app);
+        bool update(int row, const AppInfo &app, bool *renamed);
+        void removeRows(int first, int count);
+        void removeNames(const QList<int> &removedRows);
+        void replaceNames(const QList<int> &renamedRows);
+        void reindexIds(int fromRow);
+        void rankNames();
+        void placeName(int row);
+        void renumberRanks();
+    };
+
+    bool settleRevision(quint64 revision);
+    void reload(bool fromSnapshot);
+    bool swapSnapshot(const QString &path);
+    void adoptSnapshot(const QString &path);
+    void replaceData(Data &data, CatalogSnapshot *snapshot);
+
+private:
+    LocalStore *m_store;
+    QPointer<CatalogPager> m_pager;
+    Data m_data;
+    quint64 m_pageRequest;                             // 最近一次读取整个目录的请求
+    quint64 m_pageRevision;                            // 发出读取请求时已分配的修订号
+    quint64 m_settledRevision;                         // 已收到提交通知的最大修订号
+    QList<quint64> m_ownRevisions;                     // 本对象写入、尚未提交的修订号（升序）
+    bool m_reloadPending;                              // 有其他写入者的修改，等本对象的修改提交后重新加载
+    QString m_snapshotPath;                            // 目录快照，为空时从数据库读取
+    QScopedPointer<CatalogSnapshot> m_snapshot;        // 当前快照，提供缩略图（行号与记录相同）
+};
+
+#endif // CATALOGSTORE_H
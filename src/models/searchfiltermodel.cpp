@@ -0,0 +1,304 @@
+#include "searchfiltermodel.h"
+
+SearchFilterModel::SearchFilterModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+    , m_index(new SearchIndex(this))
+{
+    // 索引重建完成后，用新索引重新执行当前搜索
+    connect(m_index, &SearchIndex::ready, this, [this]() {
+        if (isFiltering()) {
+            applyQuery();
+        }
+    });
+}
+
+SearchFilterModel::~SearchFilterModel() = default;
+
+void SearchFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged,
+                this, &SearchFilterModel::handleSourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::modelReset,
+                this, &SearchFilterModel::handleSourceStructureChanged);
+        connect(sourceModel, &QAbstractItemModel::layoutChanged,
+                this, &SearchFilterModel::handleSourceStructureChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted,
+                this, &SearchFilterModel::handleSourceRowsAboutToBeInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted,
+                this, &SearchFilterModel::handleSourceRowsInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
+                this, &SearchFilterModel::handleSourceRowsAboutToBeRemoved);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved,
+                this, &SearchFilterModel::handleSourceRowsRemoved);
+        connect(sourceModel, &QAbstractItemModel::rowsMoved,
+                this, &SearchFilterModel::handleSourceStructureChanged);
+    }
+
+    m_rows.clear();
+    m_proxyRowBySource.clear();
+    endResetModel();
+}
+
+void SearchFilterModel::setEntries(const QList<SearchEntry> &entries)
+{
+    m_index->build(entries);
+}
+
+bool SearchFilterModel::updateEntries(const QList<int> &removedRows, const QList<SearchEntry> &entries)
+{
+    const bool updated = m_index->update(removedRows, entries);
+    if (updated && isFiltering()) {
+        updateQuery();
+    }
+    return updated;
+}
+
+void SearchFilterModel::setQuery(const QString &text)
+{
+    const QString query = text.trimmed();
+    if (query == m_query) return;
+
+    m_query = query;
+    applyQuery();
+}
+
+QModelIndex SearchFilterModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || column < 0
+        || row >= rowCount() || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex SearchFilterModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int SearchFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return isFiltering() ? m_rows.size() : sourceModel()->rowCount();
+}
+
+int SearchFilterModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return sourceModel()->columnCount();
+}
+
+QModelIndex SearchFilterModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel()) return QModelIndex();
+
+    const int sourceRow = isFiltering() ? m_rows.value(proxyIndex.row(), -1) : proxyIndex.row();
+    return sourceModel()->index(sourceRow, proxyIndex.column());
+}
+
+QModelIndex SearchFilterModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) return QModelIndex();
+
+    if (!isFiltering()) {
+        return createIndex(sourceIndex.row(), sourceIndex.column());
+    }
+
+    const int row = m_proxyRowBySource.value(sourceIndex.row(), -1);
+    return row < 0 ? QModelIndex() : createIndex(row, sourceIndex.column());
+}
+
+void SearchFilterModel::handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                                const QList<int> &roles)
+{
+    if (!isFiltering()) {
+        emit dataChanged(mapFromSource(topLeft), mapFromSource(bottomRight), roles);
+        return;
+    }
+
+    // 过滤后的行不连续，逐行转发命中的部分
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const int proxyRow = m_proxyRowBySource.value(row, -1);
+        if (proxyRow >= 0) {
+            emit dataChanged(index(proxyRow, topLeft.column()), index(proxyRow, bottomRight.column()), roles);
+        }
+    }
+}
+
+void SearchFilterModel::handleSourceStructureChanged()
+{
+    if (isFiltering()) {
+        applyQuery();
+    } else {
+        beginResetModel();
+        endResetModel();
+    }
+}
+
+void SearchFilterModel::handleSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    // 透传时行号一一对应，直接转发，下游模型和视图不必重置
+    if (!isFiltering() && !parent.isValid()) {
+        beginInsertRows(QModelIndex(), first, last);
+    }
+}
+
+void SearchFilterModel::handleSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    if (!isFiltering()) {
+        endInsertRows();
+        return;
+    }
+
+    // 搜索中：新行等索引更新（updateEntries）后再按搜索结果插入，这里只让已命中行的源行号后移
+    const int count = last - first + 1;
+    for (int &row : m_rows) {
+        if (row >= first) {
+            row += count;
+        }
+    }
+    rebuildSourceMap();
+}
+
+void SearchFilterModel::handleSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    if (!isFiltering()) {
+        beginRemoveRows(QModelIndex(), first, last);
+        return;
+    }
+
+    // 搜索中：命中的行里属于删除范围的按连续段删除（从后往前，前面的行号不受影响）
+    for (int proxyRow = m_rows.size() - 1; proxyRow >= 0; --proxyRow) {
+        if (m_rows.at(proxyRow) < first || m_rows.at(proxyRow) > last) continue;
+
+        const int end = proxyRow;
+        while (proxyRow > 0 && m_rows.at(proxyRow - 1) >= first && m_rows.at(proxyRow - 1) <= last) {
+            --proxyRow;
+        }
+        beginRemoveRows(QModelIndex(), proxyRow, end);
+        m_rows.remove(proxyRow, end - proxyRow + 1);
+        rebuildSourceMap();
+        endRemoveRows();
+    }
+}
+
+void SearchFilterModel::handleSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    if (!isFiltering()) {
+        endRemoveRows();
+        return;
+    }
+
+    const int count = last - first + 1;
+    for (int &row : m_rows) {
+        if (row > last) {
+            row -= count;
+        }
+    }
+    rebuildSourceMap();
+}
+
+void SearchFilterModel::applyQuery()
+{
+    beginResetModel();
+    m_rows = isFiltering() ? queryRows() : QList<int>();
+    rebuildSourceMap();
+    endResetModel();
+}
+
+void SearchFilterModel::updateQuery()
+{
+    const QList<int> rows = queryRows();
+    QHash<int, int> positions;
+    positions.reserve(rows.size());
+    for (int i = 0; i < rows.size(); ++i) {
+        positions.insert(rows.at(i), i);
+    }
+
+    // 不再命中的行：从后往前按连续段删除
+    for (int proxyRow = m_rows.size() - 1; proxyRow >= 0; --proxyRow) {
+        if (positions.contains(m_rows.at(proxyRow))) continue;
+
+        const int end = proxyRow;
+        while (proxyRow > 0 && !positions.contains(m_rows.at(proxyRow - 1))) {
+            --proxyRow;
+        }
+        beginRemoveRows(QModelIndex(), proxyRow, end);
+        m_rows.remove(proxyRow, end - proxyRow + 1);
+        rebuildSourceMap();
+        endRemoveRows();
+    }
+
+    // 保留的行在新结果中的先后顺序不变时，新命中的行按连续段插入到各自的位置；
+    // 顺序变化（例如改名后得分变化）时整体重置，这种情况只在有行内容变化时出现
+    int kept = 0;
+    for (int row : rows) {
+        if (!m_proxyRowBySource.contains(row)) continue;
+        if (m_rows.at(kept) != row) {
+            beginResetModel();
+            m_rows = rows;
+            rebuildSourceMap();
+            endResetModel();
+            return;
+        }
+        ++kept;
+    }
+
+    for (int proxyRow = 0; proxyRow < rows.size(); ++proxyRow) {
+        if (m_proxyRowBySource.contains(rows.at(proxyRow))) continue;
+
+        int end = proxyRow;
+        while (end + 1 < rows.size() && !m_proxyRowBySource.contains(rows.at(end + 1))) {
+            ++end;
+        }
+        beginInsertRows(QModelIndex(), proxyRow, end);
+        m_rows.insert(proxyRow, end - proxyRow + 1, 0);
+        for (int i = proxyRow; i <= end; ++i) {
+            m_rows[i] = rows.at(i);
+        }
+        rebuildSourceMap();
+        endInsertRows();
+        proxyRow = end;
+    }
+}
+
+QList<int> SearchFilterModel::queryRows() const
+{
+    QList<int> result;
+    if (!sourceModel()) return result;
+
+    const int sourceRows = sourceModel()->rowCount();
+    const QList<int> rows = m_index->query(m_query);
+    result.reserve(rows.size());
+    for (int row : rows) {
+        if (row >= 0 && row < sourceRows) {
+            result.append(row);
+        }
+    }
+    return result;
+}
+
+void SearchFilterModel::rebuildSourceMap()
+{
+    m_proxyRowBySource.clear();
+    m_proxyRowBySource.reserve(m_rows.size());
+    for (int i = 0; i < m_rows.size(); ++i) {
+        m_proxyRowBySource.insert(m_rows.at(i), i);
+    }
+}
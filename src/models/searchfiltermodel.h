@@ -0,0 +1,63 @@
+#ifndef SEARCHFILTERMODEL_H
+#define SEARCHFILTERMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QHash>
+#include <QList>
+#include "search/searchindex.h"
+
+// 搜索过滤代理模型：关键词为空时原样透传源模型（包括行的插入、删除通知），
+// 否则按搜索索引返回的相关度顺序只暴露命中的行；源模型的行插入、删除和索引的增量更新只通知变化的行
+class SearchFilterModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit SearchFilterModel(QObject *parent = nullptr);
+    ~SearchFilterModel() override;
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    // 设置参与索引的记录（在后台重建索引）
+    void setEntries(const QList<SearchEntry> &entries);
+    // 按行增量更新索引（见 SearchIndex::update），搜索中时重新执行当前搜索；
+    // 返回 false 时调用者应改用 setEntries 整体重建
+    bool updateEntries(const QList<int> &removedRows, const QList<SearchEntry> &entries);
+    // 设置搜索关键词
+    void setQuery(const QString &text);
+    QString query() const { return m_query; }
+    const SearchIndex *searchIndex() const { return m_index; }
+    bool isFiltering() const { return !m_query.isEmpty(); }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+private slots:
+    void handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                 const QList<int> &roles);
+    void handleSourceStructureChanged();
+    void handleSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void handleSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void handleSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void handleSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+
+private:
+    // 重新执行当前搜索并重置模型（关键词或整个索引变化时）
+    void applyQuery();
+    // 索引增量更新后重新执行当前搜索，只对变化的行发出删除、插入通知；命中行的相对顺序变化时才重置
+    void updateQuery();
+    QList<int> queryRows() const;
+    void rebuildSourceMap();
+
+private:
+    SearchIndex *m_index;              // 搜索索引
+    QString m_query;                   // 当前关键词
+    QList<int> m_rows;                 // 过滤后每一行对应的源行号
+    QHash<int, int> m_proxyRowBySource;  // 源行号 -> 过滤后的行号
+};
+
+#endif // SEARCHFILTERMODEL_H
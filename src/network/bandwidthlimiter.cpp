@@ -0,0 +1,61 @@
+#include "bandwidthlimiter.h"
+#include <QTimer>
+
+namespace {
+
+const int kRefillInterval = 50;  // 补充间隔（毫秒）
+const int kBurstIntervals = 4;   // 桶容量为 4 个补充间隔的额度，避免长时间空闲后突发
+
+} // namespace
+
+BandwidthLimiter::BandwidthLimiter(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_bytesPerSecond(0)
+    , m_tokens(0)
+    , m_starved(false)
+{
+    m_timer->setInterval(kRefillInterval);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &BandwidthLimiter::refill);
+}
+
+void BandwidthLimiter::setBytesPerSecond(qint64 bytesPerSecond)
+{
+    m_bytesPerSecond = qMax<qint64>(0, bytesPerSecond);
+    m_tokens = 0;
+
+    if (isLimited()) {
+        m_timer->start();
+    } else {
+        m_timer->stop();
+        // 取消限速后立即唤醒等待中的下载
+        if (m_starved) {
+            m_starved = false;
+            emit refilled();
+        }
+    }
+}
+
+qint64 BandwidthLimiter::acquire(qint64 wanted)
+{
+    if (!isLimited()) return wanted;
+
+    const qint64 granted = qMin(wanted, m_tokens);
+    m_tokens -= granted;
+    if (granted < wanted) {
+        m_starved = true;
+    }
+    return granted;
+}
+
+void BandwidthLimiter::refill()
+{
+    const qint64 perInterval = qMax<qint64>(1, m_bytesPerSecond * kRefillInterval / 1000);
+    m_tokens = qMin(m_tokens + perInterval, perInterval * kBurstIntervals);
+
+    if (m_starved) {
+        m_starved = false;
+        emit refilled();
+    }
+}
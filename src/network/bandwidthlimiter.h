@@ -0,0 +1,40 @@
+#ifndef BANDWIDTHLIMITER_H
+#define BANDWIDTHLIMITER_H
+
+#include <QObject>
+
+class QTimer;
+
+// 全局带宽预算（令牌桶）：所有下载共享同一个限速器。
+// 只在创建它的线程中使用，令牌不足时调用方暂停读取，
+// 网络数据留在套接字缓冲区中，由 TCP 流控降低发送速度。
+class BandwidthLimiter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BandwidthLimiter(QObject *parent = nullptr);
+
+    // 每秒允许的字节数，0 表示不限速
+    void setBytesPerSecond(qint64 bytesPerSecond);
+    qint64 bytesPerSecond() const { return m_bytesPerSecond; }
+    bool isLimited() const { return m_bytesPerSecond > 0; }
+
+    // 申请 wanted 字节的额度，返回实际可用的字节数（可能为 0）
+    qint64 acquire(qint64 wanted);
+
+signals:
+    // 令牌补充后发出，等待额度的下载可以继续读取
+    void refilled();
+
+private slots:
+    void refill();
+
+private:
+    QTimer *m_timer;          // 补充令牌的定时器
+    qint64 m_bytesPerSecond;  // 限速
+    qint64 m_tokens;          // 当前可用的字节数
+    bool m_starved;           // 是否有调用方因额度不足而等待
+};
+
+#endif // BANDWIDTHLIMITER_H
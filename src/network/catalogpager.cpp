@@ -0,0 +1,84 @@
+#include "catalogpager.h"
+#include "catalogsync.h"
+#include "httpclient.h"
+#include "core/trace.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QUrlQuery>
+
+CatalogPager::CatalogPager(const QUrl &catalogUrl, int pageSize, QObject *parent)
+    : QObject(parent)
+    , m_url(catalogUrl)
+    , m_pageSize(qMax(1, pageSize))
+    , m_client(HttpClient::instance())
+    , m_request(0)
+    , m_finished(false)
+{
+    connect(m_client, &HttpClient::finished, this, &CatalogPager::handleFinished);
+    connect(m_client, &HttpClient::failed, this, &CatalogPager::handleFailed);
+}
+
+CatalogPager::~CatalogPager()
+{
+    if (m_request != 0) {
+        m_client->cancel(m_request);
+    }
+}
+
+void CatalogPager::fetchNext()
+{
+    if (m_request != 0 || m_finished) return;
+
+    QUrl url = m_url;
+    QUrlQuery query(url);
+    query.removeAllQueryItems(QStringLiteral("cursor"));
+    query.removeAllQueryItems(QStringLiteral("limit"));
+    if (!m_cursor.isEmpty()) {
+        query.addQueryItem(QStringLiteral("cursor"), m_cursor);
+    }
+    query.addQueryItem(QStringLiteral("limit"), QString::number(m_pageSize));
+    url.setQuery(query);
+    // 用户正在等待这一页（滚动到了末尾）或即将翻到这一页，排在图标预取之前
+    m_request = m_client->get(url, HttpClient::Normal);
+}
+
+void CatalogPager::handleFailed(quint64 requestId, const QString &error)
+{
+    if (requestId != m_request) return;
+    m_request = 0;
+    emit failed(error);
+}
+
+void CatalogPager::handleFinished(quint64 requestId, const QByteArray &body)
+{
+    if (requestId != m_request) return;
+    m_request = 0;
+    TRACE_SPAN("network", "CatalogPager::handleFinished");
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(body, &error);
+    if (!document.isObject()) {
+        emit failed(error.errorString());
+        return;
+    }
+
+    const QJsonObject root = document.object();
+    QList<AppInfo> apps;
+    const QJsonArray array = root.value(QStringLiteral("apps")).toArray();
+    apps.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        const AppInfo app = CatalogSync::fromJson(value.toObject());
+        if (!app.id.isEmpty()) {
+            apps.append(app);
+        }
+    }
+
+    if (m_cursor.isEmpty()) {
+        m_version = root.value(QStringLiteral("version")).toString();
+    }
+    m_cursor = root.value(QStringLiteral("next")).toString();
+    m_finished = m_cursor.isEmpty();
+    qDebug() << "CatalogPager:" << apps.size() << "apps," << (m_finished ? "last page" : "more");
+    emit pageReady(apps, m_finished);
+}
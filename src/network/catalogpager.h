@@ -0,0 +1,51 @@
+#ifndef CATALOGPAGER_H
+#define CATALOGPAGER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+#include "models/appinfo.h"
+
+class HttpClient;
+
+// 按页读取应用目录（游标分页），用于本地还没有目录时先显示前几页：
+// GET <catalogUrl>?cursor=<游标>&limit=<条数> 返回 {"version": "<版本>", "apps": [应用], "next": "<游标>"}，
+// 第一页不带 cursor，next 为空表示已是最后一页。游标标记上一页的最后一个应用，
+// 分页期间目录的变化不会让后面的页重复或漏掉已读的应用；第一页的版本之后的变化由 CatalogSync 增量同步补齐。
+// 应用对象的字段与 CatalogSync 相同
+class CatalogPager : public QObject
+{
+    Q_OBJECT
+
+public:
+    CatalogPager(const QUrl &catalogUrl, int pageSize, QObject *parent = nullptr);
+    ~CatalogPager() override;
+
+    // 请求下一页，上一次请求未完成或已读完时忽略
+    void fetchNext();
+    bool hasMore() const { return !m_finished; }
+    bool isBusy() const { return m_request != 0; }
+    int pageSize() const { return m_pageSize; }
+    // 第一页的目录版本（读完后从这个版本开始增量同步）
+    QString version() const { return m_version; }
+
+signals:
+    void pageReady(const QList<AppInfo> &apps, bool last);
+    void failed(const QString &error);
+
+private:
+    void handleFinished(quint64 requestId, const QByteArray &body);
+    void handleFailed(quint64 requestId, const QString &error);
+
+private:
+    QUrl m_url;
+    int m_pageSize;
+    HttpClient *m_client;
+    quint64 m_request;            // 进行中的请求编号
+    QString m_cursor;             // 下一页的游标，为空时从头读取
+    QString m_version;
+    bool m_finished;              // 已读到最后一页
+};
+
+#endif // CATALOGPAGER_H
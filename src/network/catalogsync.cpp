@@ -0,0 +1,109 @@
+#include "catalogsync.h"
+#include "httpclient.h"
+#include "core/trace.h"
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QUrlQuery>
+
+CatalogSync::CatalogSync(const QUrl &catalogUrl, QObject *parent)
+    : QObject(parent)
+    , m_url(catalogUrl)
+    , m_client(HttpClient::instance())
+    , m_request(0)
+{
+    connect(m_client, &HttpClient::finished, this, &CatalogSync::handleFinished);
+    connect(m_client, &HttpClient::failed, this, &CatalogSync::handleFailed);
+}
+
+CatalogSync::~CatalogSync()
+{
+    if (m_request != 0) {
+        m_client->cancel(m_request);
+    }
+}
+
+void CatalogSync::fetch(const QString &since)
+{
+    if (m_request != 0) return;
+
+    QUrl url = m_url;
+    QUrlQuery query(url);
+    query.removeAllQueryItems(QStringLiteral("since"));
+    query.addQueryItem(QStringLiteral("since"), since);
+    url.setQuery(query);
+    m_request = m_client->get(url, HttpClient::Normal);
+}
+
+QJsonObject CatalogSync::toJson(const AppInfo &app)
+{
+    return {
+        { QStringLiteral("id"), app.id },
+        { QStringLiteral("name"), app.name },
+        { QStringLiteral("description"), app.description },
+        { QStringLiteral("iconPath"), app.iconPath },
+        { QStringLiteral("packageUrl"), app.packageUrl },
+        { QStringLiteral("packageHash"), app.packageHash }
+    };
+}
+
+AppInfo CatalogSync::fromJson(const QJsonObject &object)
+{
+    AppInfo app;
+    app.id = object.value(QStringLiteral("id")).toString();
+    app.name = object.value(QStringLiteral("name")).toString();
+    app.description = object.value(QStringLiteral("description")).toString();
+    app.iconPath = object.value(QStringLiteral("iconPath")).toString();
+    app.packageUrl = object.value(QStringLiteral("packageUrl")).toString();
+    app.packageHash = object.value(QStringLiteral("packageHash")).toString();
+    return app;
+}
+
+void CatalogSync::handleFailed(quint64 requestId, const QString &error)
+{
+    if (requestId != m_request) return;
+    m_request = 0;
+    emit failed(error);
+}
+
+void CatalogSync::handleFinished(quint64 requestId, const QByteArray &body)
+{
+    if (requestId != m_request) return;
+    m_request = 0;
+    TRACE_SPAN("network", "CatalogSync::handleFinished");
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(body, &error);
+    if (!document.isObject()) {
+        emit failed(error.errorString());
+        return;
+    }
+
+    const QJsonObject root = document.object();
+    const QString version = root.value(QStringLiteral("version")).toString();
+    if (version.isEmpty()) {
+        emit failed(QStringLiteral("missing catalog version"));
+        return;
+    }
+
+    QList<AppInfo> upserts;
+    for (const QString &key : { QStringLiteral("added"), QStringLiteral("updated") }) {
+        const QJsonArray apps = root.value(key).toArray();
+        for (const QJsonValue &value : apps) {
+            const AppInfo app = fromJson(value.toObject());
+            if (!app.id.isEmpty()) {
+                upserts.append(app);
+            }
+        }
+    }
+    QStringList removedIds;
+    const QJsonArray removed = root.value(QStringLiteral("removed")).toArray();
+    for (const QJsonValue &value : removed) {
+        removedIds.append(value.toString());
+    }
+
+    const bool full = root.value(QStringLiteral("full")).toBool();
+    qDebug() << "CatalogSync: version" << version << (full ? "full," : "delta,") << upserts.size()
+             << "upserts," << removedIds.size() << "removed";
+    emit deltaReady(version, full, upserts, removedIds);
+}
@@ -0,0 +1,49 @@
+#ifndef CATALOGSYNC_H
+#define CATALOGSYNC_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+#include "models/appinfo.h"
+
+class HttpClient;
+
+// 应用目录的增量同步：带上一次同步得到的版本标记请求服务器，只取这之后新增、修改和删除的应用。
+// 服务器接口：GET <catalogUrl>?since=<版本> 返回
+// {"version": "<新版本>", "full": false, "added": [应用], "updated": [应用], "removed": ["<应用ID>", ...]}，
+// 版本为空或服务器已不认识该版本时返回 "full": true 和完整目录（放在 added 中）。
+// 应用对象的字段：id、name、description、iconPath、packageUrl、packageHash。
+// 请求经 HttpClient 发出：多处同时同步时只请求一次，服务器返回 ETag 时响应被缓存并在下次请求时重新验证
+class CatalogSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CatalogSync(const QUrl &catalogUrl, QObject *parent = nullptr);
+    ~CatalogSync() override;
+
+    // 请求 since 之后的变化，上一次请求未完成时忽略
+    void fetch(const QString &since);
+    bool isBusy() const { return m_request != 0; }
+
+    static QJsonObject toJson(const AppInfo &app);
+    static AppInfo fromJson(const QJsonObject &object);
+
+signals:
+    // full 为 true 时 upserts 是完整目录，removedIds 为空，不在其中的本地应用应删除
+    void deltaReady(const QString &version, bool full, const QList<AppInfo> &upserts, const QStringList &removedIds);
+    void failed(const QString &error);
+
+private:
+    void handleFinished(quint64 requestId, const QByteArray &body);
+    void handleFailed(quint64 requestId, const QString &error);
+
+private:
+    QUrl m_url;
+    HttpClient *m_client;
+    quint64 m_request;            // 进行中的请求编号
+};
+
+#endif // CATALOGSYNC_H
@@ -0,0 +1,66 @@
+#include "downloadmanager.h"
+#include "downloadworker.h"
+
+DownloadManager::DownloadManager(QObject *parent)
+    : QObject(parent)
+    , m_worker(new DownloadWorker)
+    , m_nextId(1)
+{
+    m_thread.setObjectName(QStringLiteral("DownloadManager"));
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // 工作对象的信号跨线程转发（自动使用队列连接）
+    connect(m_worker, &DownloadWorker::progressChanged, this, &DownloadManager::progressChanged);
+    connect(m_worker, &DownloadWorker::finished, this, &DownloadManager::finished);
+    connect(m_worker, &DownloadWorker::failed, this, &DownloadManager::failed);
+
+    m_thread.start();
+}
+
+DownloadManager::~DownloadManager()
+{
+    // 保存所有未完成下载的进度
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker]() { worker->shutdown(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+quint64 DownloadManager::download(const QUrl &url, const QString &filePath, const QString &expectedHash)
+{
+    const quint64 id = m_nextId++;
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, id, url, filePath, expectedHash]() {
+        worker->download(id, url, filePath, expectedHash);
+    }, Qt::QueuedConnection);
+    return id;
+}
+
+void DownloadManager::pause(quint64 id)
+{
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, id]() { worker->pause(id); }, Qt::QueuedConnection);
+}
+
+void DownloadManager::cancel(quint64 id)
+{
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, id]() { worker->cancel(id); }, Qt::QueuedConnection);
+}
+
+void DownloadManager::setMaxConnections(int connections)
+{
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, connections]() {
+        worker->setMaxConnections(connections);
+    }, Qt::QueuedConnection);
+}
+
+void DownloadManager::setBandwidthLimit(qint64 bytesPerSecond)
+{
+    DownloadWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, bytesPerSecond]() {
+        worker->setBandwidthLimit(bytesPerSecond);
+    }, Qt::QueuedConnection);
+}
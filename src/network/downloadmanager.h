@@ -0,0 +1,46 @@
+#ifndef DOWNLOADMANAGER_H
+#define DOWNLOADMANAGER_H
+
+#include <QObject>
+#include <QThread>
+#include <QUrl>
+
+class DownloadWorker;
+
+// 安装包下载模块：多连接分段下载、断点续传、全局限速。
+// 下载在独立线程上进行，所有接口都是异步的，结果通过信号返回；
+// 进度按固定间隔汇总后发出，不会每收到一块数据就通知界面。
+class DownloadManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DownloadManager(QObject *parent = nullptr);
+    ~DownloadManager() override;
+
+    // 开始下载，返回下载编号。目标文件旁有未完成的进度时自动续传。
+    // expectedHash 为目录中的树哈希（见 TreeHash），下载时同步计算，不一致时以 failed 结束
+    quint64 download(const QUrl &url, const QString &filePath, const QString &expectedHash = QString());
+    // 暂停下载并保存进度，之后用相同的地址和路径再次 download() 即可续传
+    void pause(quint64 id);
+    // 取消下载并删除临时文件
+    void cancel(quint64 id);
+
+    // 每个下载的并行连接数（1-6）
+    void setMaxConnections(int connections);
+    // 所有下载共享的带宽上限（字节/秒），0 表示不限速
+    void setBandwidthLimit(qint64 bytesPerSecond);
+
+signals:
+    void progressChanged(quint64 id, qint64 bytesReceived, qint64 bytesTotal, qint64 bytesPerSecond);
+    // 文件已通过校验；hash 为实际的树哈希
+    void finished(quint64 id, const QString &filePath, const QString &hash);
+    void failed(quint64 id, const QString &error);
+
+private:
+    QThread m_thread;            // 下载线程
+    DownloadWorker *m_worker;    // 运行在下载线程上的工作对象
+    quint64 m_nextId;            // 下载编号
+};
+
+#endif // DOWNLOADMANAGER_H
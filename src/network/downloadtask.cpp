@@ -0,0 +1,722 @@
+#include "downloadtask.h"
+#include "bandwidthlimiter.h"
+#include "core/trace.h"
+#include "core/treehash.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QTimer>
+
+namespace {
+
+const int kMaxConnections = 6;                     // QNetworkAccessManager 每个主机最多 6 个 HTTP/1.1 连接
+const qint64 kMinSegmentSize = TreeHash::LeafSize; // 小于 2 倍该大小的分段不再拆分
+const qint64 kChunkSize = 64 * 1024;               // 每次从连接读取的最大字节数
+const qint64 kReadBufferSize = 256 * 1024;         // 每个连接的接收缓冲区上限，满了以后由 TCP 流控限速
+const int kMaxRetries = 5;                         // 单个分段的最大重试次数
+const int kRetryDelay = 1000;                      // 重试间隔（毫秒），随重试次数递增
+const int kMaxRestarts = 2;                        // 服务器文件变化后最多重新下载的次数
+const int kSaveInterval = 1000;                    // 保存分段进度的间隔（毫秒）
+const int kTransferTimeout = 30000;                // 连接无数据超时（毫秒）
+
+QNetworkRequest makeRequest(const QUrl &url)
+{
+    QNetworkRequest request(url);
+    // 每个分段需要独立的连接，HTTP/2 会把它们复用到同一个连接上
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+    // Range 的偏移针对未压缩的内容，禁止自动 gzip
+    request.setRawHeader("Accept-Encoding", "identity");
+    request.setTransferTimeout(kTransferTimeout);
+    return request;
+}
+
+int statusCode(QNetworkReply *reply)
+{
+    return reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+}
+
+// If-Range 只接受强校验值：弱 ETag 时改用 Last-Modified
+QString validatorOf(QNetworkReply *reply)
+{
+    const QByteArray etag = reply->rawHeader("ETag");
+    if (!etag.isEmpty() && !etag.startsWith("W/")) {
+        return QString::fromLatin1(etag);
+    }
+    return QString::fromLatin1(reply->rawHeader("Last-Modified"));
+}
+
+} // namespace
+
+DownloadTask::DownloadTask(quint64 id, const QUrl &url, const QString &filePath,
+                           const QString &expectedHash, QNetworkAccessManager *network,
+                           BandwidthLimiter *limiter, QObject *parent)
+    : QObject(parent)
+    , m_id(id)
+    , m_url(url)
+    , m_filePath(filePath)
+    , m_expectedHash(expectedHash)
+    , m_network(network)
+    , m_limiter(limiter)
+    , m_maxConnections(4)
+    , m_state(Idle)
+    , m_probe(nullptr)
+    , m_rangesSupported(false)
+    , m_total(-1)
+    , m_received(0)
+    , m_restarts(0)
+    , m_buffer(kChunkSize, Qt::Uninitialized)
+    , m_saveTimer(new QTimer(this))
+    , m_stateDirty(false)
+{
+    m_saveTimer->setInterval(kSaveInterval);
+    connect(m_saveTimer, &QTimer::timeout, this, [this]() {
+        if (m_stateDirty) {
+            saveState();
+        }
+    });
+}
+
+DownloadTask::~DownloadTask()
+{
+    if (m_state == Downloading) {
+        pause();
+    } else {
+        stopAll();
+    }
+}
+
+void DownloadTask::setMaxConnections(int connections)
+{
+    m_maxConnections = qBound(1, connections, kMaxConnections);
+    scheduleSegments();
+}
+
+void DownloadTask::start()
+{
+    if (m_state == Probing || m_state == Downloading || m_state == Finished) return;
+
+    m_rangesSupported = false;
+    m_segments.clear();
+    m_leaves.clear();
+    m_validator.clear();
+    m_total = -1;
+    m_received = 0;
+
+    // 读取上次的分段进度，探测结果确认文件未变化后才会使用
+    loadState();
+
+    // 只请求第一个字节：206 说明支持 Range，并从 Content-Range 得到文件大小
+    QNetworkRequest request = makeRequest(m_url);
+    request.setRawHeader("Range", "bytes=0-0");
+    m_probe = m_network->get(request);
+    m_state = Probing;
+    connect(m_probe, &QNetworkReply::metaDataChanged, this, &DownloadTask::handleProbeResponse);
+    connect(m_probe, &QNetworkReply::finished, this, &DownloadTask::handleProbeFinished);
+}
+
+void DownloadTask::pause()
+{
+    if (m_state != Probing && m_state != Downloading) return;
+
+    const bool downloading = m_state == Downloading;
+    stopAll();
+    if (downloading) {
+        saveState();
+    }
+    m_file.close();
+    m_state = Paused;
+}
+
+void DownloadTask::cancel()
+{
+    stopAll();
+    m_file.close();
+    removeTemporaryFiles();
+
+    if (m_state != Finished && m_state != Failed) {
+        m_state = Failed;
+        emit failed(m_id, QStringLiteral("下载已取消"));
+    }
+}
+
+void DownloadTask::resumeReading()
+{
+    for (int i = 0; i < m_segments.size() && m_state == Downloading; ++i) {
+        if (m_segments.at(i).waiting) {
+            processSegment(i);
+        }
+    }
+}
+
+void DownloadTask::handleProbeResponse()
+{
+    QNetworkReply *reply = m_probe;
+    const int status = statusCode(reply);
+    if (status != 200 && status != 206) return;  // 错误由 finished 处理
+
+    disconnect(reply, nullptr, this, nullptr);
+    m_probe = nullptr;
+    const QString validator = validatorOf(reply);
+
+    if (status == 206) {
+        const QByteArray range = reply->rawHeader("Content-Range");
+        bool ok = false;
+        const qint64 total = range.mid(range.lastIndexOf('/') + 1).toLongLong(&ok);
+        reply->abort();
+        reply->deleteLater();
+        if (!ok) {
+            fail(QStringLiteral("服务器返回的 Content-Range 无效：%1").arg(QString::fromLatin1(range)));
+            return;
+        }
+        beginSegments(total, true, validator);
+        return;
+    }
+
+    // 服务器不支持 Range：直接把探测连接当作唯一的分段继续下载
+    const QVariant length = reply->header(QNetworkRequest::ContentLengthHeader);
+    beginSegments(length.isValid() ? length.toLongLong() : -1, false, validator);
+    if (m_state == Downloading) {
+        attachReply(0, reply);
+        processSegment(0);
+    } else {
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void DownloadTask::handleProbeFinished()
+{
+    TRACE_SPAN("network", "DownloadTask::handleProbeFinished");
+    QNetworkReply *reply = m_probe;
+    m_probe = nullptr;
+    reply->deleteLater();
+
+    // 空文件无法请求第一个字节
+    const int status = statusCode(reply);
+    if (status == 416 && reply->rawHeader("Content-Range").endsWith("/0")) {
+        m_total = 0;
+        if (openPartFile(true)) {
+            complete();
+        } else {
+            fail(QStringLiteral("无法创建文件：%1").arg(m_file.errorString()));
+        }
+        return;
+    }
+
+    fail(reply->error() != QNetworkReply::NoError
+             ? reply->errorString()
+             : QStringLiteral("无法获取文件信息（HTTP %1）").arg(status));
+}
+
+void DownloadTask::beginSegments(qint64 total, bool rangesSupported, const QString &validator)
+{
+    // 大小和校验值都一致时才沿用上次的进度
+    bool resume = rangesSupported && !m_segments.isEmpty() && total == m_total
+                  && !validator.isEmpty() && validator == m_validator
+                  && QFileInfo(partPath()).size() == total;
+    for (const Segment &segment : m_segments) {
+        // 分段起点必须是叶子块边界，否则无法接着计算哈希
+        resume = resume && segment.start % TreeHash::LeafSize == 0;
+    }
+
+    m_rangesSupported = rangesSupported;
+    m_total = total;
+    m_validator = validator;
+
+    if (!resume) {
+        Segment whole;
+        whole.end = total >= 0 ? total - 1 : -1;
+        m_segments.clear();
+        m_segments.append(whole);
+        m_leaves.clear();
+    }
+    m_leaves.resize(qMax<qsizetype>(m_leaves.size(), TreeHash::leafCount(total)));
+
+    m_received = 0;
+    for (const Segment &segment : m_segments) {
+        m_received += segment.received;
+    }
+
+    if (!openPartFile(!resume)) {
+        fail(QStringLiteral("无法创建文件：%1").arg(m_file.errorString()));
+        return;
+    }
+    if (resume && !rehashPartialLeaves()) {
+        fail(QStringLiteral("读取已下载的数据失败：%1").arg(m_file.errorString()));
+        return;
+    }
+
+    m_state = Downloading;
+    m_stateDirty = true;
+    saveState();
+    m_saveTimer->start();
+
+    if (!m_rangesSupported) return;
+
+    if (m_received == m_total) {
+        complete();
+    } else {
+        scheduleSegments();
+    }
+}
+
+void DownloadTask::scheduleSegments()
+{
+    if (m_state != Downloading || !m_rangesSupported) return;
+
+    // 连接数不足时先拆分剩余最多的分段，再启动所有未开始的分段
+    int pending = 0;
+    for (const Segment &segment : m_segments) {
+        if (!segment.isDone()) {
+            ++pending;
+        }
+    }
+    while (pending < m_maxConnections && splitLargestSegment()) {
+        ++pending;
+    }
+
+    for (int i = 0; i < m_segments.size() && activeConnections() < m_maxConnections; ++i) {
+        if (!m_segments.at(i).isDone() && !m_segments.at(i).reply) {
+            startSegment(i);
+        }
+    }
+}
+
+bool DownloadTask::splitLargestSegment()
+{
+    int largest = -1;
+    qint64 largestRemaining = 0;
+    for (int i = 0; i < m_segments.size(); ++i) {
+        const Segment &segment = m_segments.at(i);
+        const qint64 remaining = segment.end - segment.position() + 1;
+        if (segment.end >= 0 && remaining > largestRemaining) {
+            largest = i;
+            largestRemaining = remaining;
+        }
+    }
+    if (largest < 0 || largestRemaining < kMinSegmentSize * 2) return false;
+
+    // 后一半（从叶子块边界开始）成为新的分段；正在下载的连接读到新的结尾时会被断开
+    const qint64 middle = m_segments.at(largest).position() + largestRemaining / 2;
+    Segment tail;
+    tail.start = (middle + TreeHash::LeafSize - 1) / TreeHash::LeafSize * TreeHash::LeafSize;
+    tail.end = m_segments.at(largest).end;
+    m_segments[largest].end = tail.start - 1;
+    m_segments.append(tail);
+    m_stateDirty = true;
+    return true;
+}
+
+void DownloadTask::startSegment(int index)
+{
+    Segment &segment = m_segments[index];
+    QNetworkRequest request = makeRequest(m_url);
+
+    if (m_rangesSupported) {
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.position())
+                                      + '-' + QByteArray::number(segment.end));
+        // 文件在服务器上变化时返回完整内容（200），而不是拼接出错误的文件
+        if (!m_validator.isEmpty()) {
+            request.setRawHeader("If-Range", m_validator.toLatin1());
+        }
+    } else {
+        // 不支持 Range 只能从头开始
+        m_received -= segment.received;
+        segment.received = 0;
+        segment.leafHash.reset();
+        m_leaves.clear();
+    }
+
+    attachReply(index, m_network->get(request));
+}
+
+void DownloadTask::attachReply(int index, QNetworkReply *reply)
+{
+    Segment &segment = m_segments[index];
+    segment.reply = reply;
+    segment.waiting = false;
+    segment.accepted = false;
+
+    reply->setReadBufferSize(kReadBufferSize);
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, index]() { handleSegmentResponse(index); });
+    connect(reply, &QNetworkReply::readyRead, this, [this, index]() { processSegment(index); });
+    connect(reply, &QNetworkReply::finished, this, [this, index]() { processSegment(index); });
+}
+
+void DownloadTask::processSegment(int index)
+{
+    TRACE_SPAN("network", "DownloadTask::processSegment");
+    if (m_state != Downloading) return;
+
+    QNetworkReply *reply = m_segments.at(index).reply;
+    if (!reply) return;
+
+    // 状态码确认之前不能读取内容：错误页或不符合请求的内容会写进文件和哈希
+    if (!m_segments.at(index).accepted && !handleSegmentResponse(index)) {
+        if (m_state == Downloading && m_segments.at(index).reply == reply && reply->isFinished()) {
+            // 没有收到响应头连接就结束了
+            const QString error = reply->error() != QNetworkReply::NoError
+                                      ? reply->errorString()
+                                      : QStringLiteral("连接提前断开");
+            releaseReply(m_segments[index]);
+            retrySegment(index, error);
+        }
+        return;
+    }
+
+    Segment &segment = m_segments[index];
+    while (!segment.isDone() && reply->bytesAvailable() > 0) {
+        qint64 wanted = qMin<qint64>(reply->bytesAvailable(), m_buffer.size());
+        if (segment.end >= 0) {
+            wanted = qMin(wanted, segment.end - segment.position() + 1);
+        }
+
+        // 带宽额度用完时停止读取，等限速器补充后由 resumeReading() 继续
+        const qint64 granted = m_limiter->acquire(wanted);
+        if (granted <= 0) {
+            segment.waiting = true;
+            return;
+        }
+
+        const qint64 read = reply->read(m_buffer.data(), granted);
+        if (read <= 0) break;
+
+        if (!m_file.seek(segment.position()) || m_file.write(m_buffer.constData(), read) != read) {
+            fail(QStringLiteral("写入文件失败：%1").arg(m_file.errorString()));
+            return;
+        }
+        hashData(segment, m_buffer.constData(), read);
+        segment.received += read;
+        m_received += read;
+        m_stateDirty = true;
+    }
+    segment.waiting = false;
+
+    if (segment.isDone()) {
+        finishLeaf(segment);
+        releaseReply(segment);
+        segment.retries = 0;
+    } else if (reply->isFinished() && reply->bytesAvailable() == 0) {
+        if (reply->error() == QNetworkReply::NoError && segment.end < 0) {
+            // 长度未知的下载以连接正常结束为准
+            segment.end = segment.position() - 1;
+            m_total = segment.position();
+            finishLeaf(segment);
+            releaseReply(segment);
+        } else {
+            const QString error = reply->error() != QNetworkReply::NoError
+                                      ? reply->errorString()
+                                      : QStringLiteral("连接提前断开");
+            releaseReply(segment);
+            retrySegment(index, error);
+            return;
+        }
+    } else {
+        return;
+    }
+
+    for (const Segment &other : m_segments) {
+        if (!other.isDone()) {
+            scheduleSegments();
+            return;
+        }
+    }
+    complete();
+}
+
+// 分段请求带 Range 时只接受 206；不支持 Range 时（唯一的分段）只接受 200。
+// 返回 false 表示内容不能写入：响应头还没到，或者已经重新开始下载、安排了重试
+bool DownloadTask::handleSegmentResponse(int index)
+{
+    TRACE_SPAN("network", "DownloadTask::handleSegmentResponse");
+    Segment &segment = m_segments[index];
+    QNetworkReply *reply = segment.reply;
+    if (!reply) return false;
+    if (segment.accepted) return true;
+
+    const int status = statusCode(reply);
+    if (status == 0) return false;
+
+    if (m_rangesSupported && status == 200) {
+        // If-Range 不匹配：服务器上的文件已经变化，丢弃已下载的内容重新开始
+        if (++m_restarts > kMaxRestarts) {
+            fail(QStringLiteral("服务器上的文件不断变化，无法完成下载"));
+            return false;
+        }
+        stopAll();
+        m_file.close();
+        removeTemporaryFiles();
+        m_state = Idle;
+        start();
+        return false;
+    }
+
+    if (status != (m_rangesSupported ? 206 : 200)) {
+        // 错误页等其他响应：不读取内容，已下载的进度和哈希保持不变，稍后重试这个分段
+        releaseReply(segment);
+        retrySegment(index, QStringLiteral("服务器返回了意外的响应（HTTP %1）").arg(status));
+        return false;
+    }
+
+    segment.accepted = true;
+    return true;
+}
+
+void DownloadTask::releaseReply(Segment &segment)
+{
+    if (!segment.reply) return;
+
+    disconnect(segment.reply, nullptr, this, nullptr);
+    if (!segment.reply->isFinished()) {
+        segment.reply->abort();
+    }
+    segment.reply->deleteLater();
+    segment.reply = nullptr;
+    segment.waiting = false;
+}
+
+void DownloadTask::retrySegment(int index, const QString &error)
+{
+    Segment &segment = m_segments[index];
+    if (++segment.retries > kMaxRetries) {
+        fail(error);
+        return;
+    }
+
+    // 在此期间空闲的连接也可能接手这个分段
+    QTimer::singleShot(kRetryDelay * segment.retries, this, [this, index]() {
+        if (m_state == Downloading && !m_segments.at(index).reply && !m_segments.at(index).isDone()
+            && activeConnections() < m_maxConnections) {
+            startSegment(index);
+        }
+    });
+}
+
+void DownloadTask::hashData(Segment &segment, const char *data, qint64 length)
+{
+    // 按叶子块边界切分，每填满一块就得到该块的哈希
+    qint64 position = segment.position();
+    while (length > 0) {
+        const qint64 leafEnd = (position / TreeHash::LeafSize + 1) * TreeHash::LeafSize;
+        const qint64 count = qMin(length, leafEnd - position);
+        segment.leafHash.addData(data, count);
+        position += count;
+        data += count;
+        length -= count;
+
+        if (position == leafEnd) {
+            const int leaf = int(position / TreeHash::LeafSize) - 1;
+            if (m_leaves.size() <= leaf) {
+                m_leaves.resize(leaf + 1);
+            }
+            m_leaves[leaf] = segment.leafHash.result();
+            segment.leafHash.reset();
+        }
+    }
+}
+
+void DownloadTask::finishLeaf(Segment &segment)
+{
+    // 文件末尾不足一块的叶子
+    const qint64 position = segment.position();
+    if (position % TreeHash::LeafSize == 0) return;
+
+    const int leaf = int(position / TreeHash::LeafSize);
+    if (m_leaves.size() <= leaf) {
+        m_leaves.resize(leaf + 1);
+    }
+    m_leaves[leaf] = segment.leafHash.result();
+    segment.leafHash.reset();
+}
+
+bool DownloadTask::rehashPartialLeaves()
+{
+    // 哈希的中间状态没有保存，续传时重新读取当前叶子块中已下载的部分（每个分段最多 4MB）
+    for (Segment &segment : m_segments) {
+        segment.leafHash.reset();
+        if (segment.isDone()) continue;
+
+        const qint64 leafStart = segment.position() / TreeHash::LeafSize * TreeHash::LeafSize;
+        if (!m_file.seek(leafStart)) return false;
+        for (qint64 offset = leafStart; offset < segment.position();) {
+            const qint64 read = m_file.read(m_buffer.data(), qMin<qint64>(m_buffer.size(), segment.position() - offset));
+            if (read <= 0) return false;
+            segment.leafHash.addData(m_buffer.constData(), read);
+            offset += read;
+        }
+    }
+    return true;
+}
+
+int DownloadTask::activeConnections() const
+{
+    int count = 0;
+    for (const Segment &segment : m_segments) {
+        if (segment.reply) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool DownloadTask::openPartFile(bool truncate)
+{
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+
+    m_file.close();
+    m_file.setFileName(partPath());
+    QIODevice::OpenMode mode = QIODevice::ReadWrite | QIODevice::Unbuffered;
+    if (truncate) {
+        mode |= QIODevice::Truncate;
+    }
+    if (!m_file.open(mode)) return false;
+
+    // 预先分配完整大小，各分段直接写到自己的偏移
+    return m_total <= 0 || m_file.size() == m_total || m_file.resize(m_total);
+}
+
+bool DownloadTask::loadState()
+{
+    QFile file(statePath());
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value(QStringLiteral("url")).toString() != m_url.toString()) return false;
+
+    m_total = root.value(QStringLiteral("total")).toInteger(-1);
+    m_validator = root.value(QStringLiteral("validator")).toString();
+    m_segments.clear();
+
+    const QJsonArray segments = root.value(QStringLiteral("segments")).toArray();
+    for (const QJsonValue &value : segments) {
+        const QJsonArray fields = value.toArray();
+        if (fields.size() != 3) continue;
+
+        Segment segment;
+        segment.start = fields.at(0).toInteger();
+        segment.end = fields.at(1).toInteger();
+        segment.received = qBound<qint64>(0, fields.at(2).toInteger(), segment.end - segment.start + 1);
+        m_segments.append(segment);
+    }
+
+    const QJsonArray leaves = root.value(QStringLiteral("leaves")).toArray();
+    m_leaves.clear();
+    for (const QJsonValue &value : leaves) {
+        m_leaves.append(QByteArray::fromHex(value.toString().toLatin1()));
+    }
+    return !m_segments.isEmpty();
+}
+
+void DownloadTask::saveState()
+{
+    m_stateDirty = false;
+
+    // 不支持 Range 的下载无法续传，不保存进度
+    if (!m_rangesSupported || m_total <= 0) return;
+
+    QJsonArray segments;
+    for (const Segment &segment : m_segments) {
+        segments.append(QJsonArray{segment.start, segment.end, segment.received});
+    }
+
+    QJsonArray leaves;
+    for (const QByteArray &leaf : m_leaves) {
+        leaves.append(QString::fromLatin1(leaf.toHex()));
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("url"), m_url.toString());
+    root.insert(QStringLiteral("total"), m_total);
+    root.insert(QStringLiteral("validator"), m_validator);
+    root.insert(QStringLiteral("segments"), segments);
+    root.insert(QStringLiteral("leaves"), leaves);
+
+    // 先写临时文件再替换，中途崩溃不会留下损坏的进度文件
+    QSaveFile file(statePath());
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+void DownloadTask::removeTemporaryFiles()
+{
+    QFile::remove(partPath());
+    QFile::remove(statePath());
+}
+
+void DownloadTask::complete()
+{
+    TRACE_SPAN("network", "DownloadTask::complete");
+    stopAll();
+    m_file.close();
+
+    // 叶子哈希齐全时直接得到根哈希；缺失时（理论上不会发生）重新读取文件计算
+    QByteArray root;
+    bool leavesComplete = m_leaves.size() == TreeHash::leafCount(m_total);
+    for (const QByteArray &leaf : std::as_const(m_leaves)) {
+        leavesComplete = leavesComplete && !leaf.isEmpty();
+    }
+    if (leavesComplete) {
+        root = TreeHash::root(m_leaves);
+    } else {
+        root = TreeHash::hashFile(partPath());
+    }
+    const QString hash = QString::fromLatin1(root.toHex());
+
+    // 校验失败的文件不能交给安装步骤
+    if (!m_expectedHash.isEmpty() && hash.compare(m_expectedHash, Qt::CaseInsensitive) != 0) {
+        removeTemporaryFiles();
+        m_state = Failed;
+        emit failed(m_id, QStringLiteral("安装包校验失败：期望 %1，实际 %2").arg(m_expectedHash, hash));
+        return;
+    }
+
+    QFile::remove(m_filePath);
+    if (!QFile::rename(partPath(), m_filePath)) {
+        m_state = Failed;
+        emit failed(m_id, QStringLiteral("无法保存文件：%1").arg(m_filePath));
+        return;
+    }
+    QFile::remove(statePath());
+
+    m_state = Finished;
+    emit finished(m_id, m_filePath, hash);
+}
+
+void DownloadTask::fail(const QString &error)
+{
+    const bool downloading = m_state == Downloading;
+    stopAll();
+    // 保留已下载的分段，下次 start() 时续传
+    if (downloading) {
+        saveState();
+    }
+    m_file.close();
+
+    m_state = Failed;
+    emit failed(m_id, error);
+}
+
+void DownloadTask::stopAll()
+{
+    m_saveTimer->stop();
+
+    if (m_probe) {
+        disconnect(m_probe, nullptr, this, nullptr);
+        m_probe->abort();
+        m_probe->deleteLater();
+        m_probe = nullptr;
+    }
+    for (Segment &segment : m_segments) {
+        releaseReply(segment);
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef DOWNLOADTASK_H
+#define DOWNLOADTASK_H
+
+#include <QObject>
+#include <QFile>
+#include <QList>
+#include <QUrl>
+#include "core/sha256.h"
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+class BandwidthLimiter;
+
+// 单个文件的分段下载：用 HTTP Range 把文件拆成多段并行下载，
+// 数据按偏移直接写入预先分配好的 .part 文件，不在内存中缓存整个响应。
+// 分段进度定期写入 .part.json，中断后再次 start() 会从断点继续。
+// 写入的同时按 TreeHash 的叶子块计算哈希，下载完成即可校验，不需要重新读取文件。
+// 只在下载线程中使用。
+class DownloadTask : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Idle,
+        Probing,      // 正在探测文件大小和是否支持 Range
+        Downloading,
+        Paused,
+        Finished,
+        Failed
+    };
+
+    // expectedHash 为目录中的树哈希（十六进制），为空时不校验
+    DownloadTask(quint64 id, const QUrl &url, const QString &filePath, const QString &expectedHash,
+                 QNetworkAccessManager *network, BandwidthLimiter *limiter,
+                 QObject *parent = nullptr);
+    ~DownloadTask() override;
+
+    void setMaxConnections(int connections);
+
+    void start();
+    // 断开所有连接并保存进度
+    void pause();
+    // 断开所有连接并删除临时文件
+    void cancel();
+    // 限速器补充额度后继续读取等待中的分段
+    void resumeReading();
+
+    quint64 id() const { return m_id; }
+    QString filePath() const { return m_filePath; }
+    State state() const { return m_state; }
+    qint64 bytesReceived() const { return m_received; }
+    qint64 bytesTotal() const { return m_total; }
+
+signals:
+    // hash 为下载内容的树哈希（十六进制）
+    void finished(quint64 id, const QString &filePath, const QString &hash);
+    void failed(quint64 id, const QString &error);
+
+private:
+    // 文件中的一段 [start, end]，end 为 -1 表示长度未知（服务器不支持 Range）
+    struct Segment {
+        qint64 start = 0;
+        qint64 end = -1;
+        qint64 received = 0;
+        QNetworkReply *reply = nullptr;
+        int retries = 0;
+        bool waiting = false;   // 因带宽额度不足暂停读取
+        bool accepted = false;  // 响应状态已确认，内容可以写入文件
+        Sha256 leafHash;        // 当前叶子块的哈希（分段起点总是叶子块边界）
+
+        qint64 position() const { return start + received; }
+        bool isDone() const { return end >= 0 && position() > end; }
+    };
+
+    void handleProbeResponse();
+    void handleProbeFinished();
+    void beginSegments(qint64 total, bool rangesSupported, const QString &validator);
+    void scheduleSegments();
+    bool splitLargestSegment();
+    void startSegment(int index);
+    void attachReply(int index, QNetworkReply *reply);
+    void processSegment(int index);
+    bool handleSegmentResponse(int index);
+    void releaseReply(Segment &segment);
+    void retrySegment(int index, const QString &error);
+    void hashData(Segment &segment, const char *data, qint64 length);
+    void finishLeaf(Segment &segment);
+    bool rehashPartialLeaves();
+    int activeConnections() const;
+
+    bool openPartFile(bool truncate);
+    bool loadState();
+    void saveState();
+    void removeTemporaryFiles();
+    void complete();
+    void fail(const QString &error);
+    void stopAll();
+
+    QString partPath() const { return m_filePath + QStringLiteral(".part"); }
+    QString statePath() const { return m_filePath + QStringLiteral(".part.json"); }
+
+private:
+    quint64 m_id;
+    QUrl m_url;
+    QString m_filePath;                 // 下载完成后的文件路径
+    QString m_expectedHash;             // 期望的树哈希
+    QNetworkAccessManager *m_network;
+    BandwidthLimiter *m_limiter;        // 全局带宽预算
+    int m_maxConnections;               // 最大并行连接数
+
+    State m_state;
+    QFile m_file;                       // .part 文件
+    QList<Segment> m_segments;          // 分段（只追加，下标作为分段编号）
+    QNetworkReply *m_probe;             // 探测请求
+    bool m_rangesSupported;             // 服务器是否支持 Range
+    QString m_validator;                // ETag 或 Last-Modified，用于确认断点续传的是同一个文件
+    qint64 m_total;                     // 文件大小，-1 表示未知
+    qint64 m_received;                  // 已写入的字节数
+    int m_restarts;                     // 文件在服务器上变化导致的重新下载次数
+    QList<QByteArray> m_leaves;         // 已完成的叶子块哈希（未完成的为空）
+    QByteArray m_buffer;                // 复用的读缓冲区
+    QTimer *m_saveTimer;                // 定期保存分段进度
+    bool m_stateDirty;
+};
+
+#endif // DOWNLOADTASK_H
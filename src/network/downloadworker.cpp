@@ -0,0 +1,147 @@
+#include "downloadworker.h"
+#include "bandwidthlimiter.h"
+#include "downloadtask.h"
+#include <QNetworkAccessManager>
+#include <QTimer>
+
+namespace {
+
+const int kProgressInterval = 250;  // 进度报告间隔（毫秒）
+
+} // namespace
+
+DownloadWorker::DownloadWorker(QObject *parent)
+    : QObject(parent)
+    , m_network(new QNetworkAccessManager(this))
+    , m_limiter(new BandwidthLimiter(this))
+    , m_progressTimer(new QTimer(this))
+    , m_maxConnections(4)
+{
+    m_progressTimer->setInterval(kProgressInterval);
+    connect(m_progressTimer, &QTimer::timeout, this, &DownloadWorker::reportProgress);
+    connect(m_limiter, &BandwidthLimiter::refilled, this, &DownloadWorker::handleRefilled);
+}
+
+DownloadWorker::~DownloadWorker()
+{
+    shutdown();
+}
+
+void DownloadWorker::download(quint64 id, const QUrl &url, const QString &filePath,
+                              const QString &expectedHash)
+{
+    if (m_tasks.contains(id)) return;
+
+    DownloadTask *task = new DownloadTask(id, url, filePath, expectedHash, m_network, m_limiter, this);
+    task->setMaxConnections(m_maxConnections);
+    connect(task, &DownloadTask::finished, this, &DownloadWorker::handleTaskFinished);
+    connect(task, &DownloadTask::failed, this, &DownloadWorker::handleTaskFailed);
+
+    m_tasks.insert(id, task);
+    m_progress.insert(id, Progress());
+    m_refillOrder.append(id);
+
+    if (!m_progressTimer->isActive()) {
+        m_progressClock.start();
+        m_progressTimer->start();
+    }
+    task->start();
+}
+
+void DownloadWorker::pause(quint64 id)
+{
+    DownloadTask *task = m_tasks.value(id);
+    if (!task) return;
+
+    // 暂停后任务对象被释放，再次 download() 时从进度文件续传
+    task->pause();
+    removeTask(id);
+}
+
+void DownloadWorker::cancel(quint64 id)
+{
+    if (DownloadTask *task = m_tasks.value(id)) {
+        task->cancel();
+    }
+}
+
+void DownloadWorker::setMaxConnections(int connections)
+{
+    m_maxConnections = connections;
+    for (DownloadTask *task : std::as_const(m_tasks)) {
+        task->setMaxConnections(connections);
+    }
+}
+
+void DownloadWorker::setBandwidthLimit(qint64 bytesPerSecond)
+{
+    m_limiter->setBytesPerSecond(bytesPerSecond);
+}
+
+void DownloadWorker::shutdown()
+{
+    const QList<quint64> ids = m_tasks.keys();
+    for (quint64 id : ids) {
+        pause(id);
+    }
+    m_progressTimer->stop();
+}
+
+void DownloadWorker::reportProgress()
+{
+    const qint64 elapsed = qMax<qint64>(1, m_progressClock.restart());
+
+    for (auto it = m_tasks.cbegin(); it != m_tasks.cend(); ++it) {
+        const DownloadTask *task = it.value();
+        Progress &last = m_progress[it.key()];
+        const qint64 received = task->bytesReceived();
+        if (received == last.received) continue;
+
+        // 速度做指数平滑，避免数值频繁跳动
+        const qint64 instant = last.received < 0 ? 0 : (received - last.received) * 1000 / elapsed;
+        last.bytesPerSecond = last.received < 0 ? instant : (last.bytesPerSecond * 7 + instant * 3) / 10;
+        last.received = received;
+
+        emit progressChanged(it.key(), received, task->bytesTotal(), last.bytesPerSecond);
+    }
+
+    if (m_tasks.isEmpty()) {
+        m_progressTimer->stop();
+    }
+}
+
+void DownloadWorker::handleRefilled()
+{
+    if (m_refillOrder.isEmpty()) return;
+
+    // 每次从不同的任务开始读取，多个下载平分带宽
+    m_refillOrder.append(m_refillOrder.takeFirst());
+    const QList<quint64> order = m_refillOrder;
+    for (quint64 id : order) {
+        if (DownloadTask *task = m_tasks.value(id)) {
+            task->resumeReading();
+        }
+    }
+}
+
+void DownloadWorker::handleTaskFinished(quint64 id, const QString &filePath, const QString &hash)
+{
+    reportProgress();
+    removeTask(id);
+    emit finished(id, filePath, hash);
+}
+
+void DownloadWorker::handleTaskFailed(quint64 id, const QString &error)
+{
+    removeTask(id);
+    emit failed(id, error);
+}
+
+void DownloadWorker::removeTask(quint64 id)
+{
+    m_progress.remove(id);
+    m_refillOrder.removeOne(id);
+    if (DownloadTask *task = m_tasks.take(id)) {
+        task->deleteLater();
+    }
+}
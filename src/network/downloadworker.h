@@ -0,0 +1,62 @@
+#ifndef DOWNLOADWORKER_H
+#define DOWNLOADWORKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QUrl>
+
+class QNetworkAccessManager;
+class QTimer;
+class BandwidthLimiter;
+class DownloadTask;
+
+// 下载工作对象：只在下载线程中使用，网络读取和文件写入都不占用界面线程
+class DownloadWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DownloadWorker(QObject *parent = nullptr);
+    ~DownloadWorker() override;
+
+    void download(quint64 id, const QUrl &url, const QString &filePath, const QString &expectedHash);
+    void pause(quint64 id);
+    void cancel(quint64 id);
+    void setMaxConnections(int connections);
+    void setBandwidthLimit(qint64 bytesPerSecond);
+    // 暂停所有下载并保存进度
+    void shutdown();
+
+signals:
+    void progressChanged(quint64 id, qint64 bytesReceived, qint64 bytesTotal, qint64 bytesPerSecond);
+    void finished(quint64 id, const QString &filePath, const QString &hash);
+    void failed(quint64 id, const QString &error);
+
+private slots:
+    void reportProgress();
+    void handleRefilled();
+    void handleTaskFinished(quint64 id, const QString &filePath, const QString &hash);
+    void handleTaskFailed(quint64 id, const QString &error);
+
+private:
+    // 上一次报告的进度，用于计算速度和跳过没有变化的任务
+    struct Progress {
+        qint64 received = -1;
+        qint64 bytesPerSecond = 0;
+    };
+
+    void removeTask(quint64 id);
+
+private:
+    QNetworkAccessManager *m_network;
+    BandwidthLimiter *m_limiter;         // 所有下载共享的带宽预算
+    QTimer *m_progressTimer;             // 进度报告节流
+    QElapsedTimer m_progressClock;       // 距上次报告的时间
+    QHash<quint64, DownloadTask*> m_tasks;
+    QHash<quint64, Progress> m_progress;
+    QList<quint64> m_refillOrder;        // 轮流优先读取，避免先加入的下载占满额度
+    int m_maxConnections;
+};
+
+#endif // DOWNLOADWORKER_H
@@ -0,0 +1,315 @@
+#include "httpclient.h"
+#include "core/trace.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QStandardPaths>
+
+namespace {
+
+// 按 Cache-Control 计算过期时间；没有 max-age 时每次使用前都要重新验证
+qint64 expiresAt(const QByteArray &cacheControl, qint64 now, bool *noStore)
+{
+    qint64 expires = 0;
+    *noStore = false;
+    const QList<QByteArray> directives = cacheControl.toLower().split(',');
+    for (const QByteArray &raw : directives) {
+        const QByteArray directive = raw.trimmed();
+        if (directive == "no-store") {
+            *noStore = true;
+        } else if (directive == "no-cache") {
+            return 0;
+        } else if (directive.startsWith("max-age=")) {
+            bool ok = false;
+            const qint64 seconds = directive.mid(8).toLongLong(&ok);
+            if (ok && seconds > 0) {
+                expires = now + seconds * 1000;
+            }
+        }
+    }
+    return expires;
+}
+
+qint64 entryBytes(const ResponseCache::Entry &entry)
+{
+    return entry.body.size() + entry.etag.size() + entry.lastModified.size() + 32;
+}
+
+} // namespace
+
+HttpClient *HttpClient::instance()
+{
+    static HttpClient *client = [] {
+        HttpClient *created = new HttpClient(QCoreApplication::instance());
+        created->setCacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                                   + QStringLiteral("/http"));
+        return created;
+    }();
+    return client;
+}
+
+HttpClient::HttpClient(QObject *parent)
+    : QObject(parent)
+    , m_network(new QNetworkAccessManager(this))
+    , m_running(0)
+    , m_maxConcurrent(6)
+    , m_nextId(0)
+{
+    // 缓存文件按提交顺序逐个读写，淘汰时不会删掉还没写完的文件
+    m_pool.setMaxThreadCount(1);
+}
+
+HttpClient::~HttpClient()
+{
+    for (Fetch &fetch : m_fetches) {
+        if (fetch.reply) {
+            fetch.reply->disconnect(this);
+            fetch.reply->abort();
+        }
+    }
+    m_pool.waitForDone();
+}
+
+quint64 HttpClient::get(const QUrl &url, Priority priority)
+{
+    const quint64 id = ++m_nextId;
+    ++m_stats.requests;
+    m_requests.insert(id, url);
+
+    auto it = m_fetches.find(url);
+    if (it != m_fetches.end()) {
+        ++m_stats.coalesced;
+        it->waiters.append(id);
+        setPriority(id, priority);
+        return id;
+    }
+
+    Fetch fetch;
+    fetch.url = url;
+    fetch.priority = priority;
+    fetch.cachePath = m_cache.filePath(url);
+    fetch.waiters.append(id);
+    Fetch &inserted = *m_fetches.insert(url, fetch);
+
+    if (inserted.cachePath.isEmpty()) {
+        enqueue(inserted);
+        startNext();
+        return id;
+    }
+
+    const QString path = inserted.cachePath;
+    m_pool.start([this, url, path]() {
+        ResponseCache::Entry entry;
+        const bool found = ResponseCache::load(path, &entry);
+        QMetaObject::invokeMethod(this, [this, url, found, entry]() {
+            handleLookup(url, found, entry);
+        }, Qt::QueuedConnection);
+    });
+    return id;
+}
+
+void HttpClient::setPriority(quint64 requestId, Priority priority)
+{
+    auto it = m_fetches.find(m_requests.value(requestId));
+    if (it == m_fetches.end() || priority >= it->priority) return;
+
+    // 排队中的请求移到更高优先级队列的末尾；已发出的请求不受影响
+    if (it->state == Queued) {
+        m_queues[it->priority].removeOne(it->url);
+        m_queues[priority].append(it->url);
+    }
+    it->priority = priority;
+}
+
+void HttpClient::cancel(quint64 requestId)
+{
+    const QUrl url = m_requests.take(requestId);
+    auto it = m_fetches.find(url);
+    if (it == m_fetches.end()) return;
+
+    it->waiters.removeOne(requestId);
+    if (it->waiters.isEmpty() && it->state == Queued) {
+        m_queues[it->priority].removeOne(url);
+        m_fetches.erase(it);
+    }
+}
+
+void HttpClient::setCacheDirectory(const QString &dir)
+{
+    m_cache.setDirectory(dir);
+}
+
+void HttpClient::setCacheSize(qint64 bytes)
+{
+    m_cache.setMaxSize(bytes);
+}
+
+void HttpClient::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = qMax(1, count);
+    startNext();
+}
+
+HttpClient::Stats HttpClient::stats() const
+{
+    Stats stats = m_stats;
+    stats.evictions = m_cache.evictions();
+    stats.cacheBytes = m_cache.size();
+    return stats;
+}
+
+void HttpClient::handleLookup(const QUrl &url, bool found, const ResponseCache::Entry &entry)
+{
+    auto it = m_fetches.find(url);
+    if (it == m_fetches.end()) return;
+    if (it->waiters.isEmpty()) {
+        m_fetches.erase(it);
+        return;
+    }
+
+    if (found) {
+        it->cached = entry;
+        it->hasCached = true;
+        if (entry.isFresh(QDateTime::currentMSecsSinceEpoch())) {
+            ++m_stats.hits;
+            const QString path = it->cachePath;
+            const QStringList evicted = m_cache.touch(path, entryBytes(entry));
+            m_pool.start([path, evicted]() {
+                ResponseCache::touchFile(path);
+                for (const QString &victim : evicted) {
+                    QFile::remove(victim);
+                }
+            });
+            complete(url, entry.body, QString());
+            return;
+        }
+    }
+
+    enqueue(*it);
+    startNext();
+}
+
+void HttpClient::enqueue(Fetch &fetch)
+{
+    fetch.state = Queued;
+    m_queues[fetch.priority].append(fetch.url);
+}
+
+void HttpClient::startNext()
+{
+    while (m_running < m_maxConcurrent) {
+        QUrl url;
+        for (QList<QUrl> &queue : m_queues) {
+            if (!queue.isEmpty()) {
+                url = queue.takeFirst();
+                break;
+            }
+        }
+        if (url.isEmpty()) return;
+
+        Fetch &fetch = m_fetches[url];
+        QNetworkRequest request(url);
+        // 小文件多、并发高，HTTP/2 下同一服务器的请求在一个连接上多路复用
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+        request.setPriority(fetch.priority == Visible ? QNetworkRequest::HighPriority
+                            : fetch.priority == Prefetch ? QNetworkRequest::LowPriority
+                                                         : QNetworkRequest::NormalPriority);
+        if (fetch.hasCached) {
+            if (!fetch.cached.etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", fetch.cached.etag);
+            }
+            if (!fetch.cached.lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", fetch.cached.lastModified);
+            }
+        }
+
+        fetch.state = Running;
+        fetch.reply = m_network->get(request);
+        ++m_running;
+        connect(fetch.reply, &QNetworkReply::finished, this, [this, url]() { handleReply(url); });
+    }
+}
+
+void HttpClient::handleReply(const QUrl &url)
+{
+    TRACE_SPAN("network", "HttpClient::handleReply");
+    auto it = m_fetches.find(url);
+    if (it == m_fetches.end()) return;
+
+    QNetworkReply *reply = it->reply;
+    it->reply = nullptr;
+    reply->deleteLater();
+    --m_running;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    bool noStore = false;
+    const qint64 expires = expiresAt(reply->rawHeader("Cache-Control"), now, &noStore);
+
+    if (status == 304 && it->hasCached) {
+        // 内容未变，沿用缓存并更新过期时间和验证信息
+        ++m_stats.revalidated;
+        ResponseCache::Entry entry = it->cached;
+        entry.expiresAt = expires;
+        if (reply->hasRawHeader("ETag")) {
+            entry.etag = reply->rawHeader("ETag");
+        }
+        if (reply->hasRawHeader("Last-Modified")) {
+            entry.lastModified = reply->rawHeader("Last-Modified");
+        }
+        storeEntry(it->cachePath, entry);
+        complete(url, entry.body, QString());
+    } else if (reply->error() == QNetworkReply::NoError) {
+        ++m_stats.misses;
+        ResponseCache::Entry entry;
+        entry.body = reply->readAll();
+        entry.etag = reply->rawHeader("ETag");
+        entry.lastModified = reply->rawHeader("Last-Modified");
+        entry.expiresAt = expires;
+        if (!noStore && (entry.hasValidators() || entry.isFresh(now))) {
+            storeEntry(it->cachePath, entry);
+        }
+        complete(url, entry.body, QString());
+    } else {
+        ++m_stats.failures;
+        if (it->hasCached) {
+            // 离线或服务器故障时先用旧内容
+            qDebug() << "HttpClient: serving stale" << url.toString() << "after" << reply->errorString();
+            complete(url, it->cached.body, QString());
+        } else {
+            complete(url, QByteArray(), reply->errorString());
+        }
+    }
+
+    startNext();
+}
+
+void HttpClient::complete(const QUrl &url, const QByteArray &body, const QString &error)
+{
+    const Fetch fetch = m_fetches.take(url);
+    for (quint64 id : fetch.waiters) {
+        m_requests.remove(id);
+        if (error.isEmpty()) {
+            emit finished(id, body);
+        } else {
+            emit failed(id, error);
+        }
+    }
+}
+
+void HttpClient::storeEntry(const QString &path, const ResponseCache::Entry &entry)
+{
+    if (path.isEmpty()) return;
+
+    const QStringList evicted = m_cache.touch(path, entryBytes(entry));
+    m_pool.start([path, entry, evicted]() {
+        ResponseCache::store(path, entry);
+        for (const QString &victim : evicted) {
+            QFile::remove(victim);
+        }
+    });
+}
@@ -0,0 +1,108 @@
+#ifndef HTTPCLIENT_H
+#define HTTPCLIENT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <QUrl>
+#include "responsecache.h"
+
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// 目录和图标等小文件的 GET 客户端：
+// - 同一地址同时只发一次请求，后来的请求合并到进行中的请求上；
+// - 磁盘响应缓存（见 ResponseCache）：未过期时直接使用，过期后带 If-None-Match / If-Modified-Since 重新验证，
+//   304 时使用缓存的内容；网络失败时有旧内容也先用旧内容；
+// - 请求按优先级排队，同时进行的请求数有上限，可见卡片的图标排在预取之前，排队中的请求可以提升优先级；
+// - 所有请求共用一个 QNetworkAccessManager 并允许 HTTP/2，同一服务器的请求复用连接。
+// 缓存文件的读写在线程池中进行，不阻塞界面线程。
+class HttpClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Visible = 0,   // 当前显示的内容
+        Normal,
+        Prefetch       // 预取，排在其他请求之后
+    };
+
+    // 命中和合并的计数（进程启动以来）
+    struct Stats {
+        quint64 requests = 0;      // get() 调用次数
+        quint64 hits = 0;          // 缓存未过期，没有访问网络
+        quint64 revalidated = 0;   // 服务器返回 304，使用缓存内容
+        quint64 misses = 0;        // 从服务器取得完整内容
+        quint64 coalesced = 0;     // 合并到同一地址进行中的请求上
+        quint64 failures = 0;      // 网络失败（其中有旧内容可用的仍按成功返回）
+        quint64 evictions = 0;     // 因大小上限淘汰的缓存文件
+        qint64 cacheBytes = 0;     // 当前缓存大小
+    };
+
+    static HttpClient *instance();
+
+    explicit HttpClient(QObject *parent = nullptr);
+    ~HttpClient() override;
+
+    // 请求地址的内容，返回请求编号；结果通过 finished 或 failed 返回，同一地址的请求按完成顺序一起返回
+    quint64 get(const QUrl &url, Priority priority = Normal);
+    // 提升排队中请求的优先级（例如预取的图标滚动到了可见区域）
+    void setPriority(quint64 requestId, Priority priority);
+    // 取消请求：不再返回结果；同一地址没有其他请求且尚未发出时从队列中移除，已发出的请求继续完成以填充缓存
+    void cancel(quint64 requestId);
+
+    // 磁盘缓存目录（为空时不缓存）和大小上限
+    void setCacheDirectory(const QString &dir);
+    void setCacheSize(qint64 bytes);
+    // 同时进行的网络请求数
+    void setMaxConcurrent(int count);
+
+    Stats stats() const;
+
+signals:
+    void finished(quint64 requestId, const QByteArray &body);
+    void failed(quint64 requestId, const QString &error);
+
+private:
+    enum State {
+        LookingUp,   // 在线程池中读取缓存
+        Queued,      // 等待发出
+        Running      // 网络请求进行中
+    };
+
+    // 一个地址上合并在一起的请求
+    struct Fetch {
+        QUrl url;
+        QString cachePath;
+        State state = LookingUp;
+        Priority priority = Normal;
+        QList<quint64> waiters;            // 等待结果的请求编号
+        ResponseCache::Entry cached;       // 缓存中的内容（可能已过期）
+        bool hasCached = false;
+        QNetworkReply *reply = nullptr;
+    };
+
+    void handleLookup(const QUrl &url, bool found, const ResponseCache::Entry &entry);
+    void enqueue(Fetch &fetch);
+    void startNext();
+    void handleReply(const QUrl &url);
+    void complete(const QUrl &url, const QByteArray &body, const QString &error);
+    void storeEntry(const QString &path, const ResponseCache::Entry &entry);
+
+private:
+    QNetworkAccessManager *m_network;
+    QThreadPool m_pool;                      // 缓存文件读写
+    ResponseCache m_cache;
+    QHash<QUrl, Fetch> m_fetches;            // 进行中的地址
+    QHash<quint64, QUrl> m_requests;         // 请求编号 -> 地址
+    QList<QUrl> m_queues[Prefetch + 1];      // 每个优先级的等待队列（先进先出）
+    int m_running;
+    int m_maxConcurrent;
+    quint64 m_nextId;
+    Stats m_stats;
+};
+
+#endif // HTTPCLIENT_H
@@ -0,0 +1,113 @@
+#include "responsecache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+const quint32 kMagic = 0x41484331;   // "AHC1"
+
+} // namespace
+
+ResponseCache::ResponseCache()
+    : m_maxSize(64 * 1024 * 1024)
+    , m_size(0)
+    , m_evictions(0)
+{
+}
+
+void ResponseCache::setDirectory(const QString &dir)
+{
+    m_dir = dir;
+    m_order.clear();
+    m_items.clear();
+    m_size = 0;
+    if (m_dir.isEmpty()) return;
+
+    QDir().mkpath(m_dir);
+    // 按修改时间（即最近使用时间）从旧到新加入索引，最新的排在最前
+    const QFileInfoList files = QDir(m_dir).entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+    for (const QFileInfo &info : files) {
+        m_order.push_front(info.filePath());
+        m_items.insert(info.filePath(), { m_order.begin(), info.size() });
+        m_size += info.size();
+    }
+
+    const QStringList evicted = touch(QString(), 0);
+    for (const QString &path : evicted) {
+        QFile::remove(path);
+    }
+}
+
+void ResponseCache::setMaxSize(qint64 bytes)
+{
+    m_maxSize = qMax<qint64>(0, bytes);
+}
+
+QString ResponseCache::filePath(const QUrl &url) const
+{
+    if (m_dir.isEmpty()) return QString();
+    const QByteArray key = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+    return m_dir + QLatin1Char('/') + QString::fromLatin1(key);
+}
+
+QStringList ResponseCache::touch(const QString &path, qint64 bytes)
+{
+    if (!path.isEmpty()) {
+        auto it = m_items.find(path);
+        if (it != m_items.end()) {
+            m_size -= it->bytes;
+            m_order.erase(it->position);
+            m_items.erase(it);
+        }
+        m_order.push_front(path);
+        m_items.insert(path, { m_order.begin(), bytes });
+        m_size += bytes;
+    }
+
+    // 从最久未使用的一端淘汰，刚使用的文件保留（即使它本身超过上限）
+    QStringList evicted;
+    while (m_size > m_maxSize && m_order.size() > 1) {
+        const QString victim = m_order.back();
+        m_order.pop_back();
+        m_size -= m_items.take(victim).bytes;
+        evicted.append(victim);
+        ++m_evictions;
+    }
+    return evicted;
+}
+
+bool ResponseCache::load(const QString &path, Entry *entry)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    stream >> magic;
+    if (magic != kMagic) return false;
+    stream >> entry->etag >> entry->lastModified >> entry->expiresAt >> entry->body;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool ResponseCache::store(const QString &path, const Entry &entry)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream stream(&file);
+    stream << kMagic << entry.etag << entry.lastModified << entry.expiresAt << entry.body;
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+void ResponseCache::touchFile(const QString &path)
+{
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+}
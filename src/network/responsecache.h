@@ -0,0 +1,62 @@
+#ifndef RESPONSECACHE_H
+#define RESPONSECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <list>
+
+// HttpClient 的磁盘响应缓存：每个地址一个文件（文件名为地址的 SHA-1），保存响应体和用于重新验证的
+// ETag、Last-Modified 以及过期时间。总大小超过上限时按最近使用时间淘汰（LRU）。
+// 文件的读写可以在任意线程进行（load/store 是静态函数），淘汰顺序的索引只在所属线程维护；
+// 最近使用时间保存为文件的修改时间，重启后扫描目录恢复索引。
+class ResponseCache
+{
+public:
+    struct Entry {
+        QByteArray body;
+        QByteArray etag;
+        QByteArray lastModified;
+        qint64 expiresAt = 0;     // 过期时间（毫秒时间戳），之前可以不经验证直接使用
+
+        bool isFresh(qint64 now) const { return expiresAt > now; }
+        bool hasValidators() const { return !etag.isEmpty() || !lastModified.isEmpty(); }
+    };
+
+    ResponseCache();
+
+    // 设置缓存目录并扫描已有文件（目录为空时不缓存）
+    void setDirectory(const QString &dir);
+    QString directory() const { return m_dir; }
+    void setMaxSize(qint64 bytes);
+    qint64 maxSize() const { return m_maxSize; }
+    qint64 size() const { return m_size; }
+    bool isEnabled() const { return !m_dir.isEmpty(); }
+
+    QString filePath(const QUrl &url) const;
+
+    // 记录一次使用（命中或写入），返回需要淘汰的文件路径，由调用者删除
+    QStringList touch(const QString &path, qint64 bytes);
+    quint64 evictions() const { return m_evictions; }
+
+    // 读写缓存文件（任意线程）；touchFile 更新最近使用时间
+    static bool load(const QString &path, Entry *entry);
+    static bool store(const QString &path, const Entry &entry);
+    static void touchFile(const QString &path);
+
+private:
+    QString m_dir;
+    qint64 m_maxSize;
+    qint64 m_size;                                   // 索引中文件的总大小
+    quint64 m_evictions;
+    std::list<QString> m_order;                      // 最近使用的在前
+    struct Item {
+        std::list<QString>::iterator position;
+        qint64 bytes;
+    };
+    QHash<QString, Item> m_items;                    // 文件路径 -> 索引项
+};
+
+#endif // RESPONSECACHE_H
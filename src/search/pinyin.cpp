@@ -0,0 +1,114 @@
+#include "pinyin.h"
+#include "pinyintable.h"
+
+namespace Pinyin {
+
+namespace {
+
+int decodeDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 36;
+    if (c == '+') return 62;
+    return 63;
+}
+
+// 常见多音字词组：数据表中每个汉字只有一个读音，这里按词组覆盖
+struct PhraseReading
+{
+    const char16_t *phrase;
+    const char *syllables[4];
+};
+
+const PhraseReading kPhraseReadings[] = {
+    { u"音乐", { "yin", "yue" } },
+    { u"乐器", { "yue", "qi" } },
+    { u"银行", { "yin", "hang" } },
+    { u"重庆", { "chong", "qing" } },
+    { u"会计", { "kuai", "ji" } },
+    { u"长沙", { "chang", "sha" } },
+};
+
+int matchPhrase(const QString &text, int pos, const PhraseReading **reading)
+{
+    for (const PhraseReading &candidate : kPhraseReadings) {
+        const QString phrase = QString::fromUtf16(candidate.phrase);
+        if (QStringView(text).mid(pos).startsWith(phrase)) {
+            *reading = &candidate;
+            return phrase.size();
+        }
+    }
+    return 0;
+}
+
+bool isAsciiAlnum(char16_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+} // namespace
+
+const char *syllable(char32_t ch)
+{
+    if (ch < PinyinTable::kFirstCodePoint || ch > PinyinTable::kLastCodePoint) return nullptr;
+
+    const int offset = static_cast<int>(ch - PinyinTable::kFirstCodePoint) * 2;
+    const int index = (decodeDigit(PinyinTable::kIndex[offset]) << 6)
+                      | decodeDigit(PinyinTable::kIndex[offset + 1]);
+    if (index <= 0 || index > PinyinTable::kSyllableCount) return nullptr;
+    return PinyinTable::kSyllables[index];
+}
+
+Transcription transcribe(const QString &text)
+{
+    Transcription result;
+    result.full.reserve(text.size() * 4);
+    result.initials.reserve(text.size());
+
+    int i = 0;
+    while (i < text.size()) {
+        const char16_t c = text.at(i).unicode();
+
+        const PhraseReading *reading = nullptr;
+        if (const int length = matchPhrase(text, i, &reading)) {
+            for (int k = 0; k < length; ++k) {
+                const char *py = reading->syllables[k];
+                result.syllableStarts.append(result.full.size());
+                result.full.append(py);
+                result.initials.append(py[0]);
+            }
+            i += length;
+            continue;
+        }
+
+        if (const char *py = syllable(c)) {
+            result.syllableStarts.append(result.full.size());
+            result.full.append(py);
+            result.initials.append(py[0]);
+            ++i;
+            continue;
+        }
+
+        if (isAsciiAlnum(c)) {
+            // 英文单词或数字整体作为一个音节
+            const int start = i;
+            while (i < text.size() && isAsciiAlnum(text.at(i).unicode())) {
+                ++i;
+            }
+            const QByteArray word = text.mid(start, i - start).toLatin1().toLower();
+            result.syllableStarts.append(result.full.size());
+            result.full.append(word);
+            // 短的缩写（如 QQ、VS）整体计入首字母，长单词只取首字母
+            result.initials.append(word.size() <= 3 ? word : word.left(1));
+            continue;
+        }
+
+        // 空格、标点等作为分隔符跳过
+        ++i;
+    }
+
+    return result;
+}
+
+} // namespace Pinyin
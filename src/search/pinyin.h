@@ -0,0 +1,26 @@
+#ifndef PINYIN_H
+#define PINYIN_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// 汉字转拼音，用于搜索时的拼音和首字母匹配
+namespace Pinyin {
+
+// 单个字符的拼音（小写、不带声调），非汉字或没有读音时返回 nullptr
+const char *syllable(char32_t ch);
+
+// 一段文本的拼音转写
+struct Transcription
+{
+    QByteArray full;           // 全拼，例如 "腾讯会议" -> "tengxunhuiyi"
+    QList<int> syllableStarts; // 每个音节（或英文单词）在 full 中的起始位置
+    QByteArray initials;       // 首字母，例如 "腾讯会议" -> "txhy"
+};
+
+Transcription transcribe(const QString &text);
+
+} // namespace Pinyin
+
+#endif // PINYIN_H
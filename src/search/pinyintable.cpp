@@ -0,0 +1,489 @@
+// 此文件由工具生成，请勿手工修改。
+// 数据来源：ICU Han-Latin 音译（uconv -x "Han-Latin; Latin-ASCII"），
+// 覆盖 CJK 统一汉字基本区 U+4E00..U+9FFF，多音字取最常用读音。
+
+#include "pinyintable.h"
+
+namespace PinyinTable {
+
+// 不带声调的拼音音节，下标从1开始（0表示无读音）
+const char *const kSyllables[] = {
+    nullptr,
+    "a", "ai", "an", "ang", "ao", "ba", "bai", "ban", "bang", "bao", "bei", "ben", "beng", "bi",
+    "bian", "biao", "bie", "bin", "bing", "bo", "bu", "ca", "cai", "can", "cang", "cao", "ce",
+    "cen", "ceng", "cha", "chai", "chan", "chang", "chao", "che", "chen", "cheng", "chi", "chong",
+    "chou", "chu", "chua", "chuai", "chuan", "chuang", "chui", "chun", "chuo", "ci", "cong", "cou",
+    "cu", "cuan", "cui", "cun", "cuo", "da", "dai", "dan", "dang", "dao", "de", "den", "deng", "di",
+    "dian", "diao", "die", "ding", "diu", "dong", "dou", "du", "duan", "dui", "dun", "duo", "e",
+    "ei", "en", "eng", "er", "fa", "fan", "fang", "fei", "fen", "feng", "fiao", "fo", "fou", "fu",
+    "ga", "gai", "gan", "gang", "gao", "ge", "gei", "gen", "geng", "gong", "gou", "gu", "gua",
+    "guai", "guan", "guang", "gui", "gun", "guo", "ha", "hai", "han", "hang", "hao", "he", "hei",
+    "hen", "heng", "hm", "hong", "hou", "hu", "hua", "huai", "huan", "huang", "hui", "hun", "huo",
+    "ji", "jia", "jian", "jiang", "jiao", "jie", "jin", "jing", "jiong", "jiu", "ju", "juan", "jue",
+    "jun", "ka", "kai", "kan", "kang", "kao", "ke", "kei", "ken", "keng", "kong", "kou", "ku",
+    "kua", "kuai", "kuan", "kuang", "kui", "kun", "kuo", "la", "lai", "lan", "lang", "lao", "le",
+    "lei", "leng", "li", "lia", "lian", "liang", "liao", "lie", "lin", "ling", "liu", "lo", "long",
+    "lou", "lu", "luan", "lue", "lun", "luo", "m", "ma", "mai", "man", "mang", "mao", "me", "mei",
+    "men", "meng", "mi", "mian", "miao", "mie", "min", "ming", "miu", "mo", "mou", "mu", "n", "na",
+    "nai", "nan", "nang", "nao", "ne", "nei", "nen", "neng", "ni", "nian", "niang", "niao", "nie",
+    "nin", "ning", "niu", "nong", "nou", "nu", "nuan", "nue", "nun", "nuo", "o", "ou", "pa", "pai",
+    "pan", "pang", "pao", "pei", "pen", "peng", "pi", "pian", "piao", "pie", "pin", "ping", "po",
+    "pou", "pu", "qi", "qia", "qian", "qiang", "qiao", "qie", "qin", "qing", "qiong", "qiu", "qu",
+    "quan", "que", "qun", "ran", "rang", "rao", "re", "ren", "reng", "ri", "rong", "rou", "ru",
+    "rua", "ruan", "rui", "run", "ruo", "sa", "sai", "san", "sang", "sao", "se", "sen", "seng",
+    "sha", "shai", "shan", "shang", "shao", "she", "shei", "shen", "sheng", "shi", "shou", "shu",
+    "shua", "shuai", "shuan", "shuang", "shui", "shun", "shuo", "si", "song", "sou", "su", "suan",
+    "sui", "sun", "suo", "ta", "tai", "tan", "tang", "tao", "te", "teng", "ti", "tian", "tiao",
+    "tie", "ting", "tong", "tou", "tu", "tuan", "tui", "tun", "tuo", "wa", "wai", "wan", "wang",
+    "wei", "wen", "weng", "wo", "wu", "xi", "xia", "xian", "xiang", "xiao", "xie", "xin", "xing",
+    "xiong", "xiu", "xu", "xuan", "xue", "xun", "ya", "yan", "yang", "yao", "ye", "yi", "yin",
+    "ying", "yo", "yong", "you", "yu", "yuan", "yue", "yun", "za", "zai", "zan", "zang", "zao",
+    "ze", "zei", "zen", "zeng", "zha", "zhai", "zhan", "zhang", "zhao", "zhe", "zhen", "zheng",
+    "zhi", "zhong", "zhou", "zhu", "zhua", "zhuai", "zhuan", "zhuang", "zhui", "zhun", "zhuo", "zi",
+    "zong", "zou", "zu", "zuan", "zui", "zun", "zuo",
+};
+
+const int kSyllableCount = 410;
+
+// 每个汉字占两个字符，按 "0-9A-Za-z+/" 编码音节下标（高6位在前）
+const char kIndex[] =
+    "5j152M3+4c5R1o5J634T4c5R240L5p391U0e0e6E433r4i4i470J5i0o174s0b16472m165o2m5f0J4U1k2D1Y5e41692429"
+    "1O1h0i0W2p6I6B065J0x5L6B2B2j2E3u1S5j5j3K5P2D2D5G345j5j685P601y1J2g5k3w3m421y1g0b0b5j5k5e3B2D3+5i"
+    "5Q5T1U2D5R1y4k184i243M252E4i331y302w6J4L5c5f1S4Z3J1V4z5p0s6540681j1V2w2p5j2G2g2/5p674i4i1I0f5p2Y"
+    "5p5s1y3+5P2B4s4x1a1a5e5V5e3+5e245B5K2L0v281n5j0W1u3H5i5T2B592m5T2B5i440K5o5V0x2l1D364G4G24245K5j"
+    "4g4G2g155y2A3z0e06632A290J4H0o1Q4T2y0J0P6J4i4+631S5S5S5G1w5A4G401V1Y0K0w2q5j0Y0X4R0X5j3H364G1K0Y"
+    "5g40693r5O5P26255h1O0P4G5K1N111L693+3o5p131C5P5j5W2L5j24025P241S1J5Z2A3r0x1S51695o23215p0s5s4T5L"
+    "0i0Z5e5S4c0X2y0P5d5W5L6B5y5S3c0K1e3S3S5V085a2q6A4g480n0D4i253r5j4s5j67121o300x6B0L480E640n5L116B"
+    "6Q5o5g55621r0E5G4e5p5j1S6Q1d3Y5A3S5S485n5H404i2I0A3o211r2f5T1Y5g071J3D251I0J241t231j4957280n5j4i"
+    "5X4g5G2K681U2c5j0c2U1i2j5k4i386B5a5o032v3G1I2y170U0c5d1c6A5j4L0t5R4s0w2v4+28660R422V0V3Y3a2A5P1x"
+    "2C0b666Q0e442v2E4k594g5E0K3L5U0F5E5p5Q0q1E475a1i2T5P2H5j1S2m6M422j5n222B404T3o4v1S5Q2j1S3w0A5p3+"
+    "5R5W5Z5p110Z0e685f2k2j2c4s265Z1S232E5U3k260G0f1M1O5e030B5p5W0E1y0X680J2D5h0s2k5J2c0P6K1Y1h0B564k"
+    "4k360z502G0k5X3q511x5j3+551V2B294x0X291L682R2F6K2E403S2y6I5O2z4t2i22176J0C5P2E3K0N26615i684Z453Y"
+    "5l0b405f4N690l25245L5p0J4Q555L3s5f1O515O1E5V0Z4h2K116Q0U590B5V205h620e5f5o265a600n1S0E686K39245j"
+    "5V5d0N1A0R663i5B5B0B5t2u295L1N0X1j4u684v5R1S5q4J2j3c5s272/0912511q295Q4b402G0P0f4T0B5U5n5h504z5g"
+    "1J0J250w5u511e0I0f3g0O2h0s5n5x6K0D4t050i5p616M4c0j2B0c4Z1o63455f115V2u0B3t2A2l2v31405S505l176E5T"
+    "4b422C5E6P3z5Q2f0X1i2n3+0b0W5L240K210i580x282D4Y1N5S2E1E28265A2p0K1e5S4v5S273C5i2A25423r1O6A024S"
+    "5j2H3a0W5j0y2B5b2V260f0x284Z5u0O0I034L4/0e0V2d3S2A40375P3Y463S0X2o2h2v2X0A5p0G5v684s5o1q450a2j54"
+    "5L2t0f0W4D4k212j2z5v3g515f2h3M1I5P5s5v5q5Y0d645Y5S1i1B2N1B395C0X1I1B1I2A5C4s5f5f4i000y40181N334g"
+    "18002B2j204L5K3P492m5p061c2r5Q1o2d1c561h5X0J3+2E126J1N5g264j245j240W2C334C3P5q331W4C0R2C0R5u1f2C"
+    "336A331d5a39384J5k5V2K2H3a5j384i1h37692E5q3D2S2p1S5V380J174/1W1O0J1y0d2G1y2X5i2i3l1S3C175S2o3/26"
+    "2B4u355C3+1e6H4t2B2m45132q171V265k0p022j0j3D6H0s4s1D2A2p2p3Y5Q19241K1K1K1O2E0f671O3H681S1O3w1O2J"
+    "202J1V103w405Y2V5C050f240y1o1o5x0z130z4G4G0j1N435j242K400t0f5M240x5X1z5J2G2j5r2o2r5y1W0j1S0f4813"
+    "4b3C2q693l0H29293n2j4b0H0W2B1f1b0z0j2Y2T1D1I684l494Z0n2N291j0n1j2J1D24552B2u2z5y5q0u5c2O2b404Z0j"
+    "1f260u2j551M3y0W3+0j6J1W5J0K241D454b1926240K5f2E234h261D1A5P1f1S4h261Y0v2J0j0i0W5D2v2j3q4b3t2S28"
+    "1f422G1z606I2l2E3r2r1j281j2626512324265j26680W263F2j6B2j5e49081c255P302o2A2Q5V68176B3c29484d5j6B"
+    "3F2j2A2f2f2F2S5g5H5U3G2X292o1r4i2N2A1X0K3C0c2e5n5n392N5d2F452v0L370c2h2J39175a5a2K5P5j5d5N4h2f3H"
+    "2v3t4i2444270Y495T5j2G1K2F5A2E0x5V305d5d2v2j0Z4D490A4d5s2D0A1d5P5s5M5Y1U1U0A0o5j5Y3q2E521Y3z1E3n"
+    "1S1c0v2D1c0E1z0B3N4i1L2D5j5t272L272X1y5R481K1j435w2X1M1y5p1j2Y210x1j2l2l4w192D2G5Q3r485j2N5f0F3S"
+    "484i5d403T4R6M4h5P21084i5Q5J1z5V5J0B6M6I5V0x303L0x240K4m0K2X0F0L622I2v5o2v5Q1f5O5V29295L04466833"
+    "5k5L4d244A2w0c2F5V5a2A4A5P241E455Q4T0X5L1E592j651o2j5e5e5f4e11603m5e435e680R3m552j4e1x596O0u1M5q"
+    "0R5q5T5f2j2G4Z120f2D2A051j5f4s2j0X2d2j5f5f5q4s1c2p4K48481I2h195S6E4T0O0O0O0O020w5o0U245o4o1K4j1g"
+    "061J4Q4i4k6I484j0F5a5R3l4u245L4u144O0o2S1e2E2q1f0z2S68286406152N4/0c4i5o473x5i1q4s500c2g13242n1w"
+    "3B5a320c1Y5b5h6J1r24130t5A3D1x2j5C5T605R5i2v5e2/3i235j2H0e2p5F5k1M0E4444290L1R061C1N1E1o592Q4q3+"
+    "1w685k5P5P0Y3J5c5Q0k185M1x1w5P1X5e2H2v1E1Y350w3+0b5P1X1S281w0c4h3J5F1S5j0w3i2j0B5q1l5M415P1E4i2F"
+    "3p5M3O2+2q4C5o116A4i6A585Q5j3+3w6J1e0n5L5a1r3N1T3o5j5U4g1y3D0v482E1o5t5G1D3y3n0H1S5g1r5t1r1n2D5n"
+    "1S0v6A5H2I1e2I6Q0L2t173Y4+4s5S233+1I1E1i605Q5j2o6J3B38685h246A1Y4k5v5U1n212U1+525S1E5b5Z1l5f2f5j"
+    "023v4g5A1w5Y1D5H1m5u5o143k5T021a2X5e0v5U0E213T1z5X2V1D1N243a3G5m1q5q2t3y321Y3h0c4d2j3J6M1r2T5U5S"
+    "2f0K65602m063B2o4x1S0L1o1u1b4r1Y5o5f1e1e0B1o4z0l5j02255C5S5J2j5Q516Q470Z5P5x5e183+11442/3F1c1848"
+    "2f2m4z5x1/2e4Z246M5O1O2A1y3+4j5L4l0X1I2j41035y5m3T5p562c4Z5Q5G1y02643b2P6I6I4c111u2p010N5T5F5P5M"
+    "0s4Z1e3+3+520x0x5i6J0E0s0h1r5e3+651M2m5S3r4Z2b5y5l1f3j654W6E3W1l2z5f11490W0K152e5U2E510c55032D0x"
+    "2I5n5L3L4b5p652b291x1o146A0V5I3g5p5k5t5h3h391y5s0i211/1/5Q1r242Y695L4Z5a201D3W5b2m5p4U0c425f0x3p"
+    "0O2j5m605L3A5l3p0L2Y5Q5p292u2T5x1y555h1r015Z414W5n4v1w5V024z2/0U1n2N0v4U0a4L4u5H243m5P404i1Y6J29"
+    "2f5N5H4s0c1q4z001n4z443W1r684S3I1Y3J1402415A0E05052l6O653F4u4u50113+280d282J504b0Q25025U3t2u1T1e"
+    "5U1y211l3i5S5y0X5a3x0+2/2/1y2h191T515i0D5l4S28385U1z304C0h3q2f5U246B0Y2Y6O5U4s1q1S2n425Q0f0W0x1s"
+    "5d1E6P1K0c215v0j0q0x5p5F0T285i5Q3+1q2l5a10215k3z2G445d3W2v4s5f5l0v623h6A2A3a215V3+1E5x5j4i285q02"
+    "5n2G2V5p3p0z1T1v1C0y5W4S3r3r5k6O3Y112d4+234L1q5R5i1D3r0e242A1q550X5d340M552v210K5o3W5k1y341w652j"
+    "2r1n3M5U3F5f2j2v2t3F0x0a3v3r5T233F5Q1D2T5f0W5l4D122b4+5U2G0m1/236E3W5U0M2j0W0V2j5j2z3M5t4v5Q5+26"
+    "5t6B2d3W3M2d2s5L215k474s3X26215W5k3L5D5D1C2L5q2C3s5s0o1y215q1E1l2Z0o5A5C5L2y1l4B4I2q1e1l4/1l5C5o"
+    "1l5k223z5p1o5q2y495p451l0i5L5q492T3z5q5q5e5C5C5C5D2x215j1/2w2w5C5e5C594h3z2v2V5e5u5L1Y5p5P1j3r5j"
+    "0+4040666I0y3/5R4b2X0X3+3W3F24256868085d5j44352H4J5F1L0C0C502K1+6Q2Q0E2B112B242V112B26502j065P1N"
+    "6G3x08512Z4850685G1V3w121f3S4/3r2C5g1Q052v473H2N1d5c060c0Z2q6B1S1y680k2b2t2t2v050w3n3C5X17241r2v"
+    "0n0c2h1U5k1x1B641S1i5h1D1D1j0U5g5k1J1d5q145V2P4c4j1E0J121w5e2U0v2I0y2J1p3N035X5S5q091S065j5k1o5a"
+    "0k441b020D1L4A5n2H2511302e2F0b4b2A652o2o0L0b1z0L4i5d1l2C5i3T115p0L5e494x3r455J2E2y672R0d170w5003"
+    "0N0f0D2K681D5j685j3o246H3+4V2E3S2T2N512Z3S261B2A1W5p1E3q1e5C2i1L5e402Z034g1D3N5C0b5k220E2l1l146E"
+    "1x0A0A5p1133294N5i1b2K6K5p201E5h5f0A0n350X195G5k1O69292A1u1W0l263w2h5T202i1A5J5b24242V5l4+0b5n2J"
+    "4v4v4i384+5N0b5C514A692j69094S5w1B565P675d1Y66021c5f2K565q5M5V2r1n2e0X3q0D0a2v2v3i40353F6E4o4k2u"
+    "0c310G2B0R4k68632K5n120a685Q1l412A114c3H0s5f4+5/40412m5L6G425/5a4b4b063z2V171K4A3F1C1C6P114h1D1D"
+    "50103H1N20500v5i6B26054124422P5j3r0E12275i5n5c502d2E1+0y4D405d5S5Q1r025e0z1q4N2A2h2X2v5f505L1+2t"
+    "2t4O2j2p4D0W5d5f2h065J4i4G4T6F6F4h5j302N6B6F1y1y2Z5j1y5a2Z4j326P4j5j681e0f271O0B610F4x4B2q1S0u5R"
+    "5Y5V3N5R2Y5Q5I5q334v1D1D5i455I1d1d3+37375k230a0v5y564/1S1g5h5g1p1X4i524/5B5f0E5j2U251D1z2X5s2506"
+    "1G2l1/115f3n2F3+3K1O5V1N12492Y6L1/3+2J600C5j27525w0C5Q201M135d0D12054e5N1m055P05272l1D5s274i1N23"
+    "0E2w1D3c3c153K40264+2D3d0U1q5S1K244r4L1M5K1w6F1S2/0x4G1S2B5f1n5M693j19242Q695h2A5s3A1R0c5r6F3Z5f"
+    "3J5W1N0E5p5G1O5J1L5P5p1j19063S6A6I640v3K5q5B5S681E353F3+0E4g431E1r5a1J673C083H1S2q6J6J4i4C4b5g31"
+    "291e4s5X5L6J2E4b3v4G5h17274k241U5T1z2F281d2f26265j3T6824245S1u1i2H2U5f3D2o3o1E5o5f0U4g5k4i1j496J"
+    "4t5L1w5H2u5e4E282w3w5S4d2j0b5V321S4z355L2N0m0m593U5X3L5p3J3y3P2F4g681o116F1E3v5E5S395P5f5P025f5p"
+    "4s5p5H2j5S2E486G3+5S6I170X2v021E1E2u390o3y2E3x0N2q5J0G5U4k3+211K5O4O501M1M29563S492B222B40125X1y"
+    "5J2c0E5k0e3N1S2B2y032d2Z5k5e2E2j125S1z1z5l0W4g590y5h5P3L0m255B5a5p5L114K350x4N44215O400l3A1S291A"
+    "5j69352039035l5b295L355q67474i5V5G2l334C4s3s5L5H0q1y05290A5a5B1j0f5h3r5Q5q5l4J4L0c2r353l052/1d2Y"
+    "44254V665q294J3D5l244v3V5S523m2e3N0A023r3v5j3t5p2h5b315j632L5n3S2j111j5f2A6E0X5y1o3Q2f3F651y1y05"
+    "3Q412/3u1e5P425G623A5S5S3F2n2l1z1j10685a5j1z5Q2Y4E5Q5f0W28351K1K5S5j21281S4i0E4b4x412l1/5W3V175j"
+    "0O023U3Y2/570e2A0n5p3v4J4L3K5f4/5l403V5r5l390E2/4g5X3S192r5q2d5f4o2q283U2d405l4o2149382j2w5f6B2d"
+    "6J292G2G2R5s2/6J0t4y1S0B6J5U5W374s4/0A241e3c5c5o6E1n2w4y3N3B0o404k0O5e6J3S1S6J2j5c0K4L3K3W3W5l2w"
+    "393Y4J4+1j61465p4j035C4t5J4K5h1w5j2B6H386B0y1w6K1h6A155J5j0A4i4i0d4g2N5b4i5o1/5j574i5S1c0b4B1c5U"
+    "5u600A1n5f5U254g0a4J20382S2W0I4v0N5v245q245k382S451r66261S3Y0J1/35441o5p4i3Y2A3Y685p0A2W3Y443F0U"
+    "2E1f441y5P2n4i3Y614g5L5V2W212n2H1/5j5j0A440d0A1O0t1B4s5d0z2v1B4j3x1O6E1S4e2N27276E5L6P5d4k1B0z5U"
+    "294d1I1I1I1T264k0a4c4c3F1T0X2n5S5S2Z5o5K5o2n2n5h325K5K5K1T5h1D2Y692D1V1e1V5E1V1V4i5k0c2M3S2A5L3V"
+    "2E3r0T5Q0E2E29564855295P134i4i3w245V665V3S625Q5L311E2u3w551M4k5V5C2v2v5Q0T2v2E5V2E2G2n2G4k5Q0Z5F"
+    "3S4b5H5S2j1E21212t5j3+4G5P1o4g5p0f4x3+4G5r085h045e5P291E24401N5J3+0S403+0U29481W5S052d0z066Q6Q5g"
+    "2E1W2N1d5c3x2j57485f1S5Z252q5G3r050w2X5r481y3x3C03572q0c3w171o2Y5Z335A5c5j0F1r062z1E1S5d142v1G1I"
+    "1U49175j3H4i035L1/68382j245A5L5o3/5R2j5h28672w281E1E5p5V0L424B1O1O3N2j5o5S4J0z4g0b5C1b2H1X5R5k5p"
+    "2e2K2f2c5S4A2R0d0d4+2p1z2E2c3+3C2Z2Z6M1e0s5e5e1W2y2y2i2G1D671l5k171o675L5U3r5f4t290D6M2T17621e5k"
+    "6J5y205p5I5g1O475g555j684i5u5h1E6B2K2v5f351o24241/594h35405P5p6K2d2N5f5f5L6K0U4x4J2N445p3+2u5C1B"
+    "5Q5N0P0y4J292J2r5P4t426J5L0D120u405n3W0u244i4Q4t6K272n2L0W140S155C2u636262050Q48410s6O0z0z5Q5p3o"
+    "2t5T0T0K44285f2f622p2n2n2A101D6P281j5h285h2G625j5c3N5i5i5j3W5S245V2N5Q11056O5L5j4J0z2q295p5r5k4L"
+    "292j1j2t2t124J5Q2E0W5l2Y5f5L3N490Y0r2w12123W5f5f5f2Y5f0i2V0i6A202B5d0Y0Y2o1c6Q422E1c2E5P3z3z0U47"
+    "47245j4s0668645T5j2A5d2F065d2A1S5t0E4i0L154m1K3W4i1N3j685Q1y0x5L63510w3F3o3j580K2l686A0K68113F5j"
+    "5j3w3/2F4L4m0w674p42664i4B5Q090w1j0e3w634T5J0w5L0X4Z3+5y1l33191x675a385L5O1S5j093w141c3l20523825"
+    "5421694b313H0G1l5y3H09632B0W1S681y1K0j0E0E6338420W1N37090e3B0f295S2d1V3w3T260J0J5X1V5h1/5o5o241i"
+    "3r595y1i6F3F450E441C0j1j5e07295a2v5P6F2T5l113n125e3A1b0n1S5A3m1M5T5j6857685Z196Q5U5C1j2T32595o0L"
+    "0J0b2c0E24034k2L5n5G4t4k455p5p3A4u0R5T1M2D1E1j2r4Z2l2e4u680L452D2D2A052a2u5k2n0w2v5j0f0W5C4s5W3A"
+    "0X5P1M1i2T2V0E415V2p2p2n2v245l5S595n2j595k5d5f59113k26213K211c3T2J0F5j3+3a1N2E5f5j5w0E5j5j1I4T4i"
+    "1I4i4i1c135k1y1S1w5P5E0c27064g11632G521S11385S1y0Y3c2B665j38495J4d4Q5b2B136327413q0x410E0E4e0x26"
+    "1d1Y1J0E2S260H5U0x1l271w381l5J2G24241j0y2v2v5D216821215j5j5j5j5r5r4b5X5M5A5f5f5p0c0N0G130I3q5n3t"
+    "635l0c0c6I5G241L695j5K0Z0E112q1S5K670q5K2B0w5Q5d1t5g1+2v1x5K0b685a2B5C0o682c0o0+3k5Q17240X680o6A"
+    "2c5p5V29264i250F201S5d5L3m5h5L5Q673t550+67680H0+0d0Z28212821352t5T0A485W5W0E5j2g4G0z151U244G4G0W"
+    "5053531V3+4i0t685K325Q1K5l563C5M690d5P245P5Q255o5J0o4t2V5p0F683+0s0a4/5F403T225Y3Z2X5S5W2L1y2J1N"
+    "1+4/4t5P3i0X0j2E5j0A0Y3C3o6Q5+5g2E083c3N673j0L581y1y2E0v2l4s0e110w5j5C5o1S243q5X5q3S1g1S5Q0E5o43"
+    "5b0o0J205a0f0E4k5Q505n6K1B3F685j4i3Q5d4i5Q2f1u2X3G685V2l5720141q2R1j1u5Q284k4s1y475g21210c255j5Y"
+    "1g2p216J5a0c4c3c1t1G2N17561c495Q3/5r3q2P0+211E5U5A5f2J0R3N5s325n5n5q3r2Z425r5p5C295Q652p551o1q43"
+    "550L5j40215Q0B315j1u4t490b2Y5P5P5o2j2m1/0o5j5r2j3X3N1E4A5b405P3C0o1M0B0+0s0X362j241h1h5X0z3+2R56"
+    "2y5Q2K1k3S450e1C1l622B5J5q2A242d5p231r495055553W5K0m1y225Q0X5W5L211E4z6K265n122E0O0b0+0B430O0x1h"
+    "1D3N5s5T6G14200l464F5X0R0F3C6K55420e0B5b5L1Y405L5p5p0E5b1/3C0E5j395n2J0y5k1E0a333/2N5p02435f3g1V"
+    "5s6K4S2i1N5l2Y2Y4A1c5s4v4v3+5h4t20241e2E0j3S5V2J675n0Q5d4g0K2J5q5Q225n5g2j4V525k0n5a404/205s4g3D"
+    "1c4e0o3t3H3H1l0c0O0O0O0s3C53635A054o311h4A5x2D212J2l3i4t445k2v4c5L5D31404e5n452L11682u2F3+3+5p3w"
+    "2n0o5o0d685A0b3+483q0B0H46285/0c2l3w2Y21420b5k5k5Q5Q0x501D1B1B4v2G0R5U1K1N2f2f0d1o3+5S3C2B2n5P0O"
+    "2G0q5S504h3r5j0f5S3N0x502B4t1o285L5b1744442E0Q2P5V5l05335j2p4W2H1+362d022p5f2a5R0c5p5k0w3702371B"
+    "3+3F2d360e683g3g5f5g0K682X2X5o1S2r3B0b210W372d1+5b4D0W242E1/4e5j2l3L38512G1W1W6F1Y5r5P265a4k4J5Q"
+    "0b5O291Y2641234162173+25145z2524682K242Y1U1062411Y26295p265f2v1y625Q5Q0m0w481y1y1y1E4i55331y2j1L"
+    "4z0F122C4c5j5j4b1y1M5f4j4j0N60472g3z060v4H1K4L5u5G63132L5p2T1V4g0U5G1e2S5P0/40684G2a364V5g3Z080Z"
+    "4E5Q4008255p1S055Q3r68681E0/640b245f2X0F0Y2E5M1y5r2G06440x675s5J3O5j4k6C3y5B182L653y1S3n06055y5D"
+    "2S2y415s1y0A0J683q3L0L3r4/5h66605g0A1r3S5i110c3r253F350a5e0e483C0f251S606B0x0V3H3T2b1S3n083k2p3J"
+    "1g402E4+065G5G052E6I3l640707113S2E2a2t263/5n2d3Y0K5y401t2a4i29673X1c1c494n0t5t2M5j5V0R213v6D4i3J"
+    "070c1f682a1D1D6843033a661Y282U173J572o602v145H2G2o2E682w5e5O4+5V3N0y286724215S5p025G3g0u0K1b5566"
+    "0b4R4R2Q353a2E3q265j594b4M5J5V0U1O285P2H2D5A2Z235C6I3y2v061o4d3W2F5y4k5i2G0L5J0L6P5i612v4u5G2f4y"
+    "09261/0z5L5J443q4e2o3C361S072E0z5O022F5r6K0a0k295C0C3J3T4Q6Q5O3+5S0b124V2y451W1D4j133y1163222452"
+    "3/3+3k4k402q5i5e2G672m1f5j234b672x0N500Z0J29552R5E5f0u6A2E56402P073j292v1g3D29680x370O4V1h3q5q3g"
+    "26672D265p5f2Y3L1w4K3r5L4S6L5b3A553W0U4i6K665j5d5n0F5g1/5f5v035a5e5O2N0h24552b2b0a2J2D2D5C29211a"
+    "0d5U145V5q405i0U600B5h5L0D2d5M440W1Y2u6K1a281d444J4A0e0h624y4y0K0f4J090u4V2N5h0z683c2b264u471X5S"
+    "4r4U2A3B1E0k3g4b4+60513l080v2j521y685H1z405M4156661E5V3g490U601Y5P1G4e2L4e4k075h0I4u504R0W4z2D0d"
+    "0j1g0J1O4m113+4u612l0b0c1h2v2z2u6K1U1y600j511z0s3K3F271j5l6805683W310W2S0f4e5D283F3F650O2Q0G275h"
+    "1d402n245l2G3u3u2f1C5S4N1j5v5j5S0b0b4R3N1w4s1o1i0v6P3T2p67216F28240Q0x0x0Z0K0Z2G1S2n0C1S420K0u6I"
+    "6E5L3z441C3T1z5V2v280r4+1o425O261V5n2h3M2v4b6I5y3z0m240y4W0Q45451/29442V0x5V2I3r07052E5i1E374u38"
+    "244/6I0z5X2d0M2E5i4L5i5i3S5O290I3Y1Y68682a3F265V2o50074u2v2x4E553l5g2h0M4k5v3T5S2H232j2b1/5l2v2t"
+    "40405v402d5S5l354D0W5N0r5V4e2z2H380c5v2w506N2j125H0y282G2d2j3M681j1j3+5d3z3z4j2M5o1U5j1c1V081L67"
+    "3x122S3C5P1e1r0R5U380f1Y115a283C0a2D4g1D5p0c05075a281D2l3W0E0X121D5j1V4T2N5f1C245B5U1D282B5g5R3C"
+    "4k0242026711661S4k2n485Y5j284b286I5j2l0E2j5U5U5M5c3+3+610I2G612e1M08082d5p2d5L184h2n251y5V255p66"
+    "285O57182A0c5k1S4162486I621A0u4s5W6I6I442p6I0f1A6B1L0W1p5p4i3o5o353m3+62332v3o3r2r1S1L5b2B2B3S6M"
+    "645j2r4d265p5j3+681K3t1K622V4x5p5P242424234I0x2D685x5V575d5a1T2b1V1o4/115a0W4i2X5g4i5K3C3C5F0l5P"
+    "5s0B045y08292Z4h1y1L1q1j0X5b3D221N441y5j5Q5W5f5y1L504g2E5g5v0J5X5l5b3x662q0l1q356Q3F0F5a22646K4i"
+    "4i5p1M14333S0X5M17020J046A2t5S2X570Y4i20205b2Y5a282A682A4c5A1w5f1U5T4a5U5i5s211o1o2H5J5S2Z6A5Q0b"
+    "4h0L65655P5J211q0a5J566I6O6A3z2B5Q4b3S5Q453+2B1j675j68035J2p2m0X5K5U5v1M5b1b5j5R5s215a3C2Y5i5l4k"
+    "5L4k45333L263d035g0l5h4z3z3D282J1X5N0X3+1q5f2j022424365v5V1q3H3F0o3S63210A1o5b0i2n5S502B3u2p5F5Q"
+    "5j24200w5i5i2j505A5U1M4g641q5j5T5X4g280A2B5f025i4L4k375d5h3z2j0a2X142n5f232v5Q4J2t3M2z2w4a515f6B"
+    "5r5r485i1b5i1y1r4k0Q0Q4h310T0T556O0O5a215k431N3r5r5o4N3q1N1S2q1M48553c574r662e2e6O3D205K5F0Y243+"
+    "5l6K5K5A2e2f372t3H105L3F0C604k4k3H6B4G063z1D1D0z2j1j242D0E5Z0b0n4Z4L5t49405p1V5P0U4b5d1K5P6J2j5X"
+    "0N0t4G0G5G1163320c5j1U1c192j3+4k1W5727395J2c2D325g2/3A4s5q1p1M0B29171X5h5S0f0l3j4k1z5W0e6B0e4t08"
+    "4t245O2A1d24333r0E5K041L1N5j1S3L5Q1y5e185W665h2p4O1E35641l680o5s6O4h4k5x112j2v260b4t411O625U5S2T"
+    "3w4/5Q681g5U25251d0A3F5j5i5i4i3W0E1D5j2q0J3S2b1r081K690w0n5g1S073G1V3+4C4K334d4t655R5o4g1j5G603L"
+    "3Y5n1168600U0x1e0L2D051S26061D2N3K6B0E2r0V4b4s0f3o4i1g605h0b2D4i682r352j4J605x0G62682t172v4h2j2d"
+    "5n4k5d4n3+663+2j5j5T662j4W1f2K0C4G5U074G0J6J0e5j0n5a6B266O1I1I5o1J1c2M2f622o5k5g1r1a5j4i1Y5u2w1S"
+    "291u1j521i5L2X4L03032F5j6I2T68465A4U4U1/2E2D5c1D6G5p5v005l292r625e4E660y3+421z1j276F5d4z4Z660B59"
+    "2a2B3x0C1S4O5A2G5Q2e2r1O3+5M2H1V4v2m47595o35092t3q6F115b5C5x051e0E111o6J684G0B1b261/5J3g2557245U"
+    "2v224d0S1N4t375P2j2j18445l4z2E555V2Z6I4k0W1K5L2B2j0I5R1Q52682c2l266I2q2j3+0J2y0o40393+3+0N1k0W0+"
+    "1M3k0909226K0b5x242j3q5p5p1e2H17511W5K110u1K0b623+5q5f5p495j4X4G0k2i3+6I1S2N2c6L6L641h1N1N4g453S"
+    "5J1l2v1q295j0e2E2E0b6Q2m41680k5e2E0B286I6J0I3q150f0X361z261j5Q19400z1j122z68493D1S1b3q4b5j5G4X1D"
+    "5i1S5L5L1A256K265j4g5Q5f5f0i260l5p1r605O3s0E5h235a4Q5g2b5f0C212Y292Y4s1O5V5G68263H330f1y1y2l2i59"
+    "3L5p5o354t5b5b5g663s5i24295i0f1C5p6L5L355524292J475l4K202u2g495T3v4i1U502d5M5p0a2v2E4g0f0E5V255j"
+    "621S3g382e4J1e262E4+5h66094Z5q6J3D4v255h29201V1M60402/4y5q5V4J4i680s5M592r4J514A614s4h4+2N5Q1e3+"
+    "1X1X4y3l521Y0l123b244r1d0k410U401+355a1W1X6I5G425g12252K6O0z2t0I6B4U5Q242l215n401l1U1U5D1z3+4X0s"
+    "3q5o1y271y1/1j3W5j1X2L1j1j0Q312A116F2g2e0a0o2j5Z454o1K5A1h5y4v2h2v2m382u0Y4v2N0f510G2v2D65604k63"
+    "313F3V5g573q6B4Z5Q491u260o245f415c5l1I5d68426O0o3z4k1z2Y666P5r4b5Q0l121J1V3F5P424E2p2r425S4P1K62"
+    "5G2f5s4q1C0b51372E0b4v2G2G1221243g5T5G3Y4O6B5A5/1N464C1u401e2r2f1X0f5Q4h6J4T24182B2v260f5q4+4k27"
+    "502p3a5k5Q214b6O5b0b1V2E6O5j443z5f2h1O210y244x0K3w0b0f6C1j242925456126410z5j0G4t4e2p2j0U375k524/"
+    "393+5D0I2324403S3Y5j1X2K5k3b455f3+38641j0l242Y3x100f1Y395o6820402h2h4R2v2j0r2v3B213i2v681X195q2j"
+    "1M6I4u2l270f456B2v5f2j6B0a291E4v1+3W5p2t2c285S1j2E5U2q5l265k5o5l5T3a0K0W2d2E4o4e5L0o49480P2D5p2z"
+    "2j0r2w0y2G5f2d2d6B2h2j063M5p2q1i400n1/5W5p5j403i5a0Y0f3+2J5j2G5Q5a1r5p2Y2e2W4r5Q025j3+0g0c442W2K"
+    "2W2K0i4Z1f5k5W5V5p405U5i1Y5P502A3i1y551/5a3p5Q5U0g4e4b1o0f5j1E5p0m1/68670n0L5P3+0L0L5I2E400c4W0c"
+    "4W694x4x2j5y5p2j1j0w1E4s26653F3F5h3F0q5g564h0w4c5a5d4k0O2G3t3/474v455s2l5j1R685i0O220x2414665s5M"
+    "0e0I552A4c5k132D210r5j0x19272l0I1926264k3i1A6B5k455j4Z422N5U5d1221211e42245j3i211A5j5U5P1h3H3535"
+    "0229195p0E0E0E3r3r0E0W331q0N3r2o25624S3H5G5d1I4J5S2E3H1q47184Z503o2E1D0s0E4T4T334S4k4k5G1r264+4T"
+    "2v3H335A4J0X3z2v624V62372v48144i113C2G323+3u3K3+0z5S0i1N5g3P0I1S4g17453+5k5Q1n5g035e2N455e170x2v"
+    "455g5s5s4p4p670J5n0y4p2g3S5F1K1j5968470I5y390r21131o0U6I0i5J1K0v5Q5G32473+4b3v1o405P5P5d4s4L1c27"
+    "0c5P5C2D51686840381e5K2B2B4O2H1w4/49240F0F1V5M691L5Y2G1y3Z3+1N5a5a445j5O5s5q1p5f4g0a0x5o1C1y233+"
+    "3H3c350v39380d3m0E4Z683o3l6G5t1d2r355y1O3i2j2y0P1O5L1y3F354k2E5t5G5G5G1r2j385j1J1M5o5668641e625f"
+    "4s2X2C2E5V475j2569493x21380C5y6B2g5o1e1w1V1J334s1y3w0n1K684v3Y0b2q3n0K3+4s3S2E4R6B4h2h5b2G1S3l3C"
+    "4/5g245n1h0D5c2t2v0x2z5V3x5y2B5k3l295i21215u0b5k5L1x265g2o4s241I5X1S4R4W685k5P5Q2M6B272z2z031755"
+    "3G2h5j38492A3x5L5U5V1w5a4v2X52432E1I6A4L3w5d5Y681i1/3D235H3/3k5P482r5j252B402728664i6I0R1J21242r"
+    "0W221y3a5d2A2o475L652H1o09326I5o5Q0K181/1w5j3z5l2d1q2e1o2j1b1S5P2l0l1O5j5p5A2f1n2A250d2C354x0b3o"
+    "5S4g5C2Z3w3W1o2B5U4e3T5C5n5U5S591E4v5F2F0S552j4p4s2h4p52192f2c2l5L5O5s1/111u4P26634W1S1h5X4j4n5e"
+    "0m635i2R5O1o5G171r5O2E4e2m224+6I12430+2F6J5Q5U3+1e1l5f2p516A3q1q0X4k3+1L682v3N2E520o2h653w1M4t56"
+    "3r0x5p3S5p2v1V382B2q2y5k0s481+5p3T4g0G0l1y5q2c22455f40563A685k0K0C5q5M4Q1M455q2N244e5q4W2v6J195j"
+    "26393k5Q5p5q4g4g4K1/6B263d5p475948191K600K5O5O115L5M4L5V0R5L1r1W5f1w5b382N335l5f5o1w3A4h355u223K"
+    "1j0c1E3k352l3+3+35560p5L0O5D39213F5a243p26261y1O5T5j5k624i290b20505p0E3C4i5C4h5n2E175D2828475f51"
+    "2t235q3L085o496F2m0W5S0l3W6J5J4i315l2b2Y1O265a2u5L1U0K5l3x2A5f515q4z5q2l5h376H0b2N4/4+5H2r1d4V3D"
+    "604i5j2y2/3z5L2j5u5P5Q5M415y4i4v02444u5s5Z5k4J224v4z3S4+4i4L023l0f0f3m5N0P3B1Y121q205Q6J11685X1S"
+    "291z1Y6J52544x0E28211k5k1X2t685f4e315l0l2v2d2w5h0I505p5Z1y0E0G68272S4g4c1138052v1y1y5o0W1K5n1k31"
+    "455p3t245e0Y3+5Q242v2u2t2A1l0o2u681U412j5f0Q280o0l5D3i545i5Q38513F4c1o2l2d5H0c1V1O5b5j316J322L2z"
+    "3q4k63636F5a1/23265f4o2n0s555g270o5l1w5Z4k1h5l5U6K2Z5a2l685L3r5p283x0y21295P3j243l5L4v40405Q2v5Q"
+    "5d1C203C4P4v2f660o5j655J4b500Y5d2Y5i4d5C6B4R1s0E4b0W0W4k5A3z2p5L4W4W0b2C0b1z282f0Z1V0t1w4s4k3q1o"
+    "5s2r1w1S1q1r5S264b5Q5p2v2d3Y5p2p395x0y1/5y5V5p2j4i5c2q5J6J5n210O2l125i051/660W310x0x5j4x3r2E4+44"
+    "246I2l3a1l2A1N4W244x210f4+4t154W6B2c0I2l384i4k383Y5l5l372A3+0E241q4L0s5O525k5k1B0n23452d2H023z6I"
+    "5L0I1e405l0I2a1M0P34265L2z5v2v2j5o5g2v4s685l195K215V3l4g0G0W3F2r263z4W0b1e0I235S2v441o5l4J2j2B5U"
+    "5l4x5L5V1+5c6B2t2c1B1K1y2c4k2q5l38242l265l1N2p5j265r0W0w4D262d1K4o5q6I1O4e2h2d0o485n401J1h2G5f1q"
+    "5l4R5v2w5f2j384b500y280W5l1q066B2d2d3M5J2w5d5S5f1V5f5p230G3B1i10215U5U211w2q5x6E2D605V0c6I5u5u0O"
+    "5g3+691N3Z2C5M3z5j2v0k3r2J3l5f2J3m3H0Y2n1j2L1C1i5W681i1i5L410F0v5R676B2N641S065V5V2q6I5b2E503n2C"
+    "3n4/4/0J5g5A4b6B60125L4i2l0c206A1y4r2d59285a1u492o1/5g5Z5Z5S5k5P6A5h4i5L5A3B5u2J1w2f5R6B5b673x5f"
+    "211i0Z212M2E1K4d5i2100512A4F2o5Q1S2C5V3z596I595J1n3q2e5f5a1O0c4J1y5Q4k1r5d2T2F5U5Q5f1o6F2H115V24"
+    "5P5f2v1o5f1/362E0z0B1N2p2Z225F5Q0s5P1w0Y1S5O280o1O3w464Q5Q465W0Y5f5f5j2G5p1W4C3r5Y1W4h0X4d5Y3T1b"
+    "5L0a1r2Y691A5R211O2l5b5X2028260E5l6B5L5D4b5Q3d3d0W5f2C2C5p354Z5L602A464K351/5a645L1K474x5g2o6B29"
+    "5x1f0A1y5s3L4i2m0F1d5E510Y4b1G0K205V5Q5P5Q5s1r1r5Q5s5Y3K4b465h5d382l5l5P4J1c5f412r5Q0E0G0o2v264k"
+    "5j2u3q4x5j542G6K5s1y5j68055L2r1o3i4F2C312Z4c0r5/265Q5Q5Q5j5U0c200W5i504C5f5d422H101C4g281N4s2n5p"
+    "2p5A4d1N1K5f5d2d35515j2C362B285l5p5j5c2d4/5x0O4x5Q4A6K2l216B5V2q5L5j5V64210v3a2d4L5S1r5d2A0e0z5h"
+    "1r2d0G4J2j3F0A4Q2v2b055d2X4r2n2j2v2G2n5f5Q5V2t5i0O4D5r2d0o2G0d1h2E0Z38512d6B2d2q0r5p64643j673n0b"
+    "5q025L1o2G2G1S5i06145i5h6M4o1I3l0j2N5w14415n413s083l0Y263k190j5p600F14090K0j5o5o195e0b3Z3Z3v2D3G"
+    "4+3H2f4G321L333H1W5P5f1Y0B4s261e5o1Y4h3H114049496J535Q322Q405P1e5Q2j2j3y241W680C490l192E25261O3s"
+    "2N2E2M0f5Q0B2z292/4T5L331C5A42275Q2j192o3k3t0K5Q0e5L2Y0e4949061K47240V6I031Y6F1i2/5o2L0K1x5e5k1/"
+    "6F5s2X3Z112X693H0B3r2E5j4h3n5R5G1y2q1M3r3S5h5o1d5c2E0x0K2T5S3Y1/1t281r64245d4b4+4J4j5A2f195R4i2V"
+    "675p4y5p0E325Q2F2j5R5k4w2e0B685f4Z2j1o5S2B3k1M5U073+3S0G5k2c2o26412Z5f1l6K380X5j68675e370N0q4e2o"
+    "122z1y6K1j5L1O5O5q5X6B335L0i5S5D5e3N5V251x0F5o5o350U5h4y0K3D1z5q4u2/5q0w5p4i1q415j660P1q312B273F"
+    "630W05051q0s0C2G0E0E203z2p5a5A5h2n4r5U4j1C281Y2F19212V5S5V4+5S5d3Y0F233b372o3N1i4j2v4+5S384D1/3N"
+    "2z5S3+2G5b3A6J2v2v5p4v5K471T152g06241w110i1V2D5p3+5p0X2/1w5P1S5M295e0I0F095r2G362G5J26350x3v5L1/"
+    "5S412q0w5j033w121S5b5Q0K0n1d254d3x0n2N4C4h4g5j6M253C4b2r0E66662G1J2t2A28262j1i5S6A1c5f5Z5g5a2z4v"
+    "6B445k5d0A1I5T5h5R1p1j0d5a083o2f0y5l215M1E0b115P5P0b2H350B595S0f1o5b5f475b2e2j5Z1S2r5e5Q2q2j2A2l"
+    "4z4z1O5J123v624W3C5p2E0a2c3C4h5L560f6Q0D0b1y3+1E2Z0X3+0D5J2v0o1h5f130B2p443r3j4A6I441J2A46192922"
+    "5p33350l5b555X0w4K3C265L4N1/5V0i266E0X2l495R1A5q5e3N1y5l5p204O4W2r4i4J4z5h5M5P662A5l2/522r512j2e"
+    "1j66410u2G645h020I4k0X2Z6E0o2A5j0s0o3+2j2B4z475b052l36635k5i5l5L2v5P105Z5/5d480y2p2n464v201j3z2B"
+    "1K2A2r24212B020E0O485x0y281k50211/4W4x560f5p2A2v0I4k5M6O2d5Q6J5b4N5O1U2h192j684K2j5v46551j4x2b2t"
+    "2v2j5v2d5l385T461h0z5v1/1f0K140K1y683t084D2j5H005T40083p1L0x5N3i00005H1y2q5j3w0n072F0X0c000y370L"
+    "6G3w0F6A66000n5l3+5S2u113i376E0D2p5/5P3r0x5N5l5f1V0w4g56561o0X4h454g0W0W4O4h4v4g5n4m2v1S5n0D1O3Y"
+    "565o254g60121S3L123w591z59665u370E0E2r5d2r0X3H5s1K1S1b562929495L1S563H1D3l275H0v3L2r0C660f3H3H0R"
+    "561U0E0v682x3+2x3l5j1K1z4e5p3H2H5j2r4e140e1z0y6G245J270b0X5F2h240U2r145D2p27270e3r14143r290x4k4k"
+    "685j3O3K150E292n1W1Y2D6A5R4b5a3e2j5g0a5o06292G3+5R0s0E5j2j6K0j1O6B3n3r1V2N0n5c680x661J68542E241M"
+    "2E4b255b600J3W675n2B49545A5j295L21505g0c681t5e35182B5U5A5C323r5U4w1S2j680u1D5P4Z2f4j1/5S5j0D631h"
+    "501M2/2p0c2456030c0E0E3C1e1B1E5L5p0s5e6B0q0x4g690c5p1x1O2b5g0a5C5p1l5M1/2T255k5j2u4V2G0c5Q1h5j5M"
+    "240j08212r0V4j3e120v0H50630G4g0q2z5j6K0e63614u4W4A132u2u3F445k5l201S2n2t422r2f5S1M0x5k1r02085S1h"
+    "1j3a5p5L5j5n3r2h2j4k0x2p122p2c0H240c5g5b2967342j232c24125b5l5k485n50122z2w2w0K0K1j061J101J070743"
+    "245x5x330+3j29201j0n2q1X3F24283q1X021E1q1o0E5J0e405Q025U1q201q5y0s1q5U5i3x1q28025X202j3t1r283r1V"
+    "3n6A2H470t4A601e2H2H6A601e64193C3+5l5p0B64693p1r5l1r5j0K5J1r04625f261r5p2Y1K1U0z3l1S474h0z2v6237"
+    "2j2A5a263l1h032v5a6A0y031e2j3H151V5a325K683+5q565T1C5W5Q3l1O1C3C3D4h4i5s393l1L3A0x35332K5S2S4i5g"
+    "675h4g230v662X2E4g5j4h353F6B6666394i5q143S6J6J0Y605b0J382t4x5A3814113O3D5b0c2X2F3G66575g5f3F693F"
+    "6567354z4d1o1/110b0u2F1E315S5Q2Z2c264b561k5J2i4i462o5e2B672j2c4x2F4p4x190E3r3H223S2v5j290N6A5p22"
+    "2/5R5X211k5u0l2635191x5b562Y1X4O335a1J5O3A0e2Y385N2S0y0a2N4u5R463F3D314p5y635j132S3F4q0o2u0c313t"
+    "0b1j375J4P3u5Q423z6B104g4q2n0Z5S2K5i5a5A3G2p1j265i022162261e6448350e4V3Y5d5h2337393v392h2X2G5b39"
+    "232v372t1h315Q0f512K6B332A2A5p4r5y2G4i5j4g681x4g5l2E6A280u1A02285/5r064i153+246J1V5P652T1W5Q1K2X"
+    "0y2/4Z0x2G2j1S3C1E232L683+2K290I1E5e3r655f4x6E0Z1C5H5f2A1O1J3F602E5p2N5G5G1161661E1S3H6B2b0F3c3w"
+    "3q2q3n2g3x0K3x4g5t022j2t5A5n2j2X0f2Q496B2X1j1E3N3/2v5L021Y5S5X5f173q5Q2f1w4r5R42455L425j2Q5U4A0W"
+    "2e1w5p5U5R322z5n0Z0Z5O2r5l324A5f4Z2Z5p0c1z2v0a263e4t6I2Q3q5f6G2R0b3+6K452p2H0K153C13261r2v024x4A"
+    "2i0B5k1B5P3+2y5J123N0B3+0a4N5f1415195G295l0F2N0E5L4r661A5R0y553N3q2611500U563+1C1O5b4A4A2/1c3T4v"
+    "1E0n2r4s51091z3r5L4U2h0u565R5Q2l3l5L5s1B652N2b6E5h1k6E0W3+053q2r2v2K0j0a5k2h0G3+3F3+0s6K450m2y24"
+    "4b2f485/10265Q2p1550203l5t42112j26285Q63421C265p6G1r2N5y2h290f5i4A0y5j273r3r5p3v1E022N265p4N373n"
+    "0n0K5g2/0M5S2X2h2h682j2j1K4A3n5l2j2t2t3F0K4o1h2d0M5f4i4i2j4H4e5r4s3+4+2/5V5h5S3+3+680D1B694G5j4i"
+    "5o68571S1S386M684w356Q481y6B4g4x0n0V382v5p5T5P573t6B1j5R68241X661X4p2A4g1U2Z110z23523+1e1h6O2q2v"
+    "0J2A0z682v0W0E65215o5Q5k6J23661S5q5P5S5g685j354s110B6I665n241X514s2/4+1S5b3+5p5Q244s0W0x1j4x2j3a"
+    "380z2j4D5r555v2h4K5p5p2j5V441r5C5Z4s4G5C6J0U1V5j5S0J3T4747691N1q5s2N3A682B0E685p382T083r3S2j5o6M"
+    "3r0K2q3F0b3T445g6Q68684k2E6J23240b5A68231r5k6J68294G195j6B213a1S5Q1X2e1S5d4p2v2Z1V2B550b5C4d4p5e"
+    "2y2v1e6Q4G6H09072468682Z2i3q2N0J0e6O5p4v2x5T5j5Q0F241S3r3g29696K5a0b0z5M5S6J5p245a66680z25241X1X"
+    "1e4J4x4J242L3H0O3568242v4v245l5M474W1r5j2043244x5U3z286I696O2v4x3a4W214D3g5p3v245E5M0b232X2v0G4W"
+    "4D6I2j0r5c5H2D465Q462R5p4g2B5h0i6H5C2f43615h0F0A5h0J5H6B2842135P1j5h680j5h57280j2C5U0b2S0r5O0x2T"
+    "2N6I5a4v1h2Y186I5d5O5H5e5p2E465h5h570Y5p56132E2n5Q5P2Y0j642W2W2t0b0s2n5x0r4246185x2t432j0f4i1S40"
+    "0f1w3+1q4h1N4k3A48626B2q2t0J2B2B63074s2H1w5A4t2B135j4k2B48293w1A2j6E0T100t5I2B2K2B6B6B2g3q5p0c1V"
+    "326B5J192428064w2444644y5e6G5q1y1p5U0S0E0E265j174b4h0v116B3J0c1e2j433C0A574s1S0R0C1J0v6J112q5y3c"
+    "1S1d1K251V1K4i333x5526462t3C0F2z1j480c5k5h5S0E462a105U2A494y4L1J2X6B5A240v1p0R692S2c0E4a0y670R1S"
+    "5s5C3j2j2e2E1h261o5A5R680b4w4i6B6Q5U4d590R5f1X2V1V0e2X1W5s3i405U263y2c6L0E0E0E1Y4/1g5p260z1e0c67"
+    "454Z6A2v0K242p4w2H1S601e2R40402H0k1h5q0R6M0K5y435G2z0x5U4Q265b0F4y5T5S3w665X1y5j6B5r0l2v5P174r24"
+    "29205X351K0i6E3s1O6B20431x473A401e2Y4i2u5s1r515r0e1X1M4Q671d3W405U0r2t3q192j0E6I0f4a0c6B412t2d26"
+    "0L2j210E110o5f3q0O6E3r3t185p3B5D5y4a1j5j1y0W2S0q3w5x241j4v2u0R2v3T4z0r134z2g1A2m5U0K384a0y2n0x12"
+    "1S263C2Y0w2810204y2f5v5U2v4i5v3+3k3+3k1V2E2v2v5f0K0y4S6C1d402l0L6A2c4i2d2Y5p5r1q664/553W0e245j3+"
+    "546E6A1K4u6A406I542v2v265G5l5p2c2t432l2d405r69482l0F1A6N2j4s2z5l5r6I5p38111K4g654g3c1r2h5S6J3S0t"
+    "6340610E085P4Z2L4K1N0E0s5k65384/1y062j1V2E3x3F0q626A0c4v572j5Q4v1w5A6J0R5r6A2p6F072f1N1I481r2m5S"
+    "1S2m0O2B2j5r2v2E3+0s07632p6K2B1l1z4T4T510F4K391x5a6K1y265v0n2j5V1S3g0B1e5Z1X5147250Q6F51384T1N5x"
+    "2L273F4T4T3g5Q2m272V0K1/4k6K5S3g5D3W2j6Q113W572d384s2D5Q1c672D5o240U6A5d5r1w5p1r5J4G5M5M473J6J5B"
+    "3Z1R244k0l3r664Z1w68241N5s4G0x2A4v1L4z0s2D5t062A1S683+6J0e1w5t2h5Q1S5V4g0K6B482q6B4d1V5g1S5G660w"
+    "0f4i695S6M2C08483F4k6O2X2B4G1p5V296B0e1f072G2X1y0n1/1b52292T28491U2z5b0D5S1S1Z174J575k2h5V2F5a1U"
+    "145A4s275T212G68262F0c39662v0b474k095A5U1/441b5Z555B5V1w5Q1S594x1B2Z1S2B1y685f2C1O245a4G6K0a1D2j"
+    "2v2m0e494d3+3+6H3+5J405S4j5L3+525J1W5K0D6G0N1l0s2y2r3+620E0m2q393+43566K1k6L5Q6J5X2m2A1M4O3C5p6K"
+    "1K2v5a5l4c3+5a5T262N5S4N39241A0d113C3A5q5V0A4s470F1/1b0o395L1S5L5B1d3A5V2l6K0F5s5k551f685s0b0W0w"
+    "5R5q6K5a4h5L1b5b5l2A5j6G3S091e3l6A260n494o5s5R0s5Q4J521S5s0a1X4L1y5u545S4v666K52200N0E1O0q2j4z5f"
+    "5Q6K2h2F4031682v3H3t2l385b6K244b4x1K2v0D5j4V3G5h41225S244Z5Z4C5b4x425/6Q684b4T2p5p1K2n0m6P264E0W"
+    "4O5Z211z6N5Q415s0v4h215Q4W26271/5x0o5V280E0x5j3a4x5j4a5a240I402d3z5d6N3+3q5h3F2h5V6N2X5o5a2h5S0W"
+    "282v0W5l0N4D5S6O6N2z2j0z2d2h2l4s2D5p1w6A5S1Y5r245J2X244G5L5s1w0l3r4Z1W3J4G6K2y1N685M1L6B663Z4k5S"
+    "1V5V1S2l6M4g5Q68696A081S0f4d5j2B0w094J292T4E141p211Z5b272z2G285A1b5U2F5Z5Q4x522455245a2q5l5a3+1M"
+    "0m4c1k4h5L394j0D0e522r496K625J2v6G6J2N5T26392d553A245s214s1D1A0F5S1d6G1/112v0F3C5q2A1S4L661O0s1X"
+    "0W2j5j260I3t312h5l4z3G4V5V2n4b5/2740421/286N1R5V1W1R4A1R3+0K3w5T641W5l5l455R1h6P500b3+5N5l2h502v"
+    "1h5K5K1W5K1o2z2z1S4g1J1e6B2E331e3C1W061f552F1S4g5f646O1f6I5p68031J2d4k4s3r2/2r061J2j0Y5L0E245/0d"
+    "2r242F38642z3r24242w5g38410v355g5o5o1N061X5g1e415w1X2q5j6B115Z415j5S4J4B4B411/4z5S5j5g41405p1b29"
+    "515q5Q1K4b1N4b2l2h1b3b410W5p1c5j0d5N1N1w0c0c0s1S5R0C5j2b5j3r2q2r68485Q5V5T5Q5Q2N4221215U4Z1w2711"
+    "0s1M0z4Z0c6B265b0c3s6K5J211x1r1r1o053t5j2l1x052p3p42051K5j215b0z5h2f2f2M33653+1d1d1d14141I4l4N3K"
+    "3K1A2h596J1b0Y1q5s063r5j4s48252E230f2f2y24513i2u3b273m602u242f235o3F1+1I5j155i0v4t445s0c0x0x1w1b"
+    "683l3W0x660Z2q675o5H2n2t683Y571I5e581f5a2l1q4h2o3v2B2E0E111l5M5a3w0o153S592E0o2Y2l2Y0o2l5N2Y2l2l"
+    "0o054h4t592Y3W680x3Y433S59592t5p5p644s4v5j4v4s64644K5j2g24472P0Q1Y0K1/200c4G5U4L6A5q191W4J1V0U5O"
+    "0X1e681o1S1M1N3o3m261L6H5o3J042P4C1c5p5M5h3+3r405Q5Q1M2P2B4/4g69635V4g5L6A140x1M060K48560B1f4/6J"
+    "1M683S3w6J1S3m665S6Q3o254h680A3H481y2N0c5k5a5g2t172I2v2B3c5f3m2U5j1i1n1Y170c285Y5Y1I031u3s3R6J1j"
+    "0b57680s355V0s5V3030245V3X2V4R5w3+3N383a2w5J0K5M5J5Z282B5o1u0u2o4b59350l4g400+2F0q5Z5W5G3n0b3P3z"
+    "185G3V3N3r1e2z2j2l630s292m4p3r0G2y3s2h2Y0k0x563P2B3K2b5i5f4G4g0m1S1S2E1M415J173r1l6K155O353S6E0c"
+    "0p2z3i11035X3N4k4n3L5s694K1E4S5C5h265L285p251A0E0X1S5S3S395H545E09402v5H4j514v6G1Y5j0K2n243r5V1X"
+    "2v0I3i0X2v1l3m0h0G271S513F5Q6E2v285l2v685c0t2p5A3q3S0h2n0s1j5U541K68284b1y0s4P5T4x1N5l4b6C0x2V3a"
+    "5F2l0E5n2G0f5j2F2b2l4V5F1e3+0s0I5d3N5O5w5S0G5X2W2b5f2v235t2z485w2w3S5t0a405O1i5w2p1i6J283W0e241X"
+    "0e393W68681Y2614685Z4/662D5S5p0U5h5p0d5Q5Q2D5p5p5X2E2D5W4e4e4e2D4i504k4i56503z3z1h1z560i4q5R5P6A"
+    "0z0i4b5j1K3j4/1K080i1p1L080E2v69260P2q6B5y1D0K5S1Y0i5R2v463m5Q2U1S5x1O2j4d5p2e595p5L0K373T2E204j"
+    "2N0F3H140z090U5j4u0P0Q2u0w5c5h0d100y412v5j242623373+2v2v0W4o1a2m26264W5f1S3w5f5f0Q0Q5j2g5928023K"
+    "5728293q5J5j0V39381V405p5p4d46191y3+326J214x685T3r1S5F5L5P683+4b5M404G1S2S292v5a24443+5f1N064O5W"
+    "241z1z1L5P2G1d685s44050f335e1M4H1p0o5k5o0F5j435L2j3r1E5S0X0P6B4v555q4C2q4/4d113A452j5n2N3H0B0A1d"
+    "3C5j5j2E3u4Q2T3Y3S0K0J4b5Z5h5S0C1w5l60172E143W1V1y3w351S4h1e0E5L1S6I331K253333060n3F6J680c242B2t"
+    "0o3V5q5c5l461Y3D2j4J5k1a400V0a5p1q6J2o5P241j0n260n1d1i320U28281S5p6B6J27215k0U1J4J4L0d325A69406B"
+    "5d1/1S491U0v2B5X0i0Q2B1I03420c4G2655203w2j2A2f4k6F0v254E0E0R4221240y6J4J225X2z5l5d2A4y5k301w6A5h"
+    "195L2j181S4G5k1r0E0L5s115C4x4x0b0a5P0H5Q1b2j3z6B3F2j6F6Q5G474Z4z0a3q2E35375X2B0Z4g2H5f595o0u1h1o"
+    "5o0u255K4v3Z4d5S2e1S1E3F5M293L3H2K2c2l4i5O5C5S235o5l5l1c0l32320n5J2B114817266L1e2b2v2E5L2H3W2Z1r"
+    "3z5u1X1l1S2y0X0e4t0k62360N062j5C0K1o0A442F5Q4411293z0y2A424/1b1z1e2q1M44035K0D6A5f2E262p504k560z"
+    "1y3+1r0s520l0E0X1/1M2c3+373w5L0x4Z1/5f5j573+5J0R3K665G2D582z0E5j3l0K3n155l5l5l5U4R472N5T5J5p5p1S"
+    "2l5b5b3L0R5O0l5U5p0F33031E2z5l2a2a27396Q6Q6M0A4K5Q5i0348261S2v2B3p1O1w1w1x5f5C656J5T4G1Y3/453820"
+    "4g3z1U176A265L0K5L3j241y5w251A5h4x0o495L662Y59225Q4i3+2d6K5h5q355s4k116E1h4C5c0W2J2Y1z272u5L3k5o"
+    "4u5k4i0l4i5s662e4L372j4A4w5q2j2E5Q090f5a5C2r2312406M3x0u5q0f5p2V3l3z3z3J4r5Q1N5s6726244Q0P1G381q"
+    "4y663D4u5a2r5Q1e2e4J5N1U0u4i512z4L4z5b0B5h1j0E6K1k6Q570R3o2d0x242j4g2e5p2q5l3F1357335A0f3q032l0o"
+    "5Q3w472A0l295L5E0Q5p5j6J2n0E2v5a0L632h41315f2q240G1k1o114v2v4e4c113B5d310K110u654g5b5L1y05382u0q"
+    "690N3x27380o3V212F5k263T4k5k1l0a1y4Z2S402/5w5y41182l2p2S020E2j5L24404h1K373i0W125d284O4O2h5p420f"
+    "1z26305s0A5o482v4E211E551M2G6O1J4L1N2Y4q4O5e5a1S2G0y5P174s5U5Q2t5M4d3+265s4y2q5p5R5N241w4s3a2h5b"
+    "5s5p5Q1q0A1q025L2121240n5T5J3B5j2i270O4g412l2N5q0v55515c0E624y5S1K155V1e5V4k261q1w4R5W5d5h074u4k"
+    "5d1B3v5L3Y0e304L3t4/245x0a661I3S5l1X0o5U3+1J265a2Y240F13382d2A0P3A46435S2n3i5S4v2v5j5a5V2j5j2b2h"
+    "2811680B545h3F1/0G1K4u505E46425L2r213i1X5s0A2j4k0f022p5x5b442c235G5P4O4O3+1u2v4v5E375s3w5p5d242C"
+    "5b3F474v2C3q3W0K4D5j5S5p2E2l2l5k415l2t5B1z5r2q485h1K351o2Y2d240y312h2h211O685L2Y621+2j24382h1+2z"
+    "242Y2v264R542h495U5j2w360H1y1y2v3e2v4s5U400f1y5a0u1S5a5a2v1y5p1q282E1l0A5f62622Y0I5Q4k0d47132447"
+    "154i5R2G654e5p1o6J1w21371Y4x5R0V4i5j2/5T1L1E060c405M5M4O093r5r5r2H3+5A5k3+0O5q2G21443+695e1q3H5K"
+    "1N1N1p1c5x1S4C291S0c180A5S3S0w475o603w0c5o1r1o2E2j1S4C601d3r3r5S6B130H0J1e62484e582q1e0x1e5l2j0b"
+    "483G1Y0n2121321S5g5H2o6B5j5S2a282j5j3w3+1m4e5j5K3F46431j4668312f65253N4s3+5X29474d5n255E0Z0B1E1o"
+    "4k5b1O4g4g1S5S655P1S2j2e0E0f5q5o290x5f59125E215O684t1M2E383+3+5p2H2b37414s5Q2y2j1457522Z1o1o5p09"
+    "1M3r5L1C5j5q4z49404O3S455L2m1l5J171E08115K0O5g5l1l0W152b2N295V59335a395p294i5b205f0F4K5L1S5q355L"
+    "1S4L5V5o47335R5l4i0d516B6K551S5q2Y372b191y47142j5O5s483L2u0l4J5l27082e3m4s5Q0n5Q5q5N2l4u084J4J24"
+    "5P5Z1o445j0E1z515j193K1r1y1j2/3D5j5M5l53690P4V3+31574c4i0Q0c11052v5L68510a3t483r5p262z2u44695k27"
+    "4m5M5U5J65652/2/1l2r335Q0o2j315U0X63325T3F6O4s4753683q3q28480H2n3l1j5Q246E201M2f2G2G215k0W284b3N"
+    "5U5P0d5d4s0f0b0y2j5V4b5j2B0v0W3+0n5T4e2z445l0V2j5z5b2l6B5y5V325V3+4J26371q4L236I293v1r3B1K2h292b"
+    "3C2j0l2j473W2v195U6B2t2j2t1O5i3r3M1e2F5l4k5Q0O4849190O3148296B6I5c203c3o3c5W69301I2I3B5Q5X5f2K5q"
+    "482q5b4k5S5A5T295S5e1y5L0z0d5L0z6H1u485j5j0L1V5p0G0U5j4b0a1S1k1N4m293J690x5j696929685V4C684G442A"
+    "2H5q350V053V214C255G2q0w0A3n5h6Q0E4d502E1r5c5Z665j3j0K115H1S1k68684C3l5j335G3J1d5b65480B5p5Q380K"
+    "0K1S0c0c2T4G273/260K291I1Y4L6B1j5k0N2o2I5X6F0y5a2Z2P3V4k252Z0b2j2F4g3y1Y5j5p662r474B245j0L6F4p4Z"
+    "4B2j2l2l2T261R0W0E2Z525q2q0c0X0e1D0G2m4c3o3o1M5q2z1l5f1955682E5j3+1l1f2P3+55551S0d5V0F142Z1A5Z5Z"
+    "1r5q0A0A1S5p5D5f210B0f2v3n0x5s4+1d0v1+4J5q4L3K2C4z085E0c4U3V5l29401+2T2l2d2j654i2v5j145V5S5L0G0Q"
+    "24414X0A5T0E1S266E260s240x5t1K0K5T5W0H4E312d055y1j0Q4x3a0W2l0E2A0y4k500E2d1S4L681B4k5H4i075V0K0a"
+    "2c2t5Q5S2d650w2E5v4i263l5j2d5e5Q5Q5h1O501S1P1S061r2424261h0F5f1j2G3s3338383B4i4s0W2z2G38572l5h68"
+    "2H5Q4b5L5Q565p2d1E19443m243D5l1d48622A1h10262z48265L2G482z2d4g111h261h5f1j384i0W2d2G245Q11565p1d"
+    "2A4828472A0q2G680Y241e0x6J114c1z491Y4i291j1c0f2922475X4v3S242v68600E5X1y4c1c685c0f5Q5j2j2G5Q5f5Q"
+    "5f5f151S4747281w241K5d131w0V525a295j4G5d5k4b3+5G245d5k1E1N5e5h4t4g5k5W2G5U3O0a5o685Y1L5W0Y4e5f4R"
+    "6H5a5j5j4v0c1r4g1r5a666B671d6J6J621e1S26142q115g2j3N3l6A1V5j2E5h605j5j48643w0E5Y48060v6M526B0n65"
+    "5n5a5d5j201r4i0U5U4i1t0U1d1j4921291z1U5T5L4g6A5A38623D1E215f5Y1f1I0J575j2h6B2X2U5P5p5424684G0q2e"
+    "1E2X1F4i590x0B0W5o2Q42444l035p5U0b295S5P5P1X4t0L212B4r664r191z0X4p292N480o5U4x5K5S1M0c4+5j3S5k13"
+    "3r6I0W0a6H243+506G5L2E4517675y6L406I2m260f1q2y4g0G1z3s5p145a3s4i5b4i221z1E69115V1S3z59263+5p6J6E"
+    "5Q215k035S3L0a1O6B5g5f205b1Y3g3+3G5i5L5X546A4b263x2Y20231Y5l385U385Q410a5c554v090c404i275q5V1r52"
+    "5h5h2v5p0G0o452j3F3F4c653E265y292l2u0O3i1k5Q6I05052A655j1y27310Y1o1z0W5a5/4W5Q601B673N2d1E5l2G24"
+    "6P280K216E5P5+604i42505+3z4h5b5x500y4x5S24282B623M5j02623r211z5j5j4b4D3b401B4+1y6A1q025l265p2621"
+    "19655b5v2h4g5L0W2j5j0F655f1E0e5L0e5h0W4D5k2d0a5V3W1/5v5j0y625f195f24151S4G24291w524D4b3+5G5d5j5d"
+    "244G27213i2E5e3O5a1E2y5Y4t1O4e1L2G671e1r3w6M4i5Y604v66116A0n48640E5j5j2X2h4i1f4i24210b6B4g1z0x1d"
+    "491j5d5j671U5T0U225a6A295P5p425P1X5o212X4r4t1F456B6L3g196I1M2N5L5p4f4g130W2m6H4x504g5j3G0a142026"
+    "5V5c5i5L1E5p5b0W6J035f11383s5a3F0y4v5V5h094i40382A3165263E505+422d3z2G5f40620a1e401w5R241w1o1w5Q"
+    "5Q232n1o192t18273+4i2j105J0E4k5S1O68685f5f4i0f215F5j5F5j26061x1E0f5T1/262P1U2E1S5Q0I1q5p6B251N5Q"
+    "0K5M1/0I116K1N5j680A0V033r3J3r1d3J5o133F4s5Z1/2Z1r1q3F03332j3S0E5p255D333r5Q5j2E3F0f501/2G0B665q"
+    "1S0N1c535j1p5J3v231K501h5y681I6B4i0E6J1I1j3s0F300w4h2X1M585j0c331r0E2v2p211U3s6J255a5z281U5w265l"
+    "5d664e0I0I474e0i5w6A2c5v0n0a4c563o1b5S30264x1S500o0o682463192A5Y0l5s0A5u2c1O0P244h5j6E1S1d4S5y2n"
+    "5j070a5J686G0G5s5/0x5v5f3z4b5J5l2A1V5S5w0E194k5f4c5b2t1V5w0B661S5q1c0N5y5S076323681K503v0F1d6B1h"
+    "1I260C4i581j2X0w331M1r5j5z6825216J2p2v5w6J1U2A47662c4e1S19244k4c0n0E6A1b3o0x2c1O6G1S6E4S5y5f5v5s"
+    "5/4b5l1V0c5Q4e3L5A5Q0b1r0b655R516L6L2j2D1S641V3+4b465k5S6J2G440c0n0a0a142E0Y115Q622G5r48240c0f1f"
+    "5c6J571D2o1V4z0q5Q644v5k2E264A510m0s2v480y476J55480c204242285x551I5v5v6M3j0A2T2N1C2G1S0a261L684+"
+    "5r063+5r415G4/5j3T2q3506142T5G250n3n3/6B2E12681S3l2E4b0K3S2E2j1a5j241D5S281D6B492U6D1j462Y5T0c2v"
+    "3s6825570N260v420E5S1D242E244k5C0f2B3W5U0L5c0t3H4k2m5n280e423G4+263+5O5L0m29243W2E3W2y2v2i1+2E0c"
+    "5J49550K6M435j0q6K0N6K3q686712685p1D1C0i5n6911600a0h261f512E1S6M143s4K3g550U5E260z0u3+4+413T1255"
+    "243W312r5v0E0d2v2n0q510w4v5Q2Y246841113l6K2l0D5x3T0H5E2E100T5S1K0f691C0K0q0q2G2G2p4+422G3z2n1C0r"
+    "1h5x0v0E0E6B2E0f421C0e245P5r3T2p2o682j680W0f1A5L2t2p5S5L6N2d5V4D4R3W4+48240r0u5Q2Y2G2p4g1c0x1N48"
+    "551D1D1c2e4G2z02242E512R2f5f352L482u2f1D685f550z5l5p0Z5e1j2H5L5r5W0w5b1K4G4b2X4k5F0a0w1E3J3+334N"
+    "2X406E1w1y482X112q0w05661K2X5g3q0B1e1e3n6B4J1E066A685h2N5j684i3w1I1c2E281i1r2J496A5u684e2m5p4d5o"
+    "5J5k655J1S456A3S2i65622m6J215K0m1l2K5j3q401k3T3w1h0B2y3k2m4N4K245g5S0i0p0l1Y5o1w4k1S6J1S5M0C625p"
+    "5M521e665R5q2v280Y6E5L225c6528620L2f1N1K2p1Y4W2K1/5j246G1I5p261w2h3o2j2j2v2p0Z5e1j5b0w4G6E1E2y4N"
+    "1w1e2N2v6A685j1y662j5h454i5u68286A492v28651S2m3T0B211k5K2m0m6J0p1S245M4k3o5q5R3T2v652p5W1e0n0n3r"
+    "6O0F2b2b0n5c080F0F0F5c0F080n0F0F0a4L3a3a0W0m0m5j4H0F0F4i5p2n0v0W1V405p5p3+5d5j1l303+5t5K5C6H5l0v"
+    "5s2A1p5e1K5P0v1E1n650v2A5q5L2l0c0Z3S57685j2C250a0w1I113x6B145y524k5G482B21175o380D243K5j296G2o5d"
+    "5E4t4i523m1x3S1C2C5b5d0L5o5U475B6B4711115C2B55185j655A1i5P4i0b4v5x4B1O2l4z212j1e2c0C0u2G0D1/0w2v"
+    "5o6A2A5p0m2Y5L555j0v5q2z0E3g5p0y4x1C4x5f0i0c555p4i665o5s1E0F1l1E5R20470z0v5L3L5j1d5h0e2r5d4+110c"
+    "5q4v4+402/5h1h63054i0M0c4v5x651C112u0c0u2p6P4E405b5p5j1E2n2E4i0E5h305V4x1n62541I3A0F0F2b2j5q5h2z"
+    "2j5j59103+5n4b1o5p324L465Q2X1S2L0I1L5X3J5W4g095q0t235V095P2E5o1o4/470E3r0J4d0B5H116L5i2p2X1j6B4i"
+    "2T5p1U1r4368241/1x5X285Q1j3g2e252V672e5s5f0b185Q2v1S5P1S1X1q2e251b2H5l0K5Q0B2j5s0L5U3+3r451l6A50"
+    "6L3w2c3S0a5o0L5T0x2E5n425j185f354Q0B1E4k2F5p5s1x2Y5T5T4u513D5Q4L0f6J6L5i5P5T5s1q5n0E330Y1S2n5k6E"
+    "1y425f6331425a100E5d0E5/5L67334b2p3x0x375i0Q2V1O376L2X2l5v0W5o245f0W0u2q1/5Q1O5v2j5o15476I3o6A5j"
+    "1V5p2D5f6O33665a18661N5q1S5s4/563/5G0q1o1e4v3x0e5u3D2f0m0e5o5A685S270b5k5C28352T4w2h3z6O1n5f4a3U"
+    "5L2v2d5f523o620l506O6G0q2Z555S191y5a5X50470l5s3x2N4u38490e0u5s5n04601n51273t0a5p2j5x2f5j270L285Q"
+    "501J3a5j2j2E5f5j3U4L5d0e5f2q38383U5W284a385f0F0N4i5o4i4i2j695i2m5Q2A2A475j2n0z64153x47061S666806"
+    "2w1S3K134b422S0i6J1K1z1z1o1W3+324I114s5Q5j0V4i5C5Q3c4047263r5i2A061L0a5X185r401S3r3J5W1E2G1C1d5k"
+    "40084R4G0Y3Z1N5s5j443r1l1w5k2H135j695Q1U4I234/2L5q2v1E441D6J3S5C4i3C1e2N2q0J4s1e0K3r5p4s6Q0L5o56"
+    "25664i4i682E0W4i4i5b640A1r0E4h0f4i0K6B0c5t3x5A401S612r401S2j5r3r5g080K291d4k673H5Q5Q11253H501/5j"
+    "4s2X2I0B265A5X1w280c1I2z0J4i3G255k2H6A0d5T5A3F2h245p5a4G6P68464b0c5S5X493r586B5T3D2U5h5S5S5Z2H0U"
+    "2f243r4L385j5k1i03165o4W2M402w4s02131o4O4i2Q475U655Z5w550u1f1w695B2v352e5J5W5s0B5P4v5p0W150K1o25"
+    "1w0r1O0W5J684s5b1z5p572X6I2x5X444g1o2x5i0f5/2E5S58323z2j3l4O0b1X2j530J6B665C2r6O2E0X5q261W13520X"
+    "2y1l2q3r2v2j413y2F3C6O3q033r5S5e6G2h2N2R4+2Z193P0k6J670C3W6K0l50153+406G245p2A1h330X565Q2l521e0u"
+    "4k662v372v1z0G1T2c2P1L5P3K5J5v1y0+5S3s232m1J362J5l112l1l5S195C5L6K1S4K241E2H0a55601y5g1A5R5p2Q4h"
+    "205L1S640U434i1w2Y563G42421x5B0o1/5i3C261A264t2Y1y5b1D29660F696J5Z5i353k022940354z0v095R2l4z2J2r"
+    "5h5i3b5N4J514z412j4r0k0K3l0v0E4U1W6J5P5l20572r2J4y4Z4u5J1q66662e5j5q513W5Q251Y2/2F4t6M4z5R1O5M3J"
+    "2v4z3i6M5D5Z1h5b2l4j05313F2z0E5L2r114T6K5j2v052Q410s3+0X51315n0W1O2B0G4k2u5Z0o2t5v260Q2j5R5Q2L4o"
+    "0D63400b2v1z243z21413x2p4W5Z4T0b2Y4s2r3N203u4x1K42495g515T2G286P2n432f1B5W5v242669105e5l1B2G3b5v"
+    "3z581K0b154b2J261M4x2v2F215p2l6I42266I2h0E581/5i1D1l0y2E1N0v0B5j026K5d136B1u6G243W1r23450I5l2Y3Y"
+    "5a2626400U683B2j2h246N2X4c3q2b194r0m2v0G0A2v5S2W2t1E2v5W262d0K265h0W5T265Q1h0P3W2h0r483l2z6N2w5x"
+    "3W2G516B2d2A1T5j6615643x2n5C400i4b4R1K13363c5g0V5X1U0L4/2E1C0Y693J0B1W08405h442H5P1d2L1L235B3Z06"
+    "5p4067401e0K2N3x0L0K5r6N3H5025125o580K2q4r40330A4i5b4+0E3S3r1D5X2M2f1I325e5o0b255i3N680y5A2v135k"
+    "2J606B5Q15165S1z494Z1m131Y3D674W285j0W0d51035k4L6B2f3z5P2c532l2Q5U4z2j5/0f1l1X1E5Z0u2x1O5W2r2J26"
+    "4O552e442E0141653g0u330C3+0+2N2Z0X5Q1e2z0k6G2A685S2F233o5015262E376J435l2J414s1E0U42691A4u201/02"
+    "19352u6J1M353F660K1Y3W512F3W3J2r1X095j250I4J0G51312z0D5n2B116M5b2r0W2G2n3z2v1B2d3z0r4110232h1/6I"
+    "2l5j0U0G2b0W5T630X2D0514482n3863362/4n4b23365f0E1o0E4b2J2L0D1w4P4T5S5S263C5R4p18603N623q5R2q0F0E"
+    "4P021h1Y1Y1J0f1w1j3C4W2Z2e2v594Z2E5r5r0W482p0X4a2Z5f5M5f1E225p5M1w0A1w485h5M08035L5k2a4A2d19491O"
+    "563W4+2J1r4A0j1h183+2Y511h3t2K5Q210W3r0y1/4+5M4+364n4b5f1o0E5M0j4P5L5S1w263C2L36603N1j5M4+3C2v2J"
+    "1J1Y1r2Z2D5r2e195p5f0X5Q5M225f1E0W2d48212a4A1r560v4A1o1/1S1S2g1B5W405P1U685k5g181E4h083o2Q5s4N68"
+    "3r2B1L5g5k66290b1E48116M6Q122q015G5G0B0J1S242v2t0a5X1D2u3F274k1D5S1I1j5p1U4b2H425X0l1S0E5R4b4h68"
+    "3z185q660f5S0z3W5s5S3o1M6L5j1B2y5k2E0k0a3r2q525S2v4h5S5k6B5g4H5R0d5f5k4k115p2t5L5L3W1B4x0320294x"
+    "5k1U5f211Y5s5P2Y025Q5124630z055Q5k4R4E2p5E10284x4x055S1N3S1I240z5Q5k68212t5Q2j2j2j6G1y684y2F3L5j"
+    "4A5f44405Y5e241e1/681d2F0n5n2E0f1y5t2z5p0e134x1o5O4o1h0f5t5n245Q0e2r2j3L5c5t24245p5p5c3J1R4W3H5M"
+    "1N3m5s2j0c5g2q2h030A5P120y1y5P135a243H0a5U6059663o352q3+6A234Z1M1w625k3S6B5F2p2q175l5P2q4o2q5R1w"
+    "5k30305s2r370I5P5L2a5k5Q5j020x545S5p2v2t0w243m5g063r5L1O5Q243037372h2j23021M0w2t2q021O2j0A1r1r1r"
+    "0J45452B56662B0b452B2B122B561M1M2M3839390A5i56215i1Y150U404G11195P4G442A5c3Z065k4R3J3F6M0v085j5h"
+    "520B291w3n5g0J5k1Y52295V03031t1c3/0v4259315l4x57425b2R0D4+4c0J2a2E2b5V4K091H47471r423H2E260F1126"
+    "5M521d4+0B5V3l1Y0E2a512u1j425c2426270W0v1y5S40195H262d5L4G1S35491Y5L421o0X2a4K5s4e5L1Y07521d5s1X"
+    "0E5L4x195H195L4G1S1o5L5s522D2D5S5V5S245k5t5s4d2g3q205l5s3q035k5T1y5i15452Y5T4q1o5a5j5a1E4t2Y3+1p"
+    "5p5J081C110x3l3x2q0Z2B2h1r421E1E5L5V2a4g5j5j1n1B5p3w2h1S255B212Y252z590b5l5s1y1o2B5E5E3v2c5E6J6J"
+    "0k152c501o402N0s5b445j4S551E1E5f5M2K5n6E5f5S5W5j5q4U1212272Y2h2f3t5I310q5h1q421e5d5f210W4L370I5S"
+    "3v2v2d3W495i15451o5T4q5a5a5J1e1C3+084t1p5p2v2q3x2B2925591r5l2C2N5j3v215E1o5l5l2N555n1E6E5f1E3W31"
+    "124U1q2h0W4L3v491O0G1f1S5R620G4R064/2o1f5b4d2E0G4s5L5g5h4u2J4u1K2r5Q2r3t3t2r0G0G0G2n0G4W1O5Z1O5g"
+    "620G4R2E4s4u5h2r3t0G0G1M1K1M1M4i4i0O24154s5G624y5T5F4G5p2F0c5k1K1K4y5k5B5j6Q0E29520A0n584s0A4i1D"
+    "1n4G5628250J5h5A0n5T5g2F1I5f2g5Q0O0K3P1E0L2H184v5p4i5h221l4i266G0J5S0L5i501M635L1h1E3d5s1y205821"
+    "261x02511N5L1e0U4t510K1X5Q2Y2r4u525i5M3F51310E5p5Z2A4T2Y6E4b0c0x5j244E0b5n525L5T621N1n375f3F0W5T"
+    "2z5v3M4i15245G515F5Q4G5p0c1K5k264i0A4s1D5j1I4E5T1r2g285Q0J0K181E5p3P2H1l225S1h0U2Y1e4u0W5i3F0K2r"
+    "5Z2A314T6E3M4j2Y1l5T1N0K3S0E0K5C1o1M2603021S5S5s5W1N3v5W2/5p1O1o115G650c5d6B683o5W4I4R5s5M680x2v"
+    "5o0K0A2G5G5j485M482C3x645q3o6A2E6B3c2E3r5w252q664/1S5g4i0E5G5G4s2r2/3s52684J54175d494g2C1I1n0K6B"
+    "5k2z6A0x1n2r2E4t44322e1o5C5b5E2H1E0b5X022v6G6A4e3s2Z522c6K2N3+3+5f1M4V5f1Y5h5P3s0o3s401M2040235p"
+    "55495R6K2Y4K4s1f5G1j4u400b682r3q545Q0Q195f5q6L4V4b3+684o2v5Q2z633F050O0G0o480E685p5a1z0K4v5U2p62"
+    "1C2r5G0T1228585f2z622B5j5i5G3v6A5f2t2v545T244o2E5Q1/2j0G2/5p5G5d0c484I0K2v5w4i4s1S2E6L6B5G3c255j"
+    "0w5U2/5k281z2z1n3s0G2j0b5f5X442H3+3+2N6G6K4v0O3s682Y4V5P052r404b0G2z0o0W6A244o5T1e5L5L5L5p1V5j04"
+    "5B290A0B0n55112T1n421x2U1Y5E1b3s0E2N3/5p4x2u0K5U090K0n2W0I3F2n2u5U195w4x550I2W2v1X1X422M422f4V0G"
+    "2Z2Z111L5Z4C330x2Z0I1J573r6J1J4C550A0E331S1I4J481c5Z2a243q6C4d4z552j0I6K113q4t67496K4q265G1y2b2D"
+    "3+2l660I3q2/4T31314Y5a2o40403M1/2a3Y0I2o4D18183N1w5Q181o18182D0X5p5p1Y5f1S441j6K2r1j4c5p1j35243+"
+    "1T2Y22063x355a5f5U2m5p5E3+5K2m5L1V0c3t0E3F245a0e5f625p0z4G29061w5G13245a1E1E4Z1p5F3F294g085q3r2v"
+    "5M1y2v5t1L1N3J5o3s3F1r5R481o3r2q5G0K473w1S0E0n5L2E13065o1k3r3T5X4/0A1S602E1e4i170w4+294k1x5T1I03"
+    "5L646B5k2o2z5A555j0J5L282T1j5S1Y212f1S2M5Z1D2H55394d604z445p3P651k1b4v5P474b3z1/572j4Z4Z2M370b2j"
+    "6L5Q5n4g6J3+675T3P0l2413431e6A172c1M3S5j2Z2v2D0X2B2y2q6L2j376K683T1y5p114i4g1/551x5X6B2b6K5z0F0F"
+    "1/495z5L5L5p0l4K14202l5f4747260E1E5g1S4S1V5R5G1y4i4Q5b5M401q5P1L4V2r2/4i4i1h6J544+5h1E5n403+5M4Q"
+    "4g2l052g213C245748264g315Q470G24246B275Z6E5n632L5c0H5p485T0K285d4v206P4b4b1K1j2p5d3A5Q5/5T1N1h1x"
+    "2V5z4V621V1j5l2j0X2h4k024L245a1y4k2j2o2j3B665T1E2v1h2j5S5p0z245o5F2v1L061r063w3T2v5o601S060A1x3r"
+    "4/1j292M5L1I5A5z1x2V24285S605T5d1b2j2l262j4i571k4Z1/2H245n452q3+6L1M2Z0X1e3S3T132B4g4i6J1N140E0X"
+    "555M5L4S1E471S2049270F4V053+4+1h5h3m262g0G5c0H313C5n5L5Q1j4b2p6P1y1V2j621h3V5j1S2j2D0L5f1S13241O"
+    "4L1V4i1O3D0A5q681y441S085M264i5p1R5h2G2G3r1/660A5f5e671L1O5M3i0w1Y4L2q3B1S5G3C2j0F681Y5q0n485U0c"
+    "0x2E5h1e695p5g5p5e585p565l1B5P1I1f02685f1u5U252o6B5g551w2z4L3G1Y4G285Z6A0c2z1u3T1E2w25245C1/5G0L"
+    "5P2F5p0K2H2H0E5Q2H2E5C2B551E1E2X1y5P4g2c283l2v3r4k1S036I3q44400B132v4A262E5C5e5q3+2j5i6G2R1D2Z4h"
+    "3+2B5j5j2B6J2c173+0l1b2E2G5j6P244k5l0c3A4K0347551y551E29331S0l5C5f1r5q3s2Z351y5l0i5P2E170P1L1r5l"
+    "5q5S5N4i1r0f515R4Q2r241e264y1o0n0n5j5h5f242j562S55555j5C2/5U1X560a245D65055h5j3i0c682r5n2v0E4o6I"
+    "5p5P2G5k554s285j1z0E5l4v201K282n5f1X2D5S5S5C306P5p5l2v5D5S5c5j3r4k2z5Q5j245y5p625i5g3r3Y1y385l37"
+    "115r5p2h0L2v1r2t4o5r5l1h482j2w3V2D245q3D4i3i5e0P0A661e172v5e5U5g2q0c485q5c5G4s681I1f5Z1u6A1Y2w1w"
+    "5P0K2j2F1e1E5p5S555P4A3A032Z0B3q400l1b5q4v1y1r1E1e470n355P5j5h5N2r245j261r5j5l652r2n282D5p2v1/62"
+    "5l1y371h4o2v2A2q265S0u26265f0u2v5o0q243n0q3n6B2H6B2638385p2r0a2H2p3S3+2v2D2H2B2j5T5S25382j4e632p"
+    "2B3+2q5f0q30301r0Y1S39391S3n48483G1S5S2c48390c1O1S48392/343F213F6L3f1N20202A1i565B1w1z2X1w4k2j3T"
+    "0c1s1s5j400x5Q5F3F3F400w0f5o125j5R5f48355f455r2j0y190O5f5f5f0x03660w0O5j35625f192v681N1S1S39395q"
+    "0q480Y5H6B6837050H5G0E5q0Y5G15383K156J1e1e171N525q3r0X1X3+5q51544k4k1N1M5M06135G69484h4i5o4i595P"
+    "2E2B222E5f5C4s5Q5S5f2h0E5h471o5P5P1x5V1E605Z5N603a3M3+61246J24243+240c0a0a1r5e5k5V0A5y5V0V0c5f2E"
+    "572q2q0f495V2P3W2D5h0m5s5p0f5j3S5y6L485s5f3i1E5O5j0n6L120f2A5e0c0a1r5k2E2q0A576J2P5p0m485O2t3m1c"
+    "3m5f2t2t1c2K0v2q0v2t1c2K1j470H1j5r0k1r2G5V5p0000000000000000000000000000000000000000000000000000"
+    "0000004b0000000000000000001W4+30000000001Y0x00000000000000000000000000000000000000000005563S0000"
+    "0000000017682e030000300000000000";
+
+} // namespace PinyinTable
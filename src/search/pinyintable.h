@@ -0,0 +1,16 @@
+#ifndef PINYINTABLE_H
+#define PINYINTABLE_H
+
+// 汉字拼音数据表（由 pinyintable.cpp 提供）
+namespace PinyinTable {
+
+const char32_t kFirstCodePoint = 0x4E00;  // 表中第一个汉字
+const char32_t kLastCodePoint = 0x9FFF;   // 表中最后一个汉字
+
+extern const char *const kSyllables[];
+extern const int kSyllableCount;
+extern const char kIndex[];
+
+} // namespace PinyinTable
+
+#endif // PINYINTABLE_H
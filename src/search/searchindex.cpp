@@ -0,0 +1,433 @@
+#include "searchindex.h"
+#include "pinyin.h"
+#include "core/taskscheduler.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+// 索引数据：构建完成后只读
+struct SearchIndexData
+{
+    enum KeyKind : quint8 {
+        NameKey,      // 名称（从每个字符开始的后缀）
+        PinyinKey,    // 全拼（从每个音节开始的后缀）
+        InitialsKey   // 首字母（从每个字母开始的后缀）
+    };
+
+    // 一个可做前缀匹配的键，文本保存在 text 中
+    struct Key {
+        quint32 offset;   // 在 text 中的起始位置
+        quint16 length;   // 字节长度
+        quint8 kind;      // KeyKind
+        quint8 position;  // 在名称中的字符/音节位置，越靠前得分越高
+        quint32 doc;      // 记录编号
+    };
+
+    QByteArray text;                                // 所有键的文本
+    std::vector<Key> keys;                          // 按文本排序的键
+    std::vector<Key> headKeys;                      // keys 中位置为 0 的键（同样有序），用于单个字母的查询
+    std::vector<int> rows;                          // 记录编号 -> 源模型行号
+    std::vector<int> nameLengths;                   // 名称长度，得分相同时短名称优先
+    std::vector<QString> descriptions;              // 小写描述，用于验证三元组候选
+    QHash<quint64, std::vector<quint32>> trigrams;  // 描述三元组 -> 记录编号（升序）
+};
+
+namespace {
+
+using Key = SearchIndexData::Key;
+
+int compareSlice(const char *a, int aLength, const char *b, int bLength)
+{
+    const int n = qMin(aLength, bLength);
+    const int c = n > 0 ? std::memcmp(a, b, n) : 0;
+    return c != 0 ? c : aLength - bLength;
+}
+
+quint64 trigramKey(QChar a, QChar b, QChar c)
+{
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+void addKey(SearchIndexData &data, int offset, int length, quint8 kind, int position, int doc)
+{
+    if (length <= 0) return;
+
+    Key key;
+    key.offset = quint32(offset);
+    key.length = quint16(qMin(length, 0xFFFF));
+    key.kind = kind;
+    key.position = quint8(qMin(position, 255));
+    key.doc = quint32(doc);
+    data.keys.push_back(key);
+}
+
+int keyScore(const Key &key, bool exact)
+{
+    switch (key.kind) {
+    case SearchIndexData::NameKey:
+        return key.position == 0 ? (exact ? 1000 : 900) : 600 - key.position;
+    case SearchIndexData::PinyinKey:
+        return key.position == 0 ? (exact ? 850 : 800) : 500 - key.position;
+    default:
+        return key.position == 0 ? (exact ? 780 : 750) : 450 - key.position;
+    }
+}
+
+const int kDescriptionScore = 200;
+const int kMaxScore = 1000;
+const int kMaxOverlayEntries = 256;   // 增量段的上限，超过后由调用者整体重建
+
+std::shared_ptr<const SearchIndexData> buildData(const QList<SearchEntry> &entries)
+{
+    auto data = std::make_shared<SearchIndexData>();
+    data->rows.reserve(entries.size());
+    data->nameLengths.reserve(entries.size());
+    data->descriptions.reserve(entries.size());
+    data->keys.reserve(entries.size() * 12);
+
+    for (int doc = 0; doc < entries.size(); ++doc) {
+        const SearchEntry &entry = entries.at(doc);
+        const QString name = entry.name.toLower();
+        data->rows.push_back(entry.row);
+        data->nameLengths.push_back(name.size());
+
+        // 名称：每个字符的起始位置都作为一个键，既支持前缀也支持子串
+        const QByteArray nameUtf8 = name.toUtf8();
+        const int nameBase = data->text.size();
+        data->text.append(nameUtf8);
+        int charIndex = 0;
+        for (int i = 0; i < nameUtf8.size(); ++i) {
+            const uchar byte = uchar(nameUtf8.at(i));
+            if ((byte & 0xC0) == 0x80) continue;  // UTF-8 续字节
+            if (byte != ' ') {
+                addKey(*data, nameBase + i, nameUtf8.size() - i, SearchIndexData::NameKey, charIndex, doc);
+            }
+            ++charIndex;
+        }
+
+        // 全拼：每个音节的起始位置作为一个键
+        const Pinyin::Transcription pinyin = Pinyin::transcribe(entry.name);
+        const int pinyinBase = data->text.size();
+        data->text.append(pinyin.full);
+        for (int s = 0; s < pinyin.syllableStarts.size(); ++s) {
+            const int start = pinyin.syllableStarts.at(s);
+            addKey(*data, pinyinBase + start, pinyin.full.size() - start,
+                   SearchIndexData::PinyinKey, s, doc);
+        }
+
+        // 首字母：每个字母的位置作为一个键
+        const int initialsBase = data->text.size();
+        data->text.append(pinyin.initials);
+        for (int i = 0; i < pinyin.initials.size(); ++i) {
+            addKey(*data, initialsBase + i, pinyin.initials.size() - i,
+                   SearchIndexData::InitialsKey, i, doc);
+        }
+
+        // 描述：三元组倒排表
+        const QString description = entry.description.toLower();
+        for (int i = 0; i + 2 < description.size(); ++i) {
+            std::vector<quint32> &postings = data->trigrams[trigramKey(description.at(i),
+                                                                       description.at(i + 1),
+                                                                       description.at(i + 2))];
+            if (postings.empty() || postings.back() != quint32(doc)) {
+                postings.push_back(quint32(doc));
+            }
+        }
+        data->descriptions.push_back(description);
+    }
+
+    const char *base = data->text.constData();
+    std::sort(data->keys.begin(), data->keys.end(), [base](const Key &a, const Key &b) {
+        const int c = compareSlice(base + a.offset, a.length, base + b.offset, b.length);
+        return c != 0 ? c < 0 : a.doc < b.doc;
+    });
+    data->keys.shrink_to_fit();
+
+    // 单个字母几乎命中每个名称的某个位置，只在开头的键中查找，结果和排序的范围都小得多
+    for (const Key &key : data->keys) {
+        if (key.position == 0) {
+            data->headKeys.push_back(key);
+        }
+    }
+
+    return data;
+}
+
+} // namespace
+
+SearchIndex::SearchIndex(QObject *parent)
+    : QObject(parent)
+    , m_baseEntries(0)
+    , m_generation(0)
+    , m_building(false)
+    , m_lastQueryNsecs(0)
+{
+}
+
+SearchIndex::~SearchIndex() = default;
+
+void SearchIndex::build(const QList<SearchEntry> &entries)
+{
+    const quint64 generation = ++m_generation;
+    QPointer<SearchIndex> guard(this);
+
+    // 这次构建已包含之前的所有增量，之后的增量在构建完成时重放
+    m_building = true;
+    m_pendingUpdates.clear();
+
+    // 新的构建开始后，尚未开始的旧构建不再需要
+    m_buildToken.cancel();
+    m_buildToken = CancellationToken();
+
+    TaskScheduler::instance()->start(TaskScheduler::Background, [guard, entries, generation]() {
+        QElapsedTimer timer;
+        timer.start();
+        const std::shared_ptr<const SearchIndexData> data = buildData(entries);
+        const qint64 buildMsecs = timer.elapsed();
+
+        // 回到界面线程替换索引；索引对象已销毁时直接丢弃
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, data, generation, buildMsecs]() {
+            if (guard) {
+                guard->install(data, generation, buildMsecs);
+            }
+        }, Qt::QueuedConnection);
+    }, m_buildToken);
+}
+
+bool SearchIndex::update(const QList<int> &removedRows, const QList<SearchEntry> &entries)
+{
+    if (m_building) {
+        m_pendingUpdates.append({ removedRows, entries });
+    }
+    if (!m_data) return m_building;
+
+    applyUpdate(removedRows, entries);
+    return int(m_overlayEntries.size()) <= kMaxOverlayEntries;
+}
+
+int SearchIndex::entryCount() const
+{
+    return m_data ? m_baseEntries + int(m_overlayEntries.size()) : 0;
+}
+
+QList<int> SearchIndex::query(const QString &text) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<int> result;
+    const QString needle = text.trimmed().toLower();
+    if (!m_data || needle.isEmpty()) {
+        m_lastQueryNsecs = timer.nsecsElapsed();
+        return result;
+    }
+
+    // 基础索引和增量段分别查找，记录编号连续排列（增量段在后）
+    const int overlayBase = int(m_rows.size());
+    scan(*m_data, m_rows, 0, needle);
+    if (m_overlay) {
+        scan(*m_overlay, m_overlayRows, overlayBase, needle);
+    }
+
+    // 按得分排序，得分相同时短名称和靠前的行优先。三者打包成一个整数排序，
+    // 比较时不必再按记录编号查表，命中上万条时也只是一次整数排序
+    m_order.clear();
+    m_order.reserve(m_touched.size());
+    for (int doc : m_touched) {
+        const bool inOverlay = doc >= overlayBase;
+        const int nameLength = inOverlay ? m_overlay->nameLengths[doc - overlayBase] : m_data->nameLengths[doc];
+        const int row = inOverlay ? m_overlayRows[doc - overlayBase] : m_rows[doc];
+        m_order.push_back((quint64(kMaxScore - m_scores[doc]) << 48)
+                          | (quint64(qMin(nameLength, 0xFFFF)) << 32)
+                          | quint32(row));
+        m_scores[doc] = -1;
+    }
+    m_touched.clear();
+    std::sort(m_order.begin(), m_order.end());
+
+    result.reserve(int(m_order.size()));
+    for (quint64 key : m_order) {
+        result.append(int(quint32(key)));
+    }
+
+    m_lastQueryNsecs = timer.nsecsElapsed();
+    return result;
+}
+
+void SearchIndex::scan(const SearchIndexData &data, const std::vector<int> &rows, int docBase,
+                       const QString &needle) const
+{
+    const char *base = data.text.constData();
+
+    // 已删除或被增量段取代的记录行号为 -1，不计入结果
+    auto touch = [this, &rows, docBase](quint32 doc, int score) {
+        if (rows[doc] < 0) return;
+        int &best = m_scores[docBase + doc];
+        if (best < 0) {
+            m_touched.push_back(docBase + int(doc));
+        }
+        best = qMax(best, score);
+    };
+
+    // 在有序键中二分查找前缀，命中的键是连续的一段
+    auto scanPrefix = [&](const std::vector<Key> &keys, const QByteArray &prefix, bool pinyinOnly) {
+        auto it = std::lower_bound(keys.begin(), keys.end(), prefix,
+                                   [base](const Key &key, const QByteArray &value) {
+            return compareSlice(base + key.offset, key.length, value.constData(), value.size()) < 0;
+        });
+        for (; it != keys.end(); ++it) {
+            if (it->length < prefix.size()
+                || std::memcmp(base + it->offset, prefix.constData(), prefix.size()) != 0) {
+                break;
+            }
+            if (pinyinOnly && it->kind == SearchIndexData::NameKey) continue;
+            touch(it->doc, keyScore(*it, it->length == prefix.size()));
+        }
+    };
+
+    // 单个字母只匹配名称、全拼和首字母的开头；汉字等其他单个字符仍做子串匹配
+    const bool singleLetter = needle.size() == 1 && needle.at(0).unicode() < 0x80;
+    scanPrefix(singleLetter ? data.headKeys : data.keys, needle.toUtf8(), false);
+
+    // 拼音输入中的空格（如 "wei xin"）去掉后再匹配一次
+    if (needle.contains(QLatin1Char(' '))) {
+        QString compact = needle;
+        compact.remove(QLatin1Char(' '));
+        scanPrefix(data.keys, compact.toUtf8(), true);
+    }
+
+    // 描述：取最短的三元组倒排表作为候选，再用子串验证
+    if (needle.size() >= 3) {
+        const std::vector<quint32> *candidates = nullptr;
+        for (int i = 0; i + 2 < needle.size(); ++i) {
+            auto it = data.trigrams.constFind(trigramKey(needle.at(i), needle.at(i + 1), needle.at(i + 2)));
+            if (it == data.trigrams.cend()) {
+                candidates = nullptr;
+                break;
+            }
+            if (!candidates || it.value().size() < candidates->size()) {
+                candidates = &it.value();
+            }
+        }
+        if (candidates) {
+            for (quint32 doc : *candidates) {
+                if (data.descriptions[doc].contains(needle)) {
+                    touch(doc, kDescriptionScore);
+                }
+            }
+        }
+    }
+}
+
+void SearchIndex::applyUpdate(const QList<int> &removedRows, const QList<SearchEntry> &entries)
+{
+    // 删除：基础索引中的记录标记失效，其余行号减去前面删除的行数（整数数组上的一次线性操作）
+    if (!removedRows.isEmpty()) {
+        const auto shift = [&removedRows](int &row) {
+            const auto it = std::lower_bound(removedRows.begin(), removedRows.end(), row);
+            row = it != removedRows.end() && *it == row ? -1 : row - int(it - removedRows.begin());
+        };
+
+        m_docByRow.clear();
+        for (int doc = 0; doc < int(m_rows.size()); ++doc) {
+            int &row = m_rows[doc];
+            if (row < 0) continue;
+            shift(row);
+            if (row < 0) {
+                --m_baseEntries;
+                continue;
+            }
+            if (row >= int(m_docByRow.size())) {
+                m_docByRow.resize(row + 1, -1);
+            }
+            m_docByRow[row] = doc;
+        }
+
+        std::map<int, SearchEntry> overlayEntries;
+        for (auto &item : m_overlayEntries) {
+            int row = item.first;
+            shift(row);
+            if (row >= 0) {
+                item.second.row = row;
+                overlayEntries.emplace(row, std::move(item.second));
+            }
+        }
+        m_overlayEntries.swap(overlayEntries);
+    }
+
+    // 新增和修改：基础索引中的旧记录失效，新内容放进增量段
+    for (const SearchEntry &entry : entries) {
+        if (entry.row < 0) continue;
+        if (entry.row < int(m_docByRow.size()) && m_docByRow[entry.row] >= 0) {
+            m_rows[m_docByRow[entry.row]] = -1;
+            m_docByRow[entry.row] = -1;
+            --m_baseEntries;
+        }
+        m_overlayEntries[entry.row] = entry;
+    }
+
+    // 增量段只有几十到几百条，同步重建；只有删除时行号已在上面更新
+    if (!entries.isEmpty()) {
+        QList<SearchEntry> overlay;
+        overlay.reserve(int(m_overlayEntries.size()));
+        for (const auto &item : m_overlayEntries) {
+            overlay.append(item.second);
+        }
+        m_overlay = buildData(overlay);
+        m_overlayRows = m_overlay->rows;
+    } else if (!removedRows.isEmpty() && m_overlay) {
+        m_overlayRows.clear();
+        for (const auto &item : m_overlayEntries) {
+            m_overlayRows.push_back(item.first);
+        }
+        if (m_overlayRows.size() != m_overlay->rows.size()) {
+            // 增量段中有记录被删除，按剩下的记录重建
+            QList<SearchEntry> overlay;
+            for (const auto &item : m_overlayEntries) {
+                overlay.append(item.second);
+            }
+            m_overlay = buildData(overlay);
+            m_overlayRows = m_overlay->rows;
+        }
+    }
+    m_scores.resize(m_rows.size() + m_overlayRows.size(), -1);
+}
+
+void SearchIndex::install(const std::shared_ptr<const SearchIndexData> &data, quint64 generation,
+                          qint64 buildMsecs)
+{
+    // 期间又发起了新的构建，丢弃旧结果
+    if (generation != m_generation) return;
+
+    m_data = data;
+    m_rows = data->rows;
+    m_baseEntries = int(m_rows.size());
+    m_docByRow.clear();
+    for (int doc = 0; doc < int(m_rows.size()); ++doc) {
+        const int row = m_rows[doc];
+        if (row < 0) continue;
+        if (row >= int(m_docByRow.size())) {
+            m_docByRow.resize(row + 1, -1);
+        }
+        m_docByRow[row] = doc;
+    }
+    m_overlay.reset();
+    m_overlayRows.clear();
+    m_overlayEntries.clear();
+    m_scores.assign(m_rows.size(), -1);
+    m_touched.clear();
+
+    // 构建期间收到的增量按顺序重放
+    m_building = false;
+    QList<PendingUpdate> pending;
+    pending.swap(m_pendingUpdates);
+    for (const PendingUpdate &update : std::as_const(pending)) {
+        applyUpdate(update.removedRows, update.entries);
+    }
+
+    emit ready(entryCount(), buildMsecs);
+}
@@ -0,0 +1,83 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include "core/taskscheduler.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+// 参与索引的一条记录
+struct SearchEntry
+{
+    int row = -1;          // 在源模型中的行号
+    QString name;          // 应用名称
+    QString description;   // 应用描述
+};
+
+struct SearchIndexData;
+
+// 应用搜索索引：在后台线程构建，查询在界面线程执行。
+// 支持名称前缀/子串、全拼、首字母以及描述的三元组匹配，结果按匹配质量排序。
+// 目录的增量变化通过 update 在界面线程直接应用：新增和修改的记录放进一个很小的增量段，
+// 基础索引中对应的旧记录和删除的记录只标记失效，查询时合并两者；增量段过大时由调用者整体重建。
+class SearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchIndex(QObject *parent = nullptr);
+    ~SearchIndex() override;
+
+    // 在后台构建索引，完成后替换当前索引并发出 ready
+    void build(const QList<SearchEntry> &entries);
+    // 增量更新：先删除 removedRows（删除前的行号，升序），其余行号前移，再加入或替换 entries 中的记录。
+    // 开销与变化条数成正比（行号前移是整数数组上的一次线性操作）；构建进行中时构建完成后重放。
+    // 增量段超过上限或还没有索引时返回 false，调用者应整体重新 build
+    bool update(const QList<int> &removedRows, const QList<SearchEntry> &entries);
+    bool isReady() const { return m_data != nullptr; }
+    bool isBuilding() const { return m_building; }
+    int entryCount() const;
+
+    // 返回匹配的行号（按相关度排序）
+    QList<int> query(const QString &text) const;
+    // 最近一次查询耗时（纳秒）
+    qint64 lastQueryNsecs() const { return m_lastQueryNsecs; }
+
+signals:
+    void ready(int entryCount, qint64 buildMsecs);
+
+private:
+    // 构建期间收到的增量
+    struct PendingUpdate {
+        QList<int> removedRows;
+        QList<SearchEntry> entries;
+    };
+
+    void install(const std::shared_ptr<const SearchIndexData> &data, quint64 generation,
+                 qint64 buildMsecs);
+    void applyUpdate(const QList<int> &removedRows, const QList<SearchEntry> &entries);
+    void scan(const SearchIndexData &data, const std::vector<int> &rows, int docBase,
+              const QString &needle) const;
+
+private:
+    std::shared_ptr<const SearchIndexData> m_data;  // 基础索引（后台整体构建，只读，可跨线程共享）
+    std::vector<int> m_rows;                        // 基础索引中每条记录当前的行号，删除或被增量段取代的为 -1
+    std::vector<int> m_docByRow;                    // 行号 -> 基础索引中的记录编号（-1 表示没有）
+    int m_baseEntries;                              // 基础索引中仍然有效的记录数
+    std::shared_ptr<const SearchIndexData> m_overlay;  // 增量段：之后新增和修改的记录
+    std::vector<int> m_overlayRows;                 // 增量段中每条记录当前的行号
+    std::map<int, SearchEntry> m_overlayEntries;    // 增量段的记录（行号 -> 记录），重建增量段用
+    quint64 m_generation;                           // 构建序号，丢弃过期的构建结果
+    bool m_building;                                // 有构建正在进行
+    QList<PendingUpdate> m_pendingUpdates;          // 构建期间收到的增量，构建完成后重放
+    CancellationToken m_buildToken;                 // 最近一次构建，新的构建开始时取消
+    mutable std::vector<int> m_scores;              // 查询时每条记录的最高得分
+    mutable std::vector<int> m_touched;             // 本次查询命中的记录
+    mutable std::vector<quint64> m_order;           // 排序用的（得分, 名称长度, 行号）
+    mutable qint64 m_lastQueryNsecs;
+};
+
+#endif // SEARCHINDEX_H
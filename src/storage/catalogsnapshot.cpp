@@ -0,0 +1,257 @@
+#include "catalogsnapshot.h"
+#include "core/iconservice.h"
+#include <QHash>
+#include <QSaveFile>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = { 'A', 'G', 'C', 'S' };
+const quint32 kByteOrderMark = 0x01020304;
+const quint32 kInstalledFlag = 0x1;
+
+struct Header
+{
+    char magic[4];
+    quint32 byteOrderMark;
+    quint32 version;
+    quint32 count;
+    quint32 recordSize;
+    quint32 reserved;
+    quint32 stringsOffset;
+    quint32 stringsSize;
+    quint32 thumbnailsOffset;
+    quint32 thumbnailsSize;
+};
+
+static_assert(sizeof(Header) == 40, "catalog snapshot header layout");
+
+// 写入字符串表，相同的字符串只写一次；偏移以字节计，长度以 UTF-16 字符计
+class StringTable
+{
+public:
+    void add(const QString &text, quint32 *offset, quint32 *length)
+    {
+        *length = quint32(text.size());
+        if (text.isEmpty()) {
+            *offset = 0;
+            return;
+        }
+        auto it = m_offsets.constFind(text);
+        if (it == m_offsets.constEnd()) {
+            it = m_offsets.insert(text, quint32(m_data.size()));
+            m_data.append(reinterpret_cast<const char *>(text.utf16()), text.size() * 2);
+        }
+        *offset = it.value();
+    }
+
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+    QHash<QString, quint32> m_offsets;
+};
+
+} // namespace
+
+struct CatalogSnapshot::Record
+{
+    quint32 strings[FieldCount][2];   // (偏移, 长度)
+    quint32 thumbnailOffset;
+    quint32 thumbnailSize;
+    quint32 flags;
+    quint32 reserved;
+};
+
+CatalogSnapshot::CatalogSnapshot()
+    : m_data(nullptr)
+    , m_count(0)
+    , m_strings(nullptr)
+    , m_stringsSize(0)
+    , m_thumbnails(nullptr)
+    , m_thumbnailsSize(0)
+{
+}
+
+CatalogSnapshot::~CatalogSnapshot() = default;
+
+bool CatalogSnapshot::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < qint64(sizeof(Header))) return false;
+
+    const qint64 size = m_file.size();
+    const uchar *data = m_file.map(0, size);
+    if (!data) return false;
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    // 只检查头部和各区域的范围，记录中的偏移在读取时检查，打开的耗时与应用数量无关
+    const bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.byteOrderMark == kByteOrderMark
+        && header.version == Version
+        && header.recordSize == sizeof(Record)
+        && qint64(sizeof(Header)) + qint64(header.count) * qint64(sizeof(Record)) <= size
+        && header.stringsOffset % 2 == 0
+        && qint64(header.stringsOffset) + header.stringsSize <= size
+        && qint64(header.thumbnailsOffset) + header.thumbnailsSize <= size;
+    if (!valid) {
+        m_file.unmap(const_cast<uchar *>(data));
+        m_file.close();
+        return false;
+    }
+
+    m_data = data;
+    m_count = int(header.count);
+    m_strings = data + header.stringsOffset;
+    m_stringsSize = header.stringsSize;
+    m_thumbnails = data + header.thumbnailsOffset;
+    m_thumbnailsSize = header.thumbnailsSize;
+    return true;
+}
+
+const CatalogSnapshot::Record *CatalogSnapshot::record(int row) const
+{
+    static_assert(sizeof(Record) == 64, "catalog snapshot record layout");
+    if (!m_data || row < 0 || row >= m_count) return nullptr;
+    return reinterpret_cast<const Record *>(m_data + sizeof(Header) + qint64(row) * sizeof(Record));
+}
+
+QStringView CatalogSnapshot::field(int row, Field field) const
+{
+    const Record *entry = record(row);
+    if (!entry || field < 0 || field >= FieldCount) return QStringView();
+
+    const quint32 offset = entry->strings[field][0];
+    const quint32 length = entry->strings[field][1];
+    if (offset % 2 != 0 || quint64(offset) + quint64(length) * 2 > m_stringsSize) return QStringView();
+    return QStringView(reinterpret_cast<const char16_t *>(m_strings + offset), qsizetype(length));
+}
+
+bool CatalogSnapshot::installed(int row) const
+{
+    const Record *entry = record(row);
+    return entry && (entry->flags & kInstalledFlag);
+}
+
+QByteArray CatalogSnapshot::thumbnail(int row) const
+{
+    const Record *entry = record(row);
+    if (!entry || entry->thumbnailSize == 0
+        || quint64(entry->thumbnailOffset) + entry->thumbnailSize > m_thumbnailsSize) {
+        return QByteArray();
+    }
+    return QByteArray(reinterpret_cast<const char *>(m_thumbnails + entry->thumbnailOffset),
+                      entry->thumbnailSize);
+}
+
+AppInfo CatalogSnapshot::app(int row) const
+{
+    AppInfo info;
+    info.id = field(row, Id).toString();
+    info.name = field(row, Name).toString();
+    info.description = field(row, Description).toString();
+    info.iconPath = field(row, IconPath).toString();
+    info.packageUrl = field(row, PackageUrl).toString();
+    info.packageHash = field(row, PackageHash).toString();
+    info.installed = installed(row);
+    return info;
+}
+
+bool CatalogSnapshot::write(const QString &path, const QList<AppInfo> &apps, const QString &iconCacheDir,
+                            QString *error)
+{
+    StringTable strings;
+    QByteArray thumbnails;
+    QHash<QString, QPair<quint32, quint32>> thumbnailRanges;   // 图标路径 -> 缩略图区中的范围
+    QByteArray records(apps.size() * int(sizeof(Record)), '\0');
+
+    for (int i = 0; i < apps.size(); ++i) {
+        const AppInfo &app = apps.at(i);
+        Record record;
+        std::memset(&record, 0, sizeof(record));
+        strings.add(app.id, &record.strings[Id][0], &record.strings[Id][1]);
+        strings.add(app.name, &record.strings[Name][0], &record.strings[Name][1]);
+        strings.add(app.description, &record.strings[Description][0], &record.strings[Description][1]);
+        strings.add(app.iconPath, &record.strings[IconPath][0], &record.strings[IconPath][1]);
+        strings.add(app.packageUrl, &record.strings[PackageUrl][0], &record.strings[PackageUrl][1]);
+        strings.add(app.packageHash, &record.strings[PackageHash][0], &record.strings[PackageHash][1]);
+        record.flags = app.installed ? kInstalledFlag : 0;
+
+        if (!iconCacheDir.isEmpty() && !app.iconPath.isEmpty()) {
+            auto it = thumbnailRanges.constFind(app.iconPath);
+            if (it == thumbnailRanges.constEnd()) {
+                QFile file(IconService::thumbnailPath(app.iconPath, iconCacheDir));
+                const QByteArray png = file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+                it = thumbnailRanges.insert(app.iconPath, qMakePair(quint32(thumbnails.size()), quint32(png.size())));
+                thumbnails += png;
+            }
+            record.thumbnailOffset = it->first;
+            record.thumbnailSize = it->second;
+        }
+        std::memcpy(records.data() + i * sizeof(Record), &record, sizeof(record));
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrderMark = kByteOrderMark;
+    header.version = Version;
+    header.count = quint32(apps.size());
+    header.recordSize = sizeof(Record);
+    header.reserved = 0;
+    header.stringsOffset = quint32(sizeof(Header) + records.size());
+    header.stringsSize = quint32(strings.data().size());
+    header.thumbnailsOffset = header.stringsOffset + header.stringsSize;
+    header.thumbnailsSize = quint32(thumbnails.size());
+
+    QSaveFile file(path);
+    const bool ok = file.open(QIODevice::WriteOnly)
+        && file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header))
+        && file.write(records) == records.size()
+        && file.write(strings.data()) == strings.data().size()
+        && file.write(thumbnails) == thumbnails.size()
+        && file.commit();
+    if (!ok && error) {
+        *error = file.errorString();
+    }
+    return ok;
+}
+
+bool CatalogSnapshot::setInstalled(const QString &path, const QHash<QString, bool> &installed, QString *error)
+{
+    CatalogSnapshot snapshot;
+    if (!snapshot.open(path)) {
+        if (error) *error = QStringLiteral("invalid catalog snapshot");
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        if (error) *error = file.errorString();
+        return false;
+    }
+
+    // 一次只修改很少几个应用，逐行比较 ID 的视图，不为每行分配字符串
+    int remaining = installed.size();
+    for (int row = 0; row < snapshot.count() && remaining > 0; ++row) {
+        const QStringView id = snapshot.field(row, Id);
+        for (auto it = installed.constBegin(); it != installed.constEnd(); ++it) {
+            if (id != it.key()) continue;
+
+            const Record *entry = snapshot.record(row);
+            const quint32 flags = it.value() ? (entry->flags | kInstalledFlag) : (entry->flags & ~kInstalledFlag);
+            if (flags != entry->flags) {
+                const qint64 offset = qint64(sizeof(Header)) + qint64(row) * sizeof(Record) + offsetof(Record, flags);
+                if (!file.seek(offset)
+                    || file.write(reinterpret_cast<const char *>(&flags), sizeof(flags)) != qint64(sizeof(flags))) {
+                    if (error) *error = file.errorString();
+                    return false;
+                }
+            }
+            --remaining;
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include "models/appinfo.h"
+
+// 应用目录快照：最近一次提交的目录保存为可以直接映射的二进制文件，
+// 启动时映射后即可按行读取，不需要等待数据库，也没有解析和逐条分配。
+// 文件格式（本机字节序，字节序标记不符时视为无效）：
+//   头部 40 字节：魔数 "AGCS"、字节序标记、版本、记录数、记录大小、字符串表和缩略图区的偏移与长度
+//   记录区：每个应用一条 64 字节的定长记录，六个字符串字段为字符串表中的 (偏移, 长度)，
+//           之后是缩略图区中的 (偏移, 长度) 和标志位
+//   字符串表：UTF-16 字符串，相同的字符串只保存一次（描述、地址前缀等大量重复）
+//   缩略图区：图标缩略图 PNG（取自 IconService 的磁盘缓存），相同的图标只保存一次
+// 写入通过 QSaveFile 原子替换，已经映射旧文件的读取方不受影响。
+class CatalogSnapshot
+{
+public:
+    enum Field {
+        Id,
+        Name,
+        Description,
+        IconPath,
+        PackageUrl,
+        PackageHash,
+        FieldCount
+    };
+
+    static const quint32 Version = 1;
+
+    CatalogSnapshot();
+    ~CatalogSnapshot();
+
+    // 映射快照文件，格式或版本不符时返回 false
+    bool open(const QString &path);
+    bool isValid() const { return m_data != nullptr; }
+
+    int count() const { return m_count; }
+    // 直接指向映射内容的字符串，在快照销毁前有效
+    QStringView field(int row, Field field) const;
+    bool installed(int row) const;
+    QByteArray thumbnail(int row) const;
+    AppInfo app(int row) const;
+
+    // 写入快照；iconCacheDir 非空时把磁盘缓存中已有的图标缩略图一起保存
+    static bool write(const QString &path, const QList<AppInfo> &apps, const QString &iconCacheDir,
+                      QString *error = nullptr);
+    // 只修改已有快照中的安装标志（应用ID -> 是否已安装），就地写入记录的标志位，不重写整个文件；
+    // 已经映射这个文件的读取方随之看到新的标志。快照中没有的应用忽略，文件无效时返回 false
+    static bool setInstalled(const QString &path, const QHash<QString, bool> &installed,
+                             QString *error = nullptr);
+
+private:
+    struct Record;
+
+    const Record *record(int row) const;
+
+private:
+    QFile m_file;
+    const uchar *m_data;
+    int m_count;
+    const uchar *m_strings;
+    quint32 m_stringsSize;
+    const uchar *m_thumbnails;
+    quint32 m_thumbnailsSize;
+
+    Q_DISABLE_COPY(CatalogSnapshot)
+};
+
+#endif // CATALOGSNAPSHOT_H
@@ -0,0 +1,164 @@
+#include "localstore.h"
+#include "localstoreworker.h"
+
+LocalStore::LocalStore(QObject *parent)
+    : QObject(parent)
+    , m_worker(new LocalStoreWorker)
+    , m_nextRequestId(1)
+    , m_catalogRevision(0)
+{
+    m_thread.setObjectName(QStringLiteral("LocalStore"));
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // 工作对象的信号跨线程转发（自动使用队列连接）
+    connect(m_worker, &LocalStoreWorker::opened, this, &LocalStore::opened);
+    connect(m_worker, &LocalStoreWorker::catalogCountReady, this, &LocalStore::catalogCountReady);
+    connect(m_worker, &LocalStoreWorker::catalogPageReady, this, &LocalStore::catalogPageReady);
+    connect(m_worker, &LocalStoreWorker::catalogVersionReady, this, &LocalStore::catalogVersionReady);
+    connect(m_worker, &LocalStoreWorker::syncRecordsCommitted, this, &LocalStore::syncRecordsCommitted);
+    connect(m_worker, &LocalStoreWorker::pendingSyncRecordsReady, this, &LocalStore::pendingSyncRecordsReady);
+    connect(m_worker, &LocalStoreWorker::catalogChanged, this, &LocalStore::catalogChanged);
+    connect(m_worker, &LocalStoreWorker::installedChanged, this, &LocalStore::installedChanged);
+    connect(m_worker, &LocalStoreWorker::errorOccurred, this, &LocalStore::errorOccurred);
+    connect(m_worker, &LocalStoreWorker::catalogSnapshotWritten, this, &LocalStore::catalogSnapshotWritten);
+
+    m_thread.start();
+}
+
+LocalStore::~LocalStore()
+{
+    // 提交剩余的写操作并关闭数据库
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker]() { worker->close(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void LocalStore::open(const QString &databasePath)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, databasePath]() {
+        worker->open(databasePath);
+    }, Qt::QueuedConnection);
+}
+
+quint64 LocalStore::replaceCatalog(const QList<AppInfo> &apps)
+{
+    const quint64 revision = ++m_catalogRevision;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, apps, revision]() {
+        worker->enqueueWrite([worker, apps]() { return worker->writeReplaceCatalog(apps); }, revision);
+    }, Qt::QueuedConnection);
+    return revision;
+}
+
+quint64 LocalStore::upsertCatalog(const QList<AppInfo> &apps)
+{
+    const quint64 revision = ++m_catalogRevision;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, apps, revision]() {
+        worker->enqueueWrite([worker, apps]() { return worker->writeUpsertCatalog(apps); }, revision);
+    }, Qt::QueuedConnection);
+    return revision;
+}
+
+quint64 LocalStore::removeCatalog(const QStringList &appIds)
+{
+    const quint64 revision = ++m_catalogRevision;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, appIds, revision]() {
+        worker->enqueueWrite([worker, appIds]() { return worker->writeRemoveCatalog(appIds); }, revision);
+    }, Qt::QueuedConnection);
+    return revision;
+}
+
+void LocalStore::setCatalogVersion(const QString &version)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, version]() {
+        worker->enqueueWrite([worker, version]() { return worker->writeCatalogVersion(version); }, 0);
+    }, Qt::QueuedConnection);
+}
+
+void LocalStore::setInstalled(const QString &appId, const QString &version, const QString &installPath)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, appId, version, installPath]() {
+        worker->enqueueWrite([worker, appId, version, installPath]() {
+            return worker->writeSetInstalled(appId, version, installPath);
+        }, 0);
+    }, Qt::QueuedConnection);
+}
+
+void LocalStore::removeInstalled(const QString &appId)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, appId]() {
+        worker->enqueueWrite([worker, appId]() { return worker->writeRemoveInstalled(appId); }, 0);
+    }, Qt::QueuedConnection);
+}
+
+void LocalStore::appendSyncRecords(const QList<SyncRecord> &records)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, records]() {
+        worker->enqueueWrite([worker, records]() { return worker->writeSyncRecords(records); }, 0, true);
+    }, Qt::QueuedConnection);
+}
+
+void LocalStore::completeSyncRecords(const QList<qint64> &ids)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, ids]() {
+        worker->enqueueWrite([worker, ids]() { return worker->writeCompleteSyncRecords(ids); }, 0);
+    }, Qt::QueuedConnection);
+}
+
+quint64 LocalStore::requestPendingSyncRecords()
+{
+    const quint64 requestId = m_nextRequestId++;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, requestId]() {
+        worker->readPendingSyncRecords(requestId);
+    }, Qt::QueuedConnection);
+    return requestId;
+}
+
+void LocalStore::setCatalogSnapshot(const QString &snapshotPath, const QString &iconCacheDir)
+{
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, snapshotPath, iconCacheDir]() {
+        worker->setCatalogSnapshot(snapshotPath, iconCacheDir);
+    }, Qt::QueuedConnection);
+}
+
+quint64 LocalStore::requestCatalogCount()
+{
+    const quint64 requestId = m_nextRequestId++;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, requestId]() {
+        worker->readCatalogCount(requestId);
+    }, Qt::QueuedConnection);
+    return requestId;
+}
+
+quint64 LocalStore::requestCatalogPage(int offset, int limit)
+{
+    const quint64 requestId = m_nextRequestId++;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, requestId, offset, limit]() {
+        worker->readCatalogPage(requestId, offset, limit);
+    }, Qt::QueuedConnection);
+    return requestId;
+}
+
+quint64 LocalStore::requestCatalogVersion()
+{
+    const quint64 requestId = m_nextRequestId++;
+    LocalStoreWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, requestId]() {
+        worker->readCatalogVersion(requestId);
+    }, Qt::QueuedConnection);
+    return requestId;
+}
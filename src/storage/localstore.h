@@ -0,0 +1,98 @@
+#ifndef LOCALSTORE_H
+#define LOCALSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QThread>
+#include <QList>
+#include <QStringList>
+#include "models/appinfo.h"
+
+class LocalStoreWorker;
+
+// 文件同步记录
+struct SyncRecord
+{
+    enum Operation {
+        Created,
+        Modified,
+        Removed
+    };
+
+    qint64 id = 0;         // 日志编号（写入数据库后有效）
+    QString appId;         // 所属应用
+    QString relativePath;  // 相对同步文件夹的路径
+    Operation operation = Modified;
+    qint64 size = 0;       // 文件大小
+    qint64 mtime = 0;      // 修改时间（毫秒）
+};
+
+// 本地存储模块：SQLite 数据库运行在独立线程上（WAL 模式），
+// 所有接口都是异步的，读结果通过信号返回。
+// 写操作会在短时间内合并到同一个事务中提交；包含同步记录的事务提交时落盘，其余提交不等待落盘。
+class LocalStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LocalStore(QObject *parent = nullptr);
+    ~LocalStore() override;
+
+    // 打开数据库（不存在时创建并初始化表结构）
+    void open(const QString &databasePath);
+
+    // 应用目录。每个修改目录的写操作返回一个递增的修订号（从 1 开始），catalogChanged 和
+    // catalogSnapshotWritten 带有提交时已包含的最大修订号，写入方据此判断提交的内容是否已经在内存中
+    quint64 replaceCatalog(const QList<AppInfo> &apps);
+    quint64 upsertCatalog(const QList<AppInfo> &apps);
+    quint64 removeCatalog(const QStringList &appIds);
+    // 最近分配的修订号
+    quint64 catalogRevision() const { return m_catalogRevision; }
+    // 目录同步的版本号（见 CatalogSync），在同一批写操作的目录修改之后写入；
+    // 两者分在不同事务时崩溃只会让下次同步重复应用同一批变化
+    void setCatalogVersion(const QString &version);
+
+    // 已安装应用
+    void setInstalled(const QString &appId, const QString &version, const QString &installPath);
+    void removeInstalled(const QString &appId);
+
+    // 同步记录：写入后作为待上传的日志保存，上传完成后调用 completeSyncRecords 删除。
+    // 记录随写操作组提交，提交后（已落盘）发出 syncRecordsCommitted
+    void appendSyncRecords(const QList<SyncRecord> &records);
+    void completeSyncRecords(const QList<qint64> &ids);
+    // 读取所有尚未上传的记录（启动时重放），返回请求编号
+    quint64 requestPendingSyncRecords();
+
+    // 目录快照（见 CatalogSnapshot）：设置后每次修改目录的提交之后在数据库线程重写快照，
+    // 完成后发出 catalogSnapshotWritten；只修改安装状态的提交只改快照中的标志位，不重写也不发出通知。
+    // 文件不存在时在数据库打开后立即写入
+    void setCatalogSnapshot(const QString &snapshotPath, const QString &iconCacheDir);
+
+    // 分页读取，返回请求编号（limit 为 -1 时读取 offset 之后的全部行）
+    quint64 requestCatalogCount();
+    quint64 requestCatalogPage(int offset, int limit);
+    quint64 requestCatalogVersion();
+
+signals:
+    void opened(bool ok, const QString &error);
+    void catalogCountReady(quint64 requestId, int count);
+    void catalogPageReady(quint64 requestId, int offset, const QList<AppInfo> &apps);
+    void catalogVersionReady(quint64 requestId, const QString &version);
+    void syncRecordsCommitted(const QList<SyncRecord> &records);
+    void pendingSyncRecordsReady(quint64 requestId, const QList<SyncRecord> &records);
+    // 目录被写入后发出，revision 为这次提交包含的最大修订号（提交失败时同样发出）
+    void catalogChanged(quint64 revision);
+    // 安装状态的修改提交后发出（应用ID -> 是否已安装）
+    void installedChanged(const QHash<QString, bool> &installed);
+    // 目录快照写入完成，revision 为快照包含的最大修订号；失败时 ok 为 false（旧快照不再与数据库一致）
+    void catalogSnapshotWritten(const QString &snapshotPath, bool ok, quint64 revision);
+    void errorOccurred(const QString &message);
+
+private:
+    QThread m_thread;             // 数据库线程
+    LocalStoreWorker *m_worker;   // 运行在数据库线程上的工作对象
+    quint64 m_nextRequestId;      // 读请求编号
+    quint64 m_catalogRevision;    // 最近分配的目录修订号
+};
+
+#endif // LOCALSTORE_H
@@ -0,0 +1,526 @@
+#include "localstoreworker.h"
+#include "catalogsnapshot.h"
+#include "core/trace.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSqlError>
+#include <QTimer>
+#include <QUuid>
+#include <QVariant>
+
+namespace {
+
+const int kSchemaVersion = 3;
+const int kFlushIntervalMs = 20;   // 写操作合并的最长等待时间
+const int kMaxBatchWrites = 256;   // 单个事务最多合并的写操作数
+
+} // namespace
+
+LocalStoreWorker::LocalStoreWorker(QObject *parent)
+    : QObject(parent)
+    , m_pendingRevision(0)
+    , m_committedRevision(0)
+    , m_pendingDurable(false)
+    , m_flushTimer(nullptr)
+{
+}
+
+LocalStoreWorker::~LocalStoreWorker()
+{
+    close();
+}
+
+void LocalStoreWorker::open(const QString &databasePath)
+{
+    if (!m_flushTimer) {
+        m_flushTimer = new QTimer(this);
+        m_flushTimer->setSingleShot(true);
+        m_flushTimer->setInterval(kFlushIntervalMs);
+        connect(m_flushTimer, &QTimer::timeout, this, &LocalStoreWorker::flush);
+    }
+
+    m_connectionName = QStringLiteral("appgo-store-") + QUuid::createUuid().toString(QUuid::WithoutBraces);
+    m_db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), m_connectionName);
+    m_db.setDatabaseName(databasePath);
+
+    if (!m_db.open()) {
+        emit opened(false, m_db.lastError().text());
+        return;
+    }
+
+    // WAL 模式下读不阻塞写；synchronous=NORMAL 时提交不等待落盘，断电最多丢失最近的几次提交，数据库不会损坏。
+    // 包含同步记录的提交在 flush() 中临时切换为 FULL，保证通知上传前记录已经落盘
+    QSqlQuery pragma(m_db);
+    pragma.exec(QStringLiteral("PRAGMA journal_mode=WAL"));
+    pragma.exec(QStringLiteral("PRAGMA synchronous=NORMAL"));
+    pragma.exec(QStringLiteral("PRAGMA temp_store=MEMORY"));
+
+    if (!createSchema()) {
+        const QString error = m_db.lastError().text();
+        m_db.close();
+        emit opened(false, error);
+        return;
+    }
+
+    emit opened(true, QString());
+
+    // 第一次运行或快照格式升级后还没有快照
+    if (!m_snapshotPath.isEmpty() && !QFileInfo::exists(m_snapshotPath)) {
+        writeCatalogSnapshot();
+    }
+
+    // 打开前排队的写操作
+    if (!m_pendingWrites.isEmpty()) {
+        m_flushTimer->start();
+    }
+}
+
+void LocalStoreWorker::close()
+{
+    if (!m_db.isOpen()) return;
+
+    flush();
+    qDeleteAll(m_statements);
+    m_statements.clear();
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+void LocalStoreWorker::setCatalogSnapshot(const QString &snapshotPath, const QString &iconCacheDir)
+{
+    m_snapshotPath = snapshotPath;
+    m_iconCacheDir = iconCacheDir;
+    if (m_db.isOpen() && !m_snapshotPath.isEmpty() && !QFileInfo::exists(m_snapshotPath)) {
+        writeCatalogSnapshot();
+    }
+}
+
+void LocalStoreWorker::enqueueWrite(const std::function<bool()> &write, quint64 catalogRevision, bool durable)
+{
+    m_pendingWrites.append(write);
+    m_pendingRevision = qMax(m_pendingRevision, catalogRevision);
+    m_pendingDurable = m_pendingDurable || durable;
+
+    if (!m_db.isOpen()) return;
+
+    if (m_pendingWrites.size() >= kMaxBatchWrites) {
+        flush();
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void LocalStoreWorker::flush()
+{
+    TRACE_SPAN("db", "LocalStore::commit");
+    if (m_flushTimer) {
+        m_flushTimer->stop();
+    }
+    if (m_pendingWrites.isEmpty() || !m_db.isOpen()) return;
+
+    const QList<std::function<bool()>> writes = m_pendingWrites;
+    const quint64 revision = m_pendingRevision;
+    const bool touchesCatalog = revision > 0;
+    const bool durable = m_pendingDurable;
+    m_pendingWrites.clear();
+    m_pendingRevision = 0;
+    m_pendingDurable = false;
+
+    // 只有这一次提交等待落盘（WAL 中之前未落盘的提交随之一起落盘），其余提交不付出 fsync 的开销
+    QSqlQuery pragma(m_db);
+    if (durable) {
+        pragma.exec(QStringLiteral("PRAGMA synchronous=FULL"));
+    }
+    const bool committed = commitWrites(writes);
+    if (durable) {
+        pragma.exec(QStringLiteral("PRAGMA synchronous=NORMAL"));
+    }
+    if (touchesCatalog) {
+        m_committedRevision = revision;
+    }
+    if (!committed) {
+        // 修订号同样推进，等待这些修订号提交的一方不会一直等下去
+        if (touchesCatalog) {
+            emit catalogChanged(revision);
+        }
+        return;
+    }
+
+    if (!m_uncommittedSyncRecords.isEmpty()) {
+        QList<SyncRecord> records;
+        records.swap(m_uncommittedSyncRecords);
+        emit syncRecordsCommitted(records);
+    }
+
+    // 目录有修改时快照整体重写，其中已包含安装状态；只修改了安装状态时只改快照中的标志位
+    if (touchesCatalog) {
+        writeCatalogSnapshot();
+        emit catalogChanged(revision);
+    }
+    if (!m_uncommittedInstalled.isEmpty()) {
+        QHash<QString, bool> installed;
+        installed.swap(m_uncommittedInstalled);
+        if (!touchesCatalog) {
+            patchCatalogSnapshot(installed);
+        }
+        emit installedChanged(installed);
+    }
+}
+
+bool LocalStoreWorker::commitWrites(const QList<std::function<bool()>> &writes)
+{
+    if (!m_db.transaction()) {
+        emit errorOccurred(m_db.lastError().text());
+        return false;
+    }
+
+    bool ok = true;
+    for (const std::function<bool()> &write : writes) {
+        if (!write()) {
+            ok = false;
+            break;
+        }
+    }
+
+    if (!ok || !m_db.commit()) {
+        const QString error = m_db.lastError().text();
+        m_db.rollback();
+        m_uncommittedSyncRecords.clear();
+        m_uncommittedInstalled.clear();
+        emit errorOccurred(error);
+        return false;
+    }
+    return true;
+}
+
+bool LocalStoreWorker::writeReplaceCatalog(const QList<AppInfo> &apps)
+{
+    QSqlQuery &clear = statement(QStringLiteral("DELETE FROM catalog"));
+    if (!exec(clear)) return false;
+
+    QSqlQuery &insert = statement(QStringLiteral(
+        "INSERT INTO catalog (app_id, name, description, icon_path, package_url, package_hash, sort_order) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?)"));
+    for (int i = 0; i < apps.size(); ++i) {
+        const AppInfo &app = apps.at(i);
+        insert.bindValue(0, app.id);
+        insert.bindValue(1, app.name);
+        insert.bindValue(2, app.description);
+        insert.bindValue(3, app.iconPath);
+        insert.bindValue(4, app.packageUrl);
+        insert.bindValue(5, app.packageHash);
+        insert.bindValue(6, i);
+        if (!exec(insert)) return false;
+    }
+    return true;
+}
+
+bool LocalStoreWorker::writeUpsertCatalog(const QList<AppInfo> &apps)
+{
+    // 已存在的条目保持原有顺序，新条目追加到末尾
+    QSqlQuery &upsert = statement(QStringLiteral(
+        "INSERT INTO catalog (app_id, name, description, icon_path, package_url, package_hash, sort_order) "
+        "VALUES (?, ?, ?, ?, ?, ?, (SELECT IFNULL(MAX(sort_order), -1) + 1 FROM catalog)) "
+        "ON CONFLICT(app_id) DO UPDATE SET "
+        "name = excluded.name, description = excluded.description, icon_path = excluded.icon_path, "
+        "package_url = excluded.package_url, package_hash = excluded.package_hash"));
+    for (const AppInfo &app : apps) {
+        upsert.bindValue(0, app.id);
+        upsert.bindValue(1, app.name);
+        upsert.bindValue(2, app.description);
+        upsert.bindValue(3, app.iconPath);
+        upsert.bindValue(4, app.packageUrl);
+        upsert.bindValue(5, app.packageHash);
+        if (!exec(upsert)) return false;
+    }
+    return true;
+}
+
+bool LocalStoreWorker::writeRemoveCatalog(const QStringList &appIds)
+{
+    QSqlQuery &remove = statement(QStringLiteral("DELETE FROM catalog WHERE app_id = ?"));
+    for (const QString &appId : appIds) {
+        remove.bindValue(0, appId);
+        if (!exec(remove)) return false;
+    }
+    return true;
+}
+
+bool LocalStoreWorker::writeCatalogVersion(const QString &version)
+{
+    QSqlQuery &upsert = statement(QStringLiteral(
+        "INSERT OR REPLACE INTO settings (key, value) VALUES ('catalog_version', ?)"));
+    upsert.bindValue(0, version);
+    return exec(upsert);
+}
+
+bool LocalStoreWorker::writeSetInstalled(const QString &appId, const QString &version,
+                                         const QString &installPath)
+{
+    QSqlQuery &upsert = statement(QStringLiteral(
+        "INSERT OR REPLACE INTO installed_apps (app_id, version, install_path, installed_at) "
+        "VALUES (?, ?, ?, ?)"));
+    upsert.bindValue(0, appId);
+    upsert.bindValue(1, version);
+    upsert.bindValue(2, installPath);
+    upsert.bindValue(3, QDateTime::currentMSecsSinceEpoch());
+    if (!exec(upsert)) return false;
+    m_uncommittedInstalled.insert(appId, true);
+    return true;
+}
+
+bool LocalStoreWorker::writeRemoveInstalled(const QString &appId)
+{
+    QSqlQuery &remove = statement(QStringLiteral("DELETE FROM installed_apps WHERE app_id = ?"));
+    remove.bindValue(0, appId);
+    if (!exec(remove)) return false;
+    m_uncommittedInstalled.insert(appId, false);
+    return true;
+}
+
+bool LocalStoreWorker::writeSyncRecords(const QList<SyncRecord> &records)
+{
+    QSqlQuery &insert = statement(QStringLiteral(
+        "INSERT INTO sync_journal (app_id, relative_path, operation, size, mtime, created_at) "
+        "VALUES (?, ?, ?, ?, ?, ?)"));
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const SyncRecord &record : records) {
+        insert.bindValue(0, record.appId);
+        insert.bindValue(1, record.relativePath);
+        insert.bindValue(2, static_cast<int>(record.operation));
+        insert.bindValue(3, record.size);
+        insert.bindValue(4, record.mtime);
+        insert.bindValue(5, now);
+        if (!exec(insert)) return false;
+
+        SyncRecord committed = record;
+        committed.id = insert.lastInsertId().toLongLong();
+        m_uncommittedSyncRecords.append(committed);
+    }
+    return true;
+}
+
+bool LocalStoreWorker::writeCompleteSyncRecords(const QList<qint64> &ids)
+{
+    // 已上传的记录直接删除，日志中只保留待上传的部分，启动时的重放与文件总数无关
+    QSqlQuery &remove = statement(QStringLiteral("DELETE FROM sync_journal WHERE id = ?"));
+    for (qint64 id : ids) {
+        remove.bindValue(0, id);
+        if (!exec(remove)) return false;
+    }
+    return true;
+}
+
+void LocalStoreWorker::readCatalogCount(quint64 requestId)
+{
+    TRACE_SPAN("db", "LocalStore::readCatalogCount");
+    // 读之前先提交排队的写操作，保证读到最新数据
+    flush();
+
+    QSqlQuery &query = statement(QStringLiteral("SELECT COUNT(*) FROM catalog"));
+    int count = 0;
+    if (exec(query) && query.next()) {
+        count = query.value(0).toInt();
+    }
+    query.finish();
+    emit catalogCountReady(requestId, count);
+}
+
+void LocalStoreWorker::readCatalogPage(quint64 requestId, int offset, int limit)
+{
+    flush();
+    emit catalogPageReady(requestId, offset, queryCatalog(offset, limit));
+}
+
+void LocalStoreWorker::readCatalogVersion(quint64 requestId)
+{
+    flush();
+
+    QSqlQuery &query = statement(QStringLiteral("SELECT value FROM settings WHERE key = 'catalog_version'"));
+    QString version;
+    if (exec(query) && query.next()) {
+        version = query.value(0).toString();
+    }
+    query.finish();
+    emit catalogVersionReady(requestId, version);
+}
+
+QList<AppInfo> LocalStoreWorker::queryCatalog(int offset, int limit, bool *ok)
+{
+    TRACE_SPAN("db", "LocalStore::queryCatalog");
+    QSqlQuery &query = statement(QStringLiteral(
+        "SELECT c.app_id, c.name, c.description, c.icon_path, i.app_id IS NOT NULL, "
+        "c.package_url, c.package_hash "
+        "FROM catalog c LEFT JOIN installed_apps i ON i.app_id = c.app_id "
+        "ORDER BY c.sort_order, c.app_id LIMIT ? OFFSET ?"));
+    query.bindValue(0, limit);
+    query.bindValue(1, offset);
+
+    QList<AppInfo> apps;
+    if (limit > 0) {
+        apps.reserve(limit);
+    }
+    const bool executed = exec(query);
+    if (ok) {
+        *ok = executed;
+    }
+    if (executed) {
+        while (query.next()) {
+            AppInfo app;
+            app.id = query.value(0).toString();
+            app.name = query.value(1).toString();
+            app.description = query.value(2).toString();
+            app.iconPath = query.value(3).toString();
+            app.installed = query.value(4).toBool();
+            app.packageUrl = query.value(5).toString();
+            app.packageHash = query.value(6).toString();
+            apps.append(app);
+        }
+    }
+    query.finish();
+    return apps;
+}
+
+void LocalStoreWorker::writeCatalogSnapshot()
+{
+    TRACE_SPAN("db", "LocalStore::writeCatalogSnapshot");
+    if (m_snapshotPath.isEmpty()) return;
+
+    bool ok = false;
+    const QList<AppInfo> apps = queryCatalog(0, -1, &ok);
+    QString error = QStringLiteral("catalog query failed");
+    ok = ok && CatalogSnapshot::write(m_snapshotPath, apps, m_iconCacheDir, &error);
+    if (!ok) {
+        emit errorOccurred(QStringLiteral("Failed to write catalog snapshot: ") + error);
+    }
+    emit catalogSnapshotWritten(m_snapshotPath, ok, m_committedRevision);
+}
+
+void LocalStoreWorker::patchCatalogSnapshot(const QHash<QString, bool> &installed)
+{
+    TRACE_SPAN("db", "LocalStore::patchCatalogSnapshot");
+    if (m_snapshotPath.isEmpty()) return;
+
+    // 快照还不存在或已损坏时退回整体重写
+    QString error;
+    if (!CatalogSnapshot::setInstalled(m_snapshotPath, installed, &error)) {
+        qWarning() << "Failed to patch catalog snapshot:" << error;
+        writeCatalogSnapshot();
+    }
+}
+
+void LocalStoreWorker::readPendingSyncRecords(quint64 requestId)
+{
+    TRACE_SPAN("db", "LocalStore::readPendingSyncRecords");
+    flush();
+
+    QSqlQuery &query = statement(QStringLiteral(
+        "SELECT id, app_id, relative_path, operation, size, mtime "
+        "FROM sync_journal WHERE state = 0 ORDER BY id"));
+    QList<SyncRecord> records;
+    if (exec(query)) {
+        while (query.next()) {
+            SyncRecord record;
+            record.id = query.value(0).toLongLong();
+            record.appId = query.value(1).toString();
+            record.relativePath = query.value(2).toString();
+            record.operation = static_cast<SyncRecord::Operation>(query.value(3).toInt());
+            record.size = query.value(4).toLongLong();
+            record.mtime = query.value(5).toLongLong();
+            records.append(record);
+        }
+    }
+    query.finish();
+    emit pendingSyncRecordsReady(requestId, records);
+}
+
+bool LocalStoreWorker::createSchema()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec(QStringLiteral("PRAGMA user_version")) || !query.next()) return false;
+    const int version = query.value(0).toInt();
+    query.finish();
+    if (version >= kSchemaVersion) return true;
+
+    // 按版本依次升级：0 -> 1 建表，1 -> 2 增加安装包信息，2 -> 3 增加设置表（目录同步版本号）
+    QStringList statements;
+    if (version < 1) {
+        statements << QStringList{
+            QStringLiteral(
+                "CREATE TABLE IF NOT EXISTS catalog ("
+                "  app_id TEXT PRIMARY KEY,"
+                "  name TEXT NOT NULL,"
+                "  description TEXT,"
+                "  icon_path TEXT,"
+                "  version TEXT,"
+                "  sort_order INTEGER NOT NULL DEFAULT 0"
+                ")"),
+            QStringLiteral("CREATE INDEX IF NOT EXISTS idx_catalog_order ON catalog (sort_order, app_id)"),
+            QStringLiteral(
+                "CREATE TABLE IF NOT EXISTS installed_apps ("
+                "  app_id TEXT PRIMARY KEY,"
+                "  version TEXT,"
+                "  install_path TEXT,"
+                "  installed_at INTEGER"
+                ")"),
+            QStringLiteral(
+                "CREATE TABLE IF NOT EXISTS sync_journal ("
+                "  id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                "  app_id TEXT NOT NULL,"
+                "  relative_path TEXT NOT NULL,"
+                "  operation INTEGER NOT NULL,"
+                "  size INTEGER,"
+                "  mtime INTEGER,"
+                "  state INTEGER NOT NULL DEFAULT 0,"
+                "  created_at INTEGER"
+                ")"),
+            QStringLiteral("CREATE INDEX IF NOT EXISTS idx_sync_journal_state ON sync_journal (state, id)")
+        };
+    }
+    if (version < 2) {
+        statements << QStringLiteral("ALTER TABLE catalog ADD COLUMN package_url TEXT")
+                   << QStringLiteral("ALTER TABLE catalog ADD COLUMN package_hash TEXT");
+    }
+    if (version < 3) {
+        statements << QStringLiteral(
+            "CREATE TABLE IF NOT EXISTS settings ("
+            "  key TEXT PRIMARY KEY,"
+            "  value TEXT"
+            ")");
+    }
+    statements << QStringLiteral("PRAGMA user_version = %1").arg(kSchemaVersion);
+
+    if (!m_db.transaction()) return false;
+    for (const QString &sql : statements) {
+        if (!query.exec(sql)) {
+            m_db.rollback();
+            return false;
+        }
+    }
+    return m_db.commit();
+}
+
+QSqlQuery &LocalStoreWorker::statement(const QString &sql)
+{
+    QSqlQuery *query = m_statements.value(sql);
+    if (!query) {
+        query = new QSqlQuery(m_db);
+        query->setForwardOnly(true);
+        if (!query->prepare(sql)) {
+            emit errorOccurred(query->lastError().text());
+        }
+        m_statements.insert(sql, query);
+    }
+    return *query;
+}
+
+bool LocalStoreWorker::exec(QSqlQuery &query)
+{
+    if (!query.exec()) {
+        emit errorOccurred(query.lastError().text());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef LOCALSTOREWORKER_H
+#define LOCALSTOREWORKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <functional>
+#include "localstore.h"
+
+class QTimer;
+
+// 数据库工作对象：只在数据库线程中使用
+class LocalStoreWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LocalStoreWorker(QObject *parent = nullptr);
+    ~LocalStoreWorker() override;
+
+    void open(const QString &databasePath);
+    void close();
+    void setCatalogSnapshot(const QString &snapshotPath, const QString &iconCacheDir);
+
+    // 写操作进入队列，由 flush() 在同一个事务中提交；catalogRevision 非 0 表示修改目录的写操作（修订号见 LocalStore），
+    // durable 的写操作（同步记录）所在的提交在返回前落盘
+    void enqueueWrite(const std::function<bool()> &write, quint64 catalogRevision, bool durable = false);
+    void flush();
+
+    // 写操作实现（在事务中调用）
+    bool writeReplaceCatalog(const QList<AppInfo> &apps);
+    bool writeUpsertCatalog(const QList<AppInfo> &apps);
+    bool writeRemoveCatalog(const QStringList &appIds);
+    bool writeCatalogVersion(const QString &version);
+    bool writeSetInstalled(const QString &appId, const QString &version, const QString &installPath);
+    bool writeRemoveInstalled(const QString &appId);
+    bool writeSyncRecords(const QList<SyncRecord> &records);
+    bool writeCompleteSyncRecords(const QList<qint64> &ids);
+
+    // 读操作
+    void readCatalogCount(quint64 requestId);
+    void readCatalogPage(quint64 requestId, int offset, int limit);
+    void readCatalogVersion(quint64 requestId);
+    void readPendingSyncRecords(quint64 requestId);
+
+signals:
+    void opened(bool ok, const QString &error);
+    void catalogCountReady(quint64 requestId, int count);
+    void catalogPageReady(quint64 requestId, int offset, const QList<AppInfo> &apps);
+    void catalogVersionReady(quint64 requestId, const QString &version);
+    void syncRecordsCommitted(const QList<SyncRecord> &records);
+    void pendingSyncRecordsReady(quint64 requestId, const QList<SyncRecord> &records);
+    void catalogChanged(quint64 revision);
+    void installedChanged(const QHash<QString, bool> &installed);
+    void catalogSnapshotWritten(const QString &snapshotPath, bool ok, quint64 revision);
+    void errorOccurred(const QString &message);
+
+private:
+    bool createSchema();
+    bool commitWrites(const QList<std::function<bool()>> &writes);
+    QList<AppInfo> queryCatalog(int offset, int limit, bool *ok = nullptr);
+    void writeCatalogSnapshot();
+    void patchCatalogSnapshot(const QHash<QString, bool> &installed);
+    QSqlQuery &statement(const QString &sql);
+    bool exec(QSqlQuery &query);
+
+private:
+    QSqlDatabase m_db;
+    QString m_connectionName;
+    QHash<QString, QSqlQuery*> m_statements;       // 预编译语句缓存
+    QList<std::function<bool()>> m_pendingWrites;  // 等待提交的写操作
+    quint64 m_pendingRevision;                     // 待提交的写操作中最大的目录修订号，0 表示没有修改目录
+    quint64 m_committedRevision;                   // 已提交的最大目录修订号
+    bool m_pendingDurable;                         // 待提交的写操作是否需要落盘后才返回
+    QList<SyncRecord> m_uncommittedSyncRecords;    // 本事务写入的同步记录，提交后通知
+    QHash<QString, bool> m_uncommittedInstalled;   // 本事务修改的安装状态，提交后修改快照并通知
+    QTimer *m_flushTimer;                          // 组提交定时器
+    QString m_snapshotPath;                        // 目录快照，为空时不写
+    QString m_iconCacheDir;                        // 快照中缩略图的来源
+};
+
+#endif // LOCALSTOREWORKER_H
@@ -0,0 +1,141 @@
+#include "blocksignature.h"
+#include "core/filewindow.h"
+#include "core/sha256.h"
+#include <QDataStream>
+#include <QFile>
+#include <QIODevice>
+#include <QtMath>
+#include <cstring>
+
+namespace {
+
+const quint32 kMagic = 0x41475347;   // "AGSG"
+const quint32 kVersion = 1;
+const int kMinBlockSize = 2 * 1024;
+const int kMaxBlockSize = 64 * 1024;
+
+} // namespace
+
+int BlockSignature::blockSizeFor(qint64 fileSize)
+{
+    const int size = static_cast<int>(qSqrt(static_cast<double>(fileSize))) & ~1023;
+    return qBound(kMinBlockSize, size, kMaxBlockSize);
+}
+
+quint32 BlockSignature::weakChecksum(const uchar *data, int length)
+{
+    quint32 s1 = 0;
+    quint32 s2 = 0;
+    for (int i = 0; i < length; ++i) {
+        s1 += data[i];
+        s2 += static_cast<quint32>(length - i) * data[i];
+    }
+    return (s1 & 0xffff) | (s2 << 16);
+}
+
+BlockSignature BlockSignature::compute(const uchar *data, qint64 size)
+{
+    Builder builder(size);
+    const int blockSize = builder.blockSize();
+    for (qint64 offset = 0; offset < size; offset += blockSize) {
+        builder.addBlock(data + offset, static_cast<int>(qMin<qint64>(blockSize, size - offset)));
+    }
+    return builder.result();
+}
+
+BlockSignature BlockSignature::computeFile(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return BlockSignature();
+    }
+
+    const qint64 size = file.size();
+    FileWindow window(&file);
+    Builder builder(size);
+    const int blockSize = builder.blockSize();
+    for (qint64 offset = 0; offset < size; offset += blockSize) {
+        const int length = static_cast<int>(qMin<qint64>(blockSize, size - offset));
+        const uchar *data = window.map(offset, length);
+        if (!data) {
+            if (error) *error = file.errorString();
+            return BlockSignature();
+        }
+        builder.addBlock(data, length);
+    }
+    return builder.result();
+}
+
+BlockSignature::Builder::Builder(qint64 fileSize)
+    : m_index(0)
+{
+    m_signature.blockSize = blockSizeFor(fileSize);
+    m_signature.fileSize = fileSize;
+
+    const int count = static_cast<int>((fileSize + m_signature.blockSize - 1) / m_signature.blockSize);
+    m_signature.weak.resize(count);
+    m_signature.strong.resize(count * StrongSize);
+}
+
+void BlockSignature::Builder::addBlock(const uchar *data, int length)
+{
+    m_signature.weak[m_index] = weakChecksum(data, length);
+
+    m_block.reset();
+    m_block.addData(reinterpret_cast<const char *>(data), length);
+    const QByteArray digest = m_block.result();
+    memcpy(m_signature.strong.data() + m_index * StrongSize, digest.constData(), StrongSize);
+    m_file.addData(digest);
+    ++m_index;
+}
+
+BlockSignature BlockSignature::Builder::result()
+{
+    m_signature.fileHash = m_file.result();
+    return m_signature;
+}
+
+QByteArray BlockSignature::serialize() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << kMagic << kVersion << qint32(blockSize) << fileSize;
+    stream.writeRawData(fileHash.constData(), fileHash.size());
+    stream << qint32(weak.size());
+    for (quint32 value : weak) {
+        stream << value;
+    }
+    stream.writeRawData(strong.constData(), strong.size());
+    return data;
+}
+
+BlockSignature BlockSignature::deserialize(const QByteArray &data)
+{
+    QDataStream stream(data);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 blockSize = 0;
+    qint64 fileSize = 0;
+    stream >> magic >> version >> blockSize >> fileSize;
+    if (magic != kMagic || version != kVersion || blockSize <= 0) return BlockSignature();
+
+    BlockSignature signature;
+    signature.blockSize = blockSize;
+    signature.fileSize = fileSize;
+    signature.fileHash.resize(32);
+    stream.readRawData(signature.fileHash.data(), 32);
+
+    qint32 count = 0;
+    stream >> count;
+    if (count < 0 || count != (fileSize + blockSize - 1) / blockSize) return BlockSignature();
+    signature.weak.resize(count);
+    for (qint32 i = 0; i < count; ++i) {
+        stream >> signature.weak[i];
+    }
+    signature.strong.resize(count * StrongSize);
+    stream.readRawData(signature.strong.data(), signature.strong.size());
+
+    if (stream.status() != QDataStream::Ok) return BlockSignature();
+    return signature;
+}
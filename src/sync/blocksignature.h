@@ -0,0 +1,58 @@
+#ifndef BLOCKSIGNATURE_H
+#define BLOCKSIGNATURE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "core/sha256.h"
+
+// 文件的块签名（rsync 方式）：文件按固定大小切块，每块保存一个滚动校验和和一个强校验。
+// 签名描述的是服务器上已有的版本，下次上传时据此只发送变化的部分（见 Delta）。
+struct BlockSignature
+{
+    static const int StrongSize = 16;   // 强校验取 SHA-256 的前 16 字节
+
+    int blockSize = 0;
+    qint64 fileSize = 0;
+    QByteArray fileHash;       // 整个文件的标识：SHA-256(按顺序拼接的每块完整 SHA-256)
+    QVector<quint32> weak;     // 每块的滚动校验和
+    QByteArray strong;         // 每块的强校验，按块顺序连续存放
+
+    bool isValid() const { return blockSize > 0 && !fileHash.isEmpty(); }
+    int blockCount() const { return weak.size(); }
+    const char *strongAt(int block) const { return strong.constData() + block * StrongSize; }
+
+    // 按文件大小选择块大小：约为 sqrt(大小)，限制在 2KB - 64KB，并按 1KB 对齐
+    static int blockSizeFor(qint64 fileSize);
+
+    // 滚动校验和（与 rsync 相同）：低 16 位为字节和，高 16 位为加权和
+    static quint32 weakChecksum(const uchar *data, int length);
+
+    static BlockSignature compute(const uchar *data, qint64 size);
+    // 分窗口读取文件，内存占用与文件大小无关
+    static BlockSignature computeFile(const QString &filePath, QString *error = nullptr);
+
+    // 按顺序逐块加入数据计算签名：每次加入一整块（最后一块可以不足），用于边读边处理的大文件
+    class Builder;
+
+    QByteArray serialize() const;
+    static BlockSignature deserialize(const QByteArray &data);
+};
+
+class BlockSignature::Builder
+{
+public:
+    explicit Builder(qint64 fileSize);
+
+    int blockSize() const { return m_signature.blockSize; }
+    void addBlock(const uchar *data, int length);
+    BlockSignature result();
+
+private:
+    BlockSignature m_signature;
+    Sha256 m_block;
+    Sha256 m_file;
+    int m_index;
+};
+
+#endif // BLOCKSIGNATURE_H
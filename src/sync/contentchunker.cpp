@@ -0,0 +1,166 @@
+#include "contentchunker.h"
+#include "core/filewindow.h"
+#include "core/sha256.h"
+#include <QDataStream>
+#include <QFile>
+#include <QIODevice>
+
+namespace {
+
+const quint32 kManifestMagic = 0x4147434d;   // "AGCM"
+const quint32 kManifestVersion = 1;
+
+// 归一化分块：平均大小之前用更严格的掩码（18 位），之后用更宽松的掩码（14 位），
+// 块大小集中在平均值附近。掩码取高位，高位包含最近 64 个字节的信息
+const quint64 kMaskStrict = 0xFFFFC00000000000ULL;
+const quint64 kMaskLoose = 0xFFFC000000000000ULL;
+
+// gear 表：固定种子的 splitmix64 序列，所有客户端必须一致
+struct GearTable
+{
+    quint64 values[256];
+
+    GearTable()
+    {
+        quint64 state = 0x6170704743444321ULL;
+        for (quint64 &value : values) {
+            state += 0x9E3779B97F4A7C15ULL;
+            quint64 z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            value = z ^ (z >> 31);
+        }
+    }
+};
+
+const GearTable kGear;
+
+} // namespace
+
+int ContentChunker::nextCut(const uchar *data, qint64 length)
+{
+    if (length <= MinSize) return static_cast<int>(length);
+
+    const int end = static_cast<int>(qMin<qint64>(length, MaxSize));
+    const int normal = qMin(end, AverageSize);
+    const quint64 *gear = kGear.values;
+    quint64 hash = 0;
+
+    // 最小块之前不可能切分，直接跳过；每次处理两个字节减少循环开销
+    int i = MinSize;
+    for (; i + 1 < normal; i += 2) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & kMaskStrict)) return i + 1;
+        hash = (hash << 1) + gear[data[i + 1]];
+        if (!(hash & kMaskStrict)) return i + 2;
+    }
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & kMaskStrict)) return i + 1;
+    }
+    for (; i + 1 < end; i += 2) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & kMaskLoose)) return i + 1;
+        hash = (hash << 1) + gear[data[i + 1]];
+        if (!(hash & kMaskLoose)) return i + 2;
+    }
+    for (; i < end; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & kMaskLoose)) return i + 1;
+    }
+    return end;
+}
+
+QVector<ContentChunker::Chunk> ContentChunker::chunk(const uchar *data, qint64 length, bool withHash)
+{
+    QVector<Chunk> chunks;
+    chunks.reserve(static_cast<int>(length / AverageSize) + 1);
+
+    qint64 offset = 0;
+    while (offset < length) {
+        Chunk chunk;
+        chunk.offset = offset;
+        chunk.length = nextCut(data + offset, length - offset);
+        if (withHash) {
+            chunk.hash = Sha256::hash(QByteArray::fromRawData(reinterpret_cast<const char *>(data + offset),
+                                                              chunk.length));
+        }
+        chunks.append(chunk);
+        offset += chunk.length;
+    }
+    return chunks;
+}
+
+QVector<ContentChunker::Chunk> ContentChunker::chunkFile(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = file.errorString();
+        return QVector<Chunk>();
+    }
+
+    // 切分点只取决于之后最多 MaxSize 个字节，分窗口映射与整体映射切出的块相同
+    const qint64 size = file.size();
+    FileWindow window(&file);
+    QVector<Chunk> chunks;
+    chunks.reserve(static_cast<int>(size / AverageSize) + 1);
+    for (qint64 offset = 0; offset < size;) {
+        const qint64 length = qMin<qint64>(MaxSize, size - offset);
+        const uchar *data = window.map(offset, length);
+        if (!data) {
+            if (error) *error = file.errorString();
+            return QVector<Chunk>();
+        }
+        Chunk chunk;
+        chunk.offset = offset;
+        chunk.length = nextCut(data, length);
+        chunk.hash = Sha256::hash(QByteArray::fromRawData(reinterpret_cast<const char *>(data), chunk.length));
+        chunks.append(chunk);
+        offset += chunk.length;
+    }
+    return chunks;
+}
+
+QByteArray ContentChunker::manifest(qint64 fileSize, const QVector<Chunk> &chunks)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << kManifestMagic << kManifestVersion << fileSize << qint32(chunks.size());
+    for (const Chunk &chunk : chunks) {
+        stream.writeRawData(chunk.hash.constData(), chunk.hash.size());
+        stream << quint32(chunk.length);
+    }
+    return data;
+}
+
+bool ContentChunker::parseManifest(const QByteArray &data, qint64 *fileSize, QVector<Chunk> *chunks)
+{
+    QDataStream stream(data);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint64 size = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> size >> count;
+    if (magic != kManifestMagic || version != kManifestVersion || count < 0) return false;
+
+    QVector<Chunk> result;
+    result.reserve(count);
+    qint64 offset = 0;
+    for (qint32 i = 0; i < count; ++i) {
+        Chunk chunk;
+        chunk.hash.resize(32);
+        quint32 length = 0;
+        stream.readRawData(chunk.hash.data(), 32);
+        stream >> length;
+        if (length == 0 || length > quint32(MaxSize)) return false;
+        chunk.offset = offset;
+        chunk.length = static_cast<int>(length);
+        offset += length;
+        result.append(chunk);
+    }
+    if (stream.status() != QDataStream::Ok || offset != size) return false;
+
+    *fileSize = size;
+    *chunks = result;
+    return true;
+}
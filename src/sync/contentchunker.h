@@ -0,0 +1,37 @@
+#ifndef CONTENTCHUNKER_H
+#define CONTENTCHUNKER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// 内容定义分块（FastCDC）：用 gear 滚动哈希在内容中寻找切分点，
+// 插入或删除数据只影响附近的块，相同的内容在不同文件中切出相同的块，便于去重。
+// 块大小 16KB - 256KB，平均约 64KB；切分规则（gear 表、掩码）一旦发布不能修改，否则无法与已有的块去重。
+namespace ContentChunker {
+
+const int MinSize = 16 * 1024;
+const int AverageSize = 64 * 1024;
+const int MaxSize = 256 * 1024;
+
+struct Chunk
+{
+    qint64 offset = 0;
+    int length = 0;
+    QByteArray hash;   // SHA-256（32 字节），块的内容地址
+};
+
+// 返回从 data 开始的第一个块的长度
+int nextCut(const uchar *data, qint64 length);
+
+// 切分整段数据；withHash 为 false 时只计算切分点（用于测量分块吞吐量）
+QVector<Chunk> chunk(const uchar *data, qint64 length, bool withHash = true);
+QVector<Chunk> chunkFile(const QString &filePath, QString *error = nullptr);
+
+// 文件的块清单：上传时告诉服务器按哪些块拼出文件
+QByteArray manifest(qint64 fileSize, const QVector<Chunk> &chunks);
+bool parseManifest(const QByteArray &data, qint64 *fileSize, QVector<Chunk> *chunks);
+
+} // namespace ContentChunker
+
+#endif // CONTENTCHUNKER_H
@@ -0,0 +1,428 @@
+#include "delta.h"
+#include "core/filewindow.h"
+#include "core/sha256.h"
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+const quint32 kMagic = 0x41474450;     // "AGDP"
+const quint32 kVersion = 1;
+const qint64 kMaxLiteral = 1024 * 1024; // 单条字面数据指令的最大长度
+const int kFilterBits = 20;             // 弱校验预筛选位图大小（2^20 位）
+
+enum Op : quint8 {
+    OpEnd = 0,
+    OpCopy = 1,
+    OpLiteral = 2
+};
+
+// 逐字节滚动时绝大多数位置都不会命中，先查位图再查哈希表
+inline quint32 filterSlot(quint32 weak)
+{
+    return (weak * 0x9E3779B1u) >> (32 - kFilterBits);
+}
+
+// 补丁指令写入：相邻的复制指令合并为一条，字面数据按上限切分
+class PatchWriter
+{
+public:
+    explicit PatchWriter(QIODevice *out) : m_stream(out), m_copyStart(0), m_copyCount(0) {}
+
+    QDataStream &stream() { return m_stream; }
+
+    void copy(int block)
+    {
+        if (m_copyCount > 0 && m_copyStart + m_copyCount == block) {
+            ++m_copyCount;
+            return;
+        }
+        flushCopy();
+        m_copyStart = block;
+        m_copyCount = 1;
+    }
+
+    void literal(const uchar *data, qint64 length)
+    {
+        if (length <= 0) return;
+        flushCopy();
+        while (length > 0) {
+            const int chunk = static_cast<int>(qMin(length, kMaxLiteral));
+            m_stream << quint8(OpLiteral) << quint32(chunk);
+            m_stream.writeRawData(reinterpret_cast<const char *>(data), chunk);
+            data += chunk;
+            length -= chunk;
+        }
+    }
+
+    void finish()
+    {
+        flushCopy();
+        m_stream << quint8(OpEnd);
+    }
+
+private:
+    void flushCopy()
+    {
+        if (m_copyCount == 0) return;
+        m_stream << quint8(OpCopy) << quint32(m_copyStart) << quint32(m_copyCount);
+        m_copyCount = 0;
+    }
+
+private:
+    QDataStream m_stream;
+    int m_copyStart;
+    int m_copyCount;
+};
+
+// 按写入顺序计算 BlockSignature::fileHash，重建文件时不需要再读一遍
+class SignatureHasher
+{
+public:
+    explicit SignatureHasher(int blockSize) : m_blockSize(blockSize), m_filled(0) {}
+
+    void addData(const char *data, qint64 length)
+    {
+        while (length > 0) {
+            const int chunk = static_cast<int>(qMin<qint64>(length, m_blockSize - m_filled));
+            m_block.addData(data, chunk);
+            m_filled += chunk;
+            data += chunk;
+            length -= chunk;
+            if (m_filled == m_blockSize) {
+                m_file.addData(m_block.result());
+                m_block.reset();
+                m_filled = 0;
+            }
+        }
+    }
+
+    QByteArray result()
+    {
+        if (m_filled > 0) {
+            m_file.addData(m_block.result());
+            m_filled = 0;
+        }
+        return m_file.result();
+    }
+
+private:
+    Sha256 m_block;
+    Sha256 m_file;
+    int m_blockSize;
+    int m_filled;
+};
+
+bool fail(QString *error, const QString &message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+} // namespace
+
+bool Delta::encode(const BlockSignature &base, const QString &filePath, QIODevice *out,
+                   BlockSignature *newSignature, Stats *stats, QString *error)
+{
+    if (!base.isValid()) return fail(error, QStringLiteral("无效的基准签名"));
+    if (out->isSequential()) return fail(error, QStringLiteral("补丁输出必须可定位"));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return fail(error, file.errorString());
+    const qint64 size = file.size();
+
+    // 新文件分窗口映射，滚动匹配的同时计算新文件的块签名
+    FileWindow window(&file);
+    BlockSignature::Builder target(size);
+    const int targetBlockSize = target.blockSize();
+    qint64 signedUpTo = 0;
+
+    // 计算 limit 之前完整的签名块（到文件末尾时包括最后不足一块的部分）
+    auto sign = [&](qint64 limit) {
+        while (signedUpTo < size) {
+            const int length = static_cast<int>(qMin<qint64>(targetBlockSize, size - signedUpTo));
+            if (signedUpTo + length > limit) break;
+            const uchar *block = window.map(signedUpTo, length);
+            if (!block) return false;
+            target.addBlock(block, length);
+            signedUpTo += length;
+        }
+        return true;
+    };
+
+    const qint64 startPos = out->pos();
+    PatchWriter writer(out);
+    QDataStream &stream = writer.stream();
+    stream << kMagic << kVersion << qint32(base.blockSize) << base.fileSize;
+    stream.writeRawData(base.fileHash.constData(), base.fileHash.size());
+    stream << size;
+    const qint64 resultHashPos = out->pos();
+    stream.writeRawData(QByteArray(32, '\0').constData(), 32);
+
+    // 按窗口输出 [from, to) 的字面数据
+    auto literal = [&](qint64 from, qint64 to) {
+        while (from < to) {
+            const qint64 length = qMin(to - from, window.windowSize());
+            const uchar *data = window.map(from, length);
+            if (!data) return false;
+            writer.literal(data, length);
+            from += length;
+        }
+        return true;
+    };
+
+    // 基准块索引：只收录完整大小的块，同一弱校验的块按序号串成链
+    const int blockSize = base.blockSize;
+    const int fullBlocks = static_cast<int>(base.fileSize / blockSize);
+    QVector<int> chain(fullBlocks, -1);
+    QHash<quint32, int> head;
+    head.reserve(fullBlocks);
+    QVector<quint64> filter((1 << kFilterBits) / 64, 0);
+    for (int i = fullBlocks - 1; i >= 0; --i) {
+        const quint32 weak = base.weak.at(i);
+        chain[i] = head.value(weak, -1);
+        head.insert(weak, i);
+        const quint32 slot = filterSlot(weak);
+        filter[slot >> 6] |= quint64(1) << (slot & 63);
+    }
+
+    qint64 copiedBytes = 0;
+    qint64 pos = 0;
+    qint64 literalStart = 0;
+    int expected = -1;   // 上一次匹配的下一块，文件未改动的部分通常连续命中
+    Sha256 hasher;
+    bool ok = true;
+
+    if (fullBlocks > 0 && size >= blockSize) {
+        // 当前窗口 [windowStart, windowEnd)，data 对应 windowStart，始终覆盖 [literalStart, pos + blockSize)
+        const uchar *data = nullptr;
+        qint64 windowStart = 0;
+        qint64 windowEnd = 0;
+        // 窗口快用完时先处理窗口内的签名块和字面数据，再从 pos 重新映射
+        auto slide = [&]() {
+            if (!sign(windowEnd) || !literal(literalStart, pos)) return false;
+            literalStart = pos;
+            windowStart = qMin(pos, signedUpTo);
+            data = window.map(windowStart, qMin(window.windowSize(), size - windowStart));
+            windowEnd = window.end();
+            return data != nullptr;
+        };
+
+        quint32 s1 = 0;
+        quint32 s2 = 0;
+        auto reset = [&]() {
+            const uchar *block = data + (pos - windowStart);
+            s1 = 0;
+            s2 = 0;
+            for (int i = 0; i < blockSize; ++i) {
+                s1 += block[i];
+                s2 += static_cast<quint32>(blockSize - i) * block[i];
+            }
+        };
+        ok = slide();
+        if (ok) {
+            reset();
+        }
+
+        while (ok) {
+            const quint32 weak = (s1 & 0xffff) | (s2 << 16);
+            const quint32 slot = filterSlot(weak);
+            int match = -1;
+            if (filter.at(slot >> 6) & (quint64(1) << (slot & 63))) {
+                const auto it = head.constFind(weak);
+                if (it != head.constEnd()) {
+                    hasher.reset();
+                    hasher.addData(reinterpret_cast<const char *>(data + (pos - windowStart)), blockSize);
+                    const QByteArray digest = hasher.result();
+                    if (expected >= 0 && expected < fullBlocks && base.weak.at(expected) == weak
+                        && memcmp(base.strongAt(expected), digest.constData(), BlockSignature::StrongSize) == 0) {
+                        match = expected;
+                    } else {
+                        for (int candidate = it.value(); candidate >= 0; candidate = chain.at(candidate)) {
+                            if (memcmp(base.strongAt(candidate), digest.constData(), BlockSignature::StrongSize) == 0) {
+                                match = candidate;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (match >= 0) {
+                ok = literal(literalStart, pos);
+                writer.copy(match);
+                copiedBytes += blockSize;
+                pos += blockSize;
+                literalStart = pos;
+                expected = match + 1;
+                if (pos + blockSize > size) break;
+                if (ok && pos + blockSize >= windowEnd && windowEnd < size) {
+                    ok = slide();
+                }
+                if (ok) {
+                    reset();
+                }
+                continue;
+            }
+
+            if (pos + blockSize >= size) break;
+            if (pos + blockSize >= windowEnd && !slide()) {
+                ok = false;
+                break;
+            }
+            const uchar outByte = data[pos - windowStart];
+            const uchar inByte = data[pos + blockSize - windowStart];
+            s1 += inByte;
+            s1 -= outByte;
+            s2 += s1;
+            s2 -= static_cast<quint32>(blockSize) * outByte;
+            ++pos;
+        }
+    }
+
+    // 基准末尾不足一块的部分只在新文件末尾原样保留时才能复制
+    const qint64 baseTail = base.fileSize - qint64(fullBlocks) * blockSize;
+    qint64 tailEnd = size;
+    if (ok && baseTail > 0 && size - literalStart >= baseTail) {
+        const qint64 tailStart = size - baseTail;
+        const uchar *tail = window.map(tailStart, baseTail);
+        ok = tail != nullptr;
+        if (ok) {
+            hasher.reset();
+            hasher.addData(reinterpret_cast<const char *>(tail), baseTail);
+            const QByteArray digest = hasher.result();
+            if (base.weak.at(fullBlocks) == BlockSignature::weakChecksum(tail, static_cast<int>(baseTail))
+                && memcmp(base.strongAt(fullBlocks), digest.constData(), BlockSignature::StrongSize) == 0) {
+                tailEnd = tailStart;
+            }
+        }
+    }
+    ok = ok && literal(literalStart, tailEnd) && sign(size);
+    if (!ok) return fail(error, file.errorString());
+    if (tailEnd < size) {
+        writer.copy(fullBlocks);
+        copiedBytes += baseTail;
+    }
+    writer.finish();
+
+    const BlockSignature signature = target.result();
+    const qint64 endPos = out->pos();
+    if (stream.status() != QDataStream::Ok || !out->seek(resultHashPos)
+        || out->write(signature.fileHash) != signature.fileHash.size() || !out->seek(endPos)) {
+        return fail(error, out->errorString());
+    }
+
+    if (newSignature) {
+        *newSignature = signature;
+    }
+    if (stats) {
+        stats->sourceBytes = size;
+        stats->copiedBytes = copiedBytes;
+        stats->literalBytes = size - copiedBytes;
+        stats->patchBytes = endPos - startPos;
+        stats->nsecs = timer.nsecsElapsed();
+    }
+    return true;
+}
+
+bool Delta::apply(const QString &basePath, QIODevice *patch, const QString &outPath, QString *error)
+{
+    QDataStream stream(patch);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 blockSize = 0;
+    qint64 baseSize = 0;
+    qint64 resultSize = 0;
+    QByteArray baseHash(32, Qt::Uninitialized);
+    QByteArray resultHash(32, Qt::Uninitialized);
+    stream >> magic >> version >> blockSize >> baseSize;
+    stream.readRawData(baseHash.data(), baseHash.size());
+    stream >> resultSize;
+    stream.readRawData(resultHash.data(), resultHash.size());
+    if (stream.status() != QDataStream::Ok || magic != kMagic || version != kVersion || blockSize <= 0) {
+        return fail(error, QStringLiteral("补丁格式错误"));
+    }
+
+    QFile base(basePath);
+    if (baseSize > 0 && (!base.open(QIODevice::ReadOnly) || base.size() != baseSize)) {
+        return fail(error, QStringLiteral("基准版本不一致"));
+    }
+    FileWindow baseWindow(&base);
+    const qint64 baseBlocks = (baseSize + blockSize - 1) / blockSize;
+
+    QSaveFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly)) return fail(error, out.errorString());
+
+    SignatureHasher hasher(BlockSignature::blockSizeFor(resultSize));
+    QByteArray literal;
+    qint64 written = 0;
+    bool ok = true;
+    for (;;) {
+        quint8 op = OpEnd;
+        stream >> op;
+        if (stream.status() != QDataStream::Ok) {
+            ok = false;
+            break;
+        }
+        if (op == OpEnd) break;
+
+        if (op == OpCopy) {
+            quint32 start = 0;
+            quint32 count = 0;
+            stream >> start >> count;
+            if (count == 0 || qint64(start) + count > baseBlocks) {
+                ok = false;
+                break;
+            }
+            qint64 offset = qint64(start) * blockSize;
+            qint64 length = qMin(qint64(count) * blockSize, baseSize - offset);
+            while (ok && length > 0) {
+                const qint64 piece = qMin(length, baseWindow.windowSize());
+                const char *source = reinterpret_cast<const char *>(baseWindow.map(offset, piece));
+                ok = source != nullptr;
+                if (ok) {
+                    hasher.addData(source, piece);
+                    ok = out.write(source, piece) == piece;
+                }
+                offset += piece;
+                length -= piece;
+                written += piece;
+            }
+        } else if (op == OpLiteral) {
+            quint32 length = 0;
+            stream >> length;
+            if (length > kMaxLiteral) {
+                ok = false;
+                break;
+            }
+            literal.resize(length);
+            ok = stream.readRawData(literal.data(), length) == static_cast<int>(length);
+            if (ok) {
+                hasher.addData(literal.constData(), length);
+                ok = out.write(literal) == length;
+                written += length;
+            }
+        } else {
+            ok = false;
+        }
+        if (!ok) break;
+    }
+
+    if (!ok || written != resultSize) {
+        out.cancelWriting();
+        return fail(error, QStringLiteral("补丁格式错误"));
+    }
+    if (hasher.result() != resultHash) {
+        out.cancelWriting();
+        return fail(error, QStringLiteral("基准版本不一致"));
+    }
+    if (!out.commit()) return fail(error, out.errorString());
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include <QString>
+#include "blocksignature.h"
+
+class QIODevice;
+
+// 块级增量补丁：根据服务器版本的块签名，用滚动校验和在新文件中逐字节查找未变化的块，
+// 补丁中只包含"复制第 n 块"指令和新写入的字节。
+//
+// 补丁格式（QDataStream，大端）：
+//   magic "AGDP"、版本、块大小、基准大小、基准 fileHash(32)、结果大小、结果 fileHash(32)，
+//   之后是指令序列：1 = 复制 (起始块, 块数)，2 = 字面数据 (长度, 字节)，0 = 结束
+namespace Delta {
+
+struct Stats
+{
+    qint64 sourceBytes = 0;   // 新文件大小
+    qint64 copiedBytes = 0;   // 从基准版本复制的字节数
+    qint64 literalBytes = 0;  // 补丁中携带的字节数
+    qint64 patchBytes = 0;    // 补丁总大小（实际上传的字节数）
+    qint64 nsecs = 0;         // 计算补丁耗时
+};
+
+// 生成补丁写入 out，同时计算新文件的签名（上传成功后作为下一次的基准）。
+// 新文件分窗口读取，只读一遍；结果 fileHash 在最后写回补丁头部，out 必须可定位
+bool encode(const BlockSignature &base, const QString &filePath, QIODevice *out,
+            BlockSignature *newSignature, Stats *stats = nullptr, QString *error = nullptr);
+
+// 用补丁和基准文件重建新文件，写入 outPath；基准不一致（结果哈希不符）时失败且不修改 outPath
+bool apply(const QString &basePath, QIODevice *patch, const QString &outPath, QString *error = nullptr);
+
+} // namespace Delta
+
+#endif // DELTA_H
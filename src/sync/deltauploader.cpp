@@ -0,0 +1,470 @@
+#include "deltauploader.h"
+#include "core/filewindow.h"
+#include "core/sha256.h"
+#include "core/taskscheduler.h"
+#include "core/trace.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QSaveFile>
+
+namespace {
+
+const int kHashSize = 32;
+const int kMaxChunkRequests = 6;   // 同时发送的块请求数（与每个主机的连接数相同）
+const int kCompressionLevel = 1;   // 压缩在发送前进行，选择最快的级别
+
+// 服务器不接受这种上传方式（不支持、基准不一致等），可以换一种方式重试
+bool isRejected(int status)
+{
+    return status >= 400 && status < 500;
+}
+
+// 只读一遍文件：计算块签名，按内容分块并记下每块的偏移、长度和哈希（块的内容留在源文件中）。
+// 文件分窗口映射，签名随分块进度计算已经读过的部分
+bool prepareChunks(const QString &filePath, BlockSignature *signature,
+                   QVector<ContentChunker::Chunk> *chunks, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    const qint64 size = file.size();
+    FileWindow window(&file);
+    BlockSignature::Builder builder(size);
+    const int blockSize = builder.blockSize();
+    qint64 signedUpTo = 0;
+    chunks->clear();
+
+    for (qint64 offset = 0; offset < size;) {
+        const qint64 length = qMin<qint64>(ContentChunker::MaxSize, size - offset);
+        const uchar *data = window.map(offset, length);
+        if (!data) {
+            *error = file.errorString();
+            return false;
+        }
+
+        ContentChunker::Chunk chunk;
+        chunk.offset = offset;
+        chunk.length = ContentChunker::nextCut(data, length);
+        chunk.hash = Sha256::hash(QByteArray::fromRawData(reinterpret_cast<const char *>(data), chunk.length));
+        chunks->append(chunk);
+        offset += chunk.length;
+
+        while (signedUpTo < size) {
+            const int blockLength = static_cast<int>(qMin<qint64>(blockSize, size - signedUpTo));
+            if (signedUpTo + blockLength > offset) break;
+            const uchar *block = window.map(signedUpTo, blockLength);
+            if (!block) {
+                *error = file.errorString();
+                return false;
+            }
+            builder.addBlock(block, blockLength);
+            signedUpTo += blockLength;
+        }
+    }
+
+    *signature = builder.result();
+    return true;
+}
+
+// 映射源文件中的一个块并确认内容与分块时一致（文件在分块之后被修改时返回空）。
+// data 直接指向映射的内存，映射随返回的 QFile 一起释放
+QFile *mapChunk(const QString &filePath, const ContentChunker::Chunk &chunk, QByteArray *data)
+{
+    QFile *file = new QFile(filePath);
+    const uchar *mapped = file->open(QIODevice::ReadOnly) ? file->map(chunk.offset, chunk.length) : nullptr;
+    if (mapped) {
+        *data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), chunk.length);
+        if (Sha256::hash(*data) == chunk.hash) return file;
+    }
+    data->clear();
+    delete file;
+    return nullptr;
+}
+
+} // namespace
+
+DeltaUploader::DeltaUploader(const QString &signatureDir, QObject *parent)
+    : QObject(parent)
+    , m_network(new QNetworkAccessManager(this))
+    , m_signatureDir(signatureDir)
+    , m_compressChunks(false)
+    , m_nextId(0)
+{
+    QDir().mkpath(m_signatureDir);
+}
+
+DeltaUploader::~DeltaUploader()
+{
+    for (const Job &job : std::as_const(m_jobs)) {
+        for (QNetworkReply *reply : job.replies) {
+            reply->disconnect(this);
+            reply->abort();
+        }
+    }
+}
+
+void DeltaUploader::enableChunkUpload(const QUrl &endpoint)
+{
+    m_chunkEndpoint = endpoint;
+}
+
+quint64 DeltaUploader::upload(const QString &filePath, const QUrl &url)
+{
+    const quint64 id = ++m_nextId;
+    const QString key = QString::fromLatin1(Sha256::hash(url.toEncoded()).toHex());
+
+    Job job;
+    job.filePath = filePath;
+    job.url = url;
+    job.signaturePath = m_signatureDir + QLatin1Char('/') + key + QStringLiteral(".sig");
+    job.patchPath = m_signatureDir + QLatin1Char('/') + key + QLatin1Char('-') + QString::number(id)
+                    + QStringLiteral(".patch");
+    m_jobs.insert(id, job);
+
+    prepare(id);
+    return id;
+}
+
+void DeltaUploader::prepare(quint64 id)
+{
+    const Job &job = m_jobs[id];
+
+    // 读签名、计算补丁、分块都要完整读取文件，放到线程池中执行
+    QPointer<DeltaUploader> guard(this);
+    const QString filePath = job.filePath;
+    const QString signaturePath = job.signaturePath;
+    const QString patchPath = job.patchPath;
+    const bool chunked = !m_chunkEndpoint.isEmpty();
+    TaskScheduler::instance()->start(TaskScheduler::Background, [guard, id, filePath, signaturePath, patchPath, chunked]() {
+        BlockSignature base;
+        QFile signatureFile(signaturePath);
+        if (signatureFile.open(QIODevice::ReadOnly)) {
+            base = BlockSignature::deserialize(signatureFile.readAll());
+        }
+
+        Mode mode = FullUpload;
+        BlockSignature signature;
+        Delta::Stats stats;
+        QVector<ContentChunker::Chunk> chunks;
+        QString error;
+        if (base.isValid()) {
+            QFile patch(patchPath);
+            // 改动过多时补丁可能比文件本身还大
+            if (patch.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                && Delta::encode(base, filePath, &patch, &signature, &stats, &error)
+                && stats.patchBytes < stats.sourceBytes) {
+                mode = PatchUpload;
+            }
+        }
+        if (mode != PatchUpload) {
+            QFile::remove(patchPath);
+            error.clear();
+            if (chunked && prepareChunks(filePath, &signature, &chunks, &error)) {
+                mode = ChunkUpload;
+            } else {
+                chunks.clear();
+                signature = BlockSignature::computeFile(filePath, &error);
+            }
+        }
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(),
+                                  [guard, id, mode, signature, chunks, error]() {
+            if (guard) {
+                guard->handlePrepared(id, mode, signature, chunks, error);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void DeltaUploader::handlePrepared(quint64 id, Mode mode, const BlockSignature &signature,
+                                   const QVector<ContentChunker::Chunk> &chunks, const QString &error)
+{
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+
+    if (!signature.isValid()) {
+        finishJob(id, error.isEmpty() ? tr("无法读取文件") : error);
+        return;
+    }
+
+    it->mode = mode;
+    it->signature = signature;
+    it->chunks = chunks;
+    send(id);
+}
+
+void DeltaUploader::send(quint64 id)
+{
+    Job &job = m_jobs[id];
+    if (job.mode == ChunkUpload) {
+        sendMissingQuery(id);
+        return;
+    }
+
+    const bool patch = job.mode == PatchUpload;
+    QFile *body = new QFile(patch ? job.patchPath : job.filePath);
+    if (!body->open(QIODevice::ReadOnly)) {
+        const QString error = body->errorString();
+        delete body;
+        finishJob(id, error);
+        return;
+    }
+    job.wireBytes += body->size();
+
+    QNetworkRequest request(job.url);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/octet-stream"));
+    request.setHeader(QNetworkRequest::ContentLengthHeader, body->size());
+
+    QNetworkReply *reply = patch ? m_network->sendCustomRequest(request, QByteArrayLiteral("PATCH"), body)
+                                 : m_network->put(request, body);
+    body->setParent(reply);
+    track(id, reply);
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]() { handleReplyFinished(id, reply); });
+}
+
+void DeltaUploader::sendMissingQuery(quint64 id)
+{
+    Job &job = m_jobs[id];
+
+    // 文件内部的重复块只询问一次，服务器缺少的块按哈希找回在文件中的位置
+    QByteArray hashes;
+    job.chunkIndex.clear();
+    for (int i = 0; i < job.chunks.size(); ++i) {
+        const QByteArray &hash = job.chunks.at(i).hash;
+        if (!job.chunkIndex.contains(hash)) {
+            job.chunkIndex.insert(hash, i);
+            hashes += hash;
+        }
+    }
+    job.wireBytes += hashes.size();
+
+    QNetworkRequest request(QUrl(m_chunkEndpoint.toString() + QStringLiteral("/missing")));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/octet-stream"));
+
+    QNetworkReply *reply = track(id, m_network->post(request, hashes));
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]() { handleMissingReply(id, reply); });
+}
+
+void DeltaUploader::handleMissingReply(quint64 id, QNetworkReply *reply)
+{
+    TRACE_SPAN("network", "DeltaUploader::handleMissingReply");
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    it->replies.removeOne(reply);
+    reply->deleteLater();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const QByteArray missing = reply->readAll();
+    if (reply->error() != QNetworkReply::NoError || status < 200 || status >= 300
+        || missing.size() % kHashSize != 0) {
+        if (isRejected(status)) {
+            fallBack(id, status);
+        } else {
+            finishJob(id, reply->errorString());
+        }
+        return;
+    }
+
+    // 只上传服务器缺少的块，同时进行的请求数有上限，大文件的几万个块不会一次全部排队
+    it->pendingChunks = missing.size() / kHashSize;
+    for (int i = 0; i < missing.size(); i += kHashSize) {
+        const int index = it->chunkIndex.value(missing.mid(i, kHashSize), -1);
+        if (index < 0) {
+            finishJob(id, tr("服务器要求上传不属于这个文件的块"));
+            return;
+        }
+        it->chunkQueue.append(index);
+    }
+
+    if (it->pendingChunks == 0) {
+        handleChunkReply(id, nullptr);
+    } else {
+        sendNextChunks(id);
+    }
+}
+
+void DeltaUploader::sendNextChunks(quint64 id)
+{
+    Job &job = m_jobs[id];
+    while (job.activeChunks < kMaxChunkRequests && !job.chunkQueue.isEmpty()) {
+        const ContentChunker::Chunk chunk = job.chunks.at(job.chunkQueue.takeFirst());
+        ++job.activeChunks;
+
+        // 块直接映射源文件，核对哈希和压缩在线程池中进行，发送时请求体指向映射的内存，不复制块的内容；
+        // qCompress 的结果去掉 4 字节长度前缀即为 zlib 格式（HTTP 的 deflate）
+        QPointer<DeltaUploader> guard(this);
+        const QString filePath = job.filePath;
+        const bool compress = m_compressChunks;
+        TaskScheduler::instance()->start(TaskScheduler::Background, [guard, id, filePath, chunk, compress]() {
+            QByteArray data;
+            QFile *mapping = mapChunk(filePath, chunk, &data);
+            const bool ok = mapping;
+            QByteArray compressed;
+            if (ok && compress) {
+                compressed = qCompress(data, kCompressionLevel).mid(4);
+                if (compressed.size() >= data.size()) {
+                    compressed.clear();
+                } else {
+                    // 发送压缩后的内容，不再需要映射
+                    data.clear();
+                    delete mapping;
+                    mapping = nullptr;
+                }
+            }
+            if (mapping) {
+                // 映射交给主线程的请求持有
+                mapping->moveToThread(QCoreApplication::instance()->thread());
+            }
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [=]() {
+                if (!guard || !guard->m_jobs.contains(id)) {
+                    delete mapping;
+                    return;
+                }
+                if (!ok) {
+                    guard->finishJob(id, tr("文件在上传过程中被修改或无法读取：%1").arg(filePath));
+                    return;
+                }
+                const bool useCompressed = !compressed.isEmpty();
+                guard->sendChunk(id, chunk.hash, useCompressed ? compressed : data, useCompressed, mapping);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void DeltaUploader::sendChunk(quint64 id, const QByteArray &hash, const QByteArray &data, bool compressed,
+                              QFile *mapping)
+{
+    Job &job = m_jobs[id];
+    job.wireBytes += data.size();
+
+    QNetworkRequest request(QUrl(m_chunkEndpoint.toString() + QLatin1Char('/') + QString::fromLatin1(hash.toHex())));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/octet-stream"));
+    request.setHeader(QNetworkRequest::ContentLengthHeader, data.size());
+    if (compressed) {
+        request.setRawHeader("Content-Encoding", "deflate");
+    }
+
+    QNetworkReply *reply = track(id, m_network->put(request, data));
+    // 请求体引用映射的内存，映射在请求结束（回复被删除）时才释放
+    if (mapping) {
+        mapping->setParent(reply);
+    }
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]() { handleChunkReply(id, reply); });
+}
+
+void DeltaUploader::handleChunkReply(quint64 id, QNetworkReply *reply)
+{
+    TRACE_SPAN("network", "DeltaUploader::handleChunkReply");
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+
+    if (reply) {
+        it->replies.removeOne(reply);
+        reply->deleteLater();
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (reply->error() != QNetworkReply::NoError || status < 200 || status >= 300) {
+            finishJob(id, reply->errorString());
+            return;
+        }
+        --it->activeChunks;
+        if (--it->pendingChunks > 0) {
+            sendNextChunks(id);
+            return;
+        }
+    }
+
+    // 所有块都已在服务器上，发送块清单让服务器拼出文件
+    const QByteArray manifest = ContentChunker::manifest(it->signature.fileSize, it->chunks);
+    it->wireBytes += manifest.size();
+
+    QNetworkRequest request(it->url);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/x-appgo-chunks"));
+
+    QNetworkReply *manifestReply = track(id, m_network->post(request, manifest));
+    connect(manifestReply, &QNetworkReply::finished, this, [this, id, manifestReply]() {
+        handleReplyFinished(id, manifestReply);
+    });
+}
+
+void DeltaUploader::handleReplyFinished(quint64 id, QNetworkReply *reply)
+{
+    TRACE_SPAN("network", "DeltaUploader::handleReplyFinished");
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end()) return;
+    it->replies.removeOne(reply);
+    reply->deleteLater();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError || status < 200 || status >= 300) {
+        if (isRejected(status)) {
+            fallBack(id, status);
+        } else {
+            finishJob(id, reply->errorString());
+        }
+        return;
+    }
+
+    QSaveFile signatureFile(it->signaturePath);
+    if (signatureFile.open(QIODevice::WriteOnly)) {
+        signatureFile.write(it->signature.serialize());
+        signatureFile.commit();
+    }
+
+    const qint64 fileSize = it->signature.fileSize;
+    const qint64 wireBytes = it->wireBytes;
+    const QString filePath = it->filePath;
+    finishJob(id, QString());
+    emit uploaded(id, filePath, wireBytes, fileSize);
+}
+
+void DeltaUploader::fallBack(quint64 id, int status)
+{
+    Job &job = m_jobs[id];
+    switch (job.mode) {
+    case PatchUpload:
+        // 服务器上的版本与本地签名不一致：丢弃签名，重新按块或完整上传
+        QFile::remove(job.signaturePath);
+        QFile::remove(job.patchPath);
+        prepare(id);
+        break;
+    case ChunkUpload:
+        job.mode = FullUpload;
+        send(id);
+        break;
+    case FullUpload:
+        finishJob(id, tr("服务器拒绝上传（HTTP %1）").arg(status));
+        break;
+    }
+}
+
+QNetworkReply *DeltaUploader::track(quint64 id, QNetworkReply *reply)
+{
+    m_jobs[id].replies.append(reply);
+    return reply;
+}
+
+void DeltaUploader::finishJob(quint64 id, const QString &error)
+{
+    const Job job = m_jobs.take(id);
+    for (QNetworkReply *reply : job.replies) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    QFile::remove(job.patchPath);
+    if (!error.isEmpty()) {
+        emit failed(id, error);
+    }
+}
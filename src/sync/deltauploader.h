@@ -0,0 +1,94 @@
+#ifndef DELTAUPLOADER_H
+#define DELTAUPLOADER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QUrl>
+#include <QVector>
+#include "blocksignature.h"
+#include "contentchunker.h"
+#include "delta.h"
+
+class QFile;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// 同步文件上传，按以下顺序选择上传方式：
+//   1. 本地有服务器版本的块签名时只上传补丁（PATCH，见 Delta），适合原地修改的大文件；
+//   2. 启用块上传时按内容分块（见 ContentChunker），先询问服务器缺少哪些块，只上传缺少的块和块清单，
+//      适合新文件以及在多个文件夹中保存的相似副本；
+//   3. 以上都不可用或被服务器拒绝时上传完整文件（PUT）。
+// 计算补丁和分块在线程池中进行，上传成功后把新文件的签名保存为下一次的基准。
+// 文件内容分窗口读取、按套接字的发送进度流式上传，内存占用与文件大小无关；同时发送的块请求数有上限，
+// 未压缩的块直接从源文件的映射发送，不复制到内存。
+class DeltaUploader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeltaUploader(const QString &signatureDir, QObject *parent = nullptr);
+    ~DeltaUploader() override;
+
+    // 启用块上传：endpoint 为服务器的块接口（POST <endpoint>/missing 查询缺少的块，PUT <endpoint>/<哈希> 上传块）。
+    // 块不在本地另存一份，发送时按分块记下的偏移和长度从源文件读取
+    void enableChunkUpload(const QUrl &endpoint);
+    // 块上传时压缩块内容（Content-Encoding: deflate），压缩后没有变小的块按原样发送
+    void setChunkCompression(bool enabled) { m_compressChunks = enabled; }
+
+    // 上传文件，返回上传编号
+    quint64 upload(const QString &filePath, const QUrl &url);
+
+signals:
+    // wireBytes 为实际发送的请求体大小
+    void uploaded(quint64 id, const QString &filePath, qint64 wireBytes, qint64 fileSize);
+    void failed(quint64 id, const QString &error);
+
+private:
+    enum Mode {
+        PatchUpload,
+        ChunkUpload,
+        FullUpload
+    };
+
+    struct Job {
+        QString filePath;
+        QUrl url;
+        QString signaturePath;    // 服务器版本的块签名
+        QString patchPath;        // 生成的补丁
+        BlockSignature signature; // 本次上传内容的签名，成功后保存
+        QVector<ContentChunker::Chunk> chunks;
+        QHash<QByteArray, int> chunkIndex;  // 块哈希 -> chunks 中的下标（文件内部重复的块取第一处）
+        Mode mode = FullUpload;
+        qint64 wireBytes = 0;     // 已发送的请求体大小
+        int pendingChunks = 0;    // 尚未完成的块上传
+        QList<int> chunkQueue;    // 等待发送的块（chunks 中的下标）
+        int activeChunks = 0;     // 正在压缩或发送的块
+        QList<QNetworkReply *> replies;
+    };
+
+    void prepare(quint64 id);
+    void handlePrepared(quint64 id, Mode mode, const BlockSignature &signature,
+                        const QVector<ContentChunker::Chunk> &chunks, const QString &error);
+    void send(quint64 id);
+    void sendMissingQuery(quint64 id);
+    void handleMissingReply(quint64 id, QNetworkReply *reply);
+    void sendNextChunks(quint64 id);
+    // mapping 不为空时 data 指向它映射的内存，由请求接管
+    void sendChunk(quint64 id, const QByteArray &hash, const QByteArray &data, bool compressed, QFile *mapping);
+    void handleChunkReply(quint64 id, QNetworkReply *reply);
+    void handleReplyFinished(quint64 id, QNetworkReply *reply);
+    void fallBack(quint64 id, int status);
+    QNetworkReply *track(quint64 id, QNetworkReply *reply);
+    void finishJob(quint64 id, const QString &error);
+
+private:
+    QNetworkAccessManager *m_network;
+    QString m_signatureDir;
+    QUrl m_chunkEndpoint;                  // 为空时不使用块上传
+    bool m_compressChunks;
+    QHash<quint64, Job> m_jobs;
+    quint64 m_nextId;
+};
+
+#endif // DELTAUPLOADER_H
@@ -0,0 +1,111 @@
+#include "folderwatcher.h"
+#include <QDir>
+
+#ifdef Q_OS_LINUX
+#include "inotifywatcher.h"
+#else
+#include <QDirIterator>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#endif
+
+FolderWatcher::FolderWatcher(QObject *parent)
+    : QObject(parent)
+{
+#ifdef Q_OS_LINUX
+    m_watcher = new InotifyWatcher(this);
+    // 监视线程发出的信号以队列方式转发到当前线程
+    connect(m_watcher, &InotifyWatcher::fileSettled, this, &FolderWatcher::fileSettled);
+    connect(m_watcher, &InotifyWatcher::fileRemoved, this, &FolderWatcher::fileRemoved);
+    connect(m_watcher, &InotifyWatcher::directoryRemoved, this, &FolderWatcher::directoryRemoved);
+    connect(m_watcher, &InotifyWatcher::rescanNeeded, this, &FolderWatcher::rescanNeeded);
+    connect(m_watcher, &InotifyWatcher::errorOccurred, this, &FolderWatcher::errorOccurred);
+#else
+    m_watcher = new QFileSystemWatcher(this);
+    m_settleTimer = new QTimer(this);
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(500);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &FolderWatcher::handleDirectoryChanged);
+    connect(m_settleTimer, &QTimer::timeout, this, [this]() {
+        const QSet<QString> directories = m_changedDirectories;
+        m_changedDirectories.clear();
+        for (const QString &directory : directories) {
+            emit rescanNeeded(directory);
+        }
+    });
+#endif
+}
+
+FolderWatcher::~FolderWatcher()
+{
+}
+
+void FolderWatcher::addFolder(const QString &path)
+{
+    const QString folder = QDir(path).absolutePath();
+    if (m_folders.contains(folder)) return;
+    m_folders.append(folder);
+
+#ifdef Q_OS_LINUX
+    m_watcher->addRoot(folder);
+#else
+    watchRecursive(folder);
+#endif
+}
+
+void FolderWatcher::removeFolder(const QString &path)
+{
+    const QString folder = QDir(path).absolutePath();
+    if (!m_folders.removeOne(folder)) return;
+
+#ifdef Q_OS_LINUX
+    m_watcher->removeRoot(folder);
+#else
+    QStringList stale;
+    const QStringList directories = m_watcher->directories();
+    for (const QString &directory : directories) {
+        if (directory == folder || directory.startsWith(folder + QLatin1Char('/'))) {
+            stale.append(directory);
+        }
+    }
+    if (!stale.isEmpty()) {
+        m_watcher->removePaths(stale);
+    }
+#endif
+}
+
+void FolderWatcher::setSettleDelay(int msecs)
+{
+#ifdef Q_OS_LINUX
+    m_watcher->setSettleDelay(msecs);
+#else
+    m_settleTimer->setInterval(msecs);
+#endif
+}
+
+#ifndef Q_OS_LINUX
+void FolderWatcher::watchRecursive(const QString &directory)
+{
+    QStringList directories{directory};
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        directories.append(it.next());
+    }
+    m_watcher->addPaths(directories);
+}
+
+void FolderWatcher::handleDirectoryChanged(const QString &directory)
+{
+    if (QDir(directory).exists()) {
+        // 新建的子目录需要补充监视，已监视的路径会被 QFileSystemWatcher 忽略
+        watchRecursive(directory);
+    } else {
+        emit directoryRemoved(directory);
+        return;
+    }
+    m_changedDirectories.insert(directory);
+    m_settleTimer->start();
+}
+#endif
@@ -0,0 +1,56 @@
+#ifndef FOLDERWATCHER_H
+#define FOLDERWATCHER_H
+
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+class InotifyWatcher;
+class QFileSystemWatcher;
+class QTimer;
+
+// 同步文件夹监视：递归监视若干根目录，把短时间内的连续变化合并后通知。
+// Linux 上使用 InotifyWatcher（独立线程 + epoll）；其他平台退回 QFileSystemWatcher，
+// 只能报告发生变化的目录，由上层重新扫描该目录。
+class FolderWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FolderWatcher(QObject *parent = nullptr);
+    ~FolderWatcher() override;
+
+    void addFolder(const QString &path);
+    void removeFolder(const QString &path);
+    QStringList folders() const { return m_folders; }
+
+    // 同一路径最后一次变化后等待多久才认为已稳定（毫秒）
+    void setSettleDelay(int msecs);
+
+signals:
+    // 文件创建或修改完成，且在静默期内没有新的变化
+    void fileSettled(const QString &path);
+    void fileRemoved(const QString &path);
+    void directoryRemoved(const QString &path);
+    // 事件可能丢失（如内核队列溢出），需要重新扫描该目录
+    void rescanNeeded(const QString &directory);
+    void errorOccurred(const QString &message);
+
+private:
+#ifndef Q_OS_LINUX
+    void watchRecursive(const QString &directory);
+    void handleDirectoryChanged(const QString &directory);
+#endif
+
+private:
+    QStringList m_folders;
+#ifdef Q_OS_LINUX
+    InotifyWatcher *m_watcher;
+#else
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_settleTimer;
+    QSet<QString> m_changedDirectories;  // 静默期内发生变化的目录
+#endif
+};
+
+#endif // FOLDERWATCHER_H
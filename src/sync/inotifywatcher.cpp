@@ -0,0 +1,341 @@
+#include "inotifywatcher.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iterator>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+
+const int kDefaultSettleDelayMs = 500;   // 同一路径最后一个事件后的静默期
+const int kReadBufferSize = 64 * 1024;   // 一次 read 最多取出的事件字节数
+
+// 只关心内容和目录结构变化；IN_EXCL_UNLINK 避免已删除文件继续产生事件
+const uint32_t kWatchMask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB
+                          | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+                          | IN_DELETE_SELF | IN_MOVE_SELF
+                          | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+bool isUnder(const QString &path, const QString &directory)
+{
+    return path == directory
+        || (path.startsWith(directory) && path.at(directory.size()) == QLatin1Char('/'));
+}
+
+} // namespace
+
+InotifyWatcher::InotifyWatcher(QObject *parent)
+    : QThread(parent)
+    , m_inotifyFd(-1)
+    , m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_stopping(false)
+    , m_settleDelay(kDefaultSettleDelayMs)
+    , m_nextDeadline(LLONG_MAX)
+    , m_watchLimitReported(false)
+{
+    // 描述符在构造时创建，addRoot/stop 可以在线程启动前后安全地唤醒监视线程
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_inotifyFd < 0 || m_wakeFd < 0 || m_epollFd < 0) return;
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_inotifyFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inotifyFd, &event);
+    event.data.fd = m_wakeFd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+    stop();
+    wait();
+
+    if (m_inotifyFd >= 0) ::close(m_inotifyFd);
+    if (m_epollFd >= 0) ::close(m_epollFd);
+    if (m_wakeFd >= 0) ::close(m_wakeFd);
+}
+
+void InotifyWatcher::addRoot(const QString &path)
+{
+    {
+        QMutexLocker locker(&m_commandMutex);
+        m_commands.append({true, QDir(path).absolutePath()});
+    }
+    if (!isRunning()) {
+        start();
+    }
+    wake();
+}
+
+void InotifyWatcher::removeRoot(const QString &path)
+{
+    {
+        QMutexLocker locker(&m_commandMutex);
+        m_commands.append({false, QDir(path).absolutePath()});
+    }
+    wake();
+}
+
+void InotifyWatcher::stop()
+{
+    m_stopping = true;
+    wake();
+}
+
+void InotifyWatcher::wake()
+{
+    if (m_wakeFd < 0) return;
+    const uint64_t one = 1;
+    const ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+    Q_UNUSED(written);
+}
+
+void InotifyWatcher::run()
+{
+    if (m_inotifyFd < 0 || m_wakeFd < 0 || m_epollFd < 0) {
+        emit errorOccurred(tr("无法初始化 inotify，文件夹监视不可用"));
+        return;
+    }
+    m_clock.start();
+
+    epoll_event events[2];
+    processCommands();
+    while (!m_stopping) {
+        const int count = epoll_wait(m_epollFd, events, 2, nextTimeout());
+        if (count < 0 && errno != EINTR) {
+            emit errorOccurred(tr("epoll_wait 失败：%1").arg(QString::fromLocal8Bit(strerror(errno))));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.fd == m_wakeFd) {
+                uint64_t value = 0;
+                const ssize_t length = ::read(m_wakeFd, &value, sizeof(value));
+                Q_UNUSED(length);
+                processCommands();
+            } else {
+                readEvents();
+            }
+        }
+        flushSettled();
+    }
+}
+
+void InotifyWatcher::processCommands()
+{
+    QList<Command> commands;
+    {
+        QMutexLocker locker(&m_commandMutex);
+        commands.swap(m_commands);
+    }
+
+    for (const Command &command : commands) {
+        if (command.add) {
+            if (m_roots.contains(command.path)) continue;
+            m_roots.append(command.path);
+
+            QElapsedTimer timer;
+            timer.start();
+            addWatchRecursive(command.path, false);
+            qDebug() << "InotifyWatcher watching" << m_pathByWatch.size() << "directories after adding"
+                     << command.path << "in" << timer.elapsed() << "ms";
+        } else {
+            if (!m_roots.removeOne(command.path)) continue;
+            removeWatchesUnder(command.path);
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                it = isUnder(it.key(), command.path) ? m_pending.erase(it) : std::next(it);
+            }
+        }
+    }
+}
+
+void InotifyWatcher::readEvents()
+{
+    alignas(inotify_event) char buffer[kReadBufferSize];
+
+    for (;;) {
+        const ssize_t length = ::read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (const char *ptr = buffer; ptr < buffer + length;) {
+            const inotify_event *event = reinterpret_cast<const inotify_event *>(ptr);
+            handleEvent(event);
+            ptr += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+
+void InotifyWatcher::handleEvent(const inotify_event *event)
+{
+    if (event->mask & IN_Q_OVERFLOW) {
+        handleOverflow();
+        return;
+    }
+
+    const auto watch = m_pathByWatch.constFind(event->wd);
+    if (watch == m_pathByWatch.constEnd()) return;
+    const QString directory = watch.value();
+
+    if (event->mask & IN_IGNORED) {
+        // 目录被删除或监视被移除，内核已经回收描述符
+        m_pathByWatch.remove(event->wd);
+        if (m_watchByPath.value(directory) == event->wd) {
+            m_watchByPath.remove(directory);
+        }
+        return;
+    }
+
+    if (event->len == 0) {
+        // 监视的目录自身被移动或删除；根目录变化时交给上层重新扫描
+        if ((event->mask & (IN_MOVE_SELF | IN_DELETE_SELF)) && m_roots.contains(directory)) {
+            emit rescanNeeded(directory);
+        }
+        return;
+    }
+
+    const QString path = directory + QLatin1Char('/') + QFile::decodeName(event->name);
+
+    if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+            // 新目录在加监视之前可能已经写入了文件，所以扫描时把文件一并报告
+            addWatchRecursive(path, true);
+        } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+            // 移走的目录监视仍然有效但路径已过期，统一移除，移入时按新路径重建
+            removeWatchesUnder(path);
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                it = isUnder(it.key(), path) ? m_pending.erase(it) : std::next(it);
+            }
+            emit directoryRemoved(path);
+        }
+        return;
+    }
+
+    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        touch(path, true);
+    } else if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM)) {
+        touch(path, false);
+    }
+}
+
+void InotifyWatcher::handleOverflow()
+{
+    // 内核队列溢出，期间的事件已经丢失：补齐新目录的监视，再让上层按根目录重新扫描
+    qWarning() << "InotifyWatcher event queue overflowed, rescanning" << m_roots.size() << "roots";
+    for (const QString &root : std::as_const(m_roots)) {
+        addWatchRecursive(root, false);
+        emit rescanNeeded(root);
+    }
+}
+
+void InotifyWatcher::addWatchRecursive(const QString &directory, bool reportFiles)
+{
+    if (!addWatch(directory)) return;
+
+    QDir::Filters filters = QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks;
+    if (reportFiles) {
+        filters |= QDir::Files;
+    }
+
+    QDirIterator it(directory, filters, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir()) {
+            addWatch(info.filePath());
+        } else {
+            touch(info.filePath(), true);
+        }
+    }
+}
+
+bool InotifyWatcher::addWatch(const QString &directory)
+{
+    const int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(directory).constData(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOSPC && !m_watchLimitReported) {
+            m_watchLimitReported = true;
+            emit errorOccurred(tr("已达到 inotify 监视数量上限（fs.inotify.max_user_watches），"
+                                  "部分目录的变化将无法实时发现"));
+        }
+        return false;
+    }
+
+    // 同一个 inode 会返回同一个描述符，重复添加只更新路径
+    const QString previous = m_pathByWatch.value(wd);
+    if (!previous.isEmpty() && previous != directory) {
+        m_watchByPath.remove(previous);
+    }
+    m_pathByWatch.insert(wd, directory);
+    m_watchByPath.insert(directory, wd);
+    return true;
+}
+
+void InotifyWatcher::removeWatchesUnder(const QString &directory)
+{
+    for (auto it = m_watchByPath.begin(); it != m_watchByPath.end();) {
+        if (isUnder(it.key(), directory)) {
+            inotify_rm_watch(m_inotifyFd, it.value());
+            m_pathByWatch.remove(it.value());
+            it = m_watchByPath.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void InotifyWatcher::touch(const QString &path, bool created)
+{
+    const qint64 deadline = m_clock.elapsed() + m_settleDelay;
+
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) {
+        it = m_pending.insert(path, Pending());
+        it->createdInBurst = created;
+    }
+    it->deadline = deadline;
+    m_nextDeadline = qMin(m_nextDeadline, deadline);
+}
+
+void InotifyWatcher::flushSettled()
+{
+    const qint64 now = m_clock.elapsed();
+    if (now < m_nextDeadline) return;
+
+    m_nextDeadline = LLONG_MAX;
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->deadline > now) {
+            m_nextDeadline = qMin(m_nextDeadline, it->deadline);
+            ++it;
+            continue;
+        }
+
+        // 以静默期结束时的实际状态为准：本轮新建后又消失的临时文件不报告
+        const QFileInfo info(it.key());
+        if (info.exists()) {
+            if (info.isFile()) {
+                emit fileSettled(it.key());
+            }
+        } else if (!it->createdInBurst) {
+            emit fileRemoved(it.key());
+        }
+        it = m_pending.erase(it);
+    }
+}
+
+int InotifyWatcher::nextTimeout() const
+{
+    if (m_pending.isEmpty()) return -1;
+    return static_cast<int>(qBound<qint64>(0, m_nextDeadline - m_clock.elapsed(), INT_MAX));
+}
@@ -0,0 +1,85 @@
+#ifndef INOTIFYWATCHER_H
+#define INOTIFYWATCHER_H
+
+#include <QThread>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QStringList>
+#include <atomic>
+
+struct inotify_event;
+
+// 基于 inotify 的递归目录监视（仅 Linux）：运行在独立线程上，用 epoll 等待事件。
+// 只为目录保存监视描述符和路径，不保存任何文件级状态；
+// 同一路径在静默期内的多次创建/修改/重命名合并为一次"文件已稳定"通知。
+class InotifyWatcher : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit InotifyWatcher(QObject *parent = nullptr);
+    ~InotifyWatcher() override;
+
+    // 以下接口可以在任意线程调用，命令由监视线程执行
+    void addRoot(const QString &path);
+    void removeRoot(const QString &path);
+    void setSettleDelay(int msecs) { m_settleDelay = msecs; }
+    void stop();
+
+signals:
+    void fileSettled(const QString &path);
+    void fileRemoved(const QString &path);
+    void directoryRemoved(const QString &path);
+    void rescanNeeded(const QString &rootPath);
+    void errorOccurred(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    struct Command {
+        bool add;
+        QString path;
+    };
+
+    // 静默期内等待合并的路径
+    struct Pending {
+        qint64 deadline = 0;
+        bool createdInBurst = false;  // 本轮第一个事件是创建，之后消失的文件不报告删除
+    };
+
+    void wake();
+    void processCommands();
+    void readEvents();
+    void handleEvent(const inotify_event *event);
+    void handleOverflow();
+    void addWatchRecursive(const QString &directory, bool reportFiles);
+    bool addWatch(const QString &directory);
+    void removeWatchesUnder(const QString &directory);
+    void touch(const QString &path, bool created);
+    void flushSettled();
+    int nextTimeout() const;
+
+private:
+    int m_inotifyFd;
+    int m_epollFd;
+    int m_wakeFd;                        // eventfd，用于唤醒 epoll 处理命令或退出
+    std::atomic<bool> m_stopping;
+    std::atomic<int> m_settleDelay;      // 静默期（毫秒）
+
+    QMutex m_commandMutex;
+    QList<Command> m_commands;           // 等待监视线程处理的命令
+
+    // 以下成员只在监视线程中访问
+    QStringList m_roots;
+    QHash<int, QString> m_pathByWatch;   // 监视描述符 -> 目录路径
+    QHash<QString, int> m_watchByPath;   // 目录路径 -> 监视描述符
+    QHash<QString, Pending> m_pending;
+    qint64 m_nextDeadline;
+    QElapsedTimer m_clock;
+    bool m_watchLimitReported;
+};
+
+#endif // INOTIFYWATCHER_H
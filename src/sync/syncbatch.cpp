@@ -0,0 +1,49 @@
+#include "syncbatch.h"
+#include <QDataStream>
+
+namespace {
+
+const quint32 kMagic = 0x41474254;   // "AGBT"
+const quint32 kVersion = 1;
+
+} // namespace
+
+QByteArray SyncBatch::encode(const QList<Entry> &entries)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << kMagic << kVersion << qint32(entries.size());
+    for (const Entry &entry : entries) {
+        stream << entry.path << quint8(entry.removed ? 1 : 0);
+        if (!entry.removed) {
+            stream << entry.data;
+        }
+    }
+    return data;
+}
+
+bool SyncBatch::parse(const QByteArray &data, QList<Entry> *entries)
+{
+    QDataStream stream(data);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != kMagic || version != kVersion || count < 0) return false;
+
+    QList<Entry> result;
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        quint8 removed = 0;
+        stream >> entry.path >> removed;
+        entry.removed = removed != 0;
+        if (!entry.removed) {
+            stream >> entry.data;
+        }
+        result.append(entry);
+    }
+    if (stream.status() != QDataStream::Ok) return false;
+
+    *entries = result;
+    return true;
+}
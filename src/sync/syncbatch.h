@@ -0,0 +1,24 @@
+#ifndef SYNCBATCH_H
+#define SYNCBATCH_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// 批量同步请求：把多个小文件的内容和删除操作打包成一个请求体（POST <同步地址>/.batch），
+// 避免每个小文件单独建立连接、等待一次往返。路径相对于同步地址，即 "<应用ID>/<相对路径>"。
+namespace SyncBatch {
+
+struct Entry
+{
+    QString path;
+    bool removed = false;
+    QByteArray data;   // 文件内容（删除时为空）
+};
+
+QByteArray encode(const QList<Entry> &entries);
+bool parse(const QByteArray &data, QList<Entry> *entries);
+
+} // namespace SyncBatch
+
+#endif // SYNCBATCH_H
@@ -0,0 +1,157 @@
+#include "syncchecker.h"
+#include "core/trace.h"
+#include "syncstate.h"
+#include "synctree.h"
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+SyncChecker::SyncChecker(SyncState *state, QObject *parent)
+    : QObject(parent)
+    , m_state(state)
+    , m_network(new QNetworkAccessManager(this))
+    , m_nextId(0)
+{
+}
+
+SyncChecker::~SyncChecker()
+{
+    for (const Check &check : std::as_const(m_checks)) {
+        for (QNetworkReply *reply : check.replies) {
+            reply->disconnect(this);
+            reply->abort();
+        }
+    }
+}
+
+quint64 SyncChecker::check(const QString &appId, const QUrl &treeUrl)
+{
+    const quint64 id = ++m_nextId;
+    Check check;
+    check.appId = appId;
+    check.treeUrl = treeUrl;
+    check.timer.start();
+    m_checks.insert(id, check);
+
+    QNetworkReply *reply = request(id, QString(), true);
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]() { handleRootReply(id, reply); });
+    return id;
+}
+
+QNetworkReply *SyncChecker::request(quint64 id, const QString &directory, bool headOnly)
+{
+    Check &check = m_checks[id];
+    QUrl url = check.treeUrl;
+    if (!directory.isEmpty()) {
+        url.setPath(url.path() + QLatin1Char('/') + directory);
+    }
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    QNetworkReply *reply = headOnly ? m_network->head(request) : m_network->get(request);
+    check.replies.append(reply);
+    ++check.requests;
+    return reply;
+}
+
+void SyncChecker::handleRootReply(quint64 id, QNetworkReply *reply)
+{
+    TRACE_SPAN("network", "SyncChecker::handleRootReply");
+    auto it = m_checks.find(id);
+    if (it == m_checks.end()) return;
+    it->replies.removeOne(reply);
+    reply->deleteLater();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 404) {
+        // 服务器上还没有这个应用的文件
+        finishCheck(id, QString());
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        finishCheck(id, reply->errorString());
+        return;
+    }
+
+    const QByteArray remoteRoot = QByteArray::fromHex(reply->rawHeader("X-Tree-Hash"));
+    if (remoteRoot == m_state->tree(it->appId)->hash()) {
+        finishCheck(id, QString());
+        return;
+    }
+
+    QNetworkReply *listing = request(id, QString(), false);
+    connect(listing, &QNetworkReply::finished, this, [this, id, listing]() {
+        handleListingReply(id, QString(), listing);
+    });
+}
+
+void SyncChecker::handleListingReply(quint64 id, const QString &directory, QNetworkReply *reply)
+{
+    TRACE_SPAN("network", "SyncChecker::handleListingReply");
+    auto it = m_checks.find(id);
+    if (it == m_checks.end()) return;
+    it->replies.removeOne(reply);
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError) {
+        finishCheck(id, reply->errorString());
+        return;
+    }
+
+    // 本地同一目录的子项（目录在本地不存在时为空）
+    QHash<QString, SyncTree::Entry> local;
+    QList<SyncTree::Entry> entries;
+    if (m_state->tree(it->appId)->children(directory, &entries)) {
+        for (const SyncTree::Entry &entry : std::as_const(entries)) {
+            local.insert(entry.name, entry);
+        }
+    }
+
+    const QList<QByteArray> lines = reply->readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        if (fields.size() != 3) continue;
+
+        const bool remoteDirectory = fields.at(0) == "d";
+        const QByteArray hash = QByteArray::fromHex(fields.at(1));
+        const QString name = QUrl::fromPercentEncoding(fields.at(2));
+        const QString path = directory.isEmpty() ? name : directory + QLatin1Char('/') + name;
+
+        const auto localEntry = local.constFind(name);
+        if (localEntry != local.constEnd() && localEntry->directory == remoteDirectory && localEntry->hash == hash) {
+            continue;
+        }
+
+        if (remoteDirectory) {
+            QNetworkReply *listing = request(id, path, false);
+            connect(listing, &QNetworkReply::finished, this, [this, id, path, listing]() {
+                handleListingReply(id, path, listing);
+            });
+        } else {
+            it->newer.append({path, hash});
+        }
+    }
+
+    if (it->replies.isEmpty()) {
+        finishCheck(id, QString());
+    }
+}
+
+void SyncChecker::finishCheck(quint64 id, const QString &error)
+{
+    const Check check = m_checks.take(id);
+    for (QNetworkReply *reply : check.replies) {
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+
+    qDebug() << "SyncChecker:" << check.appId << "checked in" << check.timer.elapsed() << "ms with"
+             << check.requests << "requests," << check.newer.size() << "newer files";
+    if (error.isEmpty()) {
+        emit finished(id, check.appId, check.newer);
+    } else {
+        emit failed(id, check.appId, error);
+    }
+}
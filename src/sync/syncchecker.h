@@ -0,0 +1,61 @@
+#ifndef SYNCCHECKER_H
+#define SYNCCHECKER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QUrl>
+
+class SyncState;
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// 启动前的同步检查：与服务器比较应用文件夹的 Merkle 树（见 SyncTree）。
+// 先只取根哈希（HEAD），一致时一个请求即可结束；不一致时只展开哈希不同的子目录，
+// 最终得到服务器上较新（或本地没有）的文件列表。
+// 服务器接口：<treeUrl>/<目录> 返回目录哈希（X-Tree-Hash 头）和子项列表，每行 "d|f <十六进制哈希> <名称（百分号编码）>"
+class SyncChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct RemoteFile
+    {
+        QString relativePath;
+        QByteArray hash;
+    };
+
+    explicit SyncChecker(SyncState *state, QObject *parent = nullptr);
+    ~SyncChecker() override;
+
+    // treeUrl 为该应用文件夹在服务器上的树接口地址，返回检查编号
+    quint64 check(const QString &appId, const QUrl &treeUrl);
+
+signals:
+    void finished(quint64 id, const QString &appId, const QList<SyncChecker::RemoteFile> &newer);
+    void failed(quint64 id, const QString &appId, const QString &error);
+
+private:
+    struct Check {
+        QString appId;
+        QUrl treeUrl;
+        QList<RemoteFile> newer;
+        QList<QNetworkReply *> replies;
+        int requests = 0;
+        QElapsedTimer timer;
+    };
+
+    QNetworkReply *request(quint64 id, const QString &directory, bool headOnly);
+    void handleRootReply(quint64 id, QNetworkReply *reply);
+    void handleListingReply(quint64 id, const QString &directory, QNetworkReply *reply);
+    void finishCheck(quint64 id, const QString &error);
+
+private:
+    SyncState *m_state;
+    QNetworkAccessManager *m_network;
+    QHash<quint64, Check> m_checks;
+    quint64 m_nextId;
+};
+
+#endif // SYNCCHECKER_H
@@ -0,0 +1,271 @@
+#include "syncdispatcher.h"
+#include "core/trace.h"
+#include "deltauploader.h"
+#include "syncbatch.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+
+namespace {
+
+const qint64 kSmallFileSize = 256 * 1024;       // 不超过此大小的文件放进批量请求
+const int kMaxBatchEntries = 64;                 // 单个批量请求最多包含的文件数
+const qint64 kMaxBatchBytes = 4 * 1024 * 1024;   // 单个批量请求的最大内容大小
+const int kMaxBatches = 2;                       // 同时进行的批量请求数
+const int kMaxStreams = 4;                       // 同时上传的大文件数
+const int kDispatchDelayMs = 100;                // 新记录到达后等待更多记录一起发送
+const int kMinRetryDelayMs = 1000;
+const int kMaxRetryDelayMs = 60 * 1000;
+
+} // namespace
+
+SyncDispatcher::SyncDispatcher(LocalStore *store, DeltaUploader *uploader, const QString &syncRoot,
+                               const QString &baseUrl, QObject *parent)
+    : QObject(parent)
+    , m_store(store)
+    , m_uploader(uploader)
+    , m_network(new QNetworkAccessManager(this))
+    , m_syncRoot(syncRoot)
+    , m_baseUrl(baseUrl)
+    , m_dispatchTimer(new QTimer(this))
+    , m_retryTimer(new QTimer(this))
+    , m_replayRequest(0)
+    , m_started(false)
+    , m_batchSupported(true)
+    , m_activeBatches(0)
+    , m_retryDelay(kMinRetryDelayMs)
+{
+    m_dispatchTimer->setSingleShot(true);
+    connect(m_dispatchTimer, &QTimer::timeout, this, &SyncDispatcher::dispatch);
+
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, [this]() {
+        m_queue += m_retryQueue;
+        m_retryQueue.clear();
+        dispatch();
+    });
+
+    connect(m_store, &LocalStore::pendingSyncRecordsReady, this, &SyncDispatcher::handlePending);
+    connect(m_store, &LocalStore::syncRecordsCommitted, this, &SyncDispatcher::enqueue);
+    connect(m_uploader, &DeltaUploader::uploaded, this, [this](quint64 id) { handleUploadDone(id, true); });
+    connect(m_uploader, &DeltaUploader::failed, this, [this](quint64 id) { handleUploadDone(id, false); });
+}
+
+SyncDispatcher::~SyncDispatcher()
+{
+}
+
+void SyncDispatcher::start()
+{
+    m_replayRequest = m_store->requestPendingSyncRecords();
+}
+
+void SyncDispatcher::handlePending(quint64 requestId, const QList<SyncRecord> &records)
+{
+    if (requestId != m_replayRequest) return;
+
+    qDebug() << "SyncDispatcher replaying" << records.size() << "pending journal records";
+    enqueue(records);
+    m_started = true;
+    scheduleDispatch(0);
+}
+
+void SyncDispatcher::enqueue(const QList<SyncRecord> &records)
+{
+    // 重放结果和刚提交的记录可能重叠，按日志编号去重；同一文件只保留最新的记录
+    for (const SyncRecord &record : records) {
+        const QString key = record.appId + QLatin1Char('/') + record.relativePath;
+        Entry &entry = m_entries[key];
+        if (entry.ids.contains(record.id)) continue;
+        entry.ids.append(record.id);
+        if (record.id > entry.record.id) {
+            entry.record = record;
+        }
+        // 正在上传的文件等这次上传完成后再发送
+        if (!entry.queued && entry.sendingIds.isEmpty()) {
+            entry.queued = true;
+            m_queue.append(key);
+        }
+    }
+
+    if (m_started) {
+        scheduleDispatch(kDispatchDelayMs);
+    }
+}
+
+void SyncDispatcher::scheduleDispatch(int delay)
+{
+    if (!m_dispatchTimer->isActive() || m_dispatchTimer->remainingTime() > delay) {
+        m_dispatchTimer->start(delay);
+    }
+}
+
+void SyncDispatcher::dispatch()
+{
+    TRACE_SPAN("sync", "SyncDispatcher::dispatch");
+    if (!m_started) return;
+
+    QStringList batch;
+    qint64 batchBytes = 0;
+    QStringList waiting;   // 没有空闲连接，留到下一次
+    const QStringList queue = m_queue;
+    m_queue.clear();
+
+    for (const QString &key : queue) {
+        Entry &entry = m_entries[key];
+        const QFileInfo info(filePathFor(entry.record));
+        // 文件已不存在时按删除处理，对应的删除记录随后到达时会合并进来
+        const bool removed = entry.record.operation == SyncRecord::Removed || !info.isFile();
+
+        if (m_batchSupported && (removed || info.size() <= kSmallFileSize)) {
+            if (m_activeBatches >= kMaxBatches) {
+                waiting.append(key);
+                continue;
+            }
+            entry.queued = false;
+            entry.sendingIds = entry.ids;
+            batch.append(key);
+            batchBytes += removed ? 0 : info.size();
+            if (batch.size() >= kMaxBatchEntries || batchBytes >= kMaxBatchBytes) {
+                sendBatch(batch);
+                batch.clear();
+                batchBytes = 0;
+            }
+        } else if (removed) {
+            // 服务器不支持批量请求时无法通知删除，只从日志中移除
+            entry.queued = false;
+            entry.sendingIds = entry.ids;
+            complete(key);
+        } else if (m_uploads.size() < kMaxStreams) {
+            entry.queued = false;
+            entry.sendingIds = entry.ids;
+            m_uploads.insert(m_uploader->upload(info.filePath(), urlFor(entry.record)), key);
+        } else {
+            waiting.append(key);
+        }
+    }
+    if (!batch.isEmpty()) {
+        sendBatch(batch);
+    }
+    m_queue = waiting + m_queue;
+}
+
+void SyncDispatcher::sendBatch(const QStringList &keys)
+{
+    QList<SyncBatch::Entry> entries;
+    entries.reserve(keys.size());
+    for (const QString &key : keys) {
+        const SyncRecord &record = m_entries.value(key).record;
+        SyncBatch::Entry entry;
+        entry.path = record.appId + QLatin1Char('/') + record.relativePath;
+        QFile file(filePathFor(record));
+        entry.removed = record.operation == SyncRecord::Removed || !file.open(QIODevice::ReadOnly);
+        if (!entry.removed) {
+            entry.data = file.readAll();
+        }
+        entries.append(entry);
+    }
+
+    QNetworkRequest request(QUrl(m_baseUrl + QStringLiteral("/.batch")));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QStringLiteral("application/x-appgo-batch"));
+    QNetworkReply *reply = m_network->post(request, SyncBatch::encode(entries));
+    ++m_activeBatches;
+    connect(reply, &QNetworkReply::finished, this, [this, reply, keys]() { handleBatchReply(reply, keys); });
+}
+
+void SyncDispatcher::handleBatchReply(QNetworkReply *reply, const QStringList &keys)
+{
+    TRACE_SPAN("network", "SyncDispatcher::handleBatchReply");
+    reply->deleteLater();
+    --m_activeBatches;
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() == QNetworkReply::NoError) {
+        m_retryDelay = kMinRetryDelayMs;
+        for (const QString &key : keys) {
+            complete(key);
+        }
+        return;
+    }
+
+    if (status == 400 || status == 404 || status == 405) {
+        // 服务器不认识批量请求，之后逐个上传
+        qWarning() << "SyncDispatcher: batch upload rejected with" << status << ", uploading files one by one";
+        m_batchSupported = false;
+        for (const QString &key : keys) {
+            Entry &entry = m_entries[key];
+            entry.sendingIds.clear();
+            entry.queued = true;
+            m_queue.append(key);
+        }
+        scheduleDispatch(0);
+        return;
+    }
+
+    qWarning() << "SyncDispatcher: batch upload failed:" << reply->errorString();
+    retry(keys);
+}
+
+void SyncDispatcher::handleUploadDone(quint64 uploadId, bool ok)
+{
+    const QString key = m_uploads.take(uploadId);
+    if (key.isEmpty()) return;
+
+    if (ok) {
+        m_retryDelay = kMinRetryDelayMs;
+        complete(key);
+    } else {
+        retry({key});
+    }
+}
+
+void SyncDispatcher::complete(const QString &key)
+{
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+
+    // 记录从日志中删除也随组提交落盘；删除前崩溃只会让这些文件在重放时再上传一次
+    m_store->completeSyncRecords(it->sendingIds);
+    for (qint64 id : std::as_const(it->sendingIds)) {
+        it->ids.removeOne(id);
+    }
+    it->sendingIds.clear();
+
+    if (it->ids.isEmpty()) {
+        m_entries.erase(it);
+    } else if (!it->queued) {
+        // 上传期间文件又被修改
+        it->queued = true;
+        m_queue.append(key);
+    }
+
+    scheduleDispatch(0);
+}
+
+void SyncDispatcher::retry(const QStringList &keys)
+{
+    for (const QString &key : keys) {
+        Entry &entry = m_entries[key];
+        entry.sendingIds.clear();
+        entry.queued = true;
+        m_retryQueue.append(key);
+    }
+    if (!m_retryTimer->isActive()) {
+        m_retryTimer->start(m_retryDelay);
+        m_retryDelay = qMin(m_retryDelay * 2, kMaxRetryDelayMs);
+    }
+}
+
+QString SyncDispatcher::filePathFor(const SyncRecord &record) const
+{
+    return m_syncRoot + QLatin1Char('/') + record.appId + QLatin1Char('/') + record.relativePath;
+}
+
+QUrl SyncDispatcher::urlFor(const SyncRecord &record) const
+{
+    return QUrl(m_baseUrl + QLatin1Char('/') + record.appId + QLatin1Char('/') + record.relativePath);
+}
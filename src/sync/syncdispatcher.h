@@ -0,0 +1,72 @@
+#ifndef SYNCDISPATCHER_H
+#define SYNCDISPATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+#include "storage/localstore.h"
+
+class DeltaUploader;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+// 同步上传调度：同步记录先写入 LocalStore 的同步日志并落盘，调度器只处理已提交的记录，
+// 上传成功后才从日志中删除，断电或崩溃后启动时重放未完成的记录即可，不需要重新扫描文件夹。
+// 同一文件的多条记录合并为一次上传；小文件和删除操作打包成批量请求（见 SyncBatch），
+// 大文件交给 DeltaUploader，最多同时上传 kMaxStreams 个。上传失败的记录保留，按退避间隔重试。
+class SyncDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // baseUrl 为同步地址，文件上传到 <baseUrl>/<应用ID>/<相对路径>
+    SyncDispatcher(LocalStore *store, DeltaUploader *uploader, const QString &syncRoot, const QString &baseUrl,
+                   QObject *parent = nullptr);
+    ~SyncDispatcher() override;
+
+    // 读取日志中未完成的记录，之后开始调度
+    void start();
+
+private:
+    struct Entry {
+        SyncRecord record;         // 最新的一条记录
+        QList<qint64> ids;         // 合并到这里的全部日志编号
+        QList<qint64> sendingIds;  // 正在上传的部分
+        bool queued = false;
+    };
+
+    void handlePending(quint64 requestId, const QList<SyncRecord> &records);
+    void enqueue(const QList<SyncRecord> &records);
+    void scheduleDispatch(int delay);
+    void dispatch();
+    void sendBatch(const QStringList &keys);
+    void handleBatchReply(QNetworkReply *reply, const QStringList &keys);
+    void handleUploadDone(quint64 uploadId, bool ok);
+    void complete(const QString &key);
+    void retry(const QStringList &keys);
+    QString filePathFor(const SyncRecord &record) const;
+    QUrl urlFor(const SyncRecord &record) const;
+
+private:
+    LocalStore *m_store;
+    DeltaUploader *m_uploader;
+    QNetworkAccessManager *m_network;
+    QString m_syncRoot;
+    QString m_baseUrl;
+    QHash<QString, Entry> m_entries;       // "<应用ID>/<相对路径>" -> 待上传的文件
+    QStringList m_queue;                   // 等待发送的文件，按到达顺序
+    QStringList m_retryQueue;              // 上传失败、等待重试的文件
+    QHash<quint64, QString> m_uploads;     // DeltaUploader 上传编号 -> 文件
+    QTimer *m_dispatchTimer;
+    QTimer *m_retryTimer;
+    quint64 m_replayRequest;
+    bool m_started;                        // 重放完成前只收集记录
+    bool m_batchSupported;                 // 服务器不支持批量请求时逐个上传
+    int m_activeBatches;
+    int m_retryDelay;                      // 当前重试间隔（毫秒），成功后复位
+};
+
+#endif // SYNCDISPATCHER_H
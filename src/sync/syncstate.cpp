@@ -0,0 +1,255 @@
+#include "syncstate.h"
+#include "synctree.h"
+#include "core/taskscheduler.h"
+#include "core/treehash.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+const int kSaveDelayMs = 2000;   // 连续修改合并保存
+
+} // namespace
+
+SyncState::SyncState(const QString &syncRoot, const QString &stateDir, QObject *parent)
+    : QObject(parent)
+    , m_syncRoot(QDir(syncRoot).absolutePath())
+    , m_stateDir(stateDir)
+    , m_saveTimer(new QTimer(this))
+{
+    QDir().mkpath(m_stateDir);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(kSaveDelayMs);
+    connect(m_saveTimer, &QTimer::timeout, this, &SyncState::save);
+}
+
+SyncState::~SyncState()
+{
+    save();
+    qDeleteAll(m_trees);
+}
+
+QString SyncState::folderFor(const QString &appId) const
+{
+    return m_syncRoot + QLatin1Char('/') + appId;
+}
+
+void SyncState::load()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const QStringList appIds = QDir(m_syncRoot).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    int files = 0;
+    for (const QString &appId : appIds) {
+        QFile file(treePath(appId));
+        if (file.open(QIODevice::ReadOnly)) {
+            if (SyncTree *tree = SyncTree::deserialize(file.readAll())) {
+                delete m_trees.value(appId);
+                m_trees.insert(appId, tree);
+                files += tree->fileCount();
+            }
+        }
+    }
+    qDebug() << "SyncState loaded" << m_trees.size() << "trees," << files << "files in" << timer.elapsed() << "ms";
+
+    for (const QString &appId : appIds) {
+        rescanApp(appId);
+    }
+}
+
+SyncTree *SyncState::tree(const QString &appId)
+{
+    SyncTree *&tree = m_trees[appId];
+    if (!tree) {
+        tree = new SyncTree;
+    }
+    return tree;
+}
+
+void SyncState::handleFileSettled(const QString &path)
+{
+    QString appId;
+    QString relativePath;
+    if (!splitPath(path, &appId, &relativePath)) return;
+
+    const QFileInfo info(path);
+    const qint64 size = info.size();
+    const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+    if (tree(appId)->isUnchanged(relativePath, size, mtime)) return;
+
+    QPointer<SyncState> guard(this);
+    TaskScheduler::instance()->start(TaskScheduler::Background, [guard, appId, relativePath, path, size, mtime]() {
+        const QByteArray hash = TreeHash::hashFile(path);
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [=]() {
+            if (guard) {
+                guard->handleHashed(appId, relativePath, path, size, mtime, hash);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SyncState::handleHashed(const QString &appId, const QString &relativePath, const QString &filePath,
+                             qint64 size, qint64 mtime, const QByteArray &hash)
+{
+    if (hash.isEmpty()) return;
+
+    SyncTree *appTree = tree(appId);
+    const bool changed = appTree->fileHash(relativePath) != hash;
+    appTree->setFile(relativePath, size, mtime, hash);
+    scheduleSave(appId);
+
+    // 只修改了时间（或保存了相同内容）时不需要上传
+    if (changed) {
+        emit fileChanged(appId, relativePath, filePath);
+    }
+}
+
+void SyncState::handleFileRemoved(const QString &path)
+{
+    QString appId;
+    QString relativePath;
+    if (!splitPath(path, &appId, &relativePath)) return;
+
+    SyncTree *appTree = tree(appId);
+    if (appTree->fileHash(relativePath).isEmpty()) return;
+    appTree->remove(relativePath);
+    scheduleSave(appId);
+    emit fileRemoved(appId, relativePath);
+}
+
+void SyncState::handleDirectoryRemoved(const QString &path)
+{
+    QString appId;
+    QString relativePath;
+    if (!splitPath(path, &appId, &relativePath)) {
+        // 整个应用文件夹被删除
+        if (QFileInfo(path).absolutePath() == m_syncRoot) {
+            rescanApp(QFileInfo(path).fileName());
+        }
+        return;
+    }
+
+    SyncTree *appTree = tree(appId);
+    const QString prefix = relativePath + QLatin1Char('/');
+    const QStringList paths = appTree->filePaths();
+    for (const QString &file : paths) {
+        if (file.startsWith(prefix)) {
+            emit fileRemoved(appId, file);
+        }
+    }
+    appTree->remove(relativePath);
+    scheduleSave(appId);
+}
+
+void SyncState::rescan(const QString &directory)
+{
+    const QString path = QDir(directory).absolutePath();
+    if (path == m_syncRoot) {
+        const QStringList appIds = QDir(m_syncRoot).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &appId : appIds) {
+            rescanApp(appId);
+        }
+        return;
+    }
+
+    const QString relative = QDir(m_syncRoot).relativeFilePath(path);
+    if (relative.startsWith(QLatin1String(".."))) return;
+    rescanApp(relative.section(QLatin1Char('/'), 0, 0));
+}
+
+void SyncState::rescanApp(const QString &appId)
+{
+    if (m_rescanning.contains(appId)) return;
+    m_rescanning.insert(appId);
+
+    // 在副本上扫描，完成后整棵替换；扫描期间到达的事件由扫描结果覆盖
+    SyncTree *copy = tree(appId)->clone();
+    const QString folder = folderFor(appId);
+    QPointer<SyncState> guard(this);
+    TaskScheduler::instance()->start(TaskScheduler::Background, [guard, appId, folder, copy]() {
+        QElapsedTimer timer;
+        timer.start();
+        QStringList changed;
+        QStringList removed;
+        copy->rescan(folder, &changed, &removed);
+        const qint64 msecs = timer.elapsed();
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, appId, copy, changed, removed, msecs]() {
+            if (!guard) {
+                delete copy;
+                return;
+            }
+            qDebug() << "SyncState rescanned" << appId << copy->fileCount() << "files in" << msecs << "ms,"
+                     << changed.size() << "changed," << removed.size() << "removed";
+            guard->m_rescanning.remove(appId);
+            delete guard->m_trees.value(appId);
+            guard->m_trees.insert(appId, copy);
+            if (!changed.isEmpty() || !removed.isEmpty()) {
+                guard->scheduleSave(appId);
+            }
+            for (const QString &path : changed) {
+                emit guard->fileChanged(appId, path, guard->folderFor(appId) + QLatin1Char('/') + path);
+            }
+            for (const QString &path : removed) {
+                emit guard->fileRemoved(appId, path);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SyncState::markPulled(const QString &appId, const QString &relativePath, const QByteArray &hash)
+{
+    const QFileInfo info(folderFor(appId) + QLatin1Char('/') + relativePath);
+    tree(appId)->setFile(relativePath, info.size(), info.lastModified().toMSecsSinceEpoch(), hash);
+    scheduleSave(appId);
+}
+
+bool SyncState::splitPath(const QString &path, QString *appId, QString *relativePath) const
+{
+    if (!path.startsWith(m_syncRoot + QLatin1Char('/'))) return false;
+    const QString relative = path.mid(m_syncRoot.size() + 1);
+    const int separator = relative.indexOf(QLatin1Char('/'));
+    if (separator <= 0) return false;
+    if (SyncTree::isIgnored(relative.section(QLatin1Char('/'), -1))) return false;
+
+    *appId = relative.left(separator);
+    *relativePath = relative.mid(separator + 1);
+    return true;
+}
+
+void SyncState::scheduleSave(const QString &appId)
+{
+    m_unsaved.insert(appId);
+    if (!m_saveTimer->isActive()) {
+        m_saveTimer->start();
+    }
+}
+
+void SyncState::save()
+{
+    for (const QString &appId : std::as_const(m_unsaved)) {
+        SyncTree *appTree = m_trees.value(appId);
+        if (!appTree) continue;
+        QSaveFile file(treePath(appId));
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(appTree->serialize());
+            file.commit();
+        }
+    }
+    m_unsaved.clear();
+}
+
+QString SyncState::treePath(const QString &appId) const
+{
+    return m_stateDir + QLatin1Char('/') + QString::fromLatin1(QUrl::toPercentEncoding(appId)) + QStringLiteral(".tree");
+}
@@ -0,0 +1,63 @@
+#ifndef SYNCSTATE_H
+#define SYNCSTATE_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+class SyncTree;
+class QTimer;
+
+// 各应用同步文件夹的本地状态：每个应用一棵 SyncTree，保存在 stateDir 中，启动时直接加载。
+// 文件夹监视的事件在这里增量更新树：大小和修改时间未变的文件直接忽略，
+// 其余文件在线程池中计算哈希，内容确实变化时才发出 fileChanged（触发上传）。
+class SyncState : public QObject
+{
+    Q_OBJECT
+
+public:
+    SyncState(const QString &syncRoot, const QString &stateDir, QObject *parent = nullptr);
+    ~SyncState() override;
+
+    QString syncRoot() const { return m_syncRoot; }
+    QString folderFor(const QString &appId) const;
+
+    // 加载保存的树，并在后台与磁盘对比一次（补上程序未运行期间的修改）
+    void load();
+
+    // 应用的树，不存在时创建空树；返回的指针在下一次重新扫描完成后失效
+    SyncTree *tree(const QString &appId);
+
+    // 文件夹监视事件
+    void handleFileSettled(const QString &path);
+    void handleFileRemoved(const QString &path);
+    void handleDirectoryRemoved(const QString &path);
+    // directory 为同步根目录时重新扫描全部应用
+    void rescan(const QString &directory);
+
+    // 从服务器拉取的文件已写入，直接记入树中，之后的监视事件不会再上传它
+    void markPulled(const QString &appId, const QString &relativePath, const QByteArray &hash);
+
+signals:
+    void fileChanged(const QString &appId, const QString &relativePath, const QString &filePath);
+    void fileRemoved(const QString &appId, const QString &relativePath);
+
+private:
+    bool splitPath(const QString &path, QString *appId, QString *relativePath) const;
+    void rescanApp(const QString &appId);
+    void handleHashed(const QString &appId, const QString &relativePath, const QString &filePath,
+                      qint64 size, qint64 mtime, const QByteArray &hash);
+    void scheduleSave(const QString &appId);
+    void save();
+    QString treePath(const QString &appId) const;
+
+private:
+    QString m_syncRoot;
+    QString m_stateDir;
+    QHash<QString, SyncTree *> m_trees;
+    QSet<QString> m_rescanning;     // 正在后台重新扫描的应用
+    QSet<QString> m_unsaved;        // 有修改尚未保存的应用
+    QTimer *m_saveTimer;
+};
+
+#endif // SYNCSTATE_H
@@ -0,0 +1,347 @@
+#include "synctree.h"
+#include "core/sha256.h"
+#include "core/treehash.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QMap>
+#include <QSet>
+
+namespace {
+
+const quint32 kMagic = 0x41475354;   // "AGST"
+const quint32 kVersion = 1;
+
+} // namespace
+
+struct SyncTree::Node
+{
+    bool directory = true;
+    bool dirty = true;      // 目录哈希需要重新计算
+    qint64 size = 0;
+    qint64 mtime = 0;
+    QByteArray hash;
+    QMap<QString, Node *> children;   // 按名称排序，保证目录哈希与遍历顺序无关
+
+    ~Node() { qDeleteAll(children); }
+
+    Node *clone() const
+    {
+        Node *copy = new Node;
+        copy->directory = directory;
+        copy->dirty = dirty;
+        copy->size = size;
+        copy->mtime = mtime;
+        copy->hash = hash;
+        for (auto it = children.constBegin(); it != children.constEnd(); ++it) {
+            copy->children.insert(it.key(), it.value()->clone());
+        }
+        return copy;
+    }
+
+    int fileCount() const
+    {
+        if (!directory) return 1;
+        int count = 0;
+        for (const Node *child : children) {
+            count += child->fileCount();
+        }
+        return count;
+    }
+};
+
+SyncTree::SyncTree()
+    : m_root(new Node)
+    , m_fileCount(0)
+{
+}
+
+SyncTree::~SyncTree()
+{
+    delete m_root;
+}
+
+SyncTree *SyncTree::clone() const
+{
+    SyncTree *copy = new SyncTree;
+    delete copy->m_root;
+    copy->m_root = m_root->clone();
+    copy->m_fileCount = m_fileCount;
+    return copy;
+}
+
+void SyncTree::setFile(const QString &path, qint64 size, qint64 mtime, const QByteArray &hash)
+{
+    const QStringList parts = path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    if (parts.isEmpty()) return;
+
+    Node *node = m_root;
+    node->dirty = true;
+    for (int i = 0; i < parts.size() - 1; ++i) {
+        Node *&child = node->children[parts.at(i)];
+        if (child && !child->directory) {
+            // 原来的同名文件被目录取代
+            delete child;
+            child = nullptr;
+            --m_fileCount;
+        }
+        if (!child) {
+            child = new Node;
+        }
+        node = child;
+        node->dirty = true;
+    }
+
+    Node *&leaf = node->children[parts.last()];
+    if (leaf && leaf->directory) {
+        m_fileCount -= leaf->fileCount();
+        delete leaf;
+        leaf = nullptr;
+    }
+    if (!leaf) {
+        leaf = new Node;
+        leaf->directory = false;
+        ++m_fileCount;
+    }
+    leaf->dirty = false;
+    leaf->size = size;
+    leaf->mtime = mtime;
+    leaf->hash = hash;
+}
+
+void SyncTree::remove(const QString &path)
+{
+    const QStringList parts = path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    if (parts.isEmpty()) return;
+
+    QList<Node *> ancestors{m_root};
+    for (int i = 0; i < parts.size() - 1; ++i) {
+        Node *child = ancestors.last()->children.value(parts.at(i));
+        if (!child || !child->directory) return;
+        ancestors.append(child);
+    }
+
+    Node *target = ancestors.last()->children.take(parts.last());
+    if (!target) return;
+    m_fileCount -= target->fileCount();
+    delete target;
+
+    // 上级目录都需要重新计算哈希；从下往上清理变空的目录
+    for (Node *node : std::as_const(ancestors)) {
+        node->dirty = true;
+    }
+    for (int i = ancestors.size() - 1; i > 0 && ancestors.at(i)->children.isEmpty(); --i) {
+        delete ancestors.at(i - 1)->children.take(parts.at(i - 1));
+    }
+}
+
+bool SyncTree::isUnchanged(const QString &path, qint64 size, qint64 mtime) const
+{
+    const Node *node = find(path);
+    return node && !node->directory && node->size == size && node->mtime == mtime;
+}
+
+QByteArray SyncTree::fileHash(const QString &path) const
+{
+    const Node *node = find(path);
+    return node && !node->directory ? node->hash : QByteArray();
+}
+
+QStringList SyncTree::filePaths() const
+{
+    QStringList paths;
+    paths.reserve(m_fileCount);
+
+    QList<QPair<QString, const Node *>> stack{qMakePair(QString(), static_cast<const Node *>(m_root))};
+    while (!stack.isEmpty()) {
+        const auto [prefix, node] = stack.takeLast();
+        for (auto it = node->children.constBegin(); it != node->children.constEnd(); ++it) {
+            const QString path = prefix.isEmpty() ? it.key() : prefix + QLatin1Char('/') + it.key();
+            if (it.value()->directory) {
+                stack.append(qMakePair(path, static_cast<const Node *>(it.value())));
+            } else {
+                paths.append(path);
+            }
+        }
+    }
+    return paths;
+}
+
+QByteArray SyncTree::hash(const QString &directory)
+{
+    Node *node = find(directory);
+    if (!node || !node->directory) return QByteArray();
+    computeHash(node);
+    return node->hash;
+}
+
+bool SyncTree::children(const QString &directory, QList<Entry> *entries)
+{
+    Node *node = find(directory);
+    if (!node || !node->directory) return false;
+    computeHash(node);
+
+    entries->clear();
+    entries->reserve(node->children.size());
+    for (auto it = node->children.constBegin(); it != node->children.constEnd(); ++it) {
+        Entry entry;
+        entry.name = it.key();
+        entry.directory = it.value()->directory;
+        entry.hash = it.value()->hash;
+        entries->append(entry);
+    }
+    return true;
+}
+
+void SyncTree::rescan(const QString &rootPath, QStringList *changed, QStringList *removed)
+{
+    QSet<QString> seen;
+    seen.reserve(m_fileCount);
+
+    const int prefix = rootPath.size() + 1;
+    QDirIterator it(rootPath, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (isIgnored(info.fileName())) continue;
+
+        const QString path = filePath.mid(prefix);
+        const qint64 size = info.size();
+        const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+        seen.insert(path);
+        if (isUnchanged(path, size, mtime)) continue;
+
+        const QByteArray hash = TreeHash::hashFile(filePath);
+        if (hash.isEmpty()) continue;
+        if (changed && hash != fileHash(path)) {
+            changed->append(path);
+        }
+        setFile(path, size, mtime, hash);
+    }
+
+    if (seen.size() == m_fileCount) return;
+    const QStringList paths = filePaths();
+    for (const QString &path : paths) {
+        if (!seen.contains(path)) {
+            remove(path);
+            if (removed) {
+                removed->append(path);
+            }
+        }
+    }
+}
+
+bool SyncTree::isIgnored(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(".part")) || fileName.endsWith(QLatin1String(".part.json"));
+}
+
+SyncTree::Node *SyncTree::find(const QString &path) const
+{
+    Node *node = m_root;
+    const QStringList parts = path.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        if (!node->directory) return nullptr;
+        node = node->children.value(part);
+        if (!node) return nullptr;
+    }
+    return node;
+}
+
+void SyncTree::computeHash(Node *node)
+{
+    if (!node->directory || !node->dirty) return;
+
+    Sha256 sha;
+    for (auto it = node->children.constBegin(); it != node->children.constEnd(); ++it) {
+        Node *child = it.value();
+        computeHash(child);
+        sha.addData(child->directory ? "d" : "f", 1);
+        sha.addData(it.key().toUtf8());
+        sha.addData("", 1);
+        sha.addData(child->hash);
+    }
+    node->hash = sha.result();
+    node->dirty = false;
+}
+
+QByteArray SyncTree::serialize()
+{
+    computeHash(m_root);
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream << kMagic << kVersion << qint32(m_fileCount);
+
+    // 先序遍历写出全部节点（含目录哈希），加载时不需要重新计算
+    QList<const Node *> stack{m_root};
+    QList<QString> names{QString()};
+    while (!stack.isEmpty()) {
+        const Node *node = stack.takeLast();
+        const QString name = names.takeLast();
+        stream << name << node->directory << node->hash;
+        if (node->directory) {
+            stream << qint32(node->children.size());
+            // 逆序压栈，出栈时按名称顺序
+            for (auto it = node->children.constEnd(); it != node->children.constBegin();) {
+                --it;
+                stack.append(it.value());
+                names.append(it.key());
+            }
+        } else {
+            stream << node->size << node->mtime;
+        }
+    }
+    return data;
+}
+
+SyncTree *SyncTree::deserialize(const QByteArray &data)
+{
+    QDataStream stream(data);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 fileCount = 0;
+    stream >> magic >> version >> fileCount;
+    if (magic != kMagic || version != kVersion) return nullptr;
+
+    SyncTree *tree = new SyncTree;
+    // 每个目录记录还剩多少子项没有读入
+    QList<QPair<Node *, qint32>> parents;
+    bool ok = true;
+    do {
+        QString name;
+        bool directory = false;
+        QByteArray hash;
+        stream >> name >> directory >> hash;
+
+        Node *node = parents.isEmpty() ? tree->m_root : new Node;
+        node->directory = directory;
+        node->dirty = false;
+        node->hash = hash;
+        if (!parents.isEmpty()) {
+            parents.last().first->children.insert(name, node);
+            --parents.last().second;
+        }
+
+        if (directory) {
+            qint32 count = 0;
+            stream >> count;
+            parents.append(qMakePair(node, count));
+        } else {
+            stream >> node->size >> node->mtime;
+        }
+        while (!parents.isEmpty() && parents.last().second == 0) {
+            parents.removeLast();
+        }
+        ok = stream.status() == QDataStream::Ok;
+    } while (ok && !parents.isEmpty());
+
+    if (!ok) {
+        delete tree;
+        return nullptr;
+    }
+    tree->m_fileCount = tree->m_root->fileCount();
+    return tree;
+}
@@ -0,0 +1,66 @@
+#ifndef SYNCTREE_H
+#define SYNCTREE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+// 同步文件夹的 Merkle 树：叶子是文件内容的树哈希（见 TreeHash），
+// 目录哈希 = SHA-256(按名称排序的子项类型、名称和哈希)。
+// 两边的根哈希相同即说明整个文件夹一致，不同时只需要逐层比较哈希不同的子目录。
+// 叶子同时记录大小和修改时间，本地重新扫描时两者未变的文件不再计算哈希。
+// 只有文件会创建目录节点，空目录不参与比较。
+class SyncTree
+{
+public:
+    struct Entry
+    {
+        QString name;
+        bool directory = false;
+        QByteArray hash;
+    };
+
+    SyncTree();
+    ~SyncTree();
+
+    SyncTree *clone() const;
+
+    // 路径均为相对文件夹的路径，以 / 分隔
+    void setFile(const QString &path, qint64 size, qint64 mtime, const QByteArray &hash);
+    // 删除文件或整个目录，并清理因此变空的上级目录
+    void remove(const QString &path);
+
+    bool isUnchanged(const QString &path, qint64 size, qint64 mtime) const;
+    QByteArray fileHash(const QString &path) const;
+    QStringList filePaths() const;
+    int fileCount() const { return m_fileCount; }
+
+    // 目录哈希，只重新计算发生过变化的目录；不是目录时返回空
+    QByteArray hash(const QString &directory = QString());
+    // 目录的直接子项，不是目录时返回 false
+    bool children(const QString &directory, QList<Entry> *entries);
+
+    // 与磁盘上的文件夹对比，只为大小或修改时间变化的文件重新计算哈希
+    void rescan(const QString &rootPath, QStringList *changed = nullptr, QStringList *removed = nullptr);
+
+    // 下载中的临时文件等不参与同步
+    static bool isIgnored(const QString &fileName);
+
+    QByteArray serialize();
+    static SyncTree *deserialize(const QByteArray &data);
+
+private:
+    struct Node;
+
+    Node *find(const QString &path) const;
+    static void computeHash(Node *node);
+
+private:
+    Node *m_root;
+    int m_fileCount;
+
+    Q_DISABLE_COPY(SyncTree)
+};
+
+#endif // SYNCTREE_H
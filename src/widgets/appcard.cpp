@@ -1,71 +1,87 @@
 #include "appcard.h"
-#include <QVBoxLayout>
-#include <QHBoxLayout>
+#include "core/iconservice.h"
+#include <QPainter>
 #include <QPixmap>
 #include <QEvent>
 #include <QMouseEvent>
 
 AppCard::AppCard(QWidget *parent)
     : QWidget(parent)
-    , m_iconLabel(new QLabel(this))
-    , m_nameLabel(new QLabel(this))
-    , m_descLabel(new QLabel(this))
-    , m_actionBtn(new QPushButton(this))
-    , m_isInstalled(false)
     , m_isHovered(false)
     , m_isPressed(false)
+    , m_isButtonHovered(false)
+    , m_isButtonPressed(false)
+    , m_iconLoaded(false)
 {
     setupUI();
-    updateStyle();
-    
+
     // 设置鼠标追踪，以便实现悬停效果
     setMouseTracking(true);
-    
+
     // 设置焦点策略，使卡片可以接收焦点
     setFocusPolicy(Qt::StrongFocus);
 }
 
-AppCard::~AppCard() = default;
+AppCard::~AppCard()
+{
+    cancelIconRequest();
+}
 
 void AppCard::setAppName(const QString &name)
 {
-    m_nameLabel->setText(name);
+    m_content.name = name;
+    update();
 }
 
 void AppCard::setAppDescription(const QString &description)
 {
-    m_descLabel->setText(description);
+    m_content.description = description;
+    update();
 }
 
 void AppCard::setAppIcon(const QString &iconPath)
 {
-    QPixmap pixmap(iconPath);
-    if (!pixmap.isNull()) {
-        pixmap = pixmap.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        m_iconLabel->setPixmap(pixmap);
+    if (iconPath == m_iconPath) return;
+
+    cancelIconRequest();
+    m_iconPath = iconPath;
+
+    // 已缓存的图标直接显示，否则先显示占位图，可见时再异步加载
+    const QPixmap cached = IconService::instance()->cachedIcon(iconPath);
+    m_content.icon = cached.isNull() ? IconService::placeholder() : cached;
+    m_iconLoaded = !cached.isNull();
+    update();
+
+    if (isVisible()) {
+        requestIcon();
     }
 }
 
 void AppCard::setInstalled(bool installed)
 {
-    m_isInstalled = installed;
-    m_actionBtn->setText(installed ? "启动" : "安装");
-    
-    // 更新按钮点击信号连接
-    disconnect(m_actionBtn, &QPushButton::clicked, this, nullptr);
-    if (installed) {
-        connect(m_actionBtn, &QPushButton::clicked, this, &AppCard::startClicked);
-    } else {
-        connect(m_actionBtn, &QPushButton::clicked, this, &AppCard::installClicked);
-    }
-    
-    updateStyle();
+    m_content.installed = installed;
+    update();
+}
+
+void AppCard::setPackage(const QString &url, const QString &hash)
+{
+    m_packageUrl = url;
+    m_packageHash = hash;
+}
+
+void AppCard::setProgress(int percent)
+{
+    // 进度由下载模块节流后上报，数值不变时不重绘
+    if (percent == m_content.progress) return;
+    m_content.progress = percent;
+    update();
 }
 
 void AppCard::enterEvent(QEnterEvent *event)
 {
     m_isHovered = true;
-    updateStyle();
+    m_isButtonHovered = AppCardPainter::buttonRect(rect()).contains(event->position().toPoint());
+    update();
     QWidget::enterEvent(event);
 }
 
@@ -73,7 +89,9 @@ void AppCard::leaveEvent(QEvent *event)
 {
     m_isHovered = false;
     m_isPressed = false;
-    updateStyle();
+    m_isButtonHovered = false;
+    m_isButtonPressed = false;
+    update();
     QWidget::leaveEvent(event);
 }
 
@@ -81,101 +99,127 @@ void AppCard::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
         m_isPressed = true;
-        updateStyle();
+        m_isButtonPressed = AppCardPainter::buttonRect(rect()).contains(event->position().toPoint());
+        update();
     }
     QWidget::mousePressEvent(event);
 }
 
+void AppCard::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && m_isPressed) {
+        const bool onButton = AppCardPainter::buttonRect(rect()).contains(event->position().toPoint());
+        const bool buttonPressed = m_isButtonPressed;
+        m_isPressed = false;
+        m_isButtonPressed = false;
+        update();
+
+        if (buttonPressed && onButton) {
+            // 按钮根据安装状态发出启动或安装信号，安装进行中时不响应
+            if (m_content.installed) {
+                emit startClicked();
+            } else if (m_content.progress < 0) {
+                emit installClicked();
+            }
+        } else if (!buttonPressed && rect().contains(event->position().toPoint())) {
+            emit cardClicked();
+        }
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void AppCard::mouseMoveEvent(QMouseEvent *event)
+{
+    // 只有按钮悬停状态变化时才重绘
+    const bool onButton = AppCardPainter::buttonRect(rect()).contains(event->position().toPoint());
+    if (onButton != m_isButtonHovered) {
+        m_isButtonHovered = onButton;
+        update(AppCardPainter::buttonRect(rect()));
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
 void AppCard::mouseDoubleClickEvent(QMouseEvent *event)
 {
-    if (event->button() == Qt::LeftButton) {
+    if (event->button() == Qt::LeftButton
+        && !AppCardPainter::buttonRect(rect()).contains(event->position().toPoint())) {
         emit cardDoubleClicked();
         // 如果已安装，双击时启动应用
-        if (m_isInstalled) {
+        if (m_content.installed) {
             emit startClicked();
         }
     }
     QWidget::mouseDoubleClickEvent(event);
 }
 
+void AppCard::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    AppCardPainter::paint(&painter, rect(), m_content, currentState(),
+                          m_isButtonHovered, font(), palette().color(QPalette::WindowText));
+}
+
+void AppCard::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    requestIcon();
+}
+
+void AppCard::hideEvent(QHideEvent *event)
+{
+    // 翻页或切换页签后不再可见，取消尚未完成的图标加载
+    cancelIconRequest();
+    QWidget::hideEvent(event);
+}
+
 void AppCard::setupUI()
 {
     // 设置固定大小
-    setFixedSize(280, 100);
-    
-    // 创建布局
-    QHBoxLayout *mainLayout = new QHBoxLayout(this);
-    mainLayout->setContentsMargins(12, 12, 12, 12);
-    mainLayout->setSpacing(12);
-    
-    // 添加图标
-    m_iconLabel->setFixedSize(48, 48);
-    mainLayout->addWidget(m_iconLabel);
-    
-    // 创建中间的文本布局
-    QVBoxLayout *textLayout = new QVBoxLayout();
-    textLayout->setSpacing(4);
-    
-    // 设置名称标签
-    QFont nameFont = m_nameLabel->font();
-    nameFont.setPointSize(12);
-    nameFont.setBold(true);
-    m_nameLabel->setFont(nameFont);
-    textLayout->addWidget(m_nameLabel);
-    
-    // 设置描述标签
-    m_descLabel->setWordWrap(true);
-    QFont descFont = m_descLabel->font();
-    descFont.setPointSize(10);
-    m_descLabel->setFont(descFont);
-    textLayout->addWidget(m_descLabel);
-    
-    mainLayout->addLayout(textLayout, 1);
-    
-    // 添加操作按钮
-    m_actionBtn->setFixedSize(80, 32);
-    mainLayout->addWidget(m_actionBtn);
-    
+    setFixedSize(AppCardPainter::cardSize());
+
     // 设置默认文本
-    m_nameLabel->setText("应用名称");
-    m_descLabel->setText("应用描述");
-    m_actionBtn->setText("安装");
-    
-    // 设置按钮不参与卡片的点击事件
-    m_actionBtn->setFocusPolicy(Qt::NoFocus);
-    m_actionBtn->setCursor(Qt::PointingHandCursor);
-}
-
-void AppCard::updateStyle()
-{
-    QString cardStyle = QString(
-        "QWidget {"
-        "  background-color: %1;"
-        "  border: 1px solid %2;"
-        "  border-radius: 8px;"
-        "}"
-        "QLabel {"
-        "  background: transparent;"
-        "  border: none;"
-        "}"
-        "QPushButton {"
-        "  background-color: %3;"
-        "  color: white;"
-        "  border: none;"
-        "  border-radius: 4px;"
-        "  padding: 4px 12px;"
-        "}"
-        "QPushButton:hover {"
-        "  background-color: %4;"
-        "}"
-    )
-    .arg(m_isPressed ? "#e8e8e8" : (m_isHovered ? "#f5f5f5" : "#ffffff"))
-    .arg(m_isHovered ? "#e0e0e0" : "#f0f0f0")
-    .arg(m_isInstalled ? "#28a745" : "#007AFF")
-    .arg(m_isInstalled ? "#218838" : "#0056b3");
-    
-    setStyleSheet(cardStyle);
-    
-    // 设置鼠标样式
-    setCursor(m_isHovered ? Qt::PointingHandCursor : Qt::ArrowCursor);
-} 
\ No newline at end of file
+    m_content.name = "应用名称";
+    m_content.description = "应用描述";
+    m_content.installed = false;
+
+    // 整张卡片都可以点击
+    setCursor(Qt::PointingHandCursor);
+}
+
+AppCardPainter::State AppCard::currentState() const
+{
+    if (m_isPressed) return AppCardPainter::Pressed;
+    if (m_isHovered) return AppCardPainter::Hovered;
+    return AppCardPainter::Normal;
+}
+
+void AppCard::requestIcon()
+{
+    if (m_iconPath.isEmpty() || m_iconLoaded || m_iconConnection) return;
+
+    IconService *service = IconService::instance();
+    m_iconConnection = connect(service, &IconService::iconReady, this,
+                               [this](const QString &iconPath, const QPixmap &pixmap) {
+        if (iconPath != m_iconPath) return;
+
+        disconnect(m_iconConnection);
+        m_iconConnection = QMetaObject::Connection();
+        m_iconLoaded = true;
+        if (!pixmap.isNull()) {
+            m_content.icon = pixmap;
+            update(AppCardPainter::iconRect(rect()));
+        }
+    });
+    service->request(m_iconPath);
+}
+
+void AppCard::cancelIconRequest()
+{
+    if (!m_iconConnection) return;
+
+    disconnect(m_iconConnection);
+    m_iconConnection = QMetaObject::Connection();
+    IconService::instance()->cancel(m_iconPath);
+}
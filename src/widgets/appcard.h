@@ -2,9 +2,9 @@
 #define APPCARD_H
 
 #include <QWidget>
-#include <QLabel>
-#include <QPushButton>
+#include <QPixmap>
 #include <QEnterEvent>
+#include "appcardpainter.h"
 
 class AppCard : public QWidget
 {
@@ -15,14 +15,22 @@ public:
     ~AppCard() override;
 
     // 设置应用信息
+    void setAppId(const QString &appId) { m_appId = appId; }
     void setAppName(const QString &name);
     void setAppDescription(const QString &description);
     void setAppIcon(const QString &iconPath);
     void setInstalled(bool installed);
+    void setPackage(const QString &url, const QString &hash);
+    // 设置下载/安装进度（0-100），-1 隐藏进度
+    void setProgress(int percent);
     
     // 获取应用信息
-    QString appName() const { return m_nameLabel->text(); }
-    bool isInstalled() const { return m_isInstalled; }
+    QString appId() const { return m_appId; }
+    QString appName() const { return m_content.name; }
+    QString packageUrl() const { return m_packageUrl; }
+    QString packageHash() const { return m_packageHash; }
+    bool isInstalled() const { return m_content.installed; }
+    int progress() const { return m_content.progress; }
 
 signals:
     void installClicked();
@@ -35,21 +43,32 @@ protected:
     void enterEvent(QEnterEvent *event) override;
     void leaveEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
     void setupUI();
-    void updateStyle();
+    AppCardPainter::State currentState() const;
+    void requestIcon();
+    void cancelIconRequest();
 
 private:
-    QLabel *m_iconLabel;      // 应用图标
-    QLabel *m_nameLabel;      // 应用名称
-    QLabel *m_descLabel;      // 应用描述
-    QPushButton *m_actionBtn; // 操作按钮（安装/卸载/启动）
+    AppCardPainter::Content m_content;  // 名称、描述、图标和安装状态
+    QString m_appId;                    // 应用唯一标识
+    QString m_packageUrl;               // 安装包下载地址
+    QString m_packageHash;              // 安装包树哈希
+    QString m_iconPath;                 // 图标路径
+    QMetaObject::Connection m_iconConnection;  // 等待图标加载时的连接
     
-    bool m_isInstalled;       // 是否已安装
     bool m_isHovered;         // 是否鼠标悬停
     bool m_isPressed;         // 是否被按下
+    bool m_isButtonHovered;   // 鼠标是否悬停在操作按钮上
+    bool m_isButtonPressed;   // 是否在操作按钮上按下
+    bool m_iconLoaded;        // 图标是否已加载完成
 };
 
 #endif // APPCARD_H 
\ No newline at end of file
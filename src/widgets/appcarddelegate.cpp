@@ -0,0 +1,169 @@
+#include "appcarddelegate.h"
+#include "models/applistmodel.h"
+#include "appcardpainter.h"
+#include "core/iconservice.h"
+#include <QMouseEvent>
+
+namespace {
+
+const qint64 kIconRetryMs = 30 * 1000;          // 首次失败后的退避时间
+const qint64 kMaxIconRetryMs = 30 * 60 * 1000;  // 退避时间上限
+
+} // namespace
+
+AppCardDelegate::AppCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_pressedOnButton(false)
+{
+    m_clock.start();
+    connect(IconService::instance(), &IconService::iconReady,
+            this, &AppCardDelegate::handleIconReady);
+}
+
+AppCardDelegate::~AppCardDelegate()
+{
+    cancelIconRequests();
+}
+
+void AppCardDelegate::cancelIconRequests()
+{
+    IconService *service = IconService::instance();
+    for (const QString &iconPath : std::as_const(m_requestedIcons)) {
+        service->cancel(iconPath);
+    }
+    m_requestedIcons.clear();
+}
+
+void AppCardDelegate::clearFailedIcons()
+{
+    m_failedIcons.clear();
+}
+
+void AppCardDelegate::setProgress(const QString &appId, int percent)
+{
+    if (percent < 0) {
+        m_progress.remove(appId);
+    } else {
+        m_progress.insert(appId, percent);
+    }
+}
+
+void AppCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                            const QModelIndex &index) const
+{
+    const bool hovered = option.state & QStyle::State_MouseOver;
+    const bool pressed = hovered && m_pressedIndex.isValid() && m_pressedIndex == index;
+
+    AppCardPainter::Content content;
+    content.name = index.data(AppListModel::NameRole).toString();
+    content.description = index.data(AppListModel::DescriptionRole).toString();
+    content.installed = index.data(AppListModel::InstalledRole).toBool();
+    if (!m_progress.isEmpty()) {
+        content.progress = progress(index.data(AppListModel::AppIdRole).toString());
+    }
+
+    // 图标：只为正在绘制的卡片请求，未加载完成前显示占位图
+    const QString iconPath = index.data(AppListModel::IconPathRole).toString();
+    if (!iconPath.isEmpty()) {
+        IconService *service = IconService::instance();
+        content.icon = service->cachedIcon(iconPath);
+        if (content.icon.isNull()) {
+            // 目录快照中带有缩略图时直接使用，不必等待解码
+            const QByteArray thumbnail = index.data(AppListModel::ThumbnailRole).toByteArray();
+            if (!thumbnail.isEmpty()) {
+                content.icon = service->addThumbnail(iconPath, thumbnail);
+            }
+        }
+        if (content.icon.isNull()) {
+            content.icon = IconService::placeholder();
+            // 加载失败的图标（文件缺失、损坏）在退避时间内不再请求，否则每次重绘都会重新下载和解码
+            const auto failed = m_failedIcons.constFind(iconPath);
+            const bool backingOff = failed != m_failedIcons.constEnd() && m_clock.elapsed() < failed->retryAt;
+            if (!m_requestedIcons.contains(iconPath) && !backingOff) {
+                m_requestedIcons.insert(iconPath);
+                service->request(iconPath);
+            }
+        }
+    }
+
+    AppCardPainter::paint(painter, option.rect, content,
+                          pressed ? AppCardPainter::Pressed
+                                  : (hovered ? AppCardPainter::Hovered : AppCardPainter::Normal),
+                          false, option.font, option.palette.color(QPalette::WindowText));
+}
+
+QSize AppCardDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+    return AppCardPainter::cardSize();
+}
+
+bool AppCardDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                  const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    switch (event->type()) {
+    case QEvent::MouseButtonPress: {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() != Qt::LeftButton) break;
+        m_pressedIndex = index;
+        m_pressedOnButton = AppCardPainter::buttonRect(option.rect).contains(mouseEvent->position().toPoint());
+        return false;
+    }
+    case QEvent::MouseButtonRelease: {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() != Qt::LeftButton) break;
+
+        const bool samePressed = m_pressedIndex.isValid() && m_pressedIndex == index;
+        const bool onButton = AppCardPainter::buttonRect(option.rect).contains(mouseEvent->position().toPoint());
+        const bool pressedOnButton = m_pressedOnButton;
+        m_pressedIndex = QPersistentModelIndex();
+        m_pressedOnButton = false;
+        if (!samePressed) break;
+
+        if (pressedOnButton && onButton) {
+            // 安装进行中时不响应
+            if (index.data(AppListModel::InstalledRole).toBool()) {
+                emit startClicked(index);
+            } else if (progress(index.data(AppListModel::AppIdRole).toString()) < 0) {
+                emit installClicked(index);
+            }
+        } else if (!pressedOnButton) {
+            emit cardClicked(index);
+        }
+        return true;
+    }
+    case QEvent::MouseButtonDblClick: {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() != Qt::LeftButton) break;
+        if (AppCardPainter::buttonRect(option.rect).contains(mouseEvent->position().toPoint())) break;
+
+        emit cardDoubleClicked(index);
+        // 如果已安装，双击时启动应用
+        if (index.data(AppListModel::InstalledRole).toBool()) {
+            emit startClicked(index);
+        }
+        return true;
+    }
+    default:
+        break;
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+void AppCardDelegate::handleIconReady(const QString &iconPath, const QPixmap &pixmap)
+{
+    if (!m_requestedIcons.remove(iconPath)) return;
+
+    if (pixmap.isNull()) {
+        // 已绘制的是占位图，不需要重绘
+        FailedIcon &failed = m_failedIcons[iconPath];
+        const qint64 delay = qMin(kIconRetryMs << qMin(failed.failures, 6), kMaxIconRetryMs);
+        failed.retryAt = m_clock.elapsed() + delay;
+        ++failed.failures;
+        return;
+    }
+    m_failedIcons.remove(iconPath);
+    emit iconLoaded(iconPath);
+}
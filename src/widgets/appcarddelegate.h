@@ -0,0 +1,64 @@
+#ifndef APPCARDDELEGATE_H
+#define APPCARDDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QPixmap>
+#include <QSet>
+
+// 应用卡片委托：直接绘制卡片并对操作按钮做命中测试，
+// 视图只为屏幕上可见的行调用绘制，不创建任何子控件
+class AppCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit AppCardDelegate(QObject *parent = nullptr);
+    ~AppCardDelegate() override;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    // 取消当前页尚未完成的图标加载（翻页时调用）
+    void cancelIconRequests();
+    // 清除图标加载失败的记录，下次绘制时重新请求（目录整体重新加载时调用）
+    void clearFailedIcons();
+
+    // 安装进度（0-100）按应用ID保存，-1 表示结束；只影响绘制，不修改模型
+    void setProgress(const QString &appId, int percent);
+    int progress(const QString &appId) const { return m_progress.value(appId, -1); }
+
+signals:
+    void cardClicked(const QModelIndex &index);
+    void cardDoubleClicked(const QModelIndex &index);
+    void installClicked(const QModelIndex &index);
+    void startClicked(const QModelIndex &index);
+    // 已请求的图标加载成功，视图需要重绘（加载失败时不发出）
+    void iconLoaded(const QString &iconPath);
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option, const QModelIndex &index) override;
+
+private slots:
+    void handleIconReady(const QString &iconPath, const QPixmap &pixmap);
+
+private:
+    // 加载失败的图标在退避时间内显示占位图且不再请求，之后绘制时重试，连续失败时退避时间加倍
+    struct FailedIcon {
+        qint64 retryAt = 0;  // m_clock 的毫秒数
+        int failures = 0;
+    };
+
+    QPersistentModelIndex m_pressedIndex;  // 当前被按下的卡片
+    bool m_pressedOnButton;                // 是否在按钮上按下
+    mutable QSet<QString> m_requestedIcons; // 已请求但尚未完成的图标
+    QHash<QString, FailedIcon> m_failedIcons; // 加载失败的图标，成功加载或清除后删除
+    QElapsedTimer m_clock;                  // 失败重试的计时
+    QHash<QString, int> m_progress;         // 进行中的安装：应用ID -> 进度
+};
+
+#endif // APPCARDDELEGATE_H
@@ -0,0 +1,125 @@
+#include "appcardpainter.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QFontMetrics>
+
+namespace {
+
+const int kMargin = 12;        // 卡片内边距
+const int kSpacing = 12;       // 图标、文本、按钮之间的间距
+const int kIconSize = 48;      // 图标尺寸
+const QSize kButtonSize(80, 32);
+
+struct PaletteTable {
+    AppCardPainter::Palette palettes[2][AppCardPainter::StateCount];
+
+    PaletteTable()
+    {
+        for (int installed = 0; installed < 2; ++installed) {
+            for (int state = 0; state < AppCardPainter::StateCount; ++state) {
+                AppCardPainter::Palette &p = palettes[installed][state];
+                p.background = QColor(state == AppCardPainter::Pressed ? "#e8e8e8"
+                                      : (state == AppCardPainter::Hovered ? "#f5f5f5" : "#ffffff"));
+                p.border = QColor(state == AppCardPainter::Normal ? "#f0f0f0" : "#e0e0e0");
+                p.button = QColor(installed ? "#28a745" : "#007AFF");
+                p.buttonHover = QColor(installed ? "#218838" : "#0056b3");
+                p.buttonText = QColor(Qt::white);
+            }
+        }
+    }
+};
+
+} // namespace
+
+const AppCardPainter::Palette &AppCardPainter::palette(State state, bool installed)
+{
+    static const PaletteTable table;
+    return table.palettes[installed ? 1 : 0][state];
+}
+
+QRect AppCardPainter::iconRect(const QRect &cardRect)
+{
+    return QRect(cardRect.left() + kMargin, cardRect.center().y() - kIconSize / 2,
+                 kIconSize, kIconSize);
+}
+
+QRect AppCardPainter::buttonRect(const QRect &cardRect)
+{
+    return QRect(cardRect.right() - kMargin - kButtonSize.width() + 1,
+                 cardRect.center().y() - kButtonSize.height() / 2,
+                 kButtonSize.width(), kButtonSize.height());
+}
+
+void AppCardPainter::paint(QPainter *painter, const QRect &cardRect, const Content &content,
+                           State state, bool buttonHovered, const QFont &baseFont,
+                           const QColor &textColor)
+{
+    const Palette &colors = palette(state, content.installed);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    // 卡片背景与边框
+    QPainterPath cardPath;
+    cardPath.addRoundedRect(QRectF(cardRect).adjusted(0.5, 0.5, -0.5, -0.5), 8, 8);
+    painter->setPen(colors.border);
+    painter->setBrush(colors.background);
+    painter->drawPath(cardPath);
+
+    // 图标居中绘制在图标区域内
+    const QRect icon = iconRect(cardRect);
+    if (!content.icon.isNull()) {
+        QRect target(QPoint(0, 0), content.icon.deviceIndependentSize().toSize());
+        target.moveCenter(icon.center());
+        painter->drawPixmap(target, content.icon);
+    }
+
+    // 操作按钮
+    const QRect button = buttonRect(cardRect);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(buttonHovered ? colors.buttonHover : colors.button);
+    painter->drawRoundedRect(button, 4, 4);
+    painter->setPen(colors.buttonText);
+    painter->setFont(baseFont);
+    const bool busy = content.progress >= 0;
+    painter->drawText(button, Qt::AlignCenter,
+                      busy ? QStringLiteral("%1%").arg(content.progress)
+                           : (content.installed ? QStringLiteral("启动") : QStringLiteral("安装")));
+
+    // 进行中的任务在卡片底部显示进度条
+    if (busy) {
+        const QRect track(cardRect.left() + kMargin, cardRect.bottom() - 5,
+                          cardRect.width() - kMargin * 2, 3);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(colors.border);
+        painter->drawRoundedRect(track, 1.5, 1.5);
+        QRect bar = track;
+        bar.setWidth(track.width() * qBound(0, content.progress, 100) / 100);
+        painter->setBrush(colors.button);
+        painter->drawRoundedRect(bar, 1.5, 1.5);
+    }
+
+    // 名称与描述
+    const int textLeft = icon.right() + 1 + kSpacing;
+    const QRect textRect(textLeft, cardRect.top() + kMargin,
+                         button.left() - kSpacing - textLeft, cardRect.height() - kMargin * 2);
+
+    QFont nameFont = baseFont;
+    nameFont.setPointSize(12);
+    nameFont.setBold(true);
+    const QFontMetrics nameMetrics(nameFont);
+    const QRect nameRect(textRect.left(), textRect.top(), textRect.width(), nameMetrics.height());
+    painter->setFont(nameFont);
+    painter->setPen(textColor);
+    painter->drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                      nameMetrics.elidedText(content.name, Qt::ElideRight, nameRect.width()));
+
+    QFont descFont = baseFont;
+    descFont.setPointSize(10);
+    const QRect descRect(textRect.left(), nameRect.bottom() + 1 + 4,
+                         textRect.width(), textRect.bottom() - nameRect.bottom() - 4);
+    painter->setFont(descFont);
+    painter->drawText(descRect, Qt::AlignLeft | Qt::AlignTop | Qt::TextWordWrap, content.description);
+
+    painter->restore();
+}
@@ -0,0 +1,54 @@
+#ifndef APPCARDPAINTER_H
+#define APPCARDPAINTER_H
+
+#include <QColor>
+#include <QFont>
+#include <QPixmap>
+#include <QRect>
+#include <QString>
+
+class QPainter;
+
+// 应用卡片绘制：AppCard 与 AppCardDelegate 共用，
+// 各状态的颜色预先计算好，状态切换只需要重绘
+class AppCardPainter
+{
+public:
+    enum State {
+        Normal,
+        Hovered,
+        Pressed,
+        StateCount
+    };
+
+    // 某一状态下卡片使用的颜色
+    struct Palette {
+        QColor background;
+        QColor border;
+        QColor button;
+        QColor buttonHover;
+        QColor buttonText;
+    };
+
+    // 卡片要显示的内容
+    struct Content {
+        QString name;
+        QString description;
+        QPixmap icon;
+        bool installed = false;
+        int progress = -1;   // 下载/安装进度（0-100），-1 表示没有进行中的任务
+    };
+
+    static const Palette &palette(State state, bool installed);
+
+    // 卡片布局，与原先的 QHBoxLayout 保持一致
+    static QSize cardSize() { return QSize(280, 100); }
+    static QRect iconRect(const QRect &cardRect);
+    static QRect buttonRect(const QRect &cardRect);
+
+    static void paint(QPainter *painter, const QRect &cardRect, const Content &content,
+                      State state, bool buttonHovered, const QFont &baseFont,
+                      const QColor &textColor);
+};
+
+#endif // APPCARDPAINTER_H
@@ -1,15 +1,52 @@
 #include "appgridview.h"
+#include "appcarddelegate.h"
+#include "cardflowlayout.h"
+#include "pageprefetcher.h"
+#include "core/trace.h"
+#include "models/applistmodel.h"
+#include "models/apppagemodel.h"
 #include <QResizeEvent>
 #include <QScrollBar>
+#include <QTimer>
 #include <QVBoxLayout>
+#include <QListView>
+
+namespace {
+
+const int kReflowIntervalMs = 16;   // 连续缩放时每帧最多重新排列一次
+const int kProbeStep = 8;           // 查找视口边缘卡片时的步长（像素）
+
+// 从 y 开始沿 step 方向找到第一列的卡片；卡片之间有间距，单个点可能落在空隙中
+QModelIndex cardNear(QListView *view, int y, int step)
+{
+    const QSize cardSize = AppCardPainter::cardSize();
+    const int x = view->spacing() + cardSize.width() / 2;
+    const int limit = cardSize.height() + view->spacing() * 2;
+    for (int offset = 0; offset <= limit; offset += kProbeStep) {
+        const QModelIndex index = view->indexAt(QPoint(x, y + (step > 0 ? offset : -offset)));
+        if (index.isValid()) return index;
+    }
+    return QModelIndex();
+}
+
+} // namespace
 
 AppGridView::AppGridView(QWidget *parent)
     : QScrollArea(parent)
     , m_container(new QWidget(this))
-    , m_gridLayout(new QGridLayout(m_container))
+    , m_flowLayout(new CardFlowLayout(m_container))
     , m_columnsCount(3)  // 默认每行显示3个卡片
     , m_spacing(20)      // 默认间距20像素
+    , m_reflowTimer(new QTimer(this))
+    , m_reflowPending(false)
     , m_pagination(new PaginationWidget(this))
+    , m_model(nullptr)
+    , m_pageModel(nullptr)
+    , m_listView(nullptr)
+    , m_delegate(nullptr)
+    , m_prefetcher(new PagePrefetcher(this))
+    , m_continuousScroll(false)
+    , m_loadedRows(0)
 {
     setupUI();
 }
@@ -22,9 +59,11 @@ void AppGridView::addAppCard(AppCard *card)
     
     m_cards.append(card);
     connectCardSignals(card);
+    // 不在当前页的卡片保持隐藏，进入当前页时再显示
+    card->hide();
     
     // 更新总页数
-    m_pagination->setTotalPages((m_cards.size() + m_pagination->itemsPerPage() - 1) / m_pagination->itemsPerPage());
+    updateTotalPages();
     
     // 更新显示
     updateVisibleCards();
@@ -32,8 +71,8 @@ void AppGridView::addAppCard(AppCard *card)
 
 void AppGridView::clearCards()
 {
+    m_flowLayout->setWidgets({});
     for (auto card : m_cards) {
-        m_gridLayout->removeWidget(card);
         card->deleteLater();
     }
     m_cards.clear();
@@ -46,17 +85,125 @@ void AppGridView::setColumnsCount(int count)
 {
     if (count > 0 && count != m_columnsCount) {
         m_columnsCount = count;
-        updateLayout();
+        m_flowLayout->setColumnCount(count);
     }
 }
 
 int AppGridView::cardsCount() const
 {
+    if (m_model) {
+        return m_model->rowCount();
+    }
     return m_cards.count();
 }
 
+void AppGridView::setModel(QAbstractItemModel *model)
+{
+    if (m_model == model) return;
+    
+    if (!m_listView) {
+        m_pageModel = new AppPageModel(this);
+        m_delegate = new AppCardDelegate(this);
+        
+        m_listView = new QListView(widget());
+        m_listView->setViewMode(QListView::ListMode);
+        m_listView->setFlow(QListView::LeftToRight);
+        m_listView->setWrapping(true);
+        m_listView->setResizeMode(QListView::Adjust);
+        m_listView->setMovement(QListView::Static);
+        m_listView->setUniformItemSizes(true);
+        m_listView->setSpacing(m_spacing / 2);
+        m_listView->setSelectionMode(QAbstractItemView::NoSelection);
+        m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        m_listView->setFrameShape(QFrame::NoFrame);
+        m_listView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        m_listView->setMouseTracking(true);
+        m_listView->viewport()->setAttribute(Qt::WA_Hover, true);
+        m_listView->viewport()->setCursor(Qt::PointingHandCursor);
+        m_listView->setStyleSheet("QListView { background: transparent; }");
+        m_listView->setItemDelegate(m_delegate);
+        m_listView->setModel(m_pageModel);
+        
+        QVBoxLayout *mainLayout = qobject_cast<QVBoxLayout*>(widget()->layout());
+        mainLayout->insertWidget(mainLayout->indexOf(m_container) + 1, m_listView, 1);
+        
+        connect(m_pageModel, &AppPageModel::sourceRowCountChanged,
+                this, &AppGridView::updateTotalPages);
+        // 连续滚动：滚动或内容高度变化后检查是否需要追加；请求的数据到达后也再检查一次
+        connect(m_listView->verticalScrollBar(), &QScrollBar::valueChanged,
+                this, &AppGridView::handleListScrolled);
+        connect(m_listView->verticalScrollBar(), &QScrollBar::rangeChanged,
+                this, &AppGridView::handleListScrolled);
+        connect(m_pageModel, &AppPageModel::sourceRowCountChanged,
+                this, &AppGridView::handleListScrolled);
+        connect(m_delegate, &AppCardDelegate::iconLoaded, m_listView->viewport(),
+                QOverload<>::of(&QWidget::update));
+        
+        // 委托的信号按行转发应用ID，不为被操作的条目创建卡片
+        connect(m_delegate, &AppCardDelegate::cardClicked, this, [this](const QModelIndex &index) {
+            emit cardClicked(index.data(AppListModel::AppIdRole).toString());
+        });
+        connect(m_delegate, &AppCardDelegate::cardDoubleClicked, this, [this](const QModelIndex &index) {
+            emit cardDoubleClicked(index.data(AppListModel::AppIdRole).toString());
+        });
+        connect(m_delegate, &AppCardDelegate::installClicked, this, [this](const QModelIndex &index) {
+            emit cardInstallClicked(index.data(AppListModel::AppIdRole).toString());
+        });
+        connect(m_delegate, &AppCardDelegate::startClicked, this, [this](const QModelIndex &index) {
+            emit cardStartClicked(index.data(AppListModel::AppIdRole).toString());
+        });
+    }
+    
+    // 目录整体重新加载后图标可能已经修复，之前加载失败的图标重新请求
+    if (m_model) {
+        disconnect(m_model, &QAbstractItemModel::modelReset, m_delegate, &AppCardDelegate::clearFailedIcons);
+    }
+    m_delegate->clearFailedIcons();
+    if (model) {
+        connect(model, &QAbstractItemModel::modelReset, m_delegate, &AppCardDelegate::clearFailedIcons);
+    }
+    
+    m_model = model;
+    m_pageModel->setSourceModel(model);
+    m_prefetcher->setModel(model);
+    
+    // 模型模式下不再使用卡片网格
+    m_container->setVisible(!model);
+    m_listView->setVisible(model != nullptr);
+    m_pagination->setVisible(!(model && m_continuousScroll));
+    
+    updateTotalPages();
+    updateVisibleCards();
+}
+
+void AppGridView::setAppProgress(const QString &appId, int percent)
+{
+    if (m_model) {
+        // 模型模式下进度保存在委托中，只重绘可见区域
+        m_delegate->setProgress(appId, percent);
+        m_listView->viewport()->update();
+        return;
+    }
+    
+    for (AppCard *card : std::as_const(m_cards)) {
+        if (card->appId() == appId) {
+            card->setProgress(percent);
+        }
+    }
+}
+
 void AppGridView::setCurrentPage(int page)
 {
+    if (m_model && m_continuousScroll) {
+        // 连续滚动没有页：只保留到这一页为止的行并滚动到这一页的开头（例如搜索条件变化后回到开头）
+        page = qMax(1, page);
+        m_loadedRows = page * itemsPerPage();
+        m_pageModel->setPage(0, m_loadedRows);
+        m_listView->scrollTo(m_pageModel->index((page - 1) * itemsPerPage(), 0),
+                             QAbstractItemView::PositionAtTop);
+        updatePrefetchRange();
+        return;
+    }
     m_pagination->setCurrentPage(page);
 }
 
@@ -80,14 +227,55 @@ int AppGridView::totalPages() const
     return m_pagination->totalPages();
 }
 
+void AppGridView::setContinuousScroll(bool enabled)
+{
+    if (m_continuousScroll == enabled) return;
+    
+    m_continuousScroll = enabled;
+    m_loadedRows = itemsPerPage();
+    m_pagination->setVisible(!(m_model && enabled));
+    if (m_model) {
+        m_delegate->cancelIconRequests();
+        m_listView->scrollToTop();
+    }
+    updateVisibleCards();
+}
+
+void AppGridView::setPrefetchEnabled(bool enabled)
+{
+    m_prefetcher->setEnabled(enabled);
+}
+
+bool AppGridView::isPrefetchEnabled() const
+{
+    return m_prefetcher->isEnabled();
+}
+
+void AppGridView::reflow()
+{
+    m_reflowPending = false;
+    calculateGrid();
+    // 列数变化时布局已失效，立即应用，不等排队的布局请求
+    m_flowLayout->activate();
+}
+
 void AppGridView::resizeEvent(QResizeEvent *event)
 {
     QScrollArea::resizeEvent(event);
-    calculateGrid();
+    
+    // 第一次缩放立即排列，之后的连续缩放合并到计时结束时处理
+    if (m_reflowTimer->isActive()) {
+        m_reflowPending = true;
+        return;
+    }
+    reflow();
+    m_reflowTimer->start();
 }
 
 void AppGridView::handlePageChanged(int page)
 {
+    TRACE_SPAN("grid", "AppGridView::handlePageChanged");
+    // 离开上一页的卡片会取消各自的图标请求，排队中的解码任务由 TaskScheduler 按取消令牌丢弃
     updateVisibleCards();
     emit pageChanged(page);
 }
@@ -95,7 +283,7 @@ void AppGridView::handlePageChanged(int page)
 void AppGridView::handleItemsPerPageChanged(int count)
 {
     // 更新总页数
-    m_pagination->setTotalPages((m_cards.size() + count - 1) / count);
+    updateTotalPages();
     
     // 更新显示
     updateVisibleCards();
@@ -121,8 +309,19 @@ void AppGridView::setupUI()
     mainLayout->addWidget(m_container);
     
     // 设置网格布局的属性
-    m_gridLayout->setSpacing(m_spacing);
-    m_gridLayout->setContentsMargins(m_spacing, m_spacing, m_spacing, m_spacing);
+    m_flowLayout->setSpacing(m_spacing);
+    m_flowLayout->setContentsMargins(m_spacing, m_spacing, m_spacing, m_spacing);
+    m_flowLayout->setCellSize(AppCardPainter::cardSize());
+    m_flowLayout->setColumnCount(m_columnsCount);
+    
+    m_reflowTimer->setSingleShot(true);
+    m_reflowTimer->setInterval(kReflowIntervalMs);
+    connect(m_reflowTimer, &QTimer::timeout, this, [this]() {
+        if (m_reflowPending) {
+            reflow();
+            m_reflowTimer->start();
+        }
+    });
     
     // 添加分页控件
     mainLayout->addWidget(m_pagination);
@@ -142,39 +341,23 @@ void AppGridView::setupUI()
     m_container->setStyleSheet("QWidget { background: transparent; }");
 }
 
-void AppGridView::updateLayout()
-{
-    // 清空现有布局
-    while (m_gridLayout->count() > 0) {
-        m_gridLayout->takeAt(0);
-    }
-    
-    // 重新添加卡片到网格布局
-    int row = 0;
-    int col = 0;
-    for (auto card : m_visibleCards) {
-        m_gridLayout->addWidget(card, row, col);
-        col++;
-        if (col >= m_columnsCount) {
-            col = 0;
-            row++;
-        }
-    }
-}
-
 void AppGridView::calculateGrid()
 {
+    TRACE_SPAN("grid", "AppGridView::calculateGrid");
+    // 模型模式下由列表视图自行换行
+    if (m_model) return;
+    
     // 获取可用宽度
     int availableWidth = width() - (m_spacing * 2) - verticalScrollBar()->sizeHint().width();
     
     // 计算合适的列数
-    int cardWidth = 280; // AppCard的固定宽度
+    int cardWidth = AppCardPainter::cardSize().width(); // AppCard的固定宽度
     int possibleColumns = (availableWidth + m_spacing) / (cardWidth + m_spacing);
     
     // 确保至少显示一列
     possibleColumns = qMax(1, possibleColumns);
     
-    // 如果列数发生变化，更新布局
+    // 如果列数发生变化，更新布局（只移动格子变化的卡片）
     if (possibleColumns != m_columnsCount) {
         setColumnsCount(possibleColumns);
     }
@@ -182,49 +365,111 @@ void AppGridView::calculateGrid()
 
 void AppGridView::connectCardSignals(AppCard *card)
 {
-    // 连接卡片的所有信号
-    connect(card, &AppCard::cardClicked, this, [this, card]() {
-        emit cardClicked(card);
+    // 连接卡片的所有信号；没有设置应用ID的卡片以名称作为ID
+    auto appIdOf = [card]() {
+        return card->appId().isEmpty() ? card->appName() : card->appId();
+    };
+    connect(card, &AppCard::cardClicked, this, [this, appIdOf]() {
+        emit cardClicked(appIdOf());
     });
     
-    connect(card, &AppCard::cardDoubleClicked, this, [this, card]() {
-        emit cardDoubleClicked(card);
+    connect(card, &AppCard::cardDoubleClicked, this, [this, appIdOf]() {
+        emit cardDoubleClicked(appIdOf());
     });
     
-    connect(card, &AppCard::installClicked, this, [this, card]() {
-        emit cardInstallClicked(card);
+    connect(card, &AppCard::installClicked, this, [this, appIdOf]() {
+        emit cardInstallClicked(appIdOf());
     });
     
-    connect(card, &AppCard::uninstallClicked, this, [this, card]() {
-        emit cardUninstallClicked(card);
+    connect(card, &AppCard::uninstallClicked, this, [this, appIdOf]() {
+        emit cardUninstallClicked(appIdOf());
     });
     
-    connect(card, &AppCard::startClicked, this, [this, card]() {
-        emit cardStartClicked(card);
+    connect(card, &AppCard::startClicked, this, [this, appIdOf]() {
+        emit cardStartClicked(appIdOf());
     });
 }
 
 void AppGridView::updateVisibleCards()
 {
-    // 隐藏所有卡片
-    for (auto card : m_cards) {
-        card->hide();
+    TRACE_SPAN("grid", "AppGridView::updateVisibleCards");
+    // 模型模式：只移动页偏移，开销与总数无关
+    if (m_model) {
+        if (m_continuousScroll) {
+            // 连续滚动：页模型从第一行开始，页大小为已显示的行数
+            m_pageModel->setPage(0, m_loadedRows);
+            updatePrefetchRange();
+            return;
+        }
+        // 离开视图的卡片不再需要图标
+        m_delegate->cancelIconRequests();
+        m_pageModel->setPage((currentPage() - 1) * itemsPerPage(), itemsPerPage());
+        m_prefetcher->setVisibleRange(m_pageModel->offset(), itemsPerPage());
+        return;
     }
     
-    // 清空可见卡片列表
-    m_visibleCards.clear();
-    
     // 计算当前页的卡片范围
     int startIndex = (currentPage() - 1) * itemsPerPage();
     int endIndex = qMin(startIndex + itemsPerPage(), m_cards.size());
+    const QList<AppCard*> visibleCards = m_cards.mid(startIndex, qMax(0, endIndex - startIndex));
     
-    // 添加可见卡片
-    for (int i = startIndex; i < endIndex; ++i) {
-        AppCard *card = m_cards[i];
-        card->show();
-        m_visibleCards.append(card);
+    // 当前页没有变化（例如向已满的页之后添加卡片）时不做任何事
+    if (visibleCards == m_visibleCards) return;
+    
+    // 只隐藏离开当前页的卡片
+    for (auto card : std::as_const(m_visibleCards)) {
+        if (!visibleCards.contains(card)) {
+            card->hide();
+        }
+    }
+    
+    const QList<AppCard*> previousCards = m_visibleCards;
+    m_visibleCards = visibleCards;
+    
+    // 更新布局：保留仍在页内卡片的布局条目，位置在下一次布局时按序号算出
+    m_flowLayout->setWidgets(QList<QWidget*>(m_visibleCards.cbegin(), m_visibleCards.cend()));
+    
+    // 显示新进入当前页的卡片
+    for (auto card : std::as_const(m_visibleCards)) {
+        if (!previousCards.contains(card)) {
+            card->show();
+        }
+    }
+}
+
+void AppGridView::updateTotalPages()
+{
+    const int count = cardsCount();
+    const int perPage = itemsPerPage();
+    m_pagination->setTotalPages((count + perPage - 1) / perPage);
+}
+
+void AppGridView::handleListScrolled()
+{
+    if (!m_model || !m_continuousScroll) return;
+    
+    // 距末尾不到一屏时追加一页；已显示源模型的全部行时请求更多数据，到达后由 sourceRowCountChanged 再次检查。
+    // 追加后内容变高（rangeChanged），仍不足一屏时继续追加
+    QScrollBar *bar = m_listView->verticalScrollBar();
+    if (bar->value() >= bar->maximum() - bar->pageStep()) {
+        if (m_loadedRows < m_model->rowCount()) {
+            m_loadedRows += itemsPerPage();
+            m_pageModel->setPage(0, m_loadedRows);
+        } else if (m_pageModel->canFetchMore(QModelIndex())) {
+            m_pageModel->fetchMore(QModelIndex());
+        }
     }
+    updatePrefetchRange();
+}
+
+void AppGridView::updatePrefetchRange()
+{
+    if (!m_model || !m_continuousScroll) return;
     
-    // 更新布局
-    updateLayout();
-} 
\ No newline at end of file
+    // 连续滚动时按视口上下边缘的卡片确定显示范围，相邻页即前后各一屏
+    const QModelIndex first = cardNear(m_listView, 0, kProbeStep);
+    const QModelIndex last = cardNear(m_listView, m_listView->viewport()->height() - 1, -kProbeStep);
+    const int firstRow = first.isValid() ? first.row() : 0;
+    const int lastRow = last.isValid() ? last.row() : firstRow + itemsPerPage() - 1;
+    m_prefetcher->setVisibleRange(firstRow, qMax(itemsPerPage(), lastRow - firstRow + 1));
+}
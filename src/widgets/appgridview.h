@@ -3,10 +3,17 @@
 
 #include <QWidget>
 #include <QScrollArea>
-#include <QGridLayout>
 #include "appcard.h"
 #include "paginationwidget.h"
 
+class QListView;
+class QAbstractItemModel;
+class AppPageModel;
+class AppCardDelegate;
+class CardFlowLayout;
+class PagePrefetcher;
+class QTimer;
+
 class AppGridView : public QScrollArea
 {
     Q_OBJECT
@@ -24,20 +31,38 @@ public:
     // 获取当前显示的卡片数量
     int cardsCount() const;
     
+    // 模型模式：由模型提供数据，委托绘制，只处理当前页可见的条目
+    void setModel(QAbstractItemModel *model);
+    QAbstractItemModel *model() const { return m_model; }
+    
+    // 显示应用的安装进度（0-100），-1 表示结束
+    void setAppProgress(const QString &appId, int percent);
+    
     // 分页相关
     void setCurrentPage(int page);
     void setItemsPerPage(int count);
     int currentPage() const;
     int itemsPerPage() const;
     int totalPages() const;
+    
+    // 立即按当前宽度重新排列；缩放时由 resizeEvent 合并为每帧最多一次
+    void reflow();
+    
+    // 连续滚动（仅模型模式）：隐藏分页控件，滚动到距末尾不到一屏时追加一页，
+    // 已显示源模型的全部行时通过 fetchMore 请求更多数据（例如按页从服务器读取目录）
+    void setContinuousScroll(bool enabled);
+    bool isContinuousScroll() const { return m_continuousScroll; }
+    // 相邻页预取（仅模型模式，默认开启，见 PagePrefetcher）
+    void setPrefetchEnabled(bool enabled);
+    bool isPrefetchEnabled() const;
 
 signals:
-    // 转发卡片的信号
-    void cardClicked(AppCard *card);
-    void cardDoubleClicked(AppCard *card);
-    void cardInstallClicked(AppCard *card);
-    void cardUninstallClicked(AppCard *card);
-    void cardStartClicked(AppCard *card);
+    // 转发卡片的信号，只携带应用ID；其余数据由接收方从模型读取
+    void cardClicked(const QString &appId);
+    void cardDoubleClicked(const QString &appId);
+    void cardInstallClicked(const QString &appId);
+    void cardUninstallClicked(const QString &appId);
+    void cardStartClicked(const QString &appId);
     
     // 分页信号
     void pageChanged(int page);
@@ -52,20 +77,33 @@ private slots:
 
 private:
     void setupUI();
-    void updateLayout();
     void calculateGrid();
     void connectCardSignals(AppCard *card);
     void updateVisibleCards();
+    void updateTotalPages();
+    void handleListScrolled();
+    void updatePrefetchRange();
 
 private:
     QWidget *m_container;       // 容器widget
-    QGridLayout *m_gridLayout;  // 网格布局
+    CardFlowLayout *m_flowLayout; // 卡片流式布局
     QList<AppCard*> m_cards;    // 所有卡片列表
     QList<AppCard*> m_visibleCards; // 当前页显示的卡片
     int m_columnsCount;         // 每行显示的卡片数量
     int m_spacing;              // 卡片之间的间距
+    QTimer *m_reflowTimer;      // 缩放时限制重新排列的频率
+    bool m_reflowPending;       // 计时期间又发生了缩放
     
     PaginationWidget *m_pagination;  // 分页控件
+    
+    // 模型模式
+    QAbstractItemModel *m_model;     // 数据模型（不持有）
+    AppPageModel *m_pageModel;       // 当前页代理模型
+    QListView *m_listView;           // 只绘制可见条目的视图
+    AppCardDelegate *m_delegate;     // 卡片绘制委托
+    PagePrefetcher *m_prefetcher;    // 相邻页预取
+    bool m_continuousScroll;         // 连续滚动模式
+    int m_loadedRows;                // 连续滚动时已显示的行数（页模型的页大小）
 };
 
 #endif // APPGRIDVIEW_H 
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "cardflowlayout.h"
+#include "core/trace.h"
+#include <QHash>
+#include <QWidget>
+
+CardFlowLayout::CardFlowLayout(QWidget *parent)
+    : QLayout(parent)
+    , m_cellSize(280, 100)
+    , m_columns(1)
+{
+}
+
+CardFlowLayout::~CardFlowLayout()
+{
+    qDeleteAll(m_items);
+}
+
+void CardFlowLayout::setCellSize(const QSize &size)
+{
+    if (size.isValid() && size != m_cellSize) {
+        m_cellSize = size;
+        invalidate();
+    }
+}
+
+void CardFlowLayout::setColumnCount(int count)
+{
+    count = qMax(1, count);
+    if (count != m_columns) {
+        m_columns = count;
+        invalidate();
+    }
+}
+
+void CardFlowLayout::setWidgets(const QList<QWidget*> &widgets)
+{
+    QHash<QWidget*, QLayoutItem*> existing;
+    existing.reserve(m_items.size());
+    for (QLayoutItem *item : std::as_const(m_items)) {
+        existing.insert(item->widget(), item);
+    }
+
+    QList<QLayoutItem*> items;
+    items.reserve(widgets.size());
+    for (QWidget *widget : widgets) {
+        QLayoutItem *item = existing.take(widget);
+        if (!item) {
+            addChildWidget(widget);
+            item = new QWidgetItem(widget);
+        }
+        items.append(item);
+    }
+    qDeleteAll(existing);
+
+    m_items = items;
+    invalidate();
+}
+
+void CardFlowLayout::addItem(QLayoutItem *item)
+{
+    m_items.append(item);
+    invalidate();
+}
+
+int CardFlowLayout::count() const
+{
+    return m_items.size();
+}
+
+QLayoutItem *CardFlowLayout::itemAt(int index) const
+{
+    return m_items.value(index);
+}
+
+QLayoutItem *CardFlowLayout::takeAt(int index)
+{
+    if (index < 0 || index >= m_items.size()) return nullptr;
+    QLayoutItem *item = m_items.takeAt(index);
+    invalidate();
+    return item;
+}
+
+Qt::Orientations CardFlowLayout::expandingDirections() const
+{
+    return {};
+}
+
+QSize CardFlowLayout::sizeHint() const
+{
+    const QMargins margins = contentsMargins();
+    const int columns = qMax(1, qMin(m_columns, int(m_items.size())));
+    const int width = columns * m_cellSize.width() + (columns - 1) * spacing();
+    return QSize(width + margins.left() + margins.right(), contentHeight());
+}
+
+QSize CardFlowLayout::minimumSize() const
+{
+    // 宽度只要求一列，列数由 AppGridView 按可用宽度决定；高度必须放下所有行，滚动区域据此滚动
+    const QMargins margins = contentsMargins();
+    return QSize(m_cellSize.width() + margins.left() + margins.right(), contentHeight());
+}
+
+void CardFlowLayout::setGeometry(const QRect &rect)
+{
+    TRACE_SPAN("grid", "CardFlowLayout::setGeometry");
+    QLayout::setGeometry(rect);
+
+    const QMargins margins = contentsMargins();
+    const QPoint origin(rect.x() + margins.left(), rect.y() + margins.top());
+    for (int i = 0; i < m_items.size(); ++i) {
+        QLayoutItem *item = m_items.at(i);
+        const QRect cell = cellRect(i, origin);
+        if (item->geometry() != cell) {
+            item->setGeometry(cell);
+        }
+    }
+}
+
+int CardFlowLayout::contentHeight() const
+{
+    const QMargins margins = contentsMargins();
+    const int rows = (int(m_items.size()) + m_columns - 1) / m_columns;
+    const int height = rows > 0 ? rows * m_cellSize.height() + (rows - 1) * spacing() : 0;
+    return height + margins.top() + margins.bottom();
+}
+
+QRect CardFlowLayout::cellRect(int index, const QPoint &origin) const
+{
+    const int row = index / m_columns;
+    const int column = index % m_columns;
+    return QRect(origin.x() + column * (m_cellSize.width() + spacing()),
+                 origin.y() + row * (m_cellSize.height() + spacing()),
+                 m_cellSize.width(), m_cellSize.height());
+}
@@ -0,0 +1,47 @@
+#ifndef CARDFLOWLAYOUT_H
+#define CARDFLOWLAYOUT_H
+
+#include <QLayout>
+#include <QList>
+
+// 卡片网格使用的流式布局：卡片尺寸固定，第 i 张卡片的位置直接由 i 和列数算出，
+// 不需要像 QGridLayout 那样拆除、重建布局条目。重新排列时只移动格子发生变化的卡片，
+// 列数不变时缩放窗口不会移动任何卡片。卡片从左上角开始排列，与模型模式的列表视图一致。
+class CardFlowLayout : public QLayout
+{
+public:
+    explicit CardFlowLayout(QWidget *parent = nullptr);
+    ~CardFlowLayout() override;
+
+    // 格子大小（卡片的固定尺寸）
+    void setCellSize(const QSize &size);
+    QSize cellSize() const { return m_cellSize; }
+
+    // 每行的格子数
+    void setColumnCount(int count);
+    int columnCount() const { return m_columns; }
+
+    // 按顺序设置显示的控件：已在布局中的控件沿用原来的条目，只为新加入的控件创建条目，
+    // 不再显示的控件从布局中移除（显示、隐藏由调用者负责）
+    void setWidgets(const QList<QWidget*> &widgets);
+
+    void addItem(QLayoutItem *item) override;
+    int count() const override;
+    QLayoutItem *itemAt(int index) const override;
+    QLayoutItem *takeAt(int index) override;
+    Qt::Orientations expandingDirections() const override;
+    QSize sizeHint() const override;
+    QSize minimumSize() const override;
+    void setGeometry(const QRect &rect) override;
+
+private:
+    int contentHeight() const;
+    QRect cellRect(int index, const QPoint &origin) const;
+
+private:
+    QList<QLayoutItem*> m_items;
+    QSize m_cellSize;
+    int m_columns;
+};
+
+#endif // CARDFLOWLAYOUT_H
@@ -0,0 +1,139 @@
+#include "pageprefetcher.h"
+#include "core/iconservice.h"
+#include "core/trace.h"
+#include "models/applistmodel.h"
+#include <QAbstractItemModel>
+#include <QTimer>
+
+namespace {
+
+const int kDefaultDelayMs = 200;   // 停留这么久才认为用户在看这一页
+
+} // namespace
+
+PagePrefetcher::PagePrefetcher(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_first(0)
+    , m_count(0)
+    , m_enabled(true)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(kDefaultDelayMs);
+    connect(m_timer, &QTimer::timeout, this, &PagePrefetcher::prefetch);
+}
+
+PagePrefetcher::~PagePrefetcher()
+{
+    cancelAll();
+}
+
+void PagePrefetcher::setModel(QAbstractItemModel *model)
+{
+    if (m_model == model) return;
+
+    cancelAll();
+    if (m_model) {
+        disconnect(m_model, nullptr, this, nullptr);
+    }
+    m_model = model;
+    if (m_model) {
+        // 请求的下一页数据到达后，为新的行继续预取
+        connect(m_model, &QAbstractItemModel::rowsInserted, this, [this]() {
+            if (m_enabled && !m_timer->isActive()) {
+                m_timer->start();
+            }
+        });
+    }
+}
+
+void PagePrefetcher::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) return;
+
+    m_enabled = enabled;
+    if (!m_enabled) {
+        m_timer->stop();
+        cancelAll();
+    } else if (m_count > 0) {
+        m_timer->start();
+    }
+}
+
+void PagePrefetcher::setVisibleRange(int first, int count)
+{
+    if (first == m_first && count == m_count) return;
+
+    m_first = qMax(0, first);
+    m_count = qMax(0, count);
+
+    // 仍在新范围附近的预取继续进行（例如翻到下一页时，正在预取的图标由当前页的请求提升优先级），其余取消
+    if (!m_prefetched.isEmpty()) {
+        QSet<QString> wanted;
+        if (m_model) {
+            const int last = qMin(m_first + m_count * 2, m_model->rowCount());
+            for (int row = qMax(0, m_first - m_count); row < last; ++row) {
+                wanted.insert(m_model->index(row, 0).data(AppListModel::IconPathRole).toString());
+            }
+        }
+        IconService *service = IconService::instance();
+        for (auto it = m_prefetched.begin(); it != m_prefetched.end();) {
+            if (wanted.contains(*it)) {
+                ++it;
+            } else {
+                service->cancelPrefetch(*it);
+                it = m_prefetched.erase(it);
+            }
+        }
+    }
+
+    if (m_enabled && m_count > 0) {
+        m_timer->start();
+    }
+}
+
+void PagePrefetcher::setDelay(int msecs)
+{
+    m_timer->setInterval(qMax(0, msecs));
+}
+
+void PagePrefetcher::prefetch()
+{
+    if (!m_enabled || !m_model || m_count <= 0) return;
+    TRACE_SPAN("grid", "PagePrefetcher::prefetch");
+
+    // 下一页超出已读取的行：先请求数据，到达后（rowsInserted）再预取图标
+    const int rows = m_model->rowCount();
+    if (m_first + m_count * 2 > rows && m_model->canFetchMore(QModelIndex())) {
+        m_model->fetchMore(QModelIndex());
+    }
+
+    // 下一页优先，其次上一页；总数不超过预取预算能容纳的图标数
+    IconService *service = IconService::instance();
+    const qint64 budget = service->prefetchBudget() / IconService::iconBytes();
+    const int next = m_first + m_count;
+    const int previous = m_first - m_count;
+    for (int i = 0; i < m_count * 2 && m_prefetched.size() < budget; ++i) {
+        const int row = i < m_count ? next + i : previous + i - m_count;
+        if (row < 0 || row >= rows) continue;
+
+        const QModelIndex index = m_model->index(row, 0);
+        const QString iconPath = index.data(AppListModel::IconPathRole).toString();
+        // 目录快照中带缩略图的条目绘制时直接使用缩略图，不需要预取
+        if (iconPath.isEmpty() || m_prefetched.contains(iconPath)
+            || !index.data(AppListModel::ThumbnailRole).toByteArray().isEmpty()) {
+            continue;
+        }
+        m_prefetched.insert(iconPath);
+        service->prefetch(iconPath);
+    }
+}
+
+void PagePrefetcher::cancelAll()
+{
+    IconService *service = IconService::instance();
+    for (const QString &iconPath : std::as_const(m_prefetched)) {
+        service->cancelPrefetch(iconPath);
+    }
+    m_prefetched.clear();
+}
@@ -0,0 +1,50 @@
+#ifndef PAGEPREFETCHER_H
+#define PAGEPREFETCHER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+
+class QAbstractItemModel;
+class QTimer;
+
+// 相邻页预取：当前显示的范围停留一段时间后（快速翻页、拖动滚动条时不预取），
+// 先为下一页、再为上一页预取图标（见 IconService::prefetch），下一页超出已读取的行时向模型请求更多数据
+// （见 QAbstractItemModel::fetchMore，例如按页从服务器读取目录）。
+// 图标以预取优先级下载和解码，不占用当前页的线程和连接；预取的图标数不超过 IconService 的预取预算，
+// 显示范围变化时取消尚未完成的预取
+class PagePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PagePrefetcher(QObject *parent = nullptr);
+    ~PagePrefetcher() override;
+
+    // 数据模型（不持有），行号与 setVisibleRange 相同
+    void setModel(QAbstractItemModel *model);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 当前显示的行 [first, first + count)，相邻页各 count 行
+    void setVisibleRange(int first, int count);
+
+    // 停留多久后开始预取（毫秒）
+    void setDelay(int msecs);
+
+private:
+    void prefetch();
+    void cancelAll();
+
+private:
+    QPointer<QAbstractItemModel> m_model;
+    QTimer *m_timer;               // 显示范围稳定后触发预取
+    QSet<QString> m_prefetched;    // 本次范围已交给 IconService 的图标
+    int m_first;
+    int m_count;
+    bool m_enabled;
+};
+
+#endif // PAGEPREFETCHER_H
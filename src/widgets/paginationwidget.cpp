@@ -6,6 +6,8 @@ PaginationWidget::PaginationWidget(QWidget *parent)
     : QWidget(parent)
     , m_prevBtn(new QPushButton("上一页", this))
     , m_nextBtn(new QPushButton("下一页", this))
+    , m_leadingEllipsis(new QLabel("...", this))
+    , m_trailingEllipsis(new QLabel("...", this))
     , m_totalLabel(new QLabel(this))
     , m_currentPage(1)
     , m_totalPages(1)
@@ -13,20 +15,19 @@ PaginationWidget::PaginationWidget(QWidget *parent)
     , m_maxVisiblePages(5)
 {
     setupUI();
+    m_totalLabel->setText(QString("共 %1 页").arg(m_totalPages));
+    updatePageNumbers();
     updateButtons();
 }
 
-PaginationWidget::~PaginationWidget()
-{
-    qDeleteAll(m_pageButtons);
-    m_pageButtons.clear();
-}
+PaginationWidget::~PaginationWidget() = default;
 
 void PaginationWidget::setTotalPages(int total)
 {
     if (total < 1) total = 1;
     if (m_totalPages != total) {
         m_totalPages = total;
+        m_totalLabel->setText(QString("共 %1 页").arg(m_totalPages));
         if (m_currentPage > m_totalPages) {
             setCurrentPage(m_totalPages);
         }
@@ -92,7 +93,26 @@ void PaginationWidget::setupUI()
     m_prevBtn->setFixedSize(80, 32);
     layout->addWidget(m_prevBtn);
     
-    // 添加页码按钮的占位符
+    // 页码按钮池：第一页、省略号、中间页码、省略号、最后一页，不需要的隐藏
+    m_pageButtons.append(createPageButton());
+    layout->addWidget(m_pageButtons.last());
+    
+    for (QLabel *ellipsisLabel : {m_leadingEllipsis, m_trailingEllipsis}) {
+        ellipsisLabel->setAlignment(Qt::AlignCenter);
+        ellipsisLabel->setFixedSize(32, 32);
+        ellipsisLabel->hide();
+    }
+    layout->addWidget(m_leadingEllipsis);
+    
+    for (int i = 0; i < m_maxVisiblePages; ++i) {
+        m_pageButtons.append(createPageButton());
+        layout->addWidget(m_pageButtons.last());
+    }
+    
+    layout->addWidget(m_trailingEllipsis);
+    m_pageButtons.append(createPageButton());
+    layout->addWidget(m_pageButtons.last());
+    
     layout->addStretch();
     
     // 添加下一页按钮
@@ -125,6 +145,23 @@ void PaginationWidget::setupUI()
         "  background-color: #e9ecef;"
         "  border-color: #dee2e6;"
         "  color: #6c757d;"
+        "}"
+        // 页码按钮共用一份样式表，按 current 属性区分当前页
+        "QPushButton[pageButton=\"true\"] {"
+        "  background-color: #ffffff;"
+        "  border: 1px solid #dee2e6;"
+        "  border-radius: 4px;"
+        "  color: #007bff;"
+        "}"
+        "QPushButton[pageButton=\"true\"]:hover {"
+        "  background-color: #e9ecef;"
+        "  border-color: #dee2e6;"
+        "  color: #0056b3;"
+        "}"
+        "QPushButton[pageButton=\"true\"][current=\"true\"] {"
+        "  background-color: #007bff;"
+        "  border-color: #007bff;"
+        "  color: #ffffff;"
         "}";
     
     setStyleSheet(btnStyle);
@@ -134,26 +171,10 @@ void PaginationWidget::updateButtons()
 {
     m_prevBtn->setEnabled(m_currentPage > 1);
     m_nextBtn->setEnabled(m_currentPage < m_totalPages);
-    m_totalLabel->setText(QString("共 %1 页").arg(m_totalPages));
-    
-    // 更新页码按钮状态
-    for (auto btn : m_pageButtons) {
-        bool ok;
-        int page = btn->property("page").toInt(&ok);
-        if (ok) {
-            btn->setProperty("current", page == m_currentPage);
-            btn->style()->unpolish(btn);
-            btn->style()->polish(btn);
-        }
-    }
 }
 
 void PaginationWidget::updatePageNumbers()
 {
-    // 清除现有的页码按钮
-    qDeleteAll(m_pageButtons);
-    m_pageButtons.clear();
-    
     // 计算显示的页码范围
     int start = qMax(1, m_currentPage - m_maxVisiblePages / 2);
     int end = qMin(m_totalPages, start + m_maxVisiblePages - 1);
@@ -163,83 +184,50 @@ void PaginationWidget::updatePageNumbers()
         start = qMax(1, end - m_maxVisiblePages + 1);
     }
     
-    // 获取布局
-    QHBoxLayout *layout = qobject_cast<QHBoxLayout*>(this->layout());
-    if (!layout) return;
+    // 第一页和省略号
+    setPageButton(m_pageButtons.first(), start > 1 ? 1 : 0);
+    m_leadingEllipsis->setVisible(start > 2);
     
-    // 移除旧的页码按钮
-    while (layout->count() > 4) {  // 4是固定的部件数量（前一页、弹簧、后一页、总页数）
-        QLayoutItem *item = layout->takeAt(1);  // 1是页码按钮的起始位置
-        delete item;
+    // 中间的页码，超出范围的按钮隐藏
+    for (int i = 0; i < m_maxVisiblePages; ++i) {
+        const int page = start + i;
+        setPageButton(m_pageButtons.at(i + 1), page <= end ? page : 0);
     }
     
-    // 添加新的页码按钮
-    int insertIndex = 1;  // 在"上一页"按钮后插入
-    
-    // 添加第一页和省略号
-    if (start > 1) {
-        auto firstBtn = createPageButton(1);
-        layout->insertWidget(insertIndex++, firstBtn);
-        m_pageButtons.append(firstBtn);
-        
-        if (start > 2) {
-            auto ellipsisLabel = new QLabel("...");
-            ellipsisLabel->setAlignment(Qt::AlignCenter);
-            ellipsisLabel->setFixedSize(32, 32);
-            layout->insertWidget(insertIndex++, ellipsisLabel);
-        }
-    }
-    
-    // 添加中间的页码
-    for (int i = start; i <= end; ++i) {
-        auto btn = createPageButton(i);
-        layout->insertWidget(insertIndex++, btn);
-        m_pageButtons.append(btn);
-    }
-    
-    // 添加最后一页和省略号
-    if (end < m_totalPages) {
-        if (end < m_totalPages - 1) {
-            auto ellipsisLabel = new QLabel("...");
-            ellipsisLabel->setAlignment(Qt::AlignCenter);
-            ellipsisLabel->setFixedSize(32, 32);
-            layout->insertWidget(insertIndex++, ellipsisLabel);
-        }
-        
-        auto lastBtn = createPageButton(m_totalPages);
-        layout->insertWidget(insertIndex++, lastBtn);
-        m_pageButtons.append(lastBtn);
-    }
+    // 最后一页和省略号
+    m_trailingEllipsis->setVisible(end < m_totalPages - 1);
+    setPageButton(m_pageButtons.last(), end < m_totalPages ? m_totalPages : 0);
 }
 
-QPushButton* PaginationWidget::createPageButton(int pageNum)
+QPushButton* PaginationWidget::createPageButton()
 {
-    QPushButton *btn = new QPushButton(QString::number(pageNum));
+    QPushButton *btn = new QPushButton(this);
     btn->setFixedSize(32, 32);
-    btn->setProperty("page", pageNum);
-    btn->setProperty("current", pageNum == m_currentPage);
-    
-    // 设置页码按钮的样式
-    QString numBtnStyle = 
-        "QPushButton {"
-        "  background-color: #ffffff;"
-        "  border: 1px solid #dee2e6;"
-        "  border-radius: 4px;"
-        "  color: #007bff;"
-        "}"
-        "QPushButton:hover {"
-        "  background-color: #e9ecef;"
-        "  border-color: #dee2e6;"
-        "  color: #0056b3;"
-        "}"
-        "QPushButton[current=\"true\"] {"
-        "  background-color: #007bff;"
-        "  border-color: #007bff;"
-        "  color: #ffffff;"
-        "}";
-    
-    btn->setStyleSheet(numBtnStyle);
+    btn->setProperty("pageButton", true);
+    btn->setProperty("page", 0);
+    btn->setProperty("current", false);
+    btn->hide();
     
     connect(btn, &QPushButton::clicked, this, &PaginationWidget::handlePageNumberClicked);
     return btn;
-} 
\ No newline at end of file
+}
+
+void PaginationWidget::setPageButton(QPushButton *button, int pageNum)
+{
+    // pageNum 为 0 表示这个位置不需要按钮
+    button->setVisible(pageNum > 0);
+    if (pageNum <= 0) return;
+    
+    if (button->property("page").toInt() != pageNum) {
+        button->setProperty("page", pageNum);
+        button->setText(QString::number(pageNum));
+    }
+    
+    // 样式表按 current 属性选择颜色，只有状态变化的按钮需要重新应用样式
+    const bool current = pageNum == m_currentPage;
+    if (button->property("current").toBool() != current) {
+        button->setProperty("current", current);
+        button->style()->unpolish(button);
+        button->style()->polish(button);
+    }
+}
@@ -38,12 +38,16 @@ private:
     void setupUI();
     void updateButtons();
     void updatePageNumbers();
-    QPushButton* createPageButton(int pageNum);
+    QPushButton* createPageButton();
+    void setPageButton(QPushButton *button, int pageNum);
 
 private:
     QPushButton *m_prevBtn;     // 上一页按钮
     QPushButton *m_nextBtn;     // 下一页按钮
-    QList<QPushButton*> m_pageButtons;  // 页码按钮列表
+    // 页码按钮池，构造时创建、之后只更新文字和状态：第一页、中间 m_maxVisiblePages 个、最后一页
+    QList<QPushButton*> m_pageButtons;
+    QLabel *m_leadingEllipsis;  // 第一页之后的省略号
+    QLabel *m_trailingEllipsis; // 最后一页之前的省略号
     QLabel *m_totalLabel;       // 总页数标签
     
     int m_currentPage;          // 当前页码